@@ -0,0 +1,117 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+// CPU optimizer step throughput: fused Adam step vs torch::optim::Adam.
+//
+//   adam_cpu_bench [num_gaussians...=1000000 3000000 10000000] [--repeats=5]
+//
+// Each Gaussian carries the 59 floats of the training parameters (means 3, sh0 3,
+// shN 45, scaling 3, rotation 4, opacity 1), one tensor per parameter group like
+// FusedAdam. Gradients are fixed so only the update itself is timed. Bandwidth
+// counts the minimal traffic of one pass: param, exp_avg and exp_avg_sq read and
+// written, grad read.
+
+#include "adam_api.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+namespace {
+
+    constexpr double LR = 1e-3;
+    constexpr double BETA1 = 0.9;
+    constexpr double BETA2 = 0.999;
+    constexpr double EPS = 1e-15;
+    constexpr int64_t FLOATS_PER_GAUSSIAN = 3 + 3 + 45 + 3 + 4 + 1;
+
+    std::vector<torch::Tensor> make_params(int64_t n) {
+        const std::vector<std::vector<int64_t>> shapes = {
+            {n, 3}, {n, 1, 3}, {n, 15, 3}, {n, 3}, {n, 4}, {n, 1}};
+        std::vector<torch::Tensor> params;
+        for (const auto& shape : shapes) {
+            auto p = torch::randn(shape).requires_grad_(true);
+            p.mutable_grad() = torch::randn(shape) * 1e-3f;
+            params.push_back(p);
+        }
+        return params;
+    }
+
+    // Best of `repeats` steps, in seconds
+    double best_of(int repeats, const std::function<void()>& step) {
+        step(); // Warm-up: state allocation and page faults
+        double best = 1e30;
+        for (int r = 0; r < repeats; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            step();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    double fused_step_seconds(int64_t n, int repeats) {
+        auto params = make_params(n);
+        std::vector<torch::Tensor> exp_avg, exp_avg_sq;
+        for (const auto& p : params) {
+            exp_avg.push_back(torch::zeros_like(p));
+            exp_avg_sq.push_back(torch::zeros_like(p));
+        }
+        int step_count = 0;
+        return best_of(repeats, [&]() {
+            ++step_count;
+            const auto bias_correction1_rcp = 1.0 / (1.0 - std::pow(BETA1, step_count));
+            const auto bias_correction2_sqrt_rcp = 1.0 / std::sqrt(1.0 - std::pow(BETA2, step_count));
+            torch::NoGradGuard no_grad;
+            for (size_t i = 0; i < params.size(); ++i) {
+                fast_gs::optimizer::adam_step_wrapper(
+                    params[i], exp_avg[i], exp_avg_sq[i], params[i].grad(), step_count,
+                    static_cast<float>(LR), static_cast<float>(BETA1), static_cast<float>(BETA2),
+                    static_cast<float>(EPS), static_cast<float>(bias_correction1_rcp),
+                    static_cast<float>(bias_correction2_sqrt_rcp));
+            }
+        });
+    }
+
+    double torch_step_seconds(int64_t n, int repeats) {
+        auto params = make_params(n);
+        torch::optim::Adam optimizer(params, torch::optim::AdamOptions(LR).betas({BETA1, BETA2}).eps(EPS));
+        return best_of(repeats, [&]() { optimizer.step(); });
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<int64_t> sizes;
+    int repeats = 5;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--repeats=")) {
+            repeats = std::max(std::atoi(arg.c_str() + 10), 1);
+        } else {
+            sizes.push_back(std::atoll(arg.c_str()));
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {1'000'000, 3'000'000, 10'000'000};
+    }
+
+    torch::manual_seed(0);
+    std::cout << std::format("{:>12} {:>14} {:>14} {:>10} {:>12}\n",
+                             "gaussians", "fused [ms]", "torch [ms]", "speedup", "fused GB/s");
+    for (const int64_t n : sizes) {
+        const double fused = fused_step_seconds(n, repeats);
+        const double reference = torch_step_seconds(n, repeats);
+        const double bytes = static_cast<double>(n) * FLOATS_PER_GAUSSIAN * sizeof(float) * 7.0;
+        std::cout << std::format("{:>12} {:>14.2f} {:>14.2f} {:>9.2f}x {:>12.1f}\n",
+                                 n, fused * 1e3, reference * 1e3, reference / fused, bytes / fused * 1e-9);
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+// Decode + resize throughput of the JPEG backends behind load_image().
+//
+//   jpeg_decode_bench <jpeg_dir> [resize_factor=2] [max_images=64] [repeats=3]
+//
+// Files are read into memory up front so only decoding and resizing are timed.
+// Throughput is reported in MB/s of compressed input and in output megapixels/s.
+
+#include "core/image_resize.hpp"
+#include "core/jpeg_decode.hpp"
+#include "external/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+    using Image = std::tuple<unsigned char*, int, int, int>;
+    using Decoder = std::function<Image(const std::vector<unsigned char>&, int)>;
+
+    Image decode_stb(const std::vector<unsigned char>& bytes, int resize_factor) {
+        int w, h, c;
+        unsigned char* img = stbi_load_from_memory(bytes.data(), static_cast<int>(bytes.size()), &w, &h, &c, 0);
+        if (!img) {
+            throw std::runtime_error(std::format("stb decode failed: {}", stbi_failure_reason()));
+        }
+        if (resize_factor > 1) {
+            int nw, nh;
+            unsigned char* out = image_io::downscale(img, w, h, c, static_cast<float>(resize_factor), nw, nh);
+            stbi_image_free(img);
+            return {out, nw, nh, c};
+        }
+        return {img, w, h, c};
+    }
+
+    Image decode_scaled_idct(const std::vector<unsigned char>& bytes, int resize_factor) {
+        auto result = image_io::decode_jpeg(bytes.data(), bytes.size(), resize_factor);
+        if (!result) {
+            throw std::runtime_error("libjpeg decode failed");
+        }
+        return *result;
+    }
+
+    struct Result {
+        double seconds = 0.0;
+        double megapixels = 0.0;
+    };
+
+    // Best of `repeats` passes over all files
+    Result run(const Decoder& decode, const std::vector<std::vector<unsigned char>>& files,
+               int resize_factor, int repeats) {
+        Result best{.seconds = 1e30};
+        for (int r = 0; r < repeats; ++r) {
+            double megapixels = 0.0;
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& bytes : files) {
+                auto [data, w, h, c] = decode(bytes, resize_factor);
+                megapixels += static_cast<double>(w) * h * 1e-6;
+                std::free(data);
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (seconds < best.seconds) {
+                best = {seconds, megapixels};
+            }
+        }
+        return best;
+    }
+
+    // Mean absolute difference between the two backends over all images
+    double mean_abs_diff(const std::vector<std::vector<unsigned char>>& files, int resize_factor) {
+        double sum = 0.0;
+        size_t count = 0;
+        for (const auto& bytes : files) {
+            auto [a, aw, ah, ac] = decode_stb(bytes, resize_factor);
+            auto [b, bw, bh, bc] = decode_scaled_idct(bytes, resize_factor);
+            if (aw != bw || ah != bh || ac != bc) {
+                std::free(a);
+                std::free(b);
+                throw std::runtime_error(std::format("size mismatch: {}x{}x{} vs {}x{}x{}", aw, ah, ac, bw, bh, bc));
+            }
+            const size_t n = static_cast<size_t>(aw) * ah * ac;
+            for (size_t i = 0; i < n; ++i) {
+                sum += std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i]));
+            }
+            count += n;
+            std::free(a);
+            std::free(b);
+        }
+        return count ? sum / static_cast<double>(count) : 0.0;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <jpeg_dir> [resize_factor=2] [max_images=64] [repeats=3]\n";
+        return 1;
+    }
+    const std::filesystem::path dir = argv[1];
+    const int resize_factor = argc > 2 ? std::atoi(argv[2]) : 2;
+    const size_t max_images = argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 64;
+    const int repeats = argc > 4 ? std::max(std::atoi(argv[4]), 1) : 3;
+
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        auto ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (entry.is_regular_file() && (ext == ".jpg" || ext == ".jpeg")) {
+            paths.push_back(entry.path());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    if (paths.size() > max_images) {
+        paths.resize(max_images);
+    }
+    if (paths.empty()) {
+        std::cerr << "No JPEG files found in " << dir << "\n";
+        return 1;
+    }
+
+    std::vector<std::vector<unsigned char>> files;
+    double input_mb = 0.0;
+    for (const auto& path : paths) {
+        std::ifstream file(path, std::ios::binary);
+        files.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        input_mb += static_cast<double>(files.back().size()) / (1024.0 * 1024.0);
+    }
+
+    std::cout << std::format("{} JPEGs, {:.1f} MB compressed, resize factor {}, best of {}\n",
+                             files.size(), input_mb, resize_factor, repeats);
+
+    const auto report = [&](const char* name, const Result& result) {
+        std::cout << std::format("  {:<24} {:8.1f} ms {:8.1f} MB/s {:8.1f} Mpx/s {:7.1f} img/s\n",
+                                 name, result.seconds * 1e3, input_mb / result.seconds,
+                                 result.megapixels / result.seconds, files.size() / result.seconds);
+    };
+
+    const Result stb = run(decode_stb, files, resize_factor, repeats);
+    report("stb_image + area resize", stb);
+
+    if (!image_io::has_fast_jpeg()) {
+        std::cout << "  libjpeg backend not built (JPEG package not found)\n";
+        return 0;
+    }
+
+    try {
+        const Result idct = run(decode_scaled_idct, files, resize_factor, repeats);
+        report("libjpeg scaled IDCT", idct);
+        std::cout << std::format("  speedup {:.2f}x, mean abs difference {:.2f} / 255\n",
+                                 stb.seconds / idct.seconds, mean_abs_diff(files, resize_factor));
+    } catch (const std::exception& e) {
+        std::cerr << "libjpeg backend failed: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
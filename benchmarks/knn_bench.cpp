@@ -0,0 +1,100 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+// KNN throughput of the initial scale estimate: mean distance to the 3 nearest neighbours.
+//
+//   knn_bench [num_points...=100000 1000000 3000000 10000000] [--repeats=3]
+//
+// Points are drawn from a few hundred Gaussian blobs, which is closer to an SfM cloud than
+// a uniform cube. The tree build is timed once per size; queries run on a single thread
+// (a one-slot TBB arena) and on the full pool.
+
+#include "core/knn.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tbb/task_arena.h>
+#include <vector>
+
+namespace {
+
+    constexpr size_t NEIGHBORS = 3;
+    constexpr int BLOBS = 256;
+
+    std::vector<float> make_points(size_t n) {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> center(-10.0f, 10.0f);
+        std::normal_distribution<float> offset(0.0f, 0.3f);
+        std::vector<float> centers(BLOBS * 3);
+        for (auto& c : centers) {
+            c = center(rng);
+        }
+        std::vector<float> points(n * 3);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t blob = i % BLOBS;
+            for (size_t d = 0; d < 3; ++d) {
+                points[i * 3 + d] = centers[blob * 3 + d] + offset(rng);
+            }
+        }
+        return points;
+    }
+
+    double seconds(const std::function<void()>& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Best of `repeats` runs, in seconds
+    double best_of(int repeats, const std::function<void()>& fn) {
+        double best = 1e30;
+        for (int r = 0; r < repeats; ++r) {
+            best = std::min(best, seconds(fn));
+        }
+        return best;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    int repeats = 3;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.starts_with("--repeats=")) {
+            repeats = std::max(std::atoi(arg.c_str() + 10), 1);
+        } else {
+            sizes.push_back(static_cast<size_t>(std::atoll(arg.c_str())));
+        }
+    }
+    if (sizes.empty()) {
+        sizes = {100'000, 1'000'000, 3'000'000, 10'000'000};
+    }
+
+    std::cout << std::format("{:>12} {:>12} {:>14} {:>14} {:>10} {:>12}\n",
+                             "points", "build [ms]", "1 thread [ms]", "pool [ms]", "speedup", "Mquery/s");
+    for (const size_t n : sizes) {
+        const auto points = make_points(n);
+        std::unique_ptr<gs::KnnIndex> index;
+        const double build = seconds([&]() { index = std::make_unique<gs::KnnIndex>(points.data(), n); });
+
+        tbb::task_arena single(1);
+        const double serial = best_of(repeats, [&]() {
+            single.execute([&]() { index->mean_neighbor_distances(NEIGHBORS, 0.01f); });
+        });
+        const double parallel = best_of(repeats, [&]() { index->mean_neighbor_distances(NEIGHBORS, 0.01f); });
+
+        std::cout << std::format("{:>12} {:>12.1f} {:>14.1f} {:>14.1f} {:>9.2f}x {:>12.2f}\n",
+                                 n, build * 1e3, serial * 1e3, parallel * 1e3, serial / parallel,
+                                 static_cast<double>(n) / parallel * 1e-6);
+    }
+    return 0;
+}
@@ -4,14 +4,41 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
 namespace fast_gs::optimizer {
 
+    // T is the storage type of param and its gradient (float, __half or __nv_bfloat16), M the one of
+    // the moments (float or __nv_bfloat16). Reduced-precision values are written back with stochastic
+    // rounding seeded by step.
+    template <typename T, typename M>
     void adam_step(
-        float* param,
-        float* exp_avg,
-        float* exp_avg_sq,
-        const float* param_grad,
+        T* param,
+        M* exp_avg,
+        M* exp_avg_sq,
+        const T* param_grad,
         const int n_elements,
+        const int step,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1_rcp,
+        const float bias_correction2_sqrt_rcp);
+
+    template <typename T, typename M>
+    void adam_step_sparse(
+        T* param,
+        M* exp_avg,
+        M* exp_avg_sq,
+        const T* param_grad,
+        const int64_t* rows,
+        const int* last_step,
+        const int n_rows,
+        const int row_size,
+        const int step,
         const float lr,
         const float beta1,
         const float beta2,
@@ -8,11 +8,33 @@
 
 namespace fast_gs::optimizer {
 
+    // param and param_grad may be fp32, fp16 or bf16, the moments fp32 or bf16. Everything is updated
+    // in fp32 and reduced-precision values are stochastically rounded back; `step` seeds the rounding.
     void adam_step_wrapper(
         torch::Tensor& param,
         torch::Tensor& exp_avg,
         torch::Tensor& exp_avg_sq,
         const torch::Tensor& param_grad,
+        const int step,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1,
+        const float bias_correction2_sqrt);
+
+    // Adam step on the rows `rows` (unique int64 [K]) of [N, ...] tensors only. last_step (int32 [N])
+    // holds the step at which each row's moments were last current; rows that earlier sparse steps
+    // skipped first apply the moment decay of the steps they missed. The updated rows of last_step
+    // are set to `step`.
+    void adam_step_sparse_wrapper(
+        torch::Tensor& param,
+        torch::Tensor& exp_avg,
+        torch::Tensor& exp_avg_sq,
+        const torch::Tensor& param_grad,
+        const torch::Tensor& rows,
+        torch::Tensor& last_step,
+        const int step,
         const float lr,
         const float beta1,
         const float beta2,
@@ -0,0 +1,43 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+
+namespace fast_gs::optimizer {
+
+    // Multithreaded CPU counterpart of adam_step, same update as adam_step_cu
+    void adam_step_cpu(
+        float* param,
+        float* exp_avg,
+        float* exp_avg_sq,
+        const float* param_grad,
+        const int n_elements,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1_rcp,
+        const float bias_correction2_sqrt_rcp);
+
+    // CPU counterpart of adam_step_sparse, same update as adam_step_sparse_cu
+    void adam_step_sparse_cpu(
+        float* param,
+        float* exp_avg,
+        float* exp_avg_sq,
+        const float* param_grad,
+        const int64_t* rows,
+        const int* last_step,
+        const int n_rows,
+        const int row_size,
+        const int step,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1_rcp,
+        const float bias_correction2_sqrt_rcp);
+
+}
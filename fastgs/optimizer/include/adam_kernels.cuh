@@ -5,17 +5,76 @@
 #pragma once
 
 #include <cooperative_groups.h>
+#include <cstdint>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+#include <type_traits>
 namespace cg = cooperative_groups;
 
 namespace fast_gs::optimizer::kernels::adam {
 
+    // Parameters may be stored as fp32, fp16 or bf16 and moments as fp32 or bf16; the update
+    // itself always runs in fp32
+    __device__ inline float load(const float value) { return value; }
+    __device__ inline float load(const __half value) { return __half2float(value); }
+    __device__ inline float load(const __nv_bfloat16 value) { return __bfloat162float(value); }
+
+    template <typename T>
+    struct ReducedFormat;
+    template <>
+    struct ReducedFormat<__half> {
+        static constexpr int mantissa_bits = 10;
+        static constexpr int min_exponent = -14;
+        __device__ static __half from_exact(const float value) { return __float2half_rn(value); }
+    };
+    template <>
+    struct ReducedFormat<__nv_bfloat16> {
+        static constexpr int mantissa_bits = 7;
+        static constexpr int min_exponent = -126;
+        __device__ static __nv_bfloat16 from_exact(const float value) { return __float2bfloat16_rn(value); }
+    };
+
+    // Independent rounding streams for the values written by one step
+    enum class Stream : uint32_t { param = 0, exp_avg = 1, exp_avg_sq = 2 };
+
+    // Uniform in [0, 1) from a counter-based hash, so every (element, step, stream) draws independently.
+    // Also called on the host by the CPU step, which rounds with the same offsets.
+    __host__ __device__ inline float uniform(const uint64_t idx, const int step, const Stream stream) {
+        uint32_t h = static_cast<uint32_t>(idx) * 0x9E3779B9u ^ static_cast<uint32_t>(idx >> 32) ^
+                     static_cast<uint32_t>(step) * 0x85EBCA6Bu ^ static_cast<uint32_t>(stream) * 0xC2B2AE35u;
+        h ^= h >> 16;
+        h *= 0x7FEB352Du;
+        h ^= h >> 15;
+        h *= 0x846CA68Bu;
+        h ^= h >> 16;
+        return static_cast<float>(h >> 8) * 0x1.0p-24f;
+    }
+
+    // Stochastic rounding onto the grid of T: the rounded value equals `value` in expectation, so
+    // updates far below the storage precision still accumulate instead of being rounded away.
+    // For bf16 moments this also keeps the beta2 = 0.999 decay, which round-to-nearest would undo.
+    template <typename T>
+    __device__ inline T store(const float value, const uint64_t idx, const int step, const Stream stream) {
+        if constexpr (std::is_same_v<T, float>) {
+            return value;
+        } else {
+            using Format = ReducedFormat<T>;
+            const int exponent = max(ilogbf(value), Format::min_exponent);
+            const float ulp = ldexpf(1.0f, exponent - Format::mantissa_bits);
+            // value / ulp is exact, and the rounded multiple of ulp is representable in T
+            return Format::from_exact(floorf(value / ulp + uniform(idx, step, stream)) * ulp);
+        }
+    }
+
     // based on https://github.com/pytorch/pytorch/blob/9d32aa9789fc0ef0cad01a788157ecc2121db810/torch/csrc/api/src/optim/adam.cpp#L72-L142
+    template <typename T, typename M>
     __global__ void adam_step_cu(
-        float* param,
-        float* exp_avg,
-        float* exp_avg_sq,
-        const float* param_grad,
+        T* param,
+        M* exp_avg,
+        M* exp_avg_sq,
+        const T* param_grad,
         const int n_elements,
+        const int step,
         const float lr,
         const float beta1,
         const float beta2,
@@ -25,14 +84,50 @@ namespace fast_gs::optimizer::kernels::adam {
         auto idx = cg::this_grid().thread_rank();
         if (idx >= n_elements)
             return;
-        const float grad = param_grad[idx];
-        const float moment1 = beta1 * exp_avg[idx] + (1.0f - beta1) * grad;
-        const float moment2 = beta2 * exp_avg_sq[idx] + (1.0f - beta2) * grad * grad;
+        const float grad = load(param_grad[idx]);
+        const float moment1 = beta1 * load(exp_avg[idx]) + (1.0f - beta1) * grad;
+        const float moment2 = beta2 * load(exp_avg_sq[idx]) + (1.0f - beta2) * grad * grad;
+        const float denom = sqrtf(moment2) * bias_correction2_sqrt_rcp + eps;
+        const float step_size = lr * bias_correction1_rcp;
+        param[idx] = store<T>(load(param[idx]) - step_size * moment1 / denom, idx, step, Stream::param);
+        exp_avg[idx] = store<M>(moment1, idx, step, Stream::exp_avg);
+        exp_avg_sq[idx] = store<M>(moment2, idx, step, Stream::exp_avg_sq);
+    }
+
+    // adam_step_cu restricted to the given unique rows of a [n_rows_total, row_size] parameter.
+    // A row skipped by the previous sparse steps first decays its moments by the steps it missed.
+    template <typename T, typename M>
+    __global__ void adam_step_sparse_cu(
+        T* param,
+        M* exp_avg,
+        M* exp_avg_sq,
+        const T* param_grad,
+        const int64_t* rows,
+        const int* last_step,
+        const int n_rows,
+        const int row_size,
+        const int step,
+        const float lr,
+        const float beta1,
+        const float beta2,
+        const float eps,
+        const float bias_correction1_rcp,
+        const float bias_correction2_sqrt_rcp) {
+        auto thread_idx = cg::this_grid().thread_rank();
+        if (thread_idx >= static_cast<unsigned long long>(n_rows) * row_size)
+            return;
+        const int64_t row = rows[thread_idx / row_size];
+        const int64_t idx = row * row_size + thread_idx % row_size;
+        // Steps since the row's moments were last current: 1 unless earlier steps skipped it
+        const float elapsed = static_cast<float>(step - last_step[row]);
+        const float grad = load(param_grad[idx]);
+        const float moment1 = powf(beta1, elapsed) * load(exp_avg[idx]) + (1.0f - beta1) * grad;
+        const float moment2 = powf(beta2, elapsed) * load(exp_avg_sq[idx]) + (1.0f - beta2) * grad * grad;
         const float denom = sqrtf(moment2) * bias_correction2_sqrt_rcp + eps;
         const float step_size = lr * bias_correction1_rcp;
-        param[idx] -= step_size * moment1 / denom;
-        exp_avg[idx] = moment1;
-        exp_avg_sq[idx] = moment2;
+        param[idx] = store<T>(load(param[idx]) - step_size * moment1 / denom, idx, step, Stream::param);
+        exp_avg[idx] = store<M>(moment1, idx, step, Stream::exp_avg);
+        exp_avg_sq[idx] = store<M>(moment2, idx, step, Stream::exp_avg_sq);
     }
 
 } // namespace fast_gs::optimizer::kernels::adam
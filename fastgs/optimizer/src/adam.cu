@@ -7,24 +7,27 @@
 #include "optimizer_config.h"
 #include "utils.h"
 
+template <typename T, typename M>
 void fast_gs::optimizer::adam_step(
-    float* param,
-    float* exp_avg,
-    float* exp_avg_sq,
-    const float* param_grad,
+    T* param,
+    M* exp_avg,
+    M* exp_avg_sq,
+    const T* param_grad,
     const int n_elements,
+    const int step,
     const float lr,
     const float beta1,
     const float beta2,
     const float eps,
     const float bias_correction1_rcp,
     const float bias_correction2_sqrt_rcp) {
-    kernels::adam::adam_step_cu<<<div_round_up(n_elements, config::block_size_adam_step), config::block_size_adam_step>>>(
+    kernels::adam::adam_step_cu<T, M><<<div_round_up(n_elements, config::block_size_adam_step), config::block_size_adam_step>>>(
         param,
         exp_avg,
         exp_avg_sq,
         param_grad,
         n_elements,
+        step,
         lr,
         beta1,
         beta2,
@@ -33,3 +36,59 @@ void fast_gs::optimizer::adam_step(
         bias_correction2_sqrt_rcp);
     CHECK_CUDA(config::debug, "adam step")
 }
+
+template <typename T, typename M>
+void fast_gs::optimizer::adam_step_sparse(
+    T* param,
+    M* exp_avg,
+    M* exp_avg_sq,
+    const T* param_grad,
+    const int64_t* rows,
+    const int* last_step,
+    const int n_rows,
+    const int row_size,
+    const int step,
+    const float lr,
+    const float beta1,
+    const float beta2,
+    const float eps,
+    const float bias_correction1_rcp,
+    const float bias_correction2_sqrt_rcp) {
+    const int n_elements = n_rows * row_size;
+    if (n_elements == 0)
+        return;
+    kernels::adam::adam_step_sparse_cu<T, M><<<div_round_up(n_elements, config::block_size_adam_step), config::block_size_adam_step>>>(
+        param,
+        exp_avg,
+        exp_avg_sq,
+        param_grad,
+        rows,
+        last_step,
+        n_rows,
+        row_size,
+        step,
+        lr,
+        beta1,
+        beta2,
+        eps,
+        bias_correction1_rcp,
+        bias_correction2_sqrt_rcp);
+    CHECK_CUDA(config::debug, "adam step sparse")
+}
+
+#define INSTANTIATE_ADAM(T, M)                                                                            \
+    template void fast_gs::optimizer::adam_step<T, M>(                                                    \
+        T*, M*, M*, const T*, const int, const int, const float, const float, const float,                \
+        const float, const float, const float);                                                           \
+    template void fast_gs::optimizer::adam_step_sparse<T, M>(                                             \
+        T*, M*, M*, const T*, const int64_t*, const int*, const int, const int, const int,                \
+        const float, const float, const float, const float, const float, const float);
+
+INSTANTIATE_ADAM(float, float)
+INSTANTIATE_ADAM(__half, float)
+INSTANTIATE_ADAM(__nv_bfloat16, float)
+INSTANTIATE_ADAM(float, __nv_bfloat16)
+INSTANTIATE_ADAM(__half, __nv_bfloat16)
+INSTANTIATE_ADAM(__nv_bfloat16, __nv_bfloat16)
+
+#undef INSTANTIATE_ADAM
@@ -4,12 +4,90 @@
 
 #include "adam.h"
 #include "adam_api.h"
+#include "adam_cpu.h"
+#include "adam_kernels.cuh"
+#include <algorithm>
+#include <c10/cuda/CUDAGuard.h>
+#include <cmath>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace {
+    // Calls f with null pointers of the storage types of param and of the moments; CUDA steps are
+    // instantiated for each combination
+    template <typename F>
+    void dispatch_types(const torch::Tensor& param, const torch::Tensor& exp_avg, F&& f) {
+        const auto with_param = [&]<typename M>(M* moment) {
+            switch (param.scalar_type()) {
+            case torch::kFloat: return f(static_cast<float*>(nullptr), moment);
+            case torch::kHalf: return f(static_cast<__half*>(nullptr), moment);
+            case torch::kBFloat16: return f(static_cast<__nv_bfloat16*>(nullptr), moment);
+            default: throw std::runtime_error("Adam parameters must be float, half or bfloat16.");
+            }
+        };
+        switch (exp_avg.scalar_type()) {
+        case torch::kFloat: return with_param(static_cast<float*>(nullptr));
+        case torch::kBFloat16: return with_param(static_cast<__nv_bfloat16*>(nullptr));
+        default: throw std::runtime_error("Adam moments must be float or bfloat16.");
+        }
+    }
+
+    using kernels::adam::Stream;
+
+    // Host counterpart of kernels::adam::store: unbiased rounding of fp32 values onto the grid of a
+    // reduced-precision dtype. The offsets come from the kernel's (index, step, stream) hash, so a CPU
+    // step rounds like a CUDA step and leaves the global generator alone. Element i of `value` is
+    // element i of the stored tensor, or of row rows[i / row_size] when `rows` is defined.
+    torch::Tensor stochastic_round_cpu(const torch::Tensor& value, const torch::ScalarType dtype, const int step,
+                                       const Stream stream, const torch::Tensor& rows = {}) {
+        const int mantissa_bits = dtype == torch::kHalf ? 10 : 7;
+        const int min_exponent = dtype == torch::kHalf ? -14 : -126;
+        const auto input = value.contiguous();
+        auto rounded = torch::empty_like(input);
+        const float* src = input.data_ptr<float>();
+        float* dst = rounded.data_ptr<float>();
+        const int64_t n = input.numel();
+        const auto row_indices = rows.defined() ? rows.contiguous() : torch::Tensor();
+        const int64_t* row_index = row_indices.defined() ? row_indices.data_ptr<int64_t>() : nullptr;
+        const int64_t row_size = row_index && row_indices.numel() > 0 ? n / row_indices.numel() : 1;
+        tbb::parallel_for(tbb::blocked_range<int64_t>(0, n, 1 << 14), [&](const tbb::blocked_range<int64_t>& range) {
+            for (int64_t i = range.begin(); i < range.end(); ++i) {
+                const uint64_t idx = row_index ? row_index[i / row_size] * row_size + i % row_size : i;
+                const int exponent = std::max(std::ilogb(src[i]), min_exponent);
+                const float ulp = std::ldexp(1.0f, exponent - mantissa_bits);
+                dst[i] = std::floor(src[i] / ulp + kernels::adam::uniform(idx, step, stream)) * ulp;
+            }
+        });
+        return rounded.to(dtype);
+    }
+
+    // The CPU step runs on fp32 tensors: reduced-precision inputs get a working copy that
+    // store_back() rounds into the original
+    torch::Tensor working_copy(const torch::Tensor& tensor) {
+        return tensor.scalar_type() == torch::kFloat ? tensor : tensor.to(torch::kFloat);
+    }
+
+    void store_back(torch::Tensor& tensor, const torch::Tensor& fp32, const int step, const Stream stream) {
+        if (tensor.scalar_type() != torch::kFloat) {
+            tensor.copy_(stochastic_round_cpu(fp32, tensor.scalar_type(), step, stream));
+        }
+    }
+
+    // Writes the fp32 copies of `rows` back into `tensor`
+    void store_rows(torch::Tensor& tensor, const torch::Tensor& rows, const torch::Tensor& fp32, const int step,
+                    const Stream stream) {
+        tensor.index_copy_(0, rows, tensor.scalar_type() == torch::kFloat
+                                        ? fp32
+                                        : stochastic_round_cpu(fp32, tensor.scalar_type(), step, stream, rows));
+    }
+} // namespace
 
 void fast_gs::optimizer::adam_step_wrapper(
     torch::Tensor& param,
     torch::Tensor& exp_avg,
     torch::Tensor& exp_avg_sq,
     const torch::Tensor& param_grad,
+    const int step,
     const float lr,
     const float beta1,
     const float beta2,
@@ -18,16 +96,138 @@ void fast_gs::optimizer::adam_step_wrapper(
     const float bias_correction2_sqrt_rcp) {
     const int n_elements = param.numel();
 
-    adam_step(
-        param.data_ptr<float>(),
-        exp_avg.data_ptr<float>(),
-        exp_avg_sq.data_ptr<float>(),
-        param_grad.data_ptr<float>(),
-        n_elements,
-        lr,
-        beta1,
-        beta2,
-        eps,
-        bias_correction1_rcp,
-        bias_correction2_sqrt_rcp);
+    TORCH_CHECK(exp_avg.scalar_type() == exp_avg_sq.scalar_type(), "Adam moments must share one dtype");
+
+    if (param.is_cpu()) {
+        auto param_fp32 = working_copy(param);
+        auto exp_avg_fp32 = working_copy(exp_avg);
+        auto exp_avg_sq_fp32 = working_copy(exp_avg_sq);
+        const auto grad_fp32 = working_copy(param_grad);
+        adam_step_cpu(
+            param_fp32.data_ptr<float>(),
+            exp_avg_fp32.data_ptr<float>(),
+            exp_avg_sq_fp32.data_ptr<float>(),
+            grad_fp32.data_ptr<float>(),
+            n_elements,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp);
+        store_back(param, param_fp32, step, Stream::param);
+        store_back(exp_avg, exp_avg_fp32, step, Stream::exp_avg);
+        store_back(exp_avg_sq, exp_avg_sq_fp32, step, Stream::exp_avg_sq);
+        return;
+    }
+
+    // Launch on the device of the parameter, which need not be the current one
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(param));
+    dispatch_types(param, exp_avg, [&]<typename T, typename M>(T*, M*) {
+        adam_step<T, M>(
+            reinterpret_cast<T*>(param.data_ptr()),
+            reinterpret_cast<M*>(exp_avg.data_ptr()),
+            reinterpret_cast<M*>(exp_avg_sq.data_ptr()),
+            reinterpret_cast<const T*>(param_grad.data_ptr()),
+            n_elements,
+            step,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp);
+    });
+}
+
+void fast_gs::optimizer::adam_step_sparse_wrapper(
+    torch::Tensor& param,
+    torch::Tensor& exp_avg,
+    torch::Tensor& exp_avg_sq,
+    const torch::Tensor& param_grad,
+    const torch::Tensor& rows,
+    torch::Tensor& last_step,
+    const int step,
+    const float lr,
+    const float beta1,
+    const float beta2,
+    const float eps,
+    const float bias_correction1_rcp,
+    const float bias_correction2_sqrt_rcp) {
+    const int n_rows = rows.numel();
+    const int row_size = param.size(0) > 0 ? static_cast<int>(param.numel() / param.size(0)) : 0;
+
+    TORCH_CHECK(exp_avg.scalar_type() == exp_avg_sq.scalar_type(), "Adam moments must share one dtype");
+    if (n_rows == 0 || row_size == 0) {
+        return; // No rows to update, or a parameter without elements
+    }
+
+    if (param.is_cpu() && param.scalar_type() == torch::kFloat && exp_avg.scalar_type() == torch::kFloat) {
+        adam_step_sparse_cpu(
+            param.data_ptr<float>(),
+            exp_avg.data_ptr<float>(),
+            exp_avg_sq.data_ptr<float>(),
+            param_grad.data_ptr<float>(),
+            rows.data_ptr<int64_t>(),
+            last_step.data_ptr<int>(),
+            n_rows,
+            row_size,
+            step,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp);
+    } else if (param.is_cpu()) {
+        // Only the touched rows are widened to fp32, updated in a compact copy and rounded back
+        auto param_rows = param.index_select(0, rows).to(torch::kFloat);
+        auto exp_avg_rows = exp_avg.index_select(0, rows).to(torch::kFloat);
+        auto exp_avg_sq_rows = exp_avg_sq.index_select(0, rows).to(torch::kFloat);
+        const auto grad_rows = param_grad.index_select(0, rows).to(torch::kFloat);
+        const auto last_step_rows = last_step.index_select(0, rows);
+        const auto compact_rows = torch::arange(n_rows, rows.options());
+        adam_step_sparse_cpu(
+            param_rows.data_ptr<float>(),
+            exp_avg_rows.data_ptr<float>(),
+            exp_avg_sq_rows.data_ptr<float>(),
+            grad_rows.data_ptr<float>(),
+            compact_rows.data_ptr<int64_t>(),
+            last_step_rows.data_ptr<int>(),
+            n_rows,
+            row_size,
+            step,
+            lr,
+            beta1,
+            beta2,
+            eps,
+            bias_correction1_rcp,
+            bias_correction2_sqrt_rcp);
+        store_rows(param, rows, param_rows, step, Stream::param);
+        store_rows(exp_avg, rows, exp_avg_rows, step, Stream::exp_avg);
+        store_rows(exp_avg_sq, rows, exp_avg_sq_rows, step, Stream::exp_avg_sq);
+    } else {
+        const at::cuda::OptionalCUDAGuard device_guard(device_of(param));
+        dispatch_types(param, exp_avg, [&]<typename T, typename M>(T*, M*) {
+            adam_step_sparse<T, M>(
+                reinterpret_cast<T*>(param.data_ptr()),
+                reinterpret_cast<M*>(exp_avg.data_ptr()),
+                reinterpret_cast<M*>(exp_avg_sq.data_ptr()),
+                reinterpret_cast<const T*>(param_grad.data_ptr()),
+                rows.data_ptr<int64_t>(),
+                last_step.data_ptr<int>(),
+                n_rows,
+                row_size,
+                step,
+                lr,
+                beta1,
+                beta2,
+                eps,
+                bias_correction1_rcp,
+                bias_correction2_sqrt_rcp);
+        });
+    }
+
+    // Ordered after the kernel, which reads the old values
+    last_step.index_fill_(0, rows, step);
 }
@@ -0,0 +1,158 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "adam_cpu.h"
+#include <algorithm>
+#include <cmath>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+// SIMD includes (with fallback)
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+    // Elements per parallel task: a multiple of every vector width, large enough to amortize scheduling
+    constexpr int ELEMENTS_PER_TASK = 1 << 14;
+
+    struct AdamConstants {
+        float beta1, one_minus_beta1;
+        float beta2, one_minus_beta2;
+        float step_size, bias_correction2_sqrt_rcp, eps;
+    };
+
+    // One pass over [begin, end): every array is loaded and stored exactly once
+    void adam_range(float* __restrict param,
+                    float* __restrict exp_avg,
+                    float* __restrict exp_avg_sq,
+                    const float* __restrict param_grad,
+                    int begin,
+                    int end,
+                    const AdamConstants& c) {
+        int idx = begin;
+#if defined(__AVX512F__)
+        const __m512 beta1 = _mm512_set1_ps(c.beta1);
+        const __m512 one_minus_beta1 = _mm512_set1_ps(c.one_minus_beta1);
+        const __m512 beta2 = _mm512_set1_ps(c.beta2);
+        const __m512 one_minus_beta2 = _mm512_set1_ps(c.one_minus_beta2);
+        const __m512 step_size = _mm512_set1_ps(c.step_size);
+        const __m512 bc2 = _mm512_set1_ps(c.bias_correction2_sqrt_rcp);
+        const __m512 eps = _mm512_set1_ps(c.eps);
+        for (; idx + 16 <= end; idx += 16) {
+            const __m512 grad = _mm512_loadu_ps(param_grad + idx);
+            const __m512 m = _mm512_fmadd_ps(beta1, _mm512_loadu_ps(exp_avg + idx), _mm512_mul_ps(one_minus_beta1, grad));
+            const __m512 v = _mm512_fmadd_ps(beta2, _mm512_loadu_ps(exp_avg_sq + idx),
+                                             _mm512_mul_ps(one_minus_beta2, _mm512_mul_ps(grad, grad)));
+            const __m512 denom = _mm512_fmadd_ps(_mm512_sqrt_ps(v), bc2, eps);
+            const __m512 update = _mm512_div_ps(_mm512_mul_ps(step_size, m), denom);
+            _mm512_storeu_ps(param + idx, _mm512_sub_ps(_mm512_loadu_ps(param + idx), update));
+            _mm512_storeu_ps(exp_avg + idx, m);
+            _mm512_storeu_ps(exp_avg_sq + idx, v);
+        }
+#elif defined(__AVX2__)
+        const __m256 beta1 = _mm256_set1_ps(c.beta1);
+        const __m256 one_minus_beta1 = _mm256_set1_ps(c.one_minus_beta1);
+        const __m256 beta2 = _mm256_set1_ps(c.beta2);
+        const __m256 one_minus_beta2 = _mm256_set1_ps(c.one_minus_beta2);
+        const __m256 step_size = _mm256_set1_ps(c.step_size);
+        const __m256 bc2 = _mm256_set1_ps(c.bias_correction2_sqrt_rcp);
+        const __m256 eps = _mm256_set1_ps(c.eps);
+        for (; idx + 8 <= end; idx += 8) {
+            const __m256 grad = _mm256_loadu_ps(param_grad + idx);
+            const __m256 m = _mm256_fmadd_ps(beta1, _mm256_loadu_ps(exp_avg + idx), _mm256_mul_ps(one_minus_beta1, grad));
+            const __m256 v = _mm256_fmadd_ps(beta2, _mm256_loadu_ps(exp_avg_sq + idx),
+                                             _mm256_mul_ps(one_minus_beta2, _mm256_mul_ps(grad, grad)));
+            const __m256 denom = _mm256_fmadd_ps(_mm256_sqrt_ps(v), bc2, eps);
+            const __m256 update = _mm256_div_ps(_mm256_mul_ps(step_size, m), denom);
+            _mm256_storeu_ps(param + idx, _mm256_sub_ps(_mm256_loadu_ps(param + idx), update));
+            _mm256_storeu_ps(exp_avg + idx, m);
+            _mm256_storeu_ps(exp_avg_sq + idx, v);
+        }
+#endif
+        for (; idx < end; ++idx) {
+            const float grad = param_grad[idx];
+            const float moment1 = c.beta1 * exp_avg[idx] + c.one_minus_beta1 * grad;
+            const float moment2 = c.beta2 * exp_avg_sq[idx] + c.one_minus_beta2 * grad * grad;
+            const float denom = std::sqrt(moment2) * c.bias_correction2_sqrt_rcp + c.eps;
+            param[idx] -= c.step_size * moment1 / denom;
+            exp_avg[idx] = moment1;
+            exp_avg_sq[idx] = moment2;
+        }
+    }
+} // namespace
+
+void fast_gs::optimizer::adam_step_cpu(
+    float* param,
+    float* exp_avg,
+    float* exp_avg_sq,
+    const float* param_grad,
+    const int n_elements,
+    const float lr,
+    const float beta1,
+    const float beta2,
+    const float eps,
+    const float bias_correction1_rcp,
+    const float bias_correction2_sqrt_rcp) {
+    const AdamConstants constants{beta1, 1.0f - beta1,
+                                  beta2, 1.0f - beta2,
+                                  lr * bias_correction1_rcp, bias_correction2_sqrt_rcp, eps};
+    if (n_elements <= ELEMENTS_PER_TASK) {
+        adam_range(param, exp_avg, exp_avg_sq, param_grad, 0, n_elements, constants);
+        return;
+    }
+    // Fixed chunks of the flat [N, ...] parameter keep every task boundary on a vector multiple,
+    // so only the very last chunk runs the scalar tail
+    const int n_tasks = (n_elements + ELEMENTS_PER_TASK - 1) / ELEMENTS_PER_TASK;
+    tbb::parallel_for(tbb::blocked_range<int>(0, n_tasks), [&](const tbb::blocked_range<int>& tasks) {
+        for (int task = tasks.begin(); task < tasks.end(); ++task) {
+            const int begin = task * ELEMENTS_PER_TASK;
+            const int end = std::min(begin + ELEMENTS_PER_TASK, n_elements);
+            adam_range(param, exp_avg, exp_avg_sq, param_grad, begin, end, constants);
+        }
+    });
+}
+
+void fast_gs::optimizer::adam_step_sparse_cpu(
+    float* param,
+    float* exp_avg,
+    float* exp_avg_sq,
+    const float* param_grad,
+    const int64_t* rows,
+    const int* last_step,
+    const int n_rows,
+    const int row_size,
+    const int step,
+    const float lr,
+    const float beta1,
+    const float beta2,
+    const float eps,
+    const float bias_correction1_rcp,
+    const float bias_correction2_sqrt_rcp) {
+    if (n_rows == 0 || row_size == 0) {
+        return;
+    }
+    const AdamConstants constants{beta1, 1.0f - beta1,
+                                  beta2, 1.0f - beta2,
+                                  lr * bias_correction1_rcp, bias_correction2_sqrt_rcp, eps};
+    const int rows_per_task = std::max(ELEMENTS_PER_TASK / row_size, 1);
+    tbb::parallel_for(tbb::blocked_range<int>(0, n_rows, rows_per_task), [&](const tbb::blocked_range<int>& range) {
+        for (int r = range.begin(); r < range.end(); ++r) {
+            const int64_t row = rows[r];
+            const int begin = static_cast<int>(row * row_size);
+            const int end = begin + row_size;
+            // Catch up on the decay of the steps that skipped this row, then take the regular step
+            const int skipped = step - 1 - last_step[row];
+            if (skipped > 0) {
+                const float decay1 = std::pow(beta1, static_cast<float>(skipped));
+                const float decay2 = std::pow(beta2, static_cast<float>(skipped));
+                for (int idx = begin; idx < end; ++idx) {
+                    exp_avg[idx] *= decay1;
+                    exp_avg_sq[idx] *= decay2;
+                }
+            }
+            adam_range(param, exp_avg, exp_avg_sq, param_grad, begin, end, constants);
+        }
+    });
+}
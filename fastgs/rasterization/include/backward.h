@@ -9,6 +9,8 @@
 
 namespace fast_gs::rasterization {
 
+    // SHRestT: storage type of the higher-degree SH coefficients and their gradient, as in forward()
+    template <typename SHRestT>
     void backward(
         const float* grad_image,
         const float* grad_alpha,
@@ -17,7 +19,7 @@ namespace fast_gs::rasterization {
         const float3* means,
         const float3* scales_raw,
         const float4* rotations_raw,
-        const float3* sh_coefficients_rest,
+        const SHRestT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         char* per_primitive_buffers_blob,
@@ -29,7 +31,7 @@ namespace fast_gs::rasterization {
         float4* grad_rotations_raw,
         float* grad_opacities_raw,
         float3* grad_sh_coefficients_0,
-        float3* grad_sh_coefficients_rest,
+        SHRestT* grad_sh_coefficients_rest,
         float2* grad_mean2d_helper,
         float* grad_conic_helper,
         float4* grad_w2c,
@@ -47,6 +49,7 @@ namespace fast_gs::rasterization {
         const float fx,
         const float fy,
         const float cx,
-        const float cy);
+        const float cy,
+        cudaStream_t stream);
 
 }
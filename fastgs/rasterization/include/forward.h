@@ -10,6 +10,8 @@
 
 namespace fast_gs::rasterization {
 
+    // SHRestT: storage type of the higher-degree SH coefficients (float, __half or __nv_bfloat16)
+    template <typename SHRestT>
     std::tuple<int, int, int, int, int> forward(
         std::function<char*(size_t)> per_primitive_buffers_func,
         std::function<char*(size_t)> per_tile_buffers_func,
@@ -20,7 +22,7 @@ namespace fast_gs::rasterization {
         const float4* rotations_raw,
         const float* opacities_raw,
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const SHRestT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         float* image,
@@ -35,6 +37,7 @@ namespace fast_gs::rasterization {
         const float cx,
         const float cy,
         const float near,
-        const float far);
+        const float far,
+        cudaStream_t stream);
 
 }
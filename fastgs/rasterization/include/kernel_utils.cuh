@@ -8,13 +8,53 @@
 #include "rasterization_config.h"
 #include "utils.h"
 #include <cooperative_groups.h>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
 namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels {
 
+    __device__ inline float to_float(const float v) { return v; }
+    __device__ inline float to_float(const __half v) { return __half2float(v); }
+    __device__ inline float to_float(const __nv_bfloat16 v) { return __bfloat162float(v); }
+
+    template <typename T>
+    __device__ inline T from_float(float v);
+    template <>
+    __device__ inline float from_float<float>(const float v) { return v; }
+    template <>
+    __device__ inline __half from_float<__half>(const float v) { return __float2half_rn(v); }
+    template <>
+    __device__ inline __nv_bfloat16 from_float<__nv_bfloat16>(const float v) { return __float2bfloat16_rn(v); }
+
+    // Higher-degree SH coefficients of one primitive, three scalars of type T (float, __half or
+    // __nv_bfloat16) per basis. Indexing yields float3, so the SH math is always done in float.
+    template <typename T>
+    struct SHCoefficients {
+        const T* ptr;
+        __device__ float3 operator[](const int basis) const {
+            return make_float3(to_float(ptr[3 * basis]), to_float(ptr[3 * basis + 1]), to_float(ptr[3 * basis + 2]));
+        }
+    };
+
+    template <typename T>
+    struct SHGradients {
+        struct Ref {
+            T* ptr;
+            __device__ void operator=(const float3& v) const {
+                ptr[0] = from_float<T>(v.x);
+                ptr[1] = from_float<T>(v.y);
+                ptr[2] = from_float<T>(v.z);
+            }
+        };
+        T* ptr;
+        __device__ Ref operator[](const int basis) const { return {ptr + 3 * basis}; }
+    };
+
+    template <typename T>
     __device__ inline float3 convert_sh_to_color(
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const T* sh_coefficients_rest,
         const float3& position,
         const float3& cam_position,
         const uint primitive_idx,
@@ -23,7 +63,7 @@ namespace fast_gs::rasterization::kernels {
         // computation adapted from https://github.com/NVlabs/tiny-cuda-nn/blob/212104156403bd87616c1a4f73a1c5f2c2e172a9/include/tiny-cuda-nn/common_device.h#L340
         float3 result = 0.5f + 0.28209479177387814f * sh_coefficients_0[primitive_idx];
         if (active_sh_bases > 1) {
-            const float3* coefficients_ptr = sh_coefficients_rest + primitive_idx * total_bases_sh_rest;
+            const SHCoefficients<T> coefficients_ptr{sh_coefficients_rest + 3 * primitive_idx * total_bases_sh_rest};
             auto [x, y, z] = normalize(position - cam_position);
             result = result + (-0.48860251190291987f * y) * coefficients_ptr[0] + (0.48860251190291987f * z) * coefficients_ptr[1] + (-0.48860251190291987f * x) * coefficients_ptr[2];
             if (active_sh_bases > 4) {
@@ -38,10 +78,11 @@ namespace fast_gs::rasterization::kernels {
         return result;
     }
 
+    template <typename T>
     __device__ inline float3 convert_sh_to_color_backward(
-        const float3* sh_coefficients_rest,
+        const T* sh_coefficients_rest,
         float3* grad_sh_coefficients_0,
-        float3* grad_sh_coefficients_rest,
+        T* grad_sh_coefficients_rest,
         const float3& position,
         const float3& cam_position,
         const uint primitive_idx,
@@ -49,8 +90,8 @@ namespace fast_gs::rasterization::kernels {
         const uint total_bases_sh_rest) {
         // computation adapted from https://github.com/NVlabs/tiny-cuda-nn/blob/212104156403bd87616c1a4f73a1c5f2c2e172a9/include/tiny-cuda-nn/common_device.h#L340
         const int coefficients_base_idx = primitive_idx * total_bases_sh_rest;
-        const float3* coefficients_ptr = sh_coefficients_rest + coefficients_base_idx;
-        float3* grad_coefficients_ptr = grad_sh_coefficients_rest + coefficients_base_idx;
+        const SHCoefficients<T> coefficients_ptr{sh_coefficients_rest + 3 * coefficients_base_idx};
+        const SHGradients<T> grad_coefficients_ptr{grad_sh_coefficients_rest + 3 * coefficients_base_idx};
         const float3 grad_color = grad_sh_coefficients_0[primitive_idx];
         grad_sh_coefficients_0[primitive_idx] = 0.28209479177387814f * grad_color;
         float3 dcolor_dposition = make_float3(0.0f);
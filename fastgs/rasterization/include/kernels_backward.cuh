@@ -15,11 +15,12 @@ namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels::backward {
 
+    template <typename SHRestT>
     __global__ void preprocess_backward_cu(
         const float3* means,
         const float3* raw_scales,
         const float4* raw_rotations,
-        const float3* sh_coefficients_rest,
+        const SHRestT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         const uint* primitive_n_touched_tiles,
@@ -29,7 +30,7 @@ namespace fast_gs::rasterization::kernels::backward {
         float3* grad_raw_scales,
         float4* grad_raw_rotations,
         float3* grad_sh_coefficients_0,
-        float3* grad_sh_coefficients_rest,
+        SHRestT* grad_sh_coefficients_rest,
         float4* grad_w2c,
         float* densification_info,
         const uint n_primitives,
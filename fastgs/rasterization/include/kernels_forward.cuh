@@ -15,13 +15,14 @@ namespace cg = cooperative_groups;
 
 namespace fast_gs::rasterization::kernels::forward {
 
+    template <typename SHRestT>
     __global__ void preprocess_cu(
         const float3* means,
         const float3* raw_scales,
         const float4* raw_rotations,
         const float* raw_opacities,
         const float3* sh_coefficients_0,
-        const float3* sh_coefficients_rest,
+        const SHRestT* sh_coefficients_rest,
         const float4* w2c,
         const float3* cam_position,
         uint* primitive_depth_keys,
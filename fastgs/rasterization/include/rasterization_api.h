@@ -74,4 +74,13 @@ namespace fast_gs::rasterization {
         const int primitive_primitive_indices_selector,
         const int instance_primitive_indices_selector);
 
+    // Indices of the primitives that survived culling in a forward pass, read from its
+    // per-primitive buffers. Returns an int64 tensor [n_visible_primitives] on the device
+    // of the buffers, in no particular order.
+    torch::Tensor visible_primitive_indices(
+        const torch::Tensor& per_primitive_buffers,
+        const int n_primitives,
+        const int n_visible_primitives,
+        const int primitive_primitive_indices_selector);
+
 } // namespace fast_gs::rasterization
@@ -0,0 +1,70 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <torch/torch.h>
+#include <tuple>
+
+namespace fast_gs::rasterization {
+
+    // Multithreaded CPU reference implementation of forward_wrapper/backward_wrapper.
+    // It follows the CUDA pipeline step by step (same culling, 16x16 tiles, depth then
+    // tile ordering, bucketed blend checkpoints and front-to-back backward), so it can
+    // serve as an oracle for the kernels. The wrappers dispatch here for CPU tensors.
+    // The buffer tensors it returns are only meaningful to backward_wrapper_cpu.
+
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int>
+    forward_wrapper_cpu(
+        const torch::Tensor& means,
+        const torch::Tensor& scales_raw,
+        const torch::Tensor& rotations_raw,
+        const torch::Tensor& opacities_raw,
+        const torch::Tensor& sh_coefficients_0,
+        const torch::Tensor& sh_coefficients_rest,
+        const torch::Tensor& w2c,
+        const torch::Tensor& cam_position,
+        const int active_sh_bases,
+        const int width,
+        const int height,
+        const float focal_x,
+        const float focal_y,
+        const float center_x,
+        const float center_y,
+        const float near_plane,
+        const float far_plane);
+
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+    backward_wrapper_cpu(
+        torch::Tensor& densification_info,
+        const torch::Tensor& grad_image,
+        const torch::Tensor& grad_alpha,
+        const torch::Tensor& image,
+        const torch::Tensor& alpha,
+        const torch::Tensor& means,
+        const torch::Tensor& scales_raw,
+        const torch::Tensor& rotations_raw,
+        const torch::Tensor& sh_coefficients_rest,
+        const torch::Tensor& per_primitive_buffers,
+        const torch::Tensor& per_tile_buffers,
+        const torch::Tensor& per_instance_buffers,
+        const torch::Tensor& per_bucket_buffers,
+        const torch::Tensor& w2c,
+        const torch::Tensor& cam_position,
+        const int active_sh_bases,
+        const int width,
+        const int height,
+        const float focal_x,
+        const float focal_y,
+        const float center_x,
+        const float center_y,
+        const int n_visible_primitives,
+        const int n_instances,
+        const int n_buckets);
+
+    torch::Tensor visible_primitive_indices_cpu(
+        const torch::Tensor& per_primitive_buffers,
+        const int n_primitives);
+
+} // namespace fast_gs::rasterization
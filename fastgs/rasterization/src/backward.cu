@@ -11,6 +11,7 @@
 #include <cub/cub.cuh>
 #include <functional>
 
+template <typename SHRestT>
 void fast_gs::rasterization::backward(
     const float* grad_image,
     const float* grad_alpha,
@@ -19,7 +20,7 @@ void fast_gs::rasterization::backward(
     const float3* means,
     const float3* scales_raw,
     const float4* rotations_raw,
-    const float3* sh_coefficients_rest,
+    const SHRestT* sh_coefficients_rest,
     const float4* w2c,
     const float3* cam_position,
     char* per_primitive_buffers_blob,
@@ -31,7 +32,7 @@ void fast_gs::rasterization::backward(
     float4* grad_rotations_raw,
     float* grad_opacities_raw,
     float3* grad_sh_coefficients_0,
-    float3* grad_sh_coefficients_rest,
+    SHRestT* grad_sh_coefficients_rest,
     float2* grad_mean2d_helper,
     float* grad_conic_helper,
     float4* grad_w2c,
@@ -49,7 +50,8 @@ void fast_gs::rasterization::backward(
     const float fx,
     const float fy,
     const float cx,
-    const float cy) {
+    const float cy,
+    cudaStream_t stream) {
     const dim3 grid(div_round_up(width, config::tile_width), div_round_up(height, config::tile_height), 1);
     const int n_tiles = grid.x * grid.y;
 
@@ -60,7 +62,7 @@ void fast_gs::rasterization::backward(
     per_primitive_buffers.primitive_indices.selector = primitive_primitive_indices_selector;
     per_instance_buffers.primitive_indices.selector = instance_primitive_indices_selector;
 
-    kernels::backward::blend_backward_cu<<<n_buckets, 32>>>(
+    kernels::backward::blend_backward_cu<<<n_buckets, 32, 0, stream>>>(
         per_tile_buffers.instance_ranges,
         per_tile_buffers.bucket_offsets,
         per_instance_buffers.primitive_indices.Current(),
@@ -86,7 +88,7 @@ void fast_gs::rasterization::backward(
         grid.x);
     CHECK_CUDA(config::debug, "blend_backward")
 
-    kernels::backward::preprocess_backward_cu<<<div_round_up(n_primitives, config::block_size_preprocess_backward), config::block_size_preprocess_backward>>>(
+    kernels::backward::preprocess_backward_cu<<<div_round_up(n_primitives, config::block_size_preprocess_backward), config::block_size_preprocess_backward, 0, stream>>>(
         means,
         scales_raw,
         rotations_raw,
@@ -114,3 +116,17 @@ void fast_gs::rasterization::backward(
         cy);
     CHECK_CUDA(config::debug, "preprocess_backward")
 }
+
+#define INSTANTIATE_BACKWARD(SHRestT)                                                                       \
+    template void fast_gs::rasterization::backward<SHRestT>(                                               \
+        const float*, const float*, const float*, const float*, const float3*, const float3*,              \
+        const float4*, const SHRestT*, const float4*, const float3*, char*, char*, char*, char*, float3*,  \
+        float3*, float4*, float*, float3*, SHRestT*, float2*, float*, float4*, float*, const int,          \
+        const int, const int, const int, const int, const int, const int, const int, const int, const int, \
+        const float, const float, const float, const float, cudaStream_t);
+
+INSTANTIATE_BACKWARD(float)
+INSTANTIATE_BACKWARD(__half)
+INSTANTIATE_BACKWARD(__nv_bfloat16)
+
+#undef INSTANTIATE_BACKWARD
@@ -12,6 +12,7 @@
 #include <functional>
 
 // sorting is done separately for depth and tile as proposed in https://github.com/m-schuetz/Splatshop
+template <typename SHRestT>
 std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     std::function<char*(size_t)> per_primitive_buffers_func,
     std::function<char*(size_t)> per_tile_buffers_func,
@@ -22,7 +23,7 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     const float4* rotations_raw,
     const float* opacities_raw,
     const float3* sh_coefficients_0,
-    const float3* sh_coefficients_rest,
+    const SHRestT* sh_coefficients_rest,
     const float4* w2c,
     const float3* cam_position,
     float* image,
@@ -37,7 +38,8 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     const float cx,
     const float cy,
     const float near_, // near and far are macros in windowns
-    const float far_) {
+    const float far_,
+    cudaStream_t stream) {
     const dim3 grid(div_round_up(width, config::tile_width), div_round_up(height, config::tile_height), 1);
     const dim3 block(config::tile_width, config::tile_height, 1);
     const int n_tiles = grid.x * grid.y;
@@ -45,24 +47,15 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     char* per_tile_buffers_blob = per_tile_buffers_func(required<PerTileBuffers>(n_tiles));
     PerTileBuffers per_tile_buffers = PerTileBuffers::from_blob(per_tile_buffers_blob, n_tiles);
 
-    static cudaStream_t memset_stream = 0;
-    if constexpr (!config::debug) {
-        static bool memset_stream_initialized = false;
-        if (!memset_stream_initialized) {
-            cudaStreamCreate(&memset_stream);
-            memset_stream_initialized = true;
-        }
-        cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, memset_stream);
-    } else
-        cudaMemset(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles);
+    cudaMemsetAsync(per_tile_buffers.instance_ranges, 0, sizeof(uint2) * n_tiles, stream);
 
     char* per_primitive_buffers_blob = per_primitive_buffers_func(required<PerPrimitiveBuffers>(n_primitives));
     PerPrimitiveBuffers per_primitive_buffers = PerPrimitiveBuffers::from_blob(per_primitive_buffers_blob, n_primitives);
 
-    cudaMemset(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint));
-    cudaMemset(per_primitive_buffers.n_instances, 0, sizeof(uint));
+    cudaMemsetAsync(per_primitive_buffers.n_visible_primitives, 0, sizeof(uint), stream);
+    cudaMemsetAsync(per_primitive_buffers.n_instances, 0, sizeof(uint), stream);
 
-    kernels::forward::preprocess_cu<<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess>>>(
+    kernels::forward::preprocess_cu<<<div_round_up(n_primitives, config::block_size_preprocess), config::block_size_preprocess, 0, stream>>>(
         means,
         scales_raw,
         rotations_raw,
@@ -96,19 +89,23 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
     CHECK_CUDA(config::debug, "preprocess")
 
     int n_visible_primitives;
-    cudaMemcpy(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(&n_visible_primitives, per_primitive_buffers.n_visible_primitives, sizeof(uint), cudaMemcpyDeviceToHost, stream);
     int n_instances;
-    cudaMemcpy(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(&n_instances, per_primitive_buffers.n_instances, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
 
     cub::DeviceRadixSort::SortPairs(
         per_primitive_buffers.cub_workspace,
         per_primitive_buffers.cub_workspace_size,
         per_primitive_buffers.depth_keys,
         per_primitive_buffers.primitive_indices,
-        n_visible_primitives);
+        n_visible_primitives,
+        0,
+        sizeof(uint) * 8,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Depth)")
 
-    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering>>>(
+    kernels::forward::apply_depth_ordering_cu<<<div_round_up(n_visible_primitives, config::block_size_apply_depth_ordering), config::block_size_apply_depth_ordering, 0, stream>>>(
         per_primitive_buffers.primitive_indices.Current(),
         per_primitive_buffers.n_touched_tiles,
         per_primitive_buffers.offset,
@@ -120,13 +117,14 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_primitive_buffers.cub_workspace_size,
         per_primitive_buffers.offset,
         per_primitive_buffers.offset,
-        n_visible_primitives);
+        n_visible_primitives,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceScan::ExclusiveSum (Primitive Offsets)")
 
     char* per_instance_buffers_blob = per_instance_buffers_func(required<PerInstanceBuffers>(n_instances));
     PerInstanceBuffers per_instance_buffers = PerInstanceBuffers::from_blob(per_instance_buffers_blob, n_instances);
 
-    kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances>>>(
+    kernels::forward::create_instances_cu<<<div_round_up(n_visible_primitives, config::block_size_create_instances), config::block_size_create_instances, 0, stream>>>(
         per_primitive_buffers.primitive_indices.Current(),
         per_primitive_buffers.offset,
         per_primitive_buffers.screen_bounds,
@@ -143,21 +141,21 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_instance_buffers.cub_workspace_size,
         per_instance_buffers.keys,
         per_instance_buffers.primitive_indices,
-        n_instances);
+        n_instances,
+        0,
+        sizeof(ushort) * 8,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceRadixSort::SortPairs (Tile)")
 
-    if constexpr (!config::debug)
-        cudaStreamSynchronize(memset_stream);
-
     if (n_instances > 0) {
-        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges>>>(
+        kernels::forward::extract_instance_ranges_cu<<<div_round_up(n_instances, config::block_size_extract_instance_ranges), config::block_size_extract_instance_ranges, 0, stream>>>(
             per_instance_buffers.keys.Current(),
             per_tile_buffers.instance_ranges,
             n_instances);
         CHECK_CUDA(config::debug, "extract_instance_ranges")
     }
 
-    kernels::forward::extract_bucket_counts<<<div_round_up(n_tiles, config::block_size_extract_bucket_counts), config::block_size_extract_bucket_counts>>>(
+    kernels::forward::extract_bucket_counts<<<div_round_up(n_tiles, config::block_size_extract_bucket_counts), config::block_size_extract_bucket_counts, 0, stream>>>(
         per_tile_buffers.instance_ranges,
         per_tile_buffers.n_buckets,
         n_tiles);
@@ -168,16 +166,18 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
         per_tile_buffers.cub_workspace_size,
         per_tile_buffers.n_buckets,
         per_tile_buffers.bucket_offsets,
-        n_tiles);
+        n_tiles,
+        stream);
     CHECK_CUDA(config::debug, "cub::DeviceScan::InclusiveSum (Bucket Counts)")
 
     int n_buckets;
-    cudaMemcpy(&n_buckets, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost);
+    cudaMemcpyAsync(&n_buckets, per_tile_buffers.bucket_offsets + n_tiles - 1, sizeof(uint), cudaMemcpyDeviceToHost, stream);
+    cudaStreamSynchronize(stream);
 
     char* per_bucket_buffers_blob = per_bucket_buffers_func(required<PerBucketBuffers>(n_buckets));
     PerBucketBuffers per_bucket_buffers = PerBucketBuffers::from_blob(per_bucket_buffers_blob, n_buckets);
 
-    kernels::forward::blend_cu<<<grid, block>>>(
+    kernels::forward::blend_cu<<<grid, block, 0, stream>>>(
         per_tile_buffers.instance_ranges,
         per_tile_buffers.bucket_offsets,
         per_instance_buffers.primitive_indices.Current(),
@@ -197,3 +197,17 @@ std::tuple<int, int, int, int, int> fast_gs::rasterization::forward(
 
     return {n_visible_primitives, n_instances, n_buckets, per_primitive_buffers.primitive_indices.selector, per_instance_buffers.primitive_indices.selector};
 }
+
+#define INSTANTIATE_FORWARD(SHRestT)                                                                         \
+    template std::tuple<int, int, int, int, int> fast_gs::rasterization::forward<SHRestT>(                   \
+        std::function<char*(size_t)>, std::function<char*(size_t)>, std::function<char*(size_t)>,            \
+        std::function<char*(size_t)>, const float3*, const float3*, const float4*, const float*,             \
+        const float3*, const SHRestT*, const float4*, const float3*, float*, float*, const int, const int,   \
+        const int, const int, const int, const float, const float, const float, const float, const float,    \
+        const float, cudaStream_t);
+
+INSTANTIATE_FORWARD(float)
+INSTANTIATE_FORWARD(__half)
+INSTANTIATE_FORWARD(__nv_bfloat16)
+
+#undef INSTANTIATE_FORWARD
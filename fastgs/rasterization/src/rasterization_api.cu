@@ -3,15 +3,38 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "backward.h"
+#include "buffer_utils.h"
 #include "forward.h"
 #include "helper_math.h"
 #include "rasterization_api.h"
 #include "rasterization_config.h"
+#include "rasterization_cpu.h"
 #include "torch_utils.h"
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
 #include <functional>
 #include <stdexcept>
 #include <tuple>
 
+namespace {
+    // Calls f with a typed pointer to the higher-degree SH coefficients: float, __half or __nv_bfloat16
+    template <typename F>
+    decltype(auto) dispatch_sh_rest(const torch::Tensor& sh_coefficients_rest, F&& f) {
+        switch (sh_coefficients_rest.scalar_type()) {
+        case torch::kFloat:
+            return f(sh_coefficients_rest.data_ptr<float>());
+        case torch::kHalf:
+            return f(reinterpret_cast<__half*>(sh_coefficients_rest.data_ptr<at::Half>()));
+        case torch::kBFloat16:
+            return f(reinterpret_cast<__nv_bfloat16*>(sh_coefficients_rest.data_ptr<at::BFloat16>()));
+        default:
+            throw std::runtime_error("sh_coefficients_rest must be a float32, float16 or bfloat16 tensor");
+        }
+    }
+} // namespace
+
 std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int>
 fast_gs::rasterization::forward_wrapper(
     const torch::Tensor& means,
@@ -31,6 +54,16 @@ fast_gs::rasterization::forward_wrapper(
     const float center_y,
     const float near_plane,
     const float far_plane) {
+    if (means.is_cpu()) {
+        return forward_wrapper_cpu(
+            means, scales_raw, rotations_raw, opacities_raw, sh_coefficients_0, sh_coefficients_rest,
+            w2c, cam_position, active_sh_bases, width, height,
+            focal_x, focal_y, center_x, center_y, near_plane, far_plane);
+    }
+
+    // Buffers are allocated on, and kernels launched to, the device of the Gaussians
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(means));
+
     // all optimizable tensors must be contiguous CUDA float tensors
     CHECK_INPUT(config::debug, means, "means");
     CHECK_INPUT(config::debug, scales_raw, "scales_raw");
@@ -54,32 +87,35 @@ fast_gs::rasterization::forward_wrapper(
     const std::function<char*(size_t)> per_instance_buffers_func = resize_function_wrapper(per_instance_buffers);
     const std::function<char*(size_t)> per_bucket_buffers_func = resize_function_wrapper(per_bucket_buffers);
 
-    auto [n_visible_primitives, n_instances, n_buckets, primitive_primitive_indices_selector, instance_primitive_indices_selector] = forward(
-        per_primitive_buffers_func,
-        per_tile_buffers_func,
-        per_instance_buffers_func,
-        per_bucket_buffers_func,
-        reinterpret_cast<float3*>(means.data_ptr<float>()),
-        reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
-        reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
-        opacities_raw.data_ptr<float>(),
-        reinterpret_cast<float3*>(sh_coefficients_0.data_ptr<float>()),
-        reinterpret_cast<float3*>(sh_coefficients_rest.data_ptr<float>()),
-        reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
-        reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
-        image.data_ptr<float>(),
-        alpha.data_ptr<float>(),
-        n_primitives,
-        active_sh_bases,
-        total_bases_sh_rest,
-        width,
-        height,
-        focal_x,
-        focal_y,
-        center_x,
-        center_y,
-        near_plane,
-        far_plane);
+    auto [n_visible_primitives, n_instances, n_buckets, primitive_primitive_indices_selector, instance_primitive_indices_selector] = dispatch_sh_rest(sh_coefficients_rest, [&](const auto* sh_rest) {
+        return forward(
+            per_primitive_buffers_func,
+            per_tile_buffers_func,
+            per_instance_buffers_func,
+            per_bucket_buffers_func,
+            reinterpret_cast<float3*>(means.data_ptr<float>()),
+            reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
+            reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
+            opacities_raw.data_ptr<float>(),
+            reinterpret_cast<float3*>(sh_coefficients_0.data_ptr<float>()),
+            sh_rest,
+            reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
+            reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
+            image.data_ptr<float>(),
+            alpha.data_ptr<float>(),
+            n_primitives,
+            active_sh_bases,
+            total_bases_sh_rest,
+            width,
+            height,
+            focal_x,
+            focal_y,
+            center_x,
+            center_y,
+            near_plane,
+            far_plane,
+            at::cuda::getCurrentCUDAStream());
+    });
 
     return {
         image, alpha,
@@ -119,6 +155,18 @@ fast_gs::rasterization::backward_wrapper(
     const int n_buckets,
     const int primitive_primitive_indices_selector,
     const int instance_primitive_indices_selector) {
+    if (means.is_cpu()) {
+        return backward_wrapper_cpu(
+            densification_info, grad_image, grad_alpha, image, alpha,
+            means, scales_raw, rotations_raw, sh_coefficients_rest,
+            per_primitive_buffers, per_tile_buffers, per_instance_buffers, per_bucket_buffers,
+            w2c, cam_position, active_sh_bases, width, height,
+            focal_x, focal_y, center_x, center_y,
+            n_visible_primitives, n_instances, n_buckets);
+    }
+
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(means));
+
     const int n_primitives = means.size(0);
     const int total_bases_sh_rest = sh_coefficients_rest.size(1);
     const torch::TensorOptions float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCUDA);
@@ -127,7 +175,8 @@ fast_gs::rasterization::backward_wrapper(
     torch::Tensor grad_rotations_raw = torch::zeros({n_primitives, 4}, float_options);
     torch::Tensor grad_opacities_raw = torch::zeros({n_primitives, 1}, float_options);
     torch::Tensor grad_sh_coefficients_0 = torch::zeros({n_primitives, 1, 3}, float_options);
-    torch::Tensor grad_sh_coefficients_rest = torch::zeros({n_primitives, total_bases_sh_rest, 3}, float_options);
+    // Same storage type as the coefficients
+    torch::Tensor grad_sh_coefficients_rest = torch::zeros_like(sh_coefficients_rest);
     torch::Tensor grad_mean2d_helper = torch::zeros({n_primitives, 2}, float_options);
     torch::Tensor grad_conic_helper = torch::zeros({n_primitives, 3}, float_options);
     torch::Tensor grad_w2c = torch::Tensor();
@@ -137,45 +186,66 @@ fast_gs::rasterization::backward_wrapper(
 
     const bool update_densification_info = densification_info.size(0) > 0;
 
-    backward(
-        grad_image.data_ptr<float>(),
-        grad_alpha.data_ptr<float>(),
-        image.data_ptr<float>(),
-        alpha.data_ptr<float>(),
-        reinterpret_cast<float3*>(means.data_ptr<float>()),
-        reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
-        reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
-        reinterpret_cast<float3*>(sh_coefficients_rest.data_ptr<float>()),
-        reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
-        reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
-        reinterpret_cast<char*>(per_primitive_buffers.data_ptr()),
-        reinterpret_cast<char*>(per_tile_buffers.data_ptr()),
-        reinterpret_cast<char*>(per_instance_buffers.data_ptr()),
-        reinterpret_cast<char*>(per_bucket_buffers.data_ptr()),
-        reinterpret_cast<float3*>(grad_means.data_ptr<float>()),
-        reinterpret_cast<float3*>(grad_scales_raw.data_ptr<float>()),
-        reinterpret_cast<float4*>(grad_rotations_raw.data_ptr<float>()),
-        reinterpret_cast<float*>(grad_opacities_raw.data_ptr<float>()),
-        reinterpret_cast<float3*>(grad_sh_coefficients_0.data_ptr<float>()),
-        reinterpret_cast<float3*>(grad_sh_coefficients_rest.data_ptr<float>()),
-        reinterpret_cast<float2*>(grad_mean2d_helper.data_ptr<float>()),
-        grad_conic_helper.data_ptr<float>(),
-        w2c.requires_grad() ? reinterpret_cast<float4*>(grad_w2c.data_ptr<float>()) : nullptr,
-        update_densification_info ? densification_info.data_ptr<float>() : nullptr,
-        n_primitives,
-        n_visible_primitives,
-        n_instances,
-        n_buckets,
-        primitive_primitive_indices_selector,
-        instance_primitive_indices_selector,
-        active_sh_bases,
-        total_bases_sh_rest,
-        width,
-        height,
-        focal_x,
-        focal_y,
-        center_x,
-        center_y);
+    dispatch_sh_rest(sh_coefficients_rest, [&](const auto* sh_rest) {
+        using SHRestT = std::remove_cv_t<std::remove_pointer_t<decltype(sh_rest)>>;
+        backward(
+            grad_image.data_ptr<float>(),
+            grad_alpha.data_ptr<float>(),
+            image.data_ptr<float>(),
+            alpha.data_ptr<float>(),
+            reinterpret_cast<float3*>(means.data_ptr<float>()),
+            reinterpret_cast<float3*>(scales_raw.data_ptr<float>()),
+            reinterpret_cast<float4*>(rotations_raw.data_ptr<float>()),
+            sh_rest,
+            reinterpret_cast<float4*>(w2c.contiguous().data_ptr<float>()),
+            reinterpret_cast<float3*>(cam_position.contiguous().data_ptr<float>()),
+            reinterpret_cast<char*>(per_primitive_buffers.data_ptr()),
+            reinterpret_cast<char*>(per_tile_buffers.data_ptr()),
+            reinterpret_cast<char*>(per_instance_buffers.data_ptr()),
+            reinterpret_cast<char*>(per_bucket_buffers.data_ptr()),
+            reinterpret_cast<float3*>(grad_means.data_ptr<float>()),
+            reinterpret_cast<float3*>(grad_scales_raw.data_ptr<float>()),
+            reinterpret_cast<float4*>(grad_rotations_raw.data_ptr<float>()),
+            reinterpret_cast<float*>(grad_opacities_raw.data_ptr<float>()),
+            reinterpret_cast<float3*>(grad_sh_coefficients_0.data_ptr<float>()),
+            reinterpret_cast<SHRestT*>(grad_sh_coefficients_rest.data_ptr()),
+            reinterpret_cast<float2*>(grad_mean2d_helper.data_ptr<float>()),
+            grad_conic_helper.data_ptr<float>(),
+            w2c.requires_grad() ? reinterpret_cast<float4*>(grad_w2c.data_ptr<float>()) : nullptr,
+            update_densification_info ? densification_info.data_ptr<float>() : nullptr,
+            n_primitives,
+            n_visible_primitives,
+            n_instances,
+            n_buckets,
+            primitive_primitive_indices_selector,
+            instance_primitive_indices_selector,
+            active_sh_bases,
+            total_bases_sh_rest,
+            width,
+            height,
+            focal_x,
+            focal_y,
+            center_x,
+            center_y,
+            at::cuda::getCurrentCUDAStream());
+    });
 
     return {grad_means, grad_scales_raw, grad_rotations_raw, grad_opacities_raw, grad_sh_coefficients_0, grad_sh_coefficients_rest, grad_w2c};
 }
+
+torch::Tensor fast_gs::rasterization::visible_primitive_indices(
+    const torch::Tensor& per_primitive_buffers,
+    const int n_primitives,
+    const int n_visible_primitives,
+    const int primitive_primitive_indices_selector) {
+    if (per_primitive_buffers.is_cpu()) {
+        return visible_primitive_indices_cpu(per_primitive_buffers, n_primitives);
+    }
+
+    // The first n_visible_primitives entries of the current index buffer are the depth-sorted visible set
+    char* blob = reinterpret_cast<char*>(per_primitive_buffers.data_ptr());
+    const PerPrimitiveBuffers buffers = PerPrimitiveBuffers::from_blob(blob, n_primitives);
+    const uint* indices = buffers.primitive_indices.d_buffers[primitive_primitive_indices_selector];
+    const auto int_options = torch::TensorOptions().dtype(torch::kInt32).device(per_primitive_buffers.device());
+    return torch::from_blob(const_cast<uint*>(indices), {n_visible_primitives}, int_options).to(torch::kInt64);
+}
@@ -0,0 +1,1067 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "rasterization_cpu.h"
+#include "rasterization_config.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <tbb/blocked_range.h>
+#include <tbb/combinable.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <vector>
+
+// The per-pixel loops below run over all pixels of a tile with branch-free bodies
+// (masks and selects instead of early exits) so the compiler can vectorize them.
+namespace fast_gs::rasterization {
+    namespace {
+        constexpr int tile_size = config::block_size_blend;
+        constexpr int bucket_size = 32; // Blend checkpoint interval, one CUDA warp
+        constexpr int n_instance_grads = 9; // mean2d (2), conic (3), opacity partial (1), color (3)
+
+        template <typename T>
+        void obtain(char*& blob, T*& ptr, std::size_t count) {
+            const std::uintptr_t offset = (reinterpret_cast<std::uintptr_t>(blob) + 63) & ~std::uintptr_t{63};
+            ptr = reinterpret_cast<T*>(offset);
+            blob = reinterpret_cast<char*>(ptr + count);
+        }
+
+        template <typename T>
+        size_t required(size_t n) {
+            char* size = nullptr;
+            T::from_blob(size, n);
+            return reinterpret_cast<size_t>(size) + 64;
+        }
+
+        char* allocate(torch::Tensor& tensor, size_t bytes) {
+            tensor = torch::empty({static_cast<int64_t>(bytes)}, torch::TensorOptions().dtype(torch::kByte));
+            return static_cast<char*>(tensor.data_ptr());
+        }
+
+        struct PrimitiveBuffers {
+            uint32_t* n_touched_tiles;
+            uint32_t* offset;      // First instance of the primitive in depth-major order
+            float* mean2d;         // [N, 2]
+            float* conic_opacity;  // [N, 4]
+            float* color;          // [N, 3] before clamping
+
+            static PrimitiveBuffers from_blob(char*& blob, size_t n_primitives) {
+                PrimitiveBuffers buffers;
+                obtain(blob, buffers.n_touched_tiles, n_primitives);
+                obtain(blob, buffers.offset, n_primitives);
+                obtain(blob, buffers.mean2d, 2 * n_primitives);
+                obtain(blob, buffers.conic_opacity, 4 * n_primitives);
+                obtain(blob, buffers.color, 3 * n_primitives);
+                return buffers;
+            }
+        };
+
+        struct TileBuffers {
+            uint32_t* instance_ranges;     // [T, 2]
+            uint32_t* bucket_offsets;      // Inclusive sum of the bucket counts
+            uint32_t* max_n_contributions; // [T]
+            uint32_t* n_contributions;     // [T, tile_size]
+
+            static TileBuffers from_blob(char*& blob, size_t n_tiles) {
+                TileBuffers buffers;
+                obtain(blob, buffers.instance_ranges, 2 * n_tiles);
+                obtain(blob, buffers.bucket_offsets, n_tiles);
+                obtain(blob, buffers.max_n_contributions, n_tiles);
+                obtain(blob, buffers.n_contributions, n_tiles * tile_size);
+                return buffers;
+            }
+        };
+
+        struct InstanceBuffers {
+            uint32_t* primitive_indices; // Sorted by tile, depth order within a tile
+            uint32_t* tile_order;        // Depth-major instance -> position in tile order
+
+            static InstanceBuffers from_blob(char*& blob, size_t n_instances) {
+                InstanceBuffers buffers;
+                obtain(blob, buffers.primitive_indices, n_instances);
+                obtain(blob, buffers.tile_order, n_instances);
+                return buffers;
+            }
+        };
+
+        struct BucketBuffers {
+            float* color_transmittance; // [B, tile_size, 4]
+
+            static BucketBuffers from_blob(char*& blob, size_t n_buckets) {
+                BucketBuffers buffers;
+                obtain(blob, buffers.color_transmittance, n_buckets * tile_size * 4);
+                return buffers;
+            }
+        };
+
+        struct Camera {
+            float w2c[3][4];
+            float position[3];
+            float width, height, fx, fy, cx, cy;
+            uint32_t grid_width, grid_height;
+        };
+
+        Camera make_camera(const torch::Tensor& w2c, const torch::Tensor& cam_position,
+                           int width, int height, float fx, float fy, float cx, float cy) {
+            const auto w2c_cpu = w2c.detach().to(torch::kCPU, torch::kFloat).contiguous();
+            const auto position_cpu = cam_position.detach().to(torch::kCPU, torch::kFloat).contiguous();
+            const float* m = w2c_cpu.data_ptr<float>();
+            const float* p = position_cpu.data_ptr<float>();
+
+            Camera cam;
+            for (int r = 0; r < 3; ++r) {
+                for (int c = 0; c < 4; ++c) {
+                    cam.w2c[r][c] = m[r * 4 + c];
+                }
+                cam.position[r] = p[r];
+            }
+            cam.width = static_cast<float>(width);
+            cam.height = static_cast<float>(height);
+            cam.fx = fx;
+            cam.fy = fy;
+            cam.cx = cx;
+            cam.cy = cy;
+            cam.grid_width = static_cast<uint32_t>((width + config::tile_width - 1) / config::tile_width);
+            cam.grid_height = static_cast<uint32_t>((height + config::tile_height - 1) / config::tile_height);
+            return cam;
+        }
+
+        float camera_row(const Camera& cam, int row, const float* mean) {
+            return cam.w2c[row][0] * mean[0] + cam.w2c[row][1] * mean[1] + cam.w2c[row][2] * mean[2] + cam.w2c[row][3];
+        }
+
+        float dot3(const float* a, const float* b) {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        // 3d covariance from raw scale and rotation
+        struct Covariance {
+            float variance[3];
+            float q[4]; // r, x, y, z
+            float q_norm_sq;
+            float qxx, qyy, qzz, qxy, qxz, qyz, qrx, qry, qrz;
+            float rotation[3][3];
+            float rotation_scaled[3][3];
+            float m11, m12, m13, m22, m23, m33;
+        };
+
+        Covariance compute_covariance(const float* raw_scale, const float* raw_rotation) {
+            Covariance c;
+            for (int i = 0; i < 3; ++i) {
+                c.variance[i] = std::exp(2.0f * raw_scale[i]);
+            }
+            const float qr = raw_rotation[0], qx = raw_rotation[1], qy = raw_rotation[2], qz = raw_rotation[3];
+            c.q[0] = qr;
+            c.q[1] = qx;
+            c.q[2] = qy;
+            c.q[3] = qz;
+            c.q_norm_sq = qr * qr + qx * qx + qy * qy + qz * qz;
+            c.qxx = 2.0f * qx * qx / c.q_norm_sq, c.qyy = 2.0f * qy * qy / c.q_norm_sq, c.qzz = 2.0f * qz * qz / c.q_norm_sq;
+            c.qxy = 2.0f * qx * qy / c.q_norm_sq, c.qxz = 2.0f * qx * qz / c.q_norm_sq, c.qyz = 2.0f * qy * qz / c.q_norm_sq;
+            c.qrx = 2.0f * qr * qx / c.q_norm_sq, c.qry = 2.0f * qr * qy / c.q_norm_sq, c.qrz = 2.0f * qr * qz / c.q_norm_sq;
+            const float rotation[3][3] = {
+                {1.0f - (c.qyy + c.qzz), c.qxy - c.qrz, c.qry + c.qxz},
+                {c.qrz + c.qxy, 1.0f - (c.qxx + c.qzz), c.qyz - c.qrx},
+                {c.qxz - c.qry, c.qrx + c.qyz, 1.0f - (c.qxx + c.qyy)}};
+            for (int r = 0; r < 3; ++r) {
+                for (int k = 0; k < 3; ++k) {
+                    c.rotation[r][k] = rotation[r][k];
+                    c.rotation_scaled[r][k] = rotation[r][k] * c.variance[k];
+                }
+            }
+            const auto& rs = c.rotation_scaled;
+            const auto& r = c.rotation;
+            c.m11 = rs[0][0] * r[0][0] + rs[0][1] * r[0][1] + rs[0][2] * r[0][2];
+            c.m12 = rs[0][0] * r[1][0] + rs[0][1] * r[1][1] + rs[0][2] * r[1][2];
+            c.m13 = rs[0][0] * r[2][0] + rs[0][1] * r[2][1] + rs[0][2] * r[2][2];
+            c.m22 = rs[1][0] * r[1][0] + rs[1][1] * r[1][1] + rs[1][2] * r[1][2];
+            c.m23 = rs[1][0] * r[2][0] + rs[1][1] * r[2][1] + rs[1][2] * r[2][2];
+            c.m33 = rs[2][0] * r[2][0] + rs[2][1] * r[2][1] + rs[2][2] * r[2][2];
+            return c;
+        }
+
+        // EWA splatting of a 3d covariance at a given camera-space position
+        struct Splat {
+            float depth, x, y, tx, ty;
+            float j11, j13, j22, j23;
+            float jw_r1[3], jw_r2[3];
+            float jwc_r1[3], jwc_r2[3];
+            float a, b, c; // 2d covariance including dilation
+        };
+
+        Splat compute_splat(const Camera& cam, const float* mean, float depth, const Covariance& cov) {
+            Splat s;
+            s.depth = depth;
+            s.x = camera_row(cam, 0, mean) / depth;
+            s.y = camera_row(cam, 1, mean) / depth;
+            const float clip_left = (-0.15f * cam.width - cam.cx) / cam.fx;
+            const float clip_right = (1.15f * cam.width - cam.cx) / cam.fx;
+            const float clip_top = (-0.15f * cam.height - cam.cy) / cam.fy;
+            const float clip_bottom = (1.15f * cam.height - cam.cy) / cam.fy;
+            s.tx = std::clamp(s.x, clip_left, clip_right);
+            s.ty = std::clamp(s.y, clip_top, clip_bottom);
+            s.j11 = cam.fx / depth;
+            s.j13 = -s.j11 * s.tx;
+            s.j22 = cam.fy / depth;
+            s.j23 = -s.j22 * s.ty;
+            for (int k = 0; k < 3; ++k) {
+                s.jw_r1[k] = s.j11 * cam.w2c[0][k] + s.j13 * cam.w2c[2][k];
+                s.jw_r2[k] = s.j22 * cam.w2c[1][k] + s.j23 * cam.w2c[2][k];
+            }
+            const float cov3d[3][3] = {
+                {cov.m11, cov.m12, cov.m13},
+                {cov.m12, cov.m22, cov.m23},
+                {cov.m13, cov.m23, cov.m33}};
+            for (int k = 0; k < 3; ++k) {
+                s.jwc_r1[k] = s.jw_r1[0] * cov3d[0][k] + s.jw_r1[1] * cov3d[1][k] + s.jw_r1[2] * cov3d[2][k];
+                s.jwc_r2[k] = s.jw_r2[0] * cov3d[0][k] + s.jw_r2[1] * cov3d[1][k] + s.jw_r2[2] * cov3d[2][k];
+            }
+            s.a = dot3(s.jwc_r1, s.jw_r1) + config::dilation;
+            s.b = dot3(s.jwc_r1, s.jw_r2);
+            s.c = dot3(s.jwc_r2, s.jw_r2) + config::dilation;
+            return s;
+        }
+
+        // Real spherical harmonics basis for the rest coefficients, matching kernel_utils.cuh
+        int sh_rest_basis(const float* direction, int active_sh_bases, float* basis) {
+            const float x = direction[0], y = direction[1], z = direction[2];
+            int n = 0;
+            if (active_sh_bases > 1) {
+                basis[n++] = -0.48860251190291987f * y;
+                basis[n++] = 0.48860251190291987f * z;
+                basis[n++] = -0.48860251190291987f * x;
+                if (active_sh_bases > 4) {
+                    const float xx = x * x, yy = y * y, zz = z * z;
+                    const float xy = x * y, xz = x * z, yz = y * z;
+                    basis[n++] = 1.0925484305920792f * xy;
+                    basis[n++] = -1.0925484305920792f * yz;
+                    basis[n++] = 0.94617469575755997f * zz - 0.31539156525251999f;
+                    basis[n++] = -1.0925484305920792f * xz;
+                    basis[n++] = 0.54627421529603959f * xx - 0.54627421529603959f * yy;
+                    if (active_sh_bases > 9) {
+                        basis[n++] = 0.59004358992664352f * y * (-3.0f * xx + yy);
+                        basis[n++] = 2.8906114426405538f * xy * z;
+                        basis[n++] = 0.45704579946446572f * y * (1.0f - 5.0f * zz);
+                        basis[n++] = 0.3731763325901154f * z * (5.0f * zz - 3.0f);
+                        basis[n++] = 0.45704579946446572f * x * (1.0f - 5.0f * zz);
+                        basis[n++] = 1.4453057213202769f * z * (xx - yy);
+                        basis[n++] = 0.59004358992664352f * x * (-xx + 3.0f * yy);
+                    }
+                }
+            }
+            return n;
+        }
+
+        void sh_direction(const float* mean, const Camera& cam, float* raw, float* direction) {
+            for (int k = 0; k < 3; ++k) {
+                raw[k] = mean[k] - cam.position[k];
+            }
+            const float inv_norm = 1.0f / std::sqrt(dot3(raw, raw));
+            for (int k = 0; k < 3; ++k) {
+                direction[k] = raw[k] * inv_norm;
+            }
+        }
+
+        void convert_sh_to_color(const float* sh0, const float* sh_rest, const float* mean, const Camera& cam,
+                                 int active_sh_bases, float* color) {
+            for (int k = 0; k < 3; ++k) {
+                color[k] = 0.5f + 0.28209479177387814f * sh0[k];
+            }
+            if (active_sh_bases <= 1) {
+                return;
+            }
+            float raw[3], direction[3], basis[15];
+            sh_direction(mean, cam, raw, direction);
+            const int n = sh_rest_basis(direction, active_sh_bases, basis);
+            for (int i = 0; i < n; ++i) {
+                for (int k = 0; k < 3; ++k) {
+                    color[k] += basis[i] * sh_rest[3 * i + k];
+                }
+            }
+        }
+
+        // Writes the sh coefficient gradients and returns the gradient w.r.t. the 3d mean
+        std::array<float, 3> convert_sh_to_color_backward(const float* sh_rest, const float* grad_color,
+                                                          float* grad_sh0, float* grad_sh_rest,
+                                                          const float* mean, const Camera& cam, int active_sh_bases) {
+            for (int k = 0; k < 3; ++k) {
+                grad_sh0[k] = 0.28209479177387814f * grad_color[k];
+            }
+            if (active_sh_bases <= 1) {
+                return {0.0f, 0.0f, 0.0f};
+            }
+            float raw[3], direction[3], basis[15];
+            sh_direction(mean, cam, raw, direction);
+            const int n = sh_rest_basis(direction, active_sh_bases, basis);
+            for (int i = 0; i < n; ++i) {
+                for (int k = 0; k < 3; ++k) {
+                    grad_sh_rest[3 * i + k] = basis[i] * grad_color[k];
+                }
+            }
+
+            const float x = direction[0], y = direction[1], z = direction[2];
+            const auto c = [sh_rest](int i, int k) { return sh_rest[3 * i + k]; };
+            float grad_direction[3] = {};
+            for (int k = 0; k < 3; ++k) {
+                float gx = -0.48860251190291987f * c(2, k);
+                float gy = -0.48860251190291987f * c(0, k);
+                float gz = 0.48860251190291987f * c(1, k);
+                if (active_sh_bases > 4) {
+                    gx += 1.0925484305920792f * y * c(3, k) - 1.0925484305920792f * z * c(6, k) + 1.0925484305920792f * x * c(7, k);
+                    gy += 1.0925484305920792f * x * c(3, k) - 1.0925484305920792f * z * c(4, k) - 1.0925484305920792f * y * c(7, k);
+                    gz += -1.0925484305920792f * y * c(4, k) + 1.8923493915151202f * z * c(5, k) - 1.0925484305920792f * x * c(6, k);
+                    if (active_sh_bases > 9) {
+                        const float xx = x * x, yy = y * y, zz = z * z;
+                        const float xy = x * y, xz = x * z, yz = y * z;
+                        gx += -3.5402615395598609f * xy * c(8, k) + 2.8906114426405538f * yz * c(9, k) +
+                              (0.45704579946446572f - 2.2852289973223288f * zz) * c(12, k) + 2.8906114426405538f * xz * c(13, k) +
+                              (-1.7701307697799304f * xx + 1.7701307697799304f * yy) * c(14, k);
+                        gy += (-1.7701307697799304f * xx + 1.7701307697799304f * yy) * c(8, k) + 2.8906114426405538f * xz * c(9, k) +
+                              (0.45704579946446572f - 2.2852289973223288f * zz) * c(10, k) - 2.8906114426405538f * yz * c(13, k) +
+                              3.5402615395598609f * xy * c(14, k);
+                        gz += 2.8906114426405538f * xy * c(9, k) - 4.5704579946446566f * yz * c(10, k) +
+                              (5.597644988851731f * zz - 1.1195289977703462f) * c(11, k) - 4.5704579946446566f * xz * c(12, k) +
+                              (1.4453057213202769f * xx - 1.4453057213202769f * yy) * c(13, k);
+                    }
+                }
+                grad_direction[0] += gx * grad_color[k];
+                grad_direction[1] += gy * grad_color[k];
+                grad_direction[2] += gz * grad_color[k];
+            }
+
+            // Through the normalization of the view direction
+            const float xx_raw = raw[0] * raw[0], yy_raw = raw[1] * raw[1], zz_raw = raw[2] * raw[2];
+            const float xy_raw = raw[0] * raw[1], xz_raw = raw[0] * raw[2], yz_raw = raw[1] * raw[2];
+            const float norm_sq = xx_raw + yy_raw + zz_raw;
+            const float scale = 1.0f / std::sqrt(norm_sq * norm_sq * norm_sq);
+            return {
+                ((yy_raw + zz_raw) * grad_direction[0] - xy_raw * grad_direction[1] - xz_raw * grad_direction[2]) * scale,
+                (-xy_raw * grad_direction[0] + (xx_raw + zz_raw) * grad_direction[1] - yz_raw * grad_direction[2]) * scale,
+                (-xz_raw * grad_direction[0] - yz_raw * grad_direction[1] + (xx_raw + yy_raw) * grad_direction[2]) * scale};
+        }
+
+        // Same test as will_primitive_contribute in kernel_utils.cuh; mean is shifted by -0.5
+        bool will_primitive_contribute(float mean_x, float mean_y, const float* conic,
+                                       uint32_t tile_x, uint32_t tile_y, float power_threshold) {
+            const float rect_min_x = static_cast<float>(tile_x * config::tile_width);
+            const float rect_min_y = static_cast<float>(tile_y * config::tile_height);
+            const float rect_max_x = static_cast<float>((tile_x + 1) * config::tile_width - 1);
+            const float rect_max_y = static_cast<float>((tile_y + 1) * config::tile_height - 1);
+
+            const float x_min_diff = rect_min_x - mean_x;
+            const float x_left = static_cast<float>(x_min_diff > 0.0f);
+            const float not_in_x_range = x_left + static_cast<float>(mean_x > rect_max_x);
+            const float y_min_diff = rect_min_y - mean_y;
+            const float y_above = static_cast<float>(y_min_diff > 0.0f);
+            const float not_in_y_range = y_above + static_cast<float>(mean_y > rect_max_y);
+
+            if (not_in_y_range + not_in_x_range == 0.0f) {
+                return true;
+            }
+            const float closest_x = rect_max_x + x_left * (rect_min_x - rect_max_x);
+            const float closest_y = rect_max_y + y_above * (rect_min_y - rect_max_y);
+            const float diff_x = mean_x - closest_x;
+            const float diff_y = mean_y - closest_y;
+
+            const auto saturate = [](float v) { return v > 0.0f ? std::min(v, 1.0f) : 0.0f; };
+            const float d_x = std::copysign(static_cast<float>(config::tile_width - 1), x_min_diff);
+            const float d_y = std::copysign(static_cast<float>(config::tile_height - 1), y_min_diff);
+            const float t_x = not_in_y_range * saturate((d_x * conic[0] * diff_x + d_x * conic[1] * diff_y) / (d_x * conic[0] * d_x));
+            const float t_y = not_in_x_range * saturate((d_y * conic[1] * diff_x + d_y * conic[2] * diff_y) / (d_y * conic[2] * d_y));
+            const float delta_x = mean_x - (closest_x + t_x * d_x);
+            const float delta_y = mean_y - (closest_y + t_y * d_y);
+            const float max_power_in_tile = 0.5f * (conic[0] * delta_x * delta_x + conic[2] * delta_y * delta_y) + conic[1] * delta_x * delta_y;
+            return max_power_in_tile <= power_threshold;
+        }
+
+        struct PreprocessInputs {
+            const float* means;
+            const float* scales_raw;
+            const float* rotations_raw;
+            const float* opacities_raw;
+            const float* sh0;
+            const float* sh_rest;
+            int active_sh_bases;
+            int total_bases_sh_rest;
+            float near_plane;
+            float far_plane;
+        };
+
+        // Culls and projects one primitive; returns the number of touched tiles (0 = culled)
+        uint32_t preprocess(const PreprocessInputs& in, const Camera& cam, uint32_t idx,
+                            PrimitiveBuffers& out, std::array<uint32_t, 4>& bounds, float& depth_out) {
+            const float* mean = in.means + 3 * idx;
+            const float depth = camera_row(cam, 2, mean);
+            if (depth < in.near_plane || depth > in.far_plane) {
+                return 0;
+            }
+
+            const float opacity = 1.0f / (1.0f + std::exp(-in.opacities_raw[idx]));
+            if (opacity < config::min_alpha_threshold) {
+                return 0;
+            }
+
+            const float* q = in.rotations_raw + 4 * idx;
+            if (q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3] < 1e-8f) {
+                return 0;
+            }
+            const Covariance cov = compute_covariance(in.scales_raw + 3 * idx, q);
+            const Splat s = compute_splat(cam, mean, depth, cov);
+
+            const float determinant = s.a * s.c - s.b * s.b;
+            if (determinant < 1e-8f) {
+                return 0;
+            }
+            const float conic[3] = {s.c / determinant, -s.b / determinant, s.a / determinant};
+            const float mean2d_x = s.x * cam.fx + cam.cx;
+            const float mean2d_y = s.y * cam.fy + cam.cy;
+
+            const float power_threshold = std::log(opacity * config::min_alpha_threshold_rcp);
+            const float power_threshold_factor = std::sqrt(2.0f * power_threshold);
+            const float extent_x = std::max(power_threshold_factor * std::sqrt(s.a) - 0.5f, 0.0f);
+            const float extent_y = std::max(power_threshold_factor * std::sqrt(s.c) - 0.5f, 0.0f);
+            const auto bound = [](float v, uint32_t limit) {
+                return std::min(limit, static_cast<uint32_t>(std::max(0, static_cast<int>(v))));
+            };
+            bounds = {
+                bound(std::floor((mean2d_x - extent_x) / static_cast<float>(config::tile_width)), cam.grid_width),
+                bound(std::ceil((mean2d_x + extent_x) / static_cast<float>(config::tile_width)), cam.grid_width),
+                bound(std::floor((mean2d_y - extent_y) / static_cast<float>(config::tile_height)), cam.grid_height),
+                bound(std::ceil((mean2d_y + extent_y) / static_cast<float>(config::tile_height)), cam.grid_height)};
+            if ((bounds[1] - bounds[0]) * (bounds[3] - bounds[2]) == 0) {
+                return 0;
+            }
+
+            uint32_t n_touched_tiles = 0;
+            for (uint32_t tile_y = bounds[2]; tile_y < bounds[3]; ++tile_y) {
+                for (uint32_t tile_x = bounds[0]; tile_x < bounds[1]; ++tile_x) {
+                    n_touched_tiles += will_primitive_contribute(mean2d_x - 0.5f, mean2d_y - 0.5f, conic, tile_x, tile_y, power_threshold);
+                }
+            }
+            if (n_touched_tiles == 0) {
+                return 0;
+            }
+
+            out.mean2d[2 * idx] = mean2d_x;
+            out.mean2d[2 * idx + 1] = mean2d_y;
+            out.conic_opacity[4 * idx] = conic[0];
+            out.conic_opacity[4 * idx + 1] = conic[1];
+            out.conic_opacity[4 * idx + 2] = conic[2];
+            out.conic_opacity[4 * idx + 3] = opacity;
+            convert_sh_to_color(in.sh0 + 3 * idx,
+                                in.sh_rest + static_cast<size_t>(idx) * in.total_bases_sh_rest * 3,
+                                mean, cam, in.active_sh_bases, out.color + 3 * idx);
+            depth_out = depth;
+            return n_touched_tiles;
+        }
+
+        void blend_tile(uint32_t tile_idx, const Camera& cam, int width, int height,
+                        const PrimitiveBuffers& primitives, const TileBuffers& tiles,
+                        const InstanceBuffers& instances, BucketBuffers& buckets,
+                        float* image, float* alpha_map) {
+            const uint32_t tile_x = tile_idx % cam.grid_width;
+            const uint32_t tile_y = tile_idx / cam.grid_width;
+            const uint32_t begin = tiles.instance_ranges[2 * tile_idx];
+            const uint32_t end = tiles.instance_ranges[2 * tile_idx + 1];
+            const uint32_t bucket_begin = tile_idx == 0 ? 0 : tiles.bucket_offsets[tile_idx - 1];
+
+            alignas(64) float px[tile_size], py[tile_size];
+            alignas(64) float r[tile_size], g[tile_size], b[tile_size], transmittance[tile_size];
+            alignas(64) uint32_t n_possible[tile_size], n_contributions[tile_size];
+            alignas(64) uint8_t done[tile_size];
+            for (int p = 0; p < tile_size; ++p) {
+                const uint32_t x = tile_x * config::tile_width + p % config::tile_width;
+                const uint32_t y = tile_y * config::tile_height + p / config::tile_width;
+                px[p] = static_cast<float>(x) + 0.5f;
+                py[p] = static_cast<float>(y) + 0.5f;
+                r[p] = g[p] = b[p] = 0.0f;
+                transmittance[p] = 1.0f;
+                n_possible[p] = n_contributions[p] = 0;
+                done[p] = !(x < static_cast<uint32_t>(width) && y < static_cast<uint32_t>(height));
+            }
+
+            for (uint32_t k = 0; begin + k < end; ++k) {
+                if (k % bucket_size == 0) {
+                    if (std::all_of(done, done + tile_size, [](uint8_t d) { return d != 0; })) {
+                        break;
+                    }
+                    // Checkpoint for the backward pass, see blend_cu
+                    float* checkpoint = buckets.color_transmittance + (static_cast<size_t>(bucket_begin) + k / bucket_size) * tile_size * 4;
+                    for (int p = 0; p < tile_size; ++p) {
+                        checkpoint[4 * p] = r[p];
+                        checkpoint[4 * p + 1] = g[p];
+                        checkpoint[4 * p + 2] = b[p];
+                        checkpoint[4 * p + 3] = transmittance[p];
+                    }
+                }
+
+                const uint32_t primitive_idx = instances.primitive_indices[begin + k];
+                const float mx = primitives.mean2d[2 * primitive_idx];
+                const float my = primitives.mean2d[2 * primitive_idx + 1];
+                const float* co = primitives.conic_opacity + 4 * primitive_idx;
+                const float cr = std::max(primitives.color[3 * primitive_idx], 0.0f);
+                const float cg = std::max(primitives.color[3 * primitive_idx + 1], 0.0f);
+                const float cb = std::max(primitives.color[3 * primitive_idx + 2], 0.0f);
+
+                for (int p = 0; p < tile_size; ++p) {
+                    const bool active = !done[p];
+                    n_possible[p] += active;
+                    const float dx = mx - px[p];
+                    const float dy = my - py[p];
+                    const float sigma_over_2 = 0.5f * (co[0] * dx * dx + co[2] * dy * dy) + co[1] * dx * dy;
+                    const float alpha = std::min(co[3] * std::exp(-sigma_over_2), config::max_fragment_alpha);
+                    const bool valid = active && sigma_over_2 >= 0.0f && alpha >= config::min_alpha_threshold;
+                    const float next_transmittance = transmittance[p] * (1.0f - alpha);
+                    const bool terminate = valid && next_transmittance < config::transmittance_threshold;
+                    const bool contribute = valid && !terminate;
+                    const float weight = contribute ? transmittance[p] * alpha : 0.0f;
+                    r[p] += weight * cr;
+                    g[p] += weight * cg;
+                    b[p] += weight * cb;
+                    transmittance[p] = contribute ? next_transmittance : transmittance[p];
+                    n_contributions[p] = contribute ? n_possible[p] : n_contributions[p];
+                    done[p] = done[p] || terminate;
+                }
+            }
+
+            const size_t n_pixels = static_cast<size_t>(width) * height;
+            uint32_t max_n_contributions = 0;
+            for (int p = 0; p < tile_size; ++p) {
+                const uint32_t x = tile_x * config::tile_width + p % config::tile_width;
+                const uint32_t y = tile_y * config::tile_height + p / config::tile_width;
+                if (x >= static_cast<uint32_t>(width) || y >= static_cast<uint32_t>(height)) {
+                    continue;
+                }
+                const size_t pixel_idx = static_cast<size_t>(width) * y + x;
+                image[pixel_idx] = r[p];
+                image[pixel_idx + n_pixels] = g[p];
+                image[pixel_idx + 2 * n_pixels] = b[p];
+                alpha_map[pixel_idx] = 1.0f - transmittance[p];
+                tiles.n_contributions[static_cast<size_t>(tile_idx) * tile_size + p] = n_contributions[p];
+                max_n_contributions = std::max(max_n_contributions, n_contributions[p]);
+            }
+            tiles.max_n_contributions[tile_idx] = max_n_contributions;
+        }
+
+        // Per-instance gradients of one tile; instance k of the tile writes slot begin + k
+        void blend_backward_tile(uint32_t tile_idx, const Camera& cam, int width, int height,
+                                 const PrimitiveBuffers& primitives, const TileBuffers& tiles,
+                                 const InstanceBuffers& instances, const BucketBuffers& buckets,
+                                 const float* image, const float* alpha_map,
+                                 const float* grad_image, const float* grad_alpha_map,
+                                 float* instance_grads) {
+            const uint32_t tile_x = tile_idx % cam.grid_width;
+            const uint32_t tile_y = tile_idx / cam.grid_width;
+            const uint32_t begin = tiles.instance_ranges[2 * tile_idx];
+            const uint32_t bucket_begin = tile_idx == 0 ? 0 : tiles.bucket_offsets[tile_idx - 1];
+            const uint32_t max_n_contributions = tiles.max_n_contributions[tile_idx];
+            if (max_n_contributions == 0) {
+                return;
+            }
+
+            const size_t n_pixels = static_cast<size_t>(width) * height;
+            alignas(64) float px[tile_size], py[tile_size];
+            alignas(64) float color_pixel[3][tile_size], grad_color_pixel[3][tile_size], grad_alpha_common[tile_size];
+            alignas(64) float color_after[3][tile_size], transmittance[tile_size];
+            alignas(64) uint32_t last_contributor[tile_size];
+            for (int p = 0; p < tile_size; ++p) {
+                const uint32_t x = tile_x * config::tile_width + p % config::tile_width;
+                const uint32_t y = tile_y * config::tile_height + p / config::tile_width;
+                px[p] = static_cast<float>(x) + 0.5f;
+                py[p] = static_cast<float>(y) + 0.5f;
+                const bool inside = x < static_cast<uint32_t>(width) && y < static_cast<uint32_t>(height);
+                const size_t pixel_idx = inside ? static_cast<size_t>(width) * y + x : 0;
+                for (int ch = 0; ch < 3; ++ch) {
+                    color_pixel[ch][p] = inside ? image[pixel_idx + ch * n_pixels] : 0.0f;
+                    grad_color_pixel[ch][p] = inside ? grad_image[pixel_idx + ch * n_pixels] : 0.0f;
+                }
+                grad_alpha_common[p] = inside ? grad_alpha_map[pixel_idx] * (1.0f - alpha_map[pixel_idx]) : 0.0f;
+                last_contributor[p] = inside ? tiles.n_contributions[static_cast<size_t>(tile_idx) * tile_size + p] : 0;
+            }
+
+            for (uint32_t k = 0; k < max_n_contributions; ++k) {
+                if (k % bucket_size == 0) {
+                    const float* checkpoint = buckets.color_transmittance + (static_cast<size_t>(bucket_begin) + k / bucket_size) * tile_size * 4;
+                    for (int p = 0; p < tile_size; ++p) {
+                        for (int ch = 0; ch < 3; ++ch) {
+                            color_after[ch][p] = color_pixel[ch][p] - checkpoint[4 * p + ch];
+                        }
+                        transmittance[p] = checkpoint[4 * p + 3];
+                    }
+                }
+
+                const uint32_t primitive_idx = instances.primitive_indices[begin + k];
+                const float mx = primitives.mean2d[2 * primitive_idx];
+                const float my = primitives.mean2d[2 * primitive_idx + 1];
+                const float* co = primitives.conic_opacity + 4 * primitive_idx;
+                float color[3], color_grad_factor[3];
+                for (int ch = 0; ch < 3; ++ch) {
+                    const float unclamped = primitives.color[3 * primitive_idx + ch];
+                    color[ch] = std::max(unclamped, 0.0f);
+                    color_grad_factor[ch] = unclamped >= 0.0f ? 1.0f : 0.0f;
+                }
+
+                // Per-lane partial sums, reduced once per instance
+                alignas(64) float acc[n_instance_grads][config::tile_width] = {};
+                for (int row = 0; row < config::tile_height; ++row) {
+                    for (int lane = 0; lane < config::tile_width; ++lane) {
+                        const int p = row * config::tile_width + lane;
+                        const float dx = mx - px[p];
+                        const float dy = my - py[p];
+                        const float sigma_over_2 = 0.5f * (co[0] * dx * dx + co[2] * dy * dy) + co[1] * dx * dy;
+                        const float alpha = std::min(co[3] * std::exp(-sigma_over_2), config::max_fragment_alpha);
+                        const bool valid = k < last_contributor[p] && sigma_over_2 >= 0.0f && alpha >= config::min_alpha_threshold;
+                        const float one_minus_alpha = 1.0f - alpha;
+                        const float t = transmittance[p];
+                        const float blending_weight = t * alpha;
+
+                        float dL_dalpha_from_color = 0.0f;
+                        const float one_minus_alpha_rcp = 1.0f / one_minus_alpha;
+                        for (int ch = 0; ch < 3; ++ch) {
+                            acc[6 + ch][lane] += valid ? blending_weight * grad_color_pixel[ch][p] * color_grad_factor[ch] : 0.0f;
+                            color_after[ch][p] -= valid ? blending_weight * color[ch] : 0.0f;
+                            dL_dalpha_from_color += (t * color[ch] - color_after[ch][p] * one_minus_alpha_rcp) * grad_color_pixel[ch][p];
+                        }
+                        const float dL_dalpha = dL_dalpha_from_color + grad_alpha_common[p] * one_minus_alpha_rcp;
+                        acc[5][lane] += valid ? alpha * dL_dalpha : 0.0f;
+
+                        const float gaussian_grad_helper = -alpha * dL_dalpha;
+                        acc[2][lane] += valid ? 0.5f * gaussian_grad_helper * dx * dx : 0.0f;
+                        acc[3][lane] += valid ? 0.5f * gaussian_grad_helper * dx * dy : 0.0f;
+                        acc[4][lane] += valid ? 0.5f * gaussian_grad_helper * dy * dy : 0.0f;
+                        acc[0][lane] += valid ? gaussian_grad_helper * (co[0] * dx + co[1] * dy) : 0.0f;
+                        acc[1][lane] += valid ? gaussian_grad_helper * (co[1] * dx + co[2] * dy) : 0.0f;
+
+                        transmittance[p] = valid ? t * one_minus_alpha : t;
+                    }
+                }
+
+                float* slot = instance_grads + static_cast<size_t>(begin + k) * n_instance_grads;
+                for (int i = 0; i < n_instance_grads; ++i) {
+                    float sum = 0.0f;
+                    for (int lane = 0; lane < config::tile_width; ++lane) {
+                        sum += acc[i][lane];
+                    }
+                    slot[i] = sum;
+                }
+            }
+        }
+
+        struct PreprocessGrads {
+            float* means;
+            float* scales_raw;
+            float* rotations_raw;
+            float* sh0;
+            float* sh_rest;
+        };
+
+        // Port of preprocess_backward_cu; returns dL/dmean3d in camera space for the w2c gradient
+        std::array<float, 3> preprocess_backward(uint32_t idx, const Camera& cam,
+                                                 const float* means, const float* scales_raw, const float* rotations_raw,
+                                                 const float* sh_rest, int active_sh_bases, int total_bases_sh_rest,
+                                                 const float* dL_dmean2d, const float* dL_dconic, const float* grad_color,
+                                                 PreprocessGrads& grads) {
+            const float* mean3d = means + 3 * idx;
+            const size_t sh_offset = static_cast<size_t>(idx) * total_bases_sh_rest * 3;
+            const auto dL_dmean3d_from_color = convert_sh_to_color_backward(
+                sh_rest + sh_offset, grad_color, grads.sh0 + 3 * idx, grads.sh_rest + sh_offset,
+                mean3d, cam, active_sh_bases);
+
+            const float depth = camera_row(cam, 2, mean3d);
+            const Covariance cov = compute_covariance(scales_raw + 3 * idx, rotations_raw + 4 * idx);
+            const Splat s = compute_splat(cam, mean3d, depth, cov);
+            const auto& w2c = cam.w2c;
+
+            // 2d covariance gradient
+            const float a = s.a, b = s.b, c = s.c;
+            const float aa = a * a, bb = b * b, cc = c * c;
+            const float ac = a * c, ab = a * b, bc = b * c;
+            const float determinant_rcp = 1.0f / (ac - bb);
+            const float determinant_rcp_sq = determinant_rcp * determinant_rcp;
+            const float dL_dcov2d[3] = {
+                determinant_rcp_sq * (2.0f * bc * dL_dconic[1] - cc * dL_dconic[0] - bb * dL_dconic[2]),
+                determinant_rcp_sq * (bc * dL_dconic[0] - (ac + bb) * dL_dconic[1] + ab * dL_dconic[2]),
+                determinant_rcp_sq * (2.0f * ab * dL_dconic[1] - bb * dL_dconic[0] - aa * dL_dconic[2])};
+
+            // 3d covariance gradient
+            const float* j1 = s.jw_r1;
+            const float* j2 = s.jw_r2;
+            const auto dcov3d = [&](int u, int v) {
+                const float cross = u == v ? 2.0f * (j1[u] * j2[u]) : (j1[u] * j2[v] + j1[v] * j2[u]);
+                return (j1[u] * j1[v]) * dL_dcov2d[0] + cross * dL_dcov2d[1] + (j2[u] * j2[v]) * dL_dcov2d[2];
+            };
+            const float d11 = dcov3d(0, 0), d12 = dcov3d(0, 1), d13 = dcov3d(0, 2);
+            const float d22 = dcov3d(1, 1), d23 = dcov3d(1, 2), d33 = dcov3d(2, 2);
+
+            // gradient of J * W
+            float dL_djw_r1[3], dL_djw_r2[3];
+            for (int k = 0; k < 3; ++k) {
+                dL_djw_r1[k] = 2.0f * (s.jwc_r1[k] * dL_dcov2d[0] + s.jwc_r2[k] * dL_dcov2d[1]);
+                dL_djw_r2[k] = 2.0f * (s.jwc_r1[k] * dL_dcov2d[1] + s.jwc_r2[k] * dL_dcov2d[2]);
+            }
+
+            // gradient of non-zero entries in J
+            const float dL_dj11 = w2c[0][0] * dL_djw_r1[0] + w2c[0][1] * dL_djw_r1[1] + w2c[0][2] * dL_djw_r1[2];
+            const float dL_dj22 = w2c[1][0] * dL_djw_r2[0] + w2c[1][1] * dL_djw_r2[1] + w2c[1][2] * dL_djw_r2[2];
+            const float dL_dj13 = w2c[2][0] * dL_djw_r1[0] + w2c[2][1] * dL_djw_r1[1] + w2c[2][2] * dL_djw_r1[2];
+            const float dL_dj23 = w2c[2][0] * dL_djw_r2[0] + w2c[2][1] * dL_djw_r2[1] + w2c[2][2] * dL_djw_r2[2];
+
+            // mean3d camera space gradient from J and mean2d
+            const float djwr1_dz_helper = dL_dj11 - 2.0f * s.tx * dL_dj13;
+            const float djwr2_dz_helper = dL_dj22 - 2.0f * s.ty * dL_dj23;
+            const std::array<float, 3> dL_dmean3d_cam = {
+                s.j11 * (dL_dmean2d[0] - dL_dj13 / depth),
+                s.j22 * (dL_dmean2d[1] - dL_dj23 / depth),
+                -s.j11 * (s.x * dL_dmean2d[0] + djwr1_dz_helper / depth) - s.j22 * (s.y * dL_dmean2d[1] + djwr2_dz_helper / depth)};
+
+            // total 3d mean gradient
+            for (int k = 0; k < 3; ++k) {
+                grads.means[3 * idx + k] = w2c[0][k] * dL_dmean3d_cam[0] + w2c[1][k] * dL_dmean3d_cam[1] +
+                                           w2c[2][k] * dL_dmean3d_cam[2] + dL_dmean3d_from_color[k];
+            }
+
+            // raw scale gradient
+            const auto& R = cov.rotation;
+            for (int k = 0; k < 3; ++k) {
+                const float dL_dvariance = R[0][k] * R[0][k] * d11 + R[1][k] * R[1][k] * d22 + R[2][k] * R[2][k] * d33 +
+                                           2.0f * (R[0][k] * R[1][k] * d12 + R[0][k] * R[2][k] * d13 + R[1][k] * R[2][k] * d23);
+                grads.scales_raw[3 * idx + k] = 2.0f * cov.variance[k] * dL_dvariance;
+            }
+
+            // raw rotation gradient
+            const auto& RS = cov.rotation_scaled;
+            const float dcov[3][3] = {{d11, d12, d13}, {d12, d22, d23}, {d13, d23, d33}};
+            float dL_drotation[3][3];
+            for (int row = 0; row < 3; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    dL_drotation[row][col] = 2.0f * (RS[0][col] * dcov[0][row] + RS[1][col] * dcov[1][row] + RS[2][col] * dcov[2][row]);
+                }
+            }
+            const float dL_dqxx = -dL_drotation[1][1] - dL_drotation[2][2];
+            const float dL_dqyy = -dL_drotation[0][0] - dL_drotation[2][2];
+            const float dL_dqzz = -dL_drotation[0][0] - dL_drotation[1][1];
+            const float dL_dqxy = dL_drotation[0][1] + dL_drotation[1][0];
+            const float dL_dqxz = dL_drotation[0][2] + dL_drotation[2][0];
+            const float dL_dqyz = dL_drotation[1][2] + dL_drotation[2][1];
+            const float dL_dqrx = dL_drotation[2][1] - dL_drotation[1][2];
+            const float dL_dqry = dL_drotation[0][2] - dL_drotation[2][0];
+            const float dL_dqrz = dL_drotation[1][0] - dL_drotation[0][1];
+            const float dL_dq_norm_helper = cov.qxx * dL_dqxx + cov.qyy * dL_dqyy + cov.qzz * dL_dqzz +
+                                            cov.qxy * dL_dqxy + cov.qxz * dL_dqxz + cov.qyz * dL_dqyz +
+                                            cov.qrx * dL_dqrx + cov.qry * dL_dqry + cov.qrz * dL_dqrz;
+            const float qr = cov.q[0], qx = cov.q[1], qy = cov.q[2], qz = cov.q[3];
+            const float factor = 2.0f / cov.q_norm_sq;
+            float* grad_rotation = grads.rotations_raw + 4 * idx;
+            grad_rotation[0] = factor * (qx * dL_dqrx + qy * dL_dqry + qz * dL_dqrz - qr * dL_dq_norm_helper);
+            grad_rotation[1] = factor * (2.0f * qx * dL_dqxx + qy * dL_dqxy + qz * dL_dqxz + qr * dL_dqrx - qx * dL_dq_norm_helper);
+            grad_rotation[2] = factor * (2.0f * qy * dL_dqyy + qx * dL_dqxy + qz * dL_dqyz + qr * dL_dqry - qy * dL_dq_norm_helper);
+            grad_rotation[3] = factor * (2.0f * qz * dL_dqzz + qx * dL_dqxz + qy * dL_dqyz + qr * dL_dqrz - qz * dL_dq_norm_helper);
+
+            return dL_dmean3d_cam;
+        }
+
+        const float* float_data(const torch::Tensor& tensor) {
+            return tensor.data_ptr<float>();
+        }
+
+        torch::Tensor contiguous_cpu(const torch::Tensor& tensor, const char* name) {
+            if (!tensor.device().is_cpu() || tensor.scalar_type() != torch::kFloat) {
+                throw std::runtime_error(std::string("Input tensor '") + name + "' must be a CPU float tensor.");
+            }
+            return tensor.detach().contiguous();
+        }
+    } // namespace
+
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, int, int, int, int, int>
+    forward_wrapper_cpu(
+        const torch::Tensor& means,
+        const torch::Tensor& scales_raw,
+        const torch::Tensor& rotations_raw,
+        const torch::Tensor& opacities_raw,
+        const torch::Tensor& sh_coefficients_0,
+        const torch::Tensor& sh_coefficients_rest,
+        const torch::Tensor& w2c,
+        const torch::Tensor& cam_position,
+        const int active_sh_bases,
+        const int width,
+        const int height,
+        const float focal_x,
+        const float focal_y,
+        const float center_x,
+        const float center_y,
+        const float near_plane,
+        const float far_plane) {
+        const auto means_c = contiguous_cpu(means, "means");
+        const auto scales_c = contiguous_cpu(scales_raw, "scales_raw");
+        const auto rotations_c = contiguous_cpu(rotations_raw, "rotations_raw");
+        const auto opacities_c = contiguous_cpu(opacities_raw, "opacities_raw");
+        const auto sh0_c = contiguous_cpu(sh_coefficients_0, "sh_coefficients_0");
+        // Reduced-precision SH storage is widened once per call; the kernels below stay fp32
+        const auto sh_rest_c = contiguous_cpu(sh_coefficients_rest.to(torch::kFloat), "sh_coefficients_rest");
+
+        const uint32_t n_primitives = static_cast<uint32_t>(means.size(0));
+        const Camera cam = make_camera(w2c, cam_position, width, height, focal_x, focal_y, center_x, center_y);
+        const uint32_t n_tiles = cam.grid_width * cam.grid_height;
+        const PreprocessInputs inputs{
+            float_data(means_c), float_data(scales_c), float_data(rotations_c), float_data(opacities_c),
+            float_data(sh0_c), float_data(sh_rest_c),
+            active_sh_bases, static_cast<int>(sh_coefficients_rest.size(1)), near_plane, far_plane};
+
+        const auto float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCPU);
+        torch::Tensor image = torch::empty({3, height, width}, float_options);
+        torch::Tensor alpha = torch::empty({1, height, width}, float_options);
+        torch::Tensor per_primitive_buffers, per_tile_buffers, per_instance_buffers, per_bucket_buffers;
+
+        char* primitive_blob = allocate(per_primitive_buffers, required<PrimitiveBuffers>(n_primitives));
+        PrimitiveBuffers primitives = PrimitiveBuffers::from_blob(primitive_blob, n_primitives);
+        std::vector<std::array<uint32_t, 4>> screen_bounds(n_primitives);
+        std::vector<float> depths(n_primitives);
+
+        // Preprocess
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, n_primitives, 1024), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t i = range.begin(); i != range.end(); ++i) {
+                primitives.n_touched_tiles[i] = preprocess(inputs, cam, i, primitives, screen_bounds[i], depths[i]);
+            }
+        });
+
+        // Depth ordering. The index in the low bits makes every key unique, so the result
+        // is deterministic and equals a stable sort of the depth keys.
+        std::vector<uint64_t> depth_keys;
+        depth_keys.reserve(n_primitives);
+        for (uint32_t i = 0; i < n_primitives; ++i) {
+            if (primitives.n_touched_tiles[i] > 0) {
+                depth_keys.push_back(static_cast<uint64_t>(std::bit_cast<uint32_t>(depths[i])) << 32 | i);
+            }
+        }
+        tbb::parallel_sort(depth_keys.begin(), depth_keys.end());
+        const uint32_t n_visible_primitives = static_cast<uint32_t>(depth_keys.size());
+
+        uint32_t n_instances = 0;
+        for (const uint64_t key : depth_keys) {
+            const uint32_t idx = static_cast<uint32_t>(key);
+            primitives.offset[idx] = n_instances;
+            n_instances += primitives.n_touched_tiles[idx];
+        }
+
+        // Instances in depth-major order
+        std::vector<uint32_t> instance_tiles(n_instances);
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, n_visible_primitives, 1024), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t v = range.begin(); v != range.end(); ++v) {
+                const uint32_t idx = static_cast<uint32_t>(depth_keys[v]);
+                const auto& bounds = screen_bounds[idx];
+                const float* conic = primitives.conic_opacity + 4 * idx;
+                const float power_threshold = std::log(conic[3] * config::min_alpha_threshold_rcp);
+                const float mean_x = primitives.mean2d[2 * idx] - 0.5f;
+                const float mean_y = primitives.mean2d[2 * idx + 1] - 0.5f;
+                uint32_t write = primitives.offset[idx];
+                for (uint32_t tile_y = bounds[2]; tile_y < bounds[3]; ++tile_y) {
+                    for (uint32_t tile_x = bounds[0]; tile_x < bounds[1]; ++tile_x) {
+                        if (will_primitive_contribute(mean_x, mean_y, conic, tile_x, tile_y, power_threshold)) {
+                            instance_tiles[write++] = tile_y * cam.grid_width + tile_x;
+                        }
+                    }
+                }
+            }
+        });
+
+        // Stable counting sort by tile keeps the depth order within each tile
+        char* tile_blob = allocate(per_tile_buffers, required<TileBuffers>(n_tiles));
+        TileBuffers tiles = TileBuffers::from_blob(tile_blob, n_tiles);
+        char* instance_blob = allocate(per_instance_buffers, required<InstanceBuffers>(n_instances));
+        InstanceBuffers instances = InstanceBuffers::from_blob(instance_blob, n_instances);
+
+        std::vector<uint32_t> tile_cursor(n_tiles, 0);
+        for (const uint32_t tile : instance_tiles) {
+            ++tile_cursor[tile];
+        }
+        uint32_t n_buckets = 0;
+        for (uint32_t t = 0, start = 0; t < n_tiles; ++t) {
+            const uint32_t count = tile_cursor[t];
+            tiles.instance_ranges[2 * t] = start;
+            tiles.instance_ranges[2 * t + 1] = start + count;
+            tile_cursor[t] = start;
+            start += count;
+            n_buckets += (count + bucket_size - 1) / bucket_size;
+            tiles.bucket_offsets[t] = n_buckets;
+        }
+        for (uint32_t v = 0; v < n_visible_primitives; ++v) {
+            const uint32_t idx = static_cast<uint32_t>(depth_keys[v]);
+            const uint32_t first = primitives.offset[idx];
+            for (uint32_t k = first; k < first + primitives.n_touched_tiles[idx]; ++k) {
+                const uint32_t position = tile_cursor[instance_tiles[k]]++;
+                instances.primitive_indices[position] = idx;
+                instances.tile_order[k] = position;
+            }
+        }
+
+        // Blend
+        char* bucket_blob = allocate(per_bucket_buffers, required<BucketBuffers>(n_buckets));
+        BucketBuffers buckets = BucketBuffers::from_blob(bucket_blob, n_buckets);
+        float* image_data = image.data_ptr<float>();
+        float* alpha_data = alpha.data_ptr<float>();
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, n_tiles), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t t = range.begin(); t != range.end(); ++t) {
+                blend_tile(t, cam, width, height, primitives, tiles, instances, buckets, image_data, alpha_data);
+            }
+        });
+
+        return {
+            image, alpha,
+            per_primitive_buffers, per_tile_buffers, per_instance_buffers, per_bucket_buffers,
+            static_cast<int>(n_visible_primitives), static_cast<int>(n_instances), static_cast<int>(n_buckets),
+            0, 0};
+    }
+
+    std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+    backward_wrapper_cpu(
+        torch::Tensor& densification_info,
+        const torch::Tensor& grad_image,
+        const torch::Tensor& grad_alpha,
+        const torch::Tensor& image,
+        const torch::Tensor& alpha,
+        const torch::Tensor& means,
+        const torch::Tensor& scales_raw,
+        const torch::Tensor& rotations_raw,
+        const torch::Tensor& sh_coefficients_rest,
+        const torch::Tensor& per_primitive_buffers,
+        const torch::Tensor& per_tile_buffers,
+        const torch::Tensor& per_instance_buffers,
+        const torch::Tensor& per_bucket_buffers,
+        const torch::Tensor& w2c,
+        const torch::Tensor& cam_position,
+        const int active_sh_bases,
+        const int width,
+        const int height,
+        const float focal_x,
+        const float focal_y,
+        const float center_x,
+        const float center_y,
+        const int /*n_visible_primitives*/,
+        const int n_instances,
+        const int n_buckets) {
+        const auto means_c = contiguous_cpu(means, "means");
+        const auto scales_c = contiguous_cpu(scales_raw, "scales_raw");
+        const auto rotations_c = contiguous_cpu(rotations_raw, "rotations_raw");
+        const auto sh_rest_c = contiguous_cpu(sh_coefficients_rest.to(torch::kFloat), "sh_coefficients_rest");
+        const auto grad_image_c = contiguous_cpu(grad_image, "grad_image");
+        const auto grad_alpha_c = contiguous_cpu(grad_alpha, "grad_alpha");
+
+        const uint32_t n_primitives = static_cast<uint32_t>(means.size(0));
+        const int total_bases_sh_rest = static_cast<int>(sh_coefficients_rest.size(1));
+        const Camera cam = make_camera(w2c, cam_position, width, height, focal_x, focal_y, center_x, center_y);
+        const uint32_t n_tiles = cam.grid_width * cam.grid_height;
+
+        const auto float_options = torch::TensorOptions().dtype(torch::kFloat).device(torch::kCPU);
+        torch::Tensor grad_means = torch::zeros({n_primitives, 3}, float_options);
+        torch::Tensor grad_scales_raw = torch::zeros({n_primitives, 3}, float_options);
+        torch::Tensor grad_rotations_raw = torch::zeros({n_primitives, 4}, float_options);
+        torch::Tensor grad_opacities_raw = torch::zeros({n_primitives, 1}, float_options);
+        torch::Tensor grad_sh_coefficients_0 = torch::zeros({n_primitives, 1, 3}, float_options);
+        torch::Tensor grad_sh_coefficients_rest = torch::zeros({n_primitives, total_bases_sh_rest, 3}, float_options);
+        torch::Tensor grad_w2c = torch::Tensor();
+        if (w2c.requires_grad()) {
+            grad_w2c = torch::zeros_like(w2c, float_options);
+        }
+
+        char* primitive_blob = static_cast<char*>(per_primitive_buffers.data_ptr());
+        const PrimitiveBuffers primitives = PrimitiveBuffers::from_blob(primitive_blob, n_primitives);
+        char* tile_blob = static_cast<char*>(per_tile_buffers.data_ptr());
+        const TileBuffers tiles = TileBuffers::from_blob(tile_blob, n_tiles);
+        char* instance_blob = static_cast<char*>(per_instance_buffers.data_ptr());
+        const InstanceBuffers instances = InstanceBuffers::from_blob(instance_blob, n_instances);
+        char* bucket_blob = static_cast<char*>(per_bucket_buffers.data_ptr());
+        const BucketBuffers buckets = BucketBuffers::from_blob(bucket_blob, n_buckets);
+
+        // Blend backward: every (tile, primitive) instance owns a gradient slot, so tiles
+        // run in parallel without atomics and the result does not depend on scheduling
+        std::vector<float> instance_grads(static_cast<size_t>(n_instances) * n_instance_grads, 0.0f);
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, n_tiles), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t t = range.begin(); t != range.end(); ++t) {
+                blend_backward_tile(t, cam, width, height, primitives, tiles, instances, buckets,
+                                    float_data(image), float_data(alpha),
+                                    float_data(grad_image_c), float_data(grad_alpha_c),
+                                    instance_grads.data());
+            }
+        });
+
+        // Preprocess backward
+        PreprocessGrads grads{
+            grad_means.data_ptr<float>(), grad_scales_raw.data_ptr<float>(), grad_rotations_raw.data_ptr<float>(),
+            grad_sh_coefficients_0.data_ptr<float>(), grad_sh_coefficients_rest.data_ptr<float>()};
+        float* grad_opacities = grad_opacities_raw.data_ptr<float>();
+        float* densification = densification_info.size(0) > 0 ? densification_info.data_ptr<float>() : nullptr;
+        tbb::combinable<std::array<float, 12>> grad_w2c_partials([] { return std::array<float, 12>{}; });
+
+        tbb::parallel_for(tbb::blocked_range<uint32_t>(0, n_primitives, 1024), [&](const tbb::blocked_range<uint32_t>& range) {
+            for (uint32_t i = range.begin(); i != range.end(); ++i) {
+                const uint32_t n_touched = primitives.n_touched_tiles[i];
+                if (n_touched == 0) {
+                    continue;
+                }
+                float sum[n_instance_grads] = {};
+                const uint32_t first = primitives.offset[i];
+                for (uint32_t k = first; k < first + n_touched; ++k) {
+                    const float* slot = instance_grads.data() + static_cast<size_t>(instances.tile_order[k]) * n_instance_grads;
+                    for (int j = 0; j < n_instance_grads; ++j) {
+                        sum[j] += slot[j];
+                    }
+                }
+                grad_opacities[i] = sum[5] * (1.0f - primitives.conic_opacity[4 * i + 3]);
+
+                const auto dL_dmean3d_cam = preprocess_backward(
+                    i, cam, float_data(means_c), float_data(scales_c), float_data(rotations_c),
+                    float_data(sh_rest_c), active_sh_bases, total_bases_sh_rest,
+                    sum, sum + 2, sum + 6, grads);
+
+                if (grad_w2c.defined()) {
+                    auto& partial = grad_w2c_partials.local();
+                    const float* mean3d = float_data(means_c) + 3 * i;
+                    for (int row = 0; row < 3; ++row) {
+                        partial[4 * row] += dL_dmean3d_cam[row] * mean3d[0];
+                        partial[4 * row + 1] += dL_dmean3d_cam[row] * mean3d[1];
+                        partial[4 * row + 2] += dL_dmean3d_cam[row] * mean3d[2];
+                        partial[4 * row + 3] += dL_dmean3d_cam[row];
+                    }
+                }
+
+                if (densification != nullptr) {
+                    densification[i] += 1.0f;
+                    densification[n_primitives + i] += std::hypot(sum[0] * 0.5f * cam.width, sum[1] * 0.5f * cam.height);
+                }
+            }
+        });
+
+        if (grad_w2c.defined()) {
+            const auto total = grad_w2c_partials.combine([](const std::array<float, 12>& a, const std::array<float, 12>& b) {
+                std::array<float, 12> out;
+                for (size_t k = 0; k < out.size(); ++k) {
+                    out[k] = a[k] + b[k];
+                }
+                return out;
+            });
+            float* out = grad_w2c.data_ptr<float>();
+            for (size_t k = 0; k < total.size(); ++k) {
+                out[k] += total[k];
+            }
+        }
+
+        return {grad_means, grad_scales_raw, grad_rotations_raw, grad_opacities_raw, grad_sh_coefficients_0,
+                grad_sh_coefficients_rest.to(sh_coefficients_rest.scalar_type()), grad_w2c};
+    }
+
+    torch::Tensor visible_primitive_indices_cpu(
+        const torch::Tensor& per_primitive_buffers,
+        const int n_primitives) {
+        // Visible primitives are exactly those touching at least one tile
+        char* blob = static_cast<char*>(per_primitive_buffers.data_ptr());
+        const PrimitiveBuffers primitives = PrimitiveBuffers::from_blob(blob, n_primitives);
+        const auto n_touched_tiles = torch::from_blob(primitives.n_touched_tiles, {n_primitives}, torch::kInt32);
+        return n_touched_tiles.nonzero().squeeze(-1);
+    }
+
+} // namespace fast_gs::rasterization
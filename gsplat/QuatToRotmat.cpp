@@ -2,8 +2,11 @@
 #include <ATen/core/Tensor.h>
 #include <c10/cuda/CUDAGuard.h> // for DEVICE_GUARD
 
+#include <ATen/Dispatch.h>
 #include <ATen/Functions.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <cmath>
 
 #include "Common.h"       // where all the macros are defined
 #include "Ops.h"          // a collection of all gsplat operators
@@ -11,9 +14,51 @@
 
 namespace gsplat {
 
+    namespace {
+        // CPU port of quat_to_rotmat_kernel, used when training on the CPU
+        template <typename scalar_t>
+        void quats_to_rotmats_cpu(int64_t N, const scalar_t* quats, scalar_t* rotmats) {
+            at::parallel_for(0, N, 1024, [&](int64_t begin, int64_t end) {
+                for (int64_t idx = begin; idx < end; ++idx) {
+                    const scalar_t* q = quats + idx * 4;
+                    float w = q[0], x = q[1], y = q[2], z = q[3];
+                    const float inv_norm = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+                    x *= inv_norm;
+                    y *= inv_norm;
+                    z *= inv_norm;
+                    w *= inv_norm;
+                    const float x2 = x * x, y2 = y * y, z2 = z * z;
+                    const float xy = x * y, xz = x * z, yz = y * z;
+                    const float wx = w * x, wy = w * y, wz = w * z;
+
+                    // Row-major, matching the layout written by the kernel
+                    scalar_t* r = rotmats + idx * 9;
+                    r[0] = 1.f - 2.f * (y2 + z2);
+                    r[1] = 2.f * (xy - wz);
+                    r[2] = 2.f * (xz + wy);
+                    r[3] = 2.f * (xy + wz);
+                    r[4] = 1.f - 2.f * (x2 + z2);
+                    r[5] = 2.f * (yz - wx);
+                    r[6] = 2.f * (xz - wy);
+                    r[7] = 2.f * (yz + wx);
+                    r[8] = 1.f - 2.f * (x2 + y2);
+                }
+            });
+        }
+    } // namespace
+
     at::Tensor quats_to_rotmats(
         const at::Tensor quats // [N, 4]
     ) {
+        if (quats.is_cpu()) {
+            CHECK_CONTIGUOUS(quats);
+            at::Tensor rotmats = at::empty({quats.size(0), 3, 3}, quats.options());
+            AT_DISPATCH_FLOATING_TYPES(quats.scalar_type(), "quats_to_rotmats_cpu", [&]() {
+                quats_to_rotmats_cpu<scalar_t>(quats.size(0), quats.data_ptr<scalar_t>(), rotmats.data_ptr<scalar_t>());
+            });
+            return rotmats;
+        }
+
         DEVICE_GUARD(quats);
         CHECK_INPUT(quats);
 
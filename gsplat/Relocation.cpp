@@ -3,8 +3,11 @@
 #include <c10/cuda/CUDAGuard.h> // for DEVICE_GUARD
 #include <tuple>
 
+#include <ATen/Dispatch.h>
 #include <ATen/Functions.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <cmath>
 
 #include "Common.h"     // where all the macros are defined
 #include "Ops.h"        // a collection of all gsplat operators
@@ -12,12 +15,113 @@
 
 namespace gsplat {
 
+    namespace {
+        // CPU ports of the kernels in RelocationCUDA.cu, used when training on the CPU
+
+        template <typename scalar_t>
+        void relocation_cpu(
+            int64_t N,
+            const scalar_t* opacities,
+            const scalar_t* scales,
+            const int* ratios,
+            const scalar_t* binoms,
+            int n_max,
+            scalar_t* new_opacities,
+            scalar_t* new_scales) {
+            at::parallel_for(0, N, 1024, [&](int64_t begin, int64_t end) {
+                for (int64_t idx = begin; idx < end; ++idx) {
+                    const int n_idx = ratios[idx];
+                    float denom_sum = 0.0f;
+
+                    new_opacities[idx] = 1.0f - std::pow(1.0f - static_cast<float>(opacities[idx]), 1.0f / n_idx);
+
+                    for (int i = 1; i <= n_idx; ++i) {
+                        for (int k = 0; k <= (i - 1); ++k) {
+                            const float bin_coeff = binoms[(i - 1) * n_max + k];
+                            const float term = (std::pow(-1.0f, k) / std::sqrt(static_cast<float>(k + 1))) *
+                                               std::pow(static_cast<float>(new_opacities[idx]), k + 1);
+                            denom_sum += (bin_coeff * term);
+                        }
+                    }
+                    const float coeff = (opacities[idx] / denom_sum);
+                    for (int i = 0; i < 3; ++i)
+                        new_scales[idx * 3 + i] = coeff * scales[idx * 3 + i];
+                }
+            });
+        }
+
+        template <typename scalar_t>
+        void add_noise_cpu(
+            int64_t N,
+            const scalar_t* raw_opacities,
+            const scalar_t* raw_scales,
+            const scalar_t* raw_quats,
+            const scalar_t* noise,
+            scalar_t* means,
+            float current_lr) {
+            at::parallel_for(0, N, 1024, [&](int64_t begin, int64_t end) {
+                for (int64_t idx = begin; idx < end; ++idx) {
+                    const scalar_t* q = raw_quats + 4 * idx;
+                    float w = q[0], x = q[1], y = q[2], z = q[3];
+                    const float inv_norm = std::fmin(1.0f / std::sqrt(x * x + y * y + z * z + w * w), 1e+12f);
+                    x *= inv_norm;
+                    y *= inv_norm;
+                    z *= inv_norm;
+                    w *= inv_norm;
+                    // Row-major rotation matrix
+                    const float R[3][3] = {
+                        {1.f - 2.f * (y * y + z * z), 2.f * (x * y - w * z), 2.f * (x * z + w * y)},
+                        {2.f * (x * y + w * z), 1.f - 2.f * (x * x + z * z), 2.f * (y * z - w * x)},
+                        {2.f * (x * z - w * y), 2.f * (y * z + w * x), 1.f - 2.f * (x * x + y * y)}};
+                    const float s2[3] = {std::exp(2.f * static_cast<float>(raw_scales[3 * idx])),
+                                         std::exp(2.f * static_cast<float>(raw_scales[3 * idx + 1])),
+                                         std::exp(2.f * static_cast<float>(raw_scales[3 * idx + 2]))};
+
+                    // covariance * noise = R * S^2 * R^T * noise
+                    float rt_noise[3];
+                    for (int j = 0; j < 3; ++j) {
+                        rt_noise[j] = s2[j] * (R[0][j] * noise[3 * idx] + R[1][j] * noise[3 * idx + 1] + R[2][j] * noise[3 * idx + 2]);
+                    }
+
+                    const float opacity = 1.f / (1.f + std::exp(-static_cast<float>(raw_opacities[idx])));
+                    const float op_sigmoid = 1.f / (1.f + std::exp(100.f * opacity - 0.5f));
+                    const float noise_factor = current_lr * op_sigmoid;
+
+                    for (int i = 0; i < 3; ++i) {
+                        means[3 * idx + i] += noise_factor * (R[i][0] * rt_noise[0] + R[i][1] * rt_noise[1] + R[i][2] * rt_noise[2]);
+                    }
+                }
+            });
+        }
+    } // namespace
+
     std::tuple<at::Tensor, at::Tensor> relocation(
         at::Tensor opacities, // [N]
         at::Tensor scales,    // [N, 3]
         at::Tensor ratios,    // [N]
         at::Tensor binoms,    // [n_max, n_max]
         const int n_max) {
+        if (opacities.is_cpu()) {
+            CHECK_CONTIGUOUS(opacities);
+            CHECK_CONTIGUOUS(scales);
+            CHECK_CONTIGUOUS(ratios);
+            CHECK_CONTIGUOUS(binoms);
+            at::Tensor new_opacities = at::empty_like(opacities);
+            at::Tensor new_scales = at::empty_like(scales);
+            AT_DISPATCH_FLOATING_TYPES(opacities.scalar_type(), "relocation_cpu", [&]() {
+                relocation_cpu<scalar_t>(
+                    opacities.size(0),
+                    opacities.data_ptr<scalar_t>(),
+                    scales.data_ptr<scalar_t>(),
+                    ratios.data_ptr<int>(),
+                    binoms.data_ptr<scalar_t>(),
+                    n_max,
+                    new_opacities.data_ptr<scalar_t>(),
+                    new_scales.data_ptr<scalar_t>());
+            });
+            return std::make_tuple(new_opacities, new_scales);
+        }
+
         DEVICE_GUARD(opacities);
         CHECK_INPUT(opacities);
         CHECK_INPUT(scales);
@@ -38,6 +142,25 @@ namespace gsplat {
         at::Tensor noise,         // [N, 3]
         at::Tensor means,         // [N, 3]
         const float current_lr) {
+        if (raw_opacities.is_cpu()) {
+            CHECK_CONTIGUOUS(raw_opacities);
+            CHECK_CONTIGUOUS(raw_scales);
+            CHECK_CONTIGUOUS(raw_quats);
+            CHECK_CONTIGUOUS(noise);
+            CHECK_CONTIGUOUS(means);
+            AT_DISPATCH_FLOATING_TYPES(raw_opacities.scalar_type(), "add_noise_cpu", [&]() {
+                add_noise_cpu<scalar_t>(
+                    raw_opacities.size(0),
+                    raw_opacities.data_ptr<scalar_t>(),
+                    raw_scales.data_ptr<scalar_t>(),
+                    raw_quats.data_ptr<scalar_t>(),
+                    noise.data_ptr<scalar_t>(),
+                    means.data_ptr<scalar_t>(),
+                    current_lr);
+            });
+            return;
+        }
+
         DEVICE_GUARD(raw_opacities);
         CHECK_INPUT(raw_opacities);
         CHECK_INPUT(raw_scales);
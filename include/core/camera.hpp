@@ -8,11 +8,15 @@
 #include <c10/cuda/CUDAStream.h>
 #include <filesystem>
 #include <future>
+#include <optional>
 #include <string>
 #include <torch/torch.h>
 
 namespace gs {
 
+    class DiskImageCache;
+    class ImageCache;
+
     class Camera {
     public:
         Camera() = default;
@@ -42,9 +46,21 @@ namespace gs {
         // Load image from disk and return it
         torch::Tensor load_and_get_image(int resize_factor = -1);
 
+        // Return image from the decoded-image cache, decoding it on a miss
+        torch::Tensor load_and_get_image(ImageCache& cache, int resize_factor = -1);
+
+        // Return image mapped from the on-disk decoded-image cache, decoding it on a miss
+        torch::Tensor load_and_get_image(const DiskImageCache& cache, int resize_factor = -1);
+
         // Load image from disk just to populate _image_width/_image_height
         void load_image_size(int resize_factor = -1);
 
+        // Record the size of an image that was decoded elsewhere (e.g. by a prefetcher)
+        void set_image_size(int width, int height) {
+            _image_width = width;
+            _image_height = height;
+        }
+
         // Get number of bytes in the image file
         size_t get_num_bytes_from_file() const;
 
@@ -80,6 +96,9 @@ namespace gs {
         float FoVy() const noexcept { return _FoVy; }
 
     private:
+        // Upload a decoded image as a uint8 [H, W, C] tensor on the training device
+        torch::Tensor upload_image(const unsigned char* data, int w, int h, int c, bool pinned);
+
         // IDs
         float _FoVx = 0.f;
         float _FoVy = 0.f;
@@ -109,8 +128,8 @@ namespace gs {
         torch::Tensor _world_view_transform;
         torch::Tensor _cam_position;
 
-        // CUDA stream for async operations
-        at::cuda::CUDAStream _stream = at::cuda::getStreamFromPool(false);
+        // CUDA stream for async operations, created on the first upload to a CUDA device
+        std::optional<at::cuda::CUDAStream> _stream;
     };
     inline float focal2fov(float focal, int pixels) {
         return 2.0f * std::atan(pixels / (2.0f * focal));
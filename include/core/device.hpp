@@ -0,0 +1,31 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <expected>
+#include <string>
+#include <torch/torch.h>
+
+namespace gs {
+
+    // Device that model parameters, camera poses and ground truth images live on.
+    // Defaults to CUDA. It is selected once with --device before the dataset is loaded;
+    // everything downstream follows the device of the tensors it is given.
+    torch::Device training_device();
+
+    void set_training_device(const torch::Device& device);
+
+    inline bool training_on_cuda() { return training_device().is_cuda(); }
+
+    // Makes the training device the current CUDA device of the calling thread. CUDA keeps the
+    // current device per thread, so each thread that allocates or launches for training calls
+    // this before its first CUDA call. Does nothing when training on the CPU.
+    void bind_training_device();
+
+    // Parses a --device value ("cuda", "cuda:N" or "cpu") and checks that it is usable.
+    // "cuda" resolves to cuda:0.
+    std::expected<torch::Device, std::string> parse_training_device(const std::string& name);
+
+} // namespace gs
@@ -0,0 +1,74 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace gs {
+
+    // Read-only memory mapping of a decoded uint8 HWC image stored by DiskImageCache
+    class MappedImage {
+    public:
+        MappedImage() = default;
+        ~MappedImage();
+
+        MappedImage(const MappedImage&) = delete;
+        MappedImage& operator=(const MappedImage&) = delete;
+        MappedImage(MappedImage&& other) noexcept;
+        MappedImage& operator=(MappedImage&& other) noexcept;
+
+        const unsigned char* data() const noexcept { return _pixels; }
+        int width() const noexcept { return _width; }
+        int height() const noexcept { return _height; }
+        int channels() const noexcept { return _channels; }
+        size_t num_bytes() const noexcept { return static_cast<size_t>(_width) * _height * _channels; }
+
+    private:
+        friend class DiskImageCache;
+
+        void unmap();
+
+        void* _mapping = nullptr;
+        size_t _mapping_size = 0;
+        const unsigned char* _pixels = nullptr;
+        int _width = 0;
+        int _height = 0;
+        int _channels = 0;
+#ifdef _WIN32
+        void* _file_handle = nullptr;
+        void* _mapping_handle = nullptr;
+#endif
+    };
+
+    // Persistent cache of decoded (and downscaled) images.
+    // Each entry is a raw pixel file named after the source path and resize factor;
+    // its header records the source mtime and size so stale entries are re-decoded.
+    class DiskImageCache {
+    public:
+        explicit DiskImageCache(std::filesystem::path root);
+
+        // Maps the cached pixels of source at resize_factor, or nullopt on a miss / stale entry
+        std::optional<MappedImage> find(const std::filesystem::path& source, int resize_factor) const;
+
+        // Writes an entry atomically; returns false if the cache directory is not writable
+        bool store(const std::filesystem::path& source, int resize_factor,
+                   const unsigned char* data, int width, int height, int channels) const;
+
+        // Maps the entry, decoding with load_image and storing it first on a miss.
+        // Returns nullopt only if the entry could not be written.
+        std::optional<MappedImage> load(const std::filesystem::path& source, int resize_factor) const;
+
+        std::filesystem::path entry_path(const std::filesystem::path& source, int resize_factor) const;
+
+        const std::filesystem::path& root() const noexcept { return _root; }
+
+    private:
+        std::filesystem::path _root;
+    };
+
+} // namespace gs
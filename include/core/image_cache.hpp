@@ -0,0 +1,137 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/disk_image_cache.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <torch/torch.h>
+#include <unordered_map>
+#include <vector>
+
+namespace gs {
+
+    class Camera;
+
+    // Decoded uint8 HWC images kept in a single pinned host arena.
+    // The arena is split into equally sized slots (one image per slot) and
+    // slots are recycled least-recently-used once the byte budget is exhausted.
+    // With levels > 1 a slot also holds the image's mip pyramid: level l is the
+    // image box-filtered down by 2^l, built once when the image is decoded.
+    class ImageCache {
+    public:
+        // Read access to a decoded image. The slot cannot be evicted while a
+        // lease on it is alive.
+        class Lease {
+        public:
+            Lease() = default;
+            ~Lease();
+
+            Lease(const Lease&) = delete;
+            Lease& operator=(const Lease&) = delete;
+            Lease(Lease&& other) noexcept;
+            Lease& operator=(Lease&& other) noexcept;
+
+            const unsigned char* data() const noexcept { return _data; }
+            int width() const noexcept { return _width; }
+            int height() const noexcept { return _height; }
+            int channels() const noexcept { return _channels; }
+
+            // True when the pixels live in the (pinned) arena
+            bool cached() const noexcept { return _cache != nullptr; }
+
+        private:
+            friend class ImageCache;
+
+            void release();
+
+            ImageCache* _cache = nullptr;
+            size_t _slot = 0;
+            const unsigned char* _data = nullptr;
+            unsigned char* _owned = nullptr; // decode that did not fit into a slot
+            MappedImage _mapped;             // disk cache entry that did not fit into a slot
+            int _width = 0;
+            int _height = 0;
+            int _channels = 0;
+        };
+
+        struct Stats {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+            size_t uncached = 0;
+        };
+
+        // slot_bytes must hold the largest decoded pyramid; byte_budget == 0 means one slot per image
+        ImageCache(size_t slot_bytes, size_t num_images, size_t byte_budget, int levels = 1);
+
+        ImageCache(const ImageCache&) = delete;
+        ImageCache& operator=(const ImageCache&) = delete;
+
+        // Builds a cache sized for the given cameras decoded at resize_factor with levels pyramid levels
+        static std::shared_ptr<ImageCache> create(const std::vector<std::shared_ptr<Camera>>& cameras,
+                                                  int resize_factor,
+                                                  size_t byte_budget,
+                                                  int levels = 1);
+
+        // Bytes of a pyramid with the given number of levels over a w x h image with c channels
+        static size_t pyramid_bytes(int width, int height, int channels, int levels);
+
+        // Returns pyramid level `level` of the decoded image, decoding it from disk on a miss
+        Lease acquire(int uid, const std::filesystem::path& path, int resize_factor, int level = 0);
+
+        // Read misses from (and write them to) a persistent decoded-image cache
+        void set_disk_cache(std::shared_ptr<DiskImageCache> disk_cache) { _disk_cache = std::move(disk_cache); }
+
+        // Decodes the given cameras in parallel until the arena is full
+        void preload(const std::vector<std::shared_ptr<Camera>>& cameras, int resize_factor);
+
+        size_t capacity() const noexcept { return _slots.size(); }
+        int levels() const noexcept { return _levels; }
+        size_t slot_bytes() const noexcept { return _slot_bytes; }
+        size_t arena_bytes() const noexcept { return _slot_bytes * _slots.size(); }
+        size_t size() const;
+        Stats stats() const;
+
+    private:
+        struct Slot {
+            uint64_t key = 0;
+            bool valid = false;
+            int refs = 0;
+            int width = 0; // Level 0
+            int height = 0;
+            int channels = 0;
+            std::list<size_t>::iterator lru_it;
+        };
+
+        static uint64_t make_key(int uid, int resize_factor) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(uid)) << 32) |
+                   static_cast<uint32_t>(resize_factor);
+        }
+
+        unsigned char* slot_data(size_t slot) {
+            return _arena.data_ptr<uint8_t>() + slot * _slot_bytes;
+        }
+
+        // Lease on a level of a slot; make_lease also takes a reference and marks the slot as used
+        Lease lease_of(size_t slot, int level);
+        Lease make_lease(size_t slot, int level);
+        void unref(size_t slot);
+
+        size_t _slot_bytes;
+        int _levels;
+        torch::Tensor _arena;
+        std::vector<Slot> _slots;
+        std::list<size_t> _lru; // front = most recently used
+        std::unordered_map<uint64_t, size_t> _slot_of;
+        std::shared_ptr<DiskImageCache> _disk_cache;
+        Stats _stats;
+        mutable std::mutex _mutex;
+    };
+
+} // namespace gs
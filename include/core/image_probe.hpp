@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace image_io {
+
+    struct ImageInfo {
+        int width = 0;
+        int height = 0;
+        int channels = 0; // Channels stored in the file (as reported by stbi_info)
+    };
+
+    // Reads image dimensions from the file header without decoding pixels.
+    // JPEG (SOF segment) and PNG (IHDR chunk) are parsed directly and only the
+    // first few hundred bytes are read; other formats fall back to stbi_info.
+    std::expected<ImageInfo, std::string> probe_image(const std::filesystem::path& path);
+
+    // Probes all files in parallel; result i belongs to paths[i]
+    std::vector<std::expected<ImageInfo, std::string>>
+    probe_images(const std::vector<std::filesystem::path>& paths);
+
+} // namespace image_io
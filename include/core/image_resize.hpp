@@ -0,0 +1,26 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <utility>
+
+namespace image_io {
+
+    // Output size for downscaling by factor (truncated, at least 1 pixel)
+    std::pair<int, int> downscaled_size(int width, int height, float factor);
+
+    // Area-filtered (box) downscale of an interleaved uint8 image.
+    // Every output pixel is the average of its exact source footprint, so
+    // integer and fractional factors are both supported. Factors that divide
+    // the image evenly take a SIMD (AVX2 / NEON) block-average path.
+    // Rows are processed in parallel. dst must hold dst_w * dst_h * channels bytes.
+    void downscale(const unsigned char* src, int src_w, int src_h, int channels,
+                   unsigned char* dst, int dst_w, int dst_h);
+
+    // Downscale by factor into a buffer allocated with malloc (release with free_image)
+    unsigned char* downscale(const unsigned char* src, int src_w, int src_h, int channels,
+                             float factor, int& dst_w, int& dst_h);
+
+} // namespace image_io
@@ -0,0 +1,29 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <tuple>
+
+namespace image_io {
+
+    // True when gs_core was built against libjpeg(-turbo)
+    bool has_fast_jpeg();
+
+    // Decodes a JPEG directly at reduced resolution using the scaled IDCT
+    // (1/2, 1/4 or 1/8, whichever is largest without exceeding res_div), then
+    // area-filters any remaining factor. The result has exactly the size
+    // load_image(p, res_div) produces, in a buffer released with free_image.
+    // Returns nullopt for non-JPEG data, color spaces the backend does not
+    // handle (e.g. CMYK), or when built without libjpeg; callers fall back to stb.
+    std::optional<std::tuple<unsigned char*, int, int, int>>
+    decode_jpeg(const unsigned char* data, size_t size, int res_div = -1);
+
+    std::optional<std::tuple<unsigned char*, int, int, int>>
+    decode_jpeg(const std::filesystem::path& path, int res_div = -1);
+
+} // namespace image_io
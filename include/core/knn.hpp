@@ -0,0 +1,48 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace gs {
+
+    // k-nearest-neighbour queries over a fixed set of 3D points.
+    // The KD-tree is built once with all hardware threads; batch queries are
+    // split across the TBB pool, each query walking the shared read-only tree.
+    class KnnIndex {
+    public:
+        // Marks the unused tail of a row when fewer than k points exist
+        static constexpr uint32_t INVALID = std::numeric_limits<uint32_t>::max();
+
+        // points: [num_points, 3] float32, row-major; must outlive the index
+        KnnIndex(const float* points, size_t num_points);
+        ~KnnIndex();
+
+        KnnIndex(const KnnIndex&) = delete;
+        KnnIndex& operator=(const KnnIndex&) = delete;
+
+        size_t size() const noexcept { return _num_points; }
+
+        // The k nearest indexed points of every query, nearest first. Row q of `indices` and
+        // `sq_dists` ([num_queries * k] each) is padded with (INVALID, inf) past size().
+        void query(const float* queries, size_t num_queries, size_t k,
+                   uint32_t* indices, float* sq_dists) const;
+
+        // Mean distance of every indexed point to its k nearest others. Coincident points among
+        // the k + 1 nearest are skipped; `fallback` where none of them is apart from the point
+        std::vector<float> mean_neighbor_distances(size_t k, float fallback) const;
+
+    private:
+        struct Tree;
+
+        size_t _num_points;
+        std::unique_ptr<Tree> _tree;
+    };
+
+} // namespace gs
@@ -33,9 +33,13 @@ namespace gs {
             float init_opacity = 0.5f;
             float init_scaling = 0.1f;
             int num_workers = 16;
+            int prefetch_depth = 8;   // Number of decoded images kept ready ahead of the training step
+            int checkpoint_every = 0; // Write a resumable training checkpoint every N iterations (0 = only on save/stop)
+            int batch_views = 1;      // Views rendered and accumulated into each optimizer step
             int max_cap = 1000000;
             std::vector<size_t> eval_steps = {7'000, 30'000}; // Steps to evaluate the model
             std::vector<size_t> save_steps = {7'000, 30'000}; // Steps to save the model
+            std::vector<size_t> resolution_steps = {};        // Steps at which the training resolution doubles (empty = full resolution)
             bool skip_intermediate_saving = false;            // Skip saving intermediate results and only save final output
             bool bg_modulation = false;                       // Enable sinusoidal background modulation
             bool enable_eval = false;                         // Only evaluate when explicitly enabled
@@ -45,7 +49,15 @@ namespace gs {
             std::string render_mode = "RGB";                  // Render mode: RGB, D, ED, RGB_D, RGB_ED
             std::string strategy = "mcmc";                    // Optimization strategy: mcmc, default.
             bool preload_to_ram = false;                      // If true, the entire dataset will be loaded into RAM at startup
+            size_t preload_budget_mb = 0;                     // RAM budget for preloaded images in MB (0 = hold every image)
             std::string pose_optimization = "none";           // Pose optimization type: none, direct, mlp
+            std::string device = "cuda";                      // Training device: cuda, cuda:N, cpu
+            bool sparse_adam = false;                         // Update only the Gaussians visible in the step's views
+            std::string shn_precision = "fp32";               // Storage type of the higher-degree SH coefficients: fp32, fp16, bf16
+            std::string moment_precision = "fp32";            // Storage type of the Adam moments: fp32, bf16
+            std::string view_sampling = "uniform";            // Training view order: uniform (shuffled epochs), loss (weighted by running loss)
+            float view_sampling_temperature = 0.5f;           // Exponent on the loss estimate for loss sampling (0 = uniform)
+            float view_sampling_floor = 0.2f;                 // Probability mass loss sampling spreads uniformly over all views
 
             // Bilateral grid parameters
             bool use_bilateral_grid = false;
@@ -73,6 +85,11 @@ namespace gs {
             int init_num_pts = 100'000; // Number of random points to initialize
             float init_extent = 3.0f;   // Extent of random point cloud
 
+            // SfM point cloud preprocessing before initialization
+            float init_voxel_size = 0.0f;  // Average the points of every voxel of this edge length (0 = off)
+            int init_max_points = 0;       // Pick the voxel size that keeps about this many points (0 = off)
+            float init_outlier_std = 0.0f; // Drop points with mean neighbour distance above mean + this * std (0 = off)
+
             // SOG format parameters
             bool save_sog = false;   // Save in SOG format alongside PLY
             int sog_iterations = 10; // K-means iterations for SOG compression
@@ -96,6 +113,8 @@ namespace gs {
             int test_every = 8;
             std::vector<std::string> timelapse_images = {};
             int timelapse_every = 50;
+            std::filesystem::path image_cache_dir = ""; // decoded image cache, reused across runs (empty = disabled)
+            bool validate_images = false;               // probe every image header when the dataset is opened
         };
 
         struct TrainingParameters {
@@ -107,6 +126,9 @@ namespace gs {
 
             // Optional PLY splat file for initialization
             std::optional<std::string> init_ply = std::nullopt;
+
+            // Training checkpoint to resume from (file, or directory holding checkpoints)
+            std::optional<std::filesystem::path> resume_checkpoint = std::nullopt;
         };
 
         // Modern C++23 functions returning expected values
@@ -0,0 +1,30 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/point_cloud.hpp"
+#include <cstdint>
+
+namespace gs {
+
+    struct PointCloudFilterOptions {
+        float voxel_size = 0.0f;    // Edge length of the averaging voxels (0 = derive from target_count)
+        int64_t target_count = 0;   // Approximate number of voxels to keep when voxel_size is 0 (0 = no downsampling)
+        float outlier_std = 0.0f;   // Standard deviations above the mean neighbour distance to drop at (0 = keep all)
+        int outlier_neighbors = 8;  // Neighbours averaged for the outlier statistic
+    };
+
+    // Multithreaded CPU preprocessing of an SfM point cloud before initialization.
+    //  1. Voxel downsampling: the points falling into one cell of a hashed voxel grid are
+    //     replaced by their mean position and color. Without a voxel size the cell size is
+    //     searched so that about target_count cells are occupied. The grid has at most 2^21
+    //     cells per axis; a finer voxel_size is raised to fit the extent of the cloud.
+    //  2. Statistical outlier removal on the result: a point whose mean distance to its
+    //     outlier_neighbors nearest neighbours exceeds mean + outlier_std * std over all
+    //     points is dropped.
+    // Only positions and colors are kept. The result lives on the CPU and keeps the color dtype.
+    PointCloud filter_point_cloud(const PointCloud& cloud, const PointCloudFilterOptions& options);
+
+} // namespace gs
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "core/point_cloud.hpp"
+#include <array>
 #include <expected>
 #include <filesystem>
 #include <future>
@@ -80,10 +81,28 @@ namespace gs {
         // Utility methods
         void increment_sh_degree();
 
+        // Reserved capacity: the raw parameters become views over the first size() rows of
+        // buffers holding `capacity` rows, so growing up to the capacity is an in-place write.
+        // Assigning a new tensor to any raw parameter drops the reservation.
+        void reserve(int64_t capacity);
+        // Re-narrows the raw parameters to the first `rows` reserved rows (new tensors, same memory)
+        void resize(int64_t rows);
+        bool has_reserved_capacity() const;
+        int64_t capacity() const { return has_reserved_capacity() ? _reserved[0].size(0) : size(); }
+
         // Export methods - join_threads controls sync vs async
         void save_ply(const std::filesystem::path& root, int iteration, bool join_threads = true) const;
         void save_sog(const std::filesystem::path& root, int iteration, int kmeans_iterations = 10, bool join_threads = true) const;
 
+        // Checkpoint state: raw parameters, SH degrees, scene scale and densification statistics.
+        // save_state writes device snapshots; load_state restores onto training_device() with gradients enabled.
+        void save_state(torch::serialize::OutputArchive& archive) const;
+        void load_state(torch::serialize::InputArchive& archive);
+
+        // Detached device copy of the raw parameters with the same SH degrees and no densification
+        // statistics, for consumers that outlive the current step (e.g. asynchronous evaluation)
+        SplatData snapshot() const;
+
         // Get attribute names for the PLY format
         std::vector<std::string> get_attribute_names() const;
 
@@ -103,6 +122,9 @@ namespace gs {
         torch::Tensor _rotation;
         torch::Tensor _opacity;
 
+        // Backing buffers of the reserved capacity, in the order means, sh0, shN, scaling, rotation, opacity
+        std::array<torch::Tensor, 6> _reserved;
+
         // Async save management
         mutable std::mutex _save_mutex;
         mutable std::vector<std::future<void>> _save_futures;
@@ -0,0 +1,48 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+// -----------------------------------------------------------------------------
+// Header-only LibTorch wrapper for the fused L1 + SSIM photometric loss
+//  – Equal to (1 - lambda) * l1_loss(rendered, gt)
+//             + lambda * (1 - fused_ssim(rendered, gt, "valid", true))
+//  – The gradient is produced together with the loss and only scaled in backward.
+// -----------------------------------------------------------------------------
+#include "kernels/fused_ssim.cuh" // kC1, kC2
+#include "kernels/l1_ssim.cuh"    // declares fused_l1_ssim & fused_l1_ssim_cpu
+#include <torch/torch.h>
+
+namespace fs_internal {
+    class _FusedL1SSIM : public torch::autograd::Function<_FusedL1SSIM> {
+    public:
+        static torch::Tensor forward(torch::autograd::AutogradContext* ctx,
+                                     torch::Tensor rendered,
+                                     torch::Tensor gt,
+                                     double lambda_dssim) {
+            auto [loss, grad] = rendered.is_cpu()
+                                    ? fused_l1_ssim_cpu(kC1, kC2, rendered, gt, static_cast<float>(lambda_dssim))
+                                    : fused_l1_ssim(kC1, kC2, rendered, gt, static_cast<float>(lambda_dssim));
+            ctx->save_for_backward({grad});
+            return loss;
+        }
+
+        static std::vector<torch::Tensor> backward(torch::autograd::AutogradContext* ctx,
+                                                   std::vector<torch::Tensor> grad_out) {
+            auto grad = ctx->get_saved_variables()[0];
+            return {grad * grad_out[0], torch::Tensor(), torch::Tensor()};
+        }
+    };
+} // namespace fs_internal
+
+// rendered: [N,C,H,W] or [C,H,W] float. gt on the same device: the same shape as float, or the
+// uint8 [N,H,W,C] or [H,W,C] image as loaded, normalized inside the kernel
+inline torch::Tensor fused_l1_ssim_loss(torch::Tensor rendered, torch::Tensor gt, float lambda_dssim) {
+    if (rendered.dim() == 3) {
+        rendered = rendered.unsqueeze(0);
+    }
+    if (gt.dim() == 3) {
+        gt = gt.unsqueeze(0);
+    }
+    return fs_internal::_FusedL1SSIM::apply(rendered, gt, static_cast<double>(lambda_dssim));
+}
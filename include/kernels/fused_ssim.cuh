@@ -23,6 +23,51 @@ namespace fs_internal {
                     p, "\")");
     }
 
+    /* ----------------- CPU path (plain torch ops, autograd) ------------------- */
+    // Same map as the fused kernel: 11x11 Gaussian window (sigma 1.5), zero padding
+    inline torch::Tensor ssim_map_cpu(torch::Tensor img1, torch::Tensor img2, const std::string& padding) {
+        if (img1.dim() == 3) {
+            img1 = img1.unsqueeze(0);
+        }
+        if (img2.dim() == 3) {
+            img2 = img2.unsqueeze(0);
+        }
+        TORCH_CHECK(img1.dim() == 4 && img1.sizes() == img2.sizes(),
+                    "fused_ssim expects two 4D tensors [N,C,H,W] of the same shape");
+
+        constexpr int window_size = 11;
+        const int64_t channels = img1.size(1);
+        const auto x = torch::arange(window_size, img1.options().requires_grad(false)) - window_size / 2;
+        auto g = torch::exp(-(x * x) / (2.0 * 1.5 * 1.5));
+        g = g / g.sum();
+        const auto window = torch::outer(g, g).expand({channels, 1, window_size, window_size}).contiguous();
+
+        namespace F = torch::nn::functional;
+        const auto blur = [&](const torch::Tensor& t) {
+            return F::conv2d(t, window, F::Conv2dFuncOptions().padding(window_size / 2).groups(channels));
+        };
+        const auto mu1 = blur(img1);
+        const auto mu2 = blur(img2);
+        const auto mu1_sq = mu1 * mu1;
+        const auto mu2_sq = mu2 * mu2;
+        const auto mu1_mu2 = mu1 * mu2;
+        const auto sigma1_sq = blur(img1 * img1) - mu1_sq;
+        const auto sigma2_sq = blur(img2 * img2) - mu2_sq;
+        const auto sigma12 = blur(img1 * img2) - mu1_mu2;
+        auto map = ((2.0 * mu1_mu2 + kC1) * (2.0 * sigma12 + kC2)) /
+                   ((mu1_sq + mu2_sq + kC1) * (sigma1_sq + sigma2_sq + kC2));
+
+        if (padding == "valid") {
+            using torch::indexing::Slice;
+            const int64_t h = map.size(2);
+            const int64_t w = map.size(3);
+            if (h > 10 && w > 10) {
+                map = map.index({Slice(), Slice(), Slice(5, h - 5), Slice(5, w - 5)});
+            }
+        }
+        return map;
+    }
+
     /* ----------------- custom autograd Function (always header-only) --------- */
     class _FusedSSIM : public torch::autograd::Function<_FusedSSIM> {
     public:
@@ -117,6 +162,9 @@ torch::Tensor fused_ssim(torch::Tensor img1, torch::Tensor img2,
 inline torch::Tensor fused_ssim(torch::Tensor img1, torch::Tensor img2,
                                 const std::string& padding, bool train) {
     fs_internal::check_padding(padding);
+    if (img1.is_cpu()) {
+        return fs_internal::ssim_map_cpu(img1, img2, padding).mean();
+    }
     img1 = img1.contiguous();
     return fs_internal::_FusedSSIM::apply(img1, img2, padding, train).mean();
 }
@@ -0,0 +1,44 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+#include <torch/torch.h>
+#include <tuple>
+
+inline void check_l1_ssim_inputs(const torch::Tensor& rendered, const torch::Tensor& gt) {
+    TORCH_CHECK(rendered.dim() == 4 && rendered.scalar_type() == torch::kFloat,
+                "fused_l1_ssim expects rendered as a 4D float tensor [N,C,H,W]");
+    if (gt.scalar_type() == torch::kByte) {
+        TORCH_CHECK(gt.dim() == 4 && gt.size(0) == rendered.size(0) && gt.size(1) == rendered.size(2) &&
+                        gt.size(2) == rendered.size(3) && gt.size(3) == rendered.size(1),
+                    "fused_l1_ssim expects a uint8 gt as [N,H,W,C] matching rendered ", rendered.sizes(),
+                    ", got ", gt.sizes());
+    } else {
+        TORCH_CHECK(gt.scalar_type() == torch::kFloat && gt.sizes() == rendered.sizes(),
+                    "fused_l1_ssim expects a float gt of the same shape as rendered ", rendered.sizes(),
+                    ", got ", gt.sizes());
+    }
+}
+
+// Photometric loss (1 - lambda) * L1 + lambda * (1 - SSIM) of rendered, a [N,C,H,W] float tensor,
+// against gt, either the same layout or the uint8 [N,H,W,C] images as loaded, which are normalized
+// to [0, 1] while the tile is read. SSIM matches fused_ssim(rendered, gt, "valid", true). Each image tile is read once:
+// the SSIM statistics, the SSIM partial derivatives and their blur live in tile-local scratch with a
+// recomputed halo. Returns (scalar loss, d(loss)/d(rendered)).
+std::tuple<torch::Tensor, torch::Tensor>
+fused_l1_ssim(
+    float C1,
+    float C2,
+    const torch::Tensor& rendered,
+    const torch::Tensor& gt,
+    float lambda_dssim);
+
+// CPU counterpart of fused_l1_ssim, processing row bands of every channel in parallel
+std::tuple<torch::Tensor, torch::Tensor>
+fused_l1_ssim_cpu(
+    float C1,
+    float C2,
+    const torch::Tensor& rendered,
+    const torch::Tensor& gt,
+    float lambda_dssim);
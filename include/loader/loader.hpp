@@ -41,6 +41,7 @@ namespace gs::loader {
         int resize_factor = -1;
         std::string images_folder = "images";
         bool validate_only = false;
+        bool validate_images = false; // Probe every image header in parallel, fail on unreadable images
         ProgressCallback progress = nullptr;
     };
 
@@ -3,12 +3,16 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "core/argument_parser.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
+#include <algorithm>
 #include <args.hxx>
+#include <charconv>
 #include <expected>
 #include <filesystem>
 #include <format>
+#include <functional>
 #include <print>
 #include <set>
 #include <unordered_map>
@@ -83,7 +87,12 @@ namespace {
             ::args::ValueFlag<uint32_t> iterations(parser, "iterations", "Number of iterations", {'i', "iter"});
             ::args::ValueFlag<int> num_workers(parser, "num_threads", "Number of workers", {"num-workers"});
             ::args::ValueFlag<int> max_cap(parser, "max_cap", "Max Gaussians for MCMC", {"max-cap"});
+            ::args::ValueFlag<int> prefetch_depth(parser, "prefetch_depth", "Decoded images kept ready ahead of training (default: 8)", {"prefetch-depth"});
+            ::args::ValueFlag<int> checkpoint_every(parser, "checkpoint_every", "Write a resumable training checkpoint every N iterations", {"checkpoint-every"});
+            ::args::ValueFlag<int> batch_views(parser, "batch_views", "Views accumulated into each optimizer step (default: 1)", {"batch-views"});
+            ::args::ValueFlag<size_t> preload_budget_mb(parser, "preload_budget_mb", "RAM budget in MB for --preload-to-ram (default: 0 = all images)", {"preload-budget-mb"});
             ::args::ValueFlag<std::string> images_folder(parser, "images", "Images folder name", {"images"});
+            ::args::ValueFlag<std::string> image_cache_dir(parser, "image_cache_dir", "Directory for decoded images reused across runs", {"image-cache-dir"});
             ::args::ValueFlag<int> test_every(parser, "test_every", "Use every Nth image as test", {"test-every"});
             ::args::ValueFlag<float> steps_scaler(parser, "steps_scaler", "Scale training steps by factor", {"steps-scaler"});
             ::args::ValueFlag<int> sh_degree_interval(parser, "sh_degree_interval", "SH degree interval", {"sh-degree-interval"});
@@ -92,11 +101,20 @@ namespace {
             ::args::ValueFlag<std::string> render_mode(parser, "render_mode", "Render mode: RGB, D, ED, RGB_D, RGB_ED", {"render-mode"});
             ::args::ValueFlag<std::string> pose_opt(parser, "pose_opt", "Enable pose optimization type: none, direct, mlp", {"pose-opt"});
             ::args::ValueFlag<std::string> strategy(parser, "strategy", "Optimization strategy: mcmc, default", {"strategy"});
+            ::args::ValueFlag<std::string> device(parser, "device", "Training device: cuda, cuda:N, cpu (default: cuda)", {"device"});
+            ::args::ValueFlag<std::string> shn_precision(parser, "shn_precision", "Storage type of the higher-degree SH coefficients: fp32, fp16, bf16 (default: fp32)", {"shn-precision"});
+            ::args::ValueFlag<std::string> moment_precision(parser, "moment_precision", "Storage type of the Adam moments: fp32, bf16 (default: fp32)", {"moment-precision"});
+            ::args::ValueFlag<std::string> view_sampling(parser, "view_sampling", "Training view order: uniform, loss (default: uniform)", {"view-sampling"});
             ::args::ValueFlag<int> init_num_pts(parser, "init_num_pts", "Number of random initialization points", {"init-num-pts"});
             ::args::ValueFlag<float> init_extent(parser, "init_extent", "Extent of random initialization", {"init-extent"});
+            ::args::ValueFlag<float> init_voxel_size(parser, "init_voxel_size", "Average the SfM points of every voxel of this edge length before initialization (default: off)", {"init-voxel-size"});
+            ::args::ValueFlag<int> init_max_points(parser, "init_max_points", "Voxel-downsample the SfM points to about this many before initialization (default: off)", {"init-max-points"});
+            ::args::ValueFlag<float> init_outlier_std(parser, "init_outlier_std", "Drop SfM points whose mean neighbour distance is more than this many standard deviations above the mean (default: off)", {"init-outlier-std"});
+            ::args::ValueFlagList<size_t> resolution_steps(parser, "resolution_steps", "Step at which the training resolution doubles; repeat to train coarse to fine, e.g. 1/4 and 1/2 before two steps", {"resolution-steps"});
             ::args::ValueFlagList<std::string> timelapse_images(parser, "timelapse_images", "Image filenames to render timelapse images for", {"timelapse-images"});
             ::args::ValueFlag<int> timelapse_every(parser, "timelapse_every", "Render timelapse image every N iterations (default: 50)", {"timelapse-every"});
             ::args::ValueFlag<std::string> init_ply(parser, "init_ply", "Optional PLY splat file for initialization", {"init-ply"});
+            ::args::ValueFlag<std::string> resume(parser, "resume", "Resume training from a checkpoint file or directory", {"resume"});
 
             // Sparsity optimization arguments
             ::args::ValueFlag<int> sparsify_steps(parser, "sparsify_steps", "Number of steps for sparsification (default: 15000)", {"sparsify-steps"});
@@ -124,17 +142,13 @@ namespace {
             ::args::Flag enable_sparsity(parser, "enable_sparsity", "Enable sparsity optimization", {"enable-sparsity"});
             ::args::Flag rc(parser, "rc", "Workaround for reality captures - doesn't properly convert COLMAP camera model", {"rc"});
             ::args::Flag save_sog(parser, "sog", "Save in SOG format alongside PLY", {"sog"});
+            ::args::Flag preload_to_ram(parser, "preload_to_ram", "Decode training images once and serve them from RAM", {"preload-to-ram"});
+            ::args::Flag sparse_adam(parser, "sparse_adam", "Update only the Gaussians visible in each step's views", {"sparse-adam"});
+            ::args::Flag validate_images(parser, "validate_images", "Check that every dataset image is readable before training", {"validate-images"});
 
-            ::args::MapFlag<std::string, int> resize_factor(parser, "resize_factor",
-                                                            "resize resolution by this factor. Options: auto, 1, 2, 4, 8 (default: auto)",
-                                                            {'r', "resize_factor"},
-                                                            // load_image only supports those resizes
-                                                            std::unordered_map<std::string, int>{
-                                                                {"auto", 1},
-                                                                {"1", 1},
-                                                                {"2", 2},
-                                                                {"4", 4},
-                                                                {"8", 8}});
+            ::args::ValueFlag<std::string> resize_factor(parser, "resize_factor",
+                                                         "resize resolution by this integer factor, or auto (default: auto)",
+                                                         {'r', "resize_factor"});
 
             // Parse arguments
             try {
@@ -208,6 +222,16 @@ namespace {
                 }
             }
 
+            if (resume) {
+                const std::filesystem::path resume_path = ::args::get(resume);
+                params.resume_checkpoint = resume_path;
+
+                // A directory is searched for the newest checkpoint when the trainer starts
+                if (!std::filesystem::exists(resume_path)) {
+                    return std::unexpected(std::format("Checkpoint path does not exist: {}", resume_path.string()));
+                }
+            }
+
             // Training mode
             bool has_data_path = data_path && !::args::get(data_path).empty();
             bool has_output_path = output_path && !::args::get(output_path).empty();
@@ -247,6 +271,55 @@ namespace {
                         mode));
                 }
             }
+            if (batch_views && ::args::get(batch_views) < 1) {
+                return std::unexpected(std::format(
+                    "ERROR: --batch-views must be at least 1, got {}",
+                    ::args::get(batch_views)));
+            }
+            if (device) {
+                if (auto parsed = gs::parse_training_device(::args::get(device)); !parsed) {
+                    return std::unexpected(std::format("ERROR: {}", parsed.error()));
+                }
+            }
+            if (shn_precision) {
+                const auto precision = ::args::get(shn_precision);
+                if (precision != "fp32" && precision != "fp16" && precision != "bf16") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid SH precision '{}'. Valid values are: fp32, fp16, bf16",
+                        precision));
+                }
+            }
+            if (moment_precision) {
+                const auto precision = ::args::get(moment_precision);
+                if (precision != "fp32" && precision != "bf16") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid moment precision '{}'. Valid values are: fp32, bf16",
+                        precision));
+                }
+            }
+            if (view_sampling) {
+                const auto sampling = ::args::get(view_sampling);
+                if (sampling != "uniform" && sampling != "loss") {
+                    return std::unexpected(std::format(
+                        "ERROR: Invalid view sampling '{}'. Valid values are: uniform, loss",
+                        sampling));
+                }
+            }
+            if (init_voxel_size && ::args::get(init_voxel_size) < 0.0f) {
+                return std::unexpected(std::format("ERROR: --init-voxel-size must not be negative"));
+            }
+            if (init_max_points && ::args::get(init_max_points) < 0) {
+                return std::unexpected(std::format("ERROR: --init-max-points must not be negative"));
+            }
+            if (init_outlier_std && ::args::get(init_outlier_std) < 0.0f) {
+                return std::unexpected(std::format("ERROR: --init-outlier-std must not be negative"));
+            }
+            if (resolution_steps) {
+                const auto steps = ::args::get(resolution_steps);
+                if (!std::is_sorted(steps.begin(), steps.end(), std::less_equal<size_t>())) {
+                    return std::unexpected(std::format("ERROR: --resolution-steps must be strictly increasing"));
+                }
+            }
             if (strategy) {
                 const auto strat = ::args::get(strategy);
                 if (VALID_STRATEGIES.find(strat) == VALID_STRATEGIES.end()) {
@@ -270,15 +343,38 @@ namespace {
                 }
             }
 
+            // Any positive integer factor is supported by the image downscaler
+            std::optional<int> resize_factor_parsed;
+            if (resize_factor) {
+                const auto value = ::args::get(resize_factor);
+                if (value == "auto") {
+                    resize_factor_parsed = 1;
+                } else {
+                    int factor = 0;
+                    const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), factor);
+                    if (ec != std::errc() || ptr != value.data() + value.size() || factor < 1) {
+                        return std::unexpected(std::format(
+                            "ERROR: Invalid resize factor '{}'. Use auto or a positive integer",
+                            value));
+                    }
+                    resize_factor_parsed = factor;
+                }
+            }
+
             // Create lambda to apply command line overrides after JSON loading
             auto apply_cmd_overrides = [&params,
                                         // Capture values, not references
                                         iterations_val = iterations ? std::optional<uint32_t>(::args::get(iterations)) : std::optional<uint32_t>(),
-                                        resize_factor_val = resize_factor ? std::optional<int>(::args::get(resize_factor)) : std::optional<int>(1), // default 1
+                                        resize_factor_val = std::optional<int>(resize_factor_parsed.value_or(1)), // default 1
                                         num_workers_val = num_workers ? std::optional<int>(::args::get(num_workers)) : std::optional<int>(),
                                         max_cap_val = max_cap ? std::optional<int>(::args::get(max_cap)) : std::optional<int>(),
+                                        prefetch_depth_val = prefetch_depth ? std::optional<int>(::args::get(prefetch_depth)) : std::optional<int>(),
+                                        checkpoint_every_val = checkpoint_every ? std::optional<int>(::args::get(checkpoint_every)) : std::optional<int>(),
+                                        batch_views_val = batch_views ? std::optional<int>(::args::get(batch_views)) : std::optional<int>(),
+                                        preload_budget_mb_val = preload_budget_mb ? std::optional<size_t>(::args::get(preload_budget_mb)) : std::optional<size_t>(),
                                         project_name_val = project_name ? std::optional<std::string>(::args::get(project_name)) : std::optional<std::string>(),
                                         images_folder_val = images_folder ? std::optional<std::string>(::args::get(images_folder)) : std::optional<std::string>(),
+                                        image_cache_dir_val = image_cache_dir ? std::optional<std::string>(::args::get(image_cache_dir)) : std::optional<std::string>(),
                                         test_every_val = test_every ? std::optional<int>(::args::get(test_every)) : std::optional<int>(),
                                         steps_scaler_val = steps_scaler ? std::optional<float>(::args::get(steps_scaler)) : std::optional<float>(),
                                         sh_degree_interval_val = sh_degree_interval ? std::optional<int>(::args::get(sh_degree_interval)) : std::optional<int>(),
@@ -287,8 +383,16 @@ namespace {
                                         render_mode_val = render_mode ? std::optional<std::string>(::args::get(render_mode)) : std::optional<std::string>(),
                                         init_num_pts_val = init_num_pts ? std::optional<int>(::args::get(init_num_pts)) : std::optional<int>(),
                                         init_extent_val = init_extent ? std::optional<float>(::args::get(init_extent)) : std::optional<float>(),
+                                        init_voxel_size_val = init_voxel_size ? std::optional<float>(::args::get(init_voxel_size)) : std::optional<float>(),
+                                        init_max_points_val = init_max_points ? std::optional<int>(::args::get(init_max_points)) : std::optional<int>(),
+                                        init_outlier_std_val = init_outlier_std ? std::optional<float>(::args::get(init_outlier_std)) : std::optional<float>(),
                                         pose_opt_val = pose_opt ? std::optional<std::string>(::args::get(pose_opt)) : std::optional<std::string>(),
                                         strategy_val = strategy ? std::optional<std::string>(::args::get(strategy)) : std::optional<std::string>(),
+                                        device_val = device ? std::optional<std::string>(::args::get(device)) : std::optional<std::string>(),
+                                        shn_precision_val = shn_precision ? std::optional<std::string>(::args::get(shn_precision)) : std::optional<std::string>(),
+                                        moment_precision_val = moment_precision ? std::optional<std::string>(::args::get(moment_precision)) : std::optional<std::string>(),
+                                        view_sampling_val = view_sampling ? std::optional<std::string>(::args::get(view_sampling)) : std::optional<std::string>(),
+                                        resolution_steps_val = resolution_steps ? std::optional<std::vector<size_t>>(::args::get(resolution_steps)) : std::optional<std::vector<size_t>>(),
                                         timelapse_images_val = timelapse_images ? std::optional<std::vector<std::string>>(::args::get(timelapse_images)) : std::optional<std::vector<std::string>>(),
                                         timelapse_every_val = timelapse_every ? std::optional<int>(::args::get(timelapse_every)) : std::optional<int>(),
                                         sog_iterations_val = sog_iterations ? std::optional<int>(::args::get(sog_iterations)) : std::optional<int>(),
@@ -308,7 +412,10 @@ namespace {
                                         random_flag = bool(random),
                                         gut_flag = bool(gut),
                                         save_sog_flag = bool(save_sog),
-                                        enable_sparsity_flag = bool(enable_sparsity)]() {
+                                        enable_sparsity_flag = bool(enable_sparsity),
+                                        preload_to_ram_flag = bool(preload_to_ram),
+                                        sparse_adam_flag = bool(sparse_adam),
+                                        validate_images_flag = bool(validate_images)]() {
                 auto& opt = params.optimization;
                 auto& ds = params.dataset;
 
@@ -328,8 +435,13 @@ namespace {
                 setVal(resize_factor_val, ds.resize_factor);
                 setVal(num_workers_val, opt.num_workers);
                 setVal(max_cap_val, opt.max_cap);
+                setVal(prefetch_depth_val, opt.prefetch_depth);
+                setVal(checkpoint_every_val, opt.checkpoint_every);
+                setVal(batch_views_val, opt.batch_views);
+                setVal(preload_budget_mb_val, opt.preload_budget_mb);
                 setVal(project_name_val, ds.project_path);
                 setVal(images_folder_val, ds.images);
+                setVal(image_cache_dir_val, ds.image_cache_dir);
                 setVal(test_every_val, ds.test_every);
                 setVal(steps_scaler_val, opt.steps_scaler);
                 setVal(sh_degree_interval_val, opt.sh_degree_interval);
@@ -338,8 +450,16 @@ namespace {
                 setVal(render_mode_val, opt.render_mode);
                 setVal(init_num_pts_val, opt.init_num_pts);
                 setVal(init_extent_val, opt.init_extent);
+                setVal(init_voxel_size_val, opt.init_voxel_size);
+                setVal(init_max_points_val, opt.init_max_points);
+                setVal(init_outlier_std_val, opt.init_outlier_std);
                 setVal(pose_opt_val, opt.pose_optimization);
                 setVal(strategy_val, opt.strategy);
+                setVal(device_val, opt.device);
+                setVal(shn_precision_val, opt.shn_precision);
+                setVal(moment_precision_val, opt.moment_precision);
+                setVal(view_sampling_val, opt.view_sampling);
+                setVal(resolution_steps_val, opt.resolution_steps);
                 setVal(timelapse_images_val, ds.timelapse_images);
                 setVal(timelapse_every_val, ds.timelapse_every);
                 setVal(sog_iterations_val, opt.sog_iterations);
@@ -361,6 +481,9 @@ namespace {
                 setFlag(gut_flag, opt.gut);
                 setFlag(save_sog_flag, opt.save_sog);
                 setFlag(enable_sparsity_flag, opt.enable_sparsity);
+                setFlag(preload_to_ram_flag, opt.preload_to_ram);
+                setFlag(sparse_adam_flag, opt.sparse_adam);
+                setFlag(validate_images_flag, ds.validate_images);
             };
 
             return std::make_tuple(ParseResult::Success, apply_cmd_overrides);
@@ -386,6 +509,9 @@ namespace {
 
             scale_steps_vector(opt.eval_steps, scaler);
             scale_steps_vector(opt.save_steps, scaler);
+            for (auto& step : opt.resolution_steps) {
+                step *= scaler;
+            }
         }
     }
 
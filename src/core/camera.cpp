@@ -3,7 +3,11 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "core/camera.hpp"
+#include "core/device.hpp"
+#include "core/disk_image_cache.hpp"
+#include "core/image_cache.hpp"
 #include "core/image_io.hpp"
+#include "core/image_resize.hpp"
 #include <c10/cuda/CUDAGuard.h>
 #include <torch/torch.h>
 
@@ -17,7 +21,7 @@ namespace gs {
 
         w2c.index_put_({Slice(0, 3), 3}, t);
 
-        return w2c.to(torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA)).unsqueeze(0).contiguous();
+        return w2c.to(torch::TensorOptions().dtype(torch::kFloat32).device(training_device())).unsqueeze(0).contiguous();
     }
 
     Camera::Camera(const torch::Tensor& R,
@@ -97,55 +101,72 @@ namespace gs {
         return std::make_tuple(fx, fy, cx, cy);
     }
 
-    torch::Tensor Camera::load_and_get_image(int resize_factor) {
-        // Use pinned memory for faster GPU transfer
-        auto pinned_options = torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(true);
-
-        unsigned char* data;
-        int w, h, c;
-
-        // Load image synchronously
-        auto result = load_image(_image_path, resize_factor);
-        data = std::get<0>(result);
-        w = std::get<1>(result);
-        h = std::get<2>(result);
-        c = std::get<3>(result);
-
+    torch::Tensor Camera::upload_image(const unsigned char* data, int w, int h, int c, bool pinned) {
         _image_width = w;
         _image_height = h;
 
-        // Create tensor from pinned memory and transfer asynchronously
+        const auto device = training_device();
+        if (!device.is_cuda()) {
+            // Copy, so the result does not alias the host buffer
+            return torch::from_blob(const_cast<unsigned char*>(data), {h, w, c}, {w * c, c, 1}, torch::kUInt8)
+                .clone();
+        }
+
+        // Only memory that is actually page-locked can be copied asynchronously
+        auto options = torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(pinned);
+
         torch::Tensor image = torch::from_blob(
-            data,
+            const_cast<unsigned char*>(data),
             {h, w, c},
             {w * c, c, 1},
-            pinned_options);
+            options);
 
         // Use the CUDA stream for async transfer
-        at::cuda::CUDAStreamGuard guard(_stream);
+        if (!_stream) {
+            _stream = at::cuda::getStreamFromPool(false, device.index());
+        }
+        at::cuda::CUDAStreamGuard guard(*_stream);
 
-        image = image.to(torch::kCUDA, /*non_blocking=*/true)
-                    .permute({2, 0, 1})
-                    .to(torch::kFloat32) /
-                255.0f;
+        // Stays uint8 HWC: the loss kernels normalize and permute while reading
+        image = image.to(device, /*non_blocking=*/pinned);
+
+        // Ensure the transfer is complete before the host buffer is released
+        _stream->synchronize();
+
+        return image;
+    }
+
+    torch::Tensor Camera::load_and_get_image(int resize_factor) {
+        // Load image synchronously
+        auto [data, w, h, c] = load_image(_image_path, resize_factor);
+
+        torch::Tensor image = upload_image(data, w, h, c, /*pinned=*/false);
 
         // Free the original data
         free_image(data);
 
-        // Ensure the transfer is complete before returning
-        _stream.synchronize();
-
         return image;
     }
 
-    void Camera::load_image_size(int resize_factor) {
-        // Load image synchronously
-        auto result = load_image(_image_path, resize_factor);
-        int w = std::get<1>(result);
-        int h = std::get<2>(result);
+    torch::Tensor Camera::load_and_get_image(ImageCache& cache, int resize_factor) {
+        // The lease keeps the arena slot alive until the upload has completed
+        auto lease = cache.acquire(_uid, _image_path, resize_factor);
+        return upload_image(lease.data(), lease.width(), lease.height(), lease.channels(), lease.cached());
+    }
 
-        _image_width = w;
-        _image_height = h;
+    torch::Tensor Camera::load_and_get_image(const DiskImageCache& cache, int resize_factor) {
+        // Upload straight from the mapped file, no decode and no intermediate copy
+        if (auto mapped = cache.load(_image_path, resize_factor)) {
+            return upload_image(mapped->data(), mapped->width(), mapped->height(), mapped->channels(), /*pinned=*/false);
+        }
+        return load_and_get_image(resize_factor);
+    }
+
+    void Camera::load_image_size(int resize_factor) {
+        // Header only: the size load_image(_image_path, resize_factor) would produce
+        auto [w, h, c] = get_image_info(_image_path);
+        std::tie(_image_width, _image_height) =
+            image_io::downscaled_size(w, h, resize_factor > 1 ? static_cast<float>(resize_factor) : 1.0f);
     }
 
     size_t Camera::get_num_bytes_from_file() const {
@@ -0,0 +1,57 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/device.hpp"
+#include <c10/cuda/CUDAFunctions.h>
+#include <format>
+#include <mutex>
+
+namespace gs {
+    namespace {
+        std::mutex device_mutex;
+        torch::Device current_device{torch::kCUDA};
+    } // namespace
+
+    torch::Device training_device() {
+        std::lock_guard<std::mutex> lock(device_mutex);
+        return current_device;
+    }
+
+    void set_training_device(const torch::Device& device) {
+        std::lock_guard<std::mutex> lock(device_mutex);
+        current_device = device;
+    }
+
+    void bind_training_device() {
+        const auto device = training_device();
+        if (device.is_cuda()) {
+            c10::cuda::set_device(device.has_index() ? device.index() : c10::DeviceIndex{0});
+        }
+    }
+
+    std::expected<torch::Device, std::string> parse_training_device(const std::string& name) {
+        if (name == "cpu") {
+            return torch::Device(torch::kCPU);
+        }
+        if (name == "cuda" || name.starts_with("cuda:")) {
+            if (!torch::cuda::is_available()) {
+                return std::unexpected("CUDA is not available, use --device cpu");
+            }
+            try {
+                torch::Device device(name);
+                if (!device.has_index()) {
+                    return torch::Device(torch::kCUDA, 0);
+                }
+                if (device.index() >= static_cast<int>(torch::cuda::device_count())) {
+                    return std::unexpected(std::format("Device '{}' does not exist", name));
+                }
+                return device;
+            } catch (const std::exception&) {
+                return std::unexpected(std::format("Invalid device '{}'", name));
+            }
+        }
+        return std::unexpected(std::format("Invalid device '{}'. Valid options are: cuda, cuda:N, cpu", name));
+    }
+
+} // namespace gs
@@ -0,0 +1,299 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/disk_image_cache.hpp"
+#include "core/image_io.hpp"
+#include "core/logger.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Platform-specific includes
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gs {
+
+    namespace {
+        constexpr char kMagic[8] = {'L', 'F', 'S', 'I', 'M', 'G', '0', '1'};
+        constexpr uint32_t kVersion = 1;
+        // Pixels start on a page boundary so the mapping can be handed to the driver as is
+        constexpr size_t kPixelOffset = 4096;
+
+        struct EntryHeader {
+            char magic[8];
+            uint32_t version;
+            int32_t width;
+            int32_t height;
+            int32_t channels;
+            int32_t resize_factor;
+            uint32_t reserved;
+            int64_t source_mtime;
+            uint64_t source_size;
+        };
+        static_assert(sizeof(EntryHeader) <= kPixelOffset);
+
+        // load_image treats every factor <= 1 as "no resize"
+        int normalize_factor(int resize_factor) {
+            return resize_factor > 1 ? resize_factor : 1;
+        }
+
+        // FNV-1a, stable across runs and platforms unlike std::hash
+        uint64_t fnv1a(const std::string& s) {
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for (unsigned char ch : s) {
+                hash ^= ch;
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        bool stat_source(const std::filesystem::path& source, int64_t& mtime, uint64_t& size) {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(source, ec);
+            if (ec) {
+                return false;
+            }
+            size = std::filesystem::file_size(source, ec);
+            if (ec) {
+                return false;
+            }
+            mtime = static_cast<int64_t>(time.time_since_epoch().count());
+            return true;
+        }
+    } // namespace
+
+    // ---------------------------------------------------------------------
+    // MappedImage
+    // ---------------------------------------------------------------------
+
+    MappedImage::~MappedImage() {
+        unmap();
+    }
+
+    MappedImage::MappedImage(MappedImage&& other) noexcept
+        : _mapping(std::exchange(other._mapping, nullptr)),
+          _mapping_size(std::exchange(other._mapping_size, 0)),
+          _pixels(std::exchange(other._pixels, nullptr)),
+          _width(other._width),
+          _height(other._height),
+          _channels(other._channels)
+#ifdef _WIN32
+          ,
+          _file_handle(std::exchange(other._file_handle, nullptr)),
+          _mapping_handle(std::exchange(other._mapping_handle, nullptr))
+#endif
+    {
+    }
+
+    MappedImage& MappedImage::operator=(MappedImage&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            _mapping = std::exchange(other._mapping, nullptr);
+            _mapping_size = std::exchange(other._mapping_size, 0);
+            _pixels = std::exchange(other._pixels, nullptr);
+            _width = other._width;
+            _height = other._height;
+            _channels = other._channels;
+#ifdef _WIN32
+            _file_handle = std::exchange(other._file_handle, nullptr);
+            _mapping_handle = std::exchange(other._mapping_handle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    void MappedImage::unmap() {
+#ifdef _WIN32
+        if (_mapping)
+            UnmapViewOfFile(_mapping);
+        if (_mapping_handle)
+            CloseHandle(_mapping_handle);
+        if (_file_handle)
+            CloseHandle(_file_handle);
+        _file_handle = nullptr;
+        _mapping_handle = nullptr;
+#else
+        if (_mapping)
+            munmap(_mapping, _mapping_size);
+#endif
+        _mapping = nullptr;
+        _mapping_size = 0;
+        _pixels = nullptr;
+    }
+
+    // ---------------------------------------------------------------------
+    // DiskImageCache
+    // ---------------------------------------------------------------------
+
+    DiskImageCache::DiskImageCache(std::filesystem::path root)
+        : _root(std::move(root)) {
+        std::error_code ec;
+        std::filesystem::create_directories(_root, ec);
+        if (ec) {
+            throw std::runtime_error(std::format("Cannot create image cache directory {}: {}",
+                                                 _root.string(), ec.message()));
+        }
+    }
+
+    std::filesystem::path DiskImageCache::entry_path(const std::filesystem::path& source, int resize_factor) const {
+        std::error_code ec;
+        auto absolute = std::filesystem::absolute(source, ec).lexically_normal();
+        const uint64_t hash = fnv1a(absolute.generic_string());
+        return _root / std::format("{}_{:016x}_r{}.lfsimg",
+                                   source.stem().string(), hash, normalize_factor(resize_factor));
+    }
+
+    std::optional<MappedImage> DiskImageCache::find(const std::filesystem::path& source, int resize_factor) const {
+        const auto path = entry_path(source, resize_factor);
+
+        int64_t mtime = 0;
+        uint64_t size = 0;
+        if (!stat_source(source, mtime, size) || !std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+
+        MappedImage image;
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return std::nullopt;
+        }
+        image._file_handle = file;
+
+        LARGE_INTEGER file_size_li;
+        if (!GetFileSizeEx(file, &file_size_li)) {
+            return std::nullopt;
+        }
+        image._mapping_size = static_cast<size_t>(file_size_li.QuadPart);
+        if (image._mapping_size < kPixelOffset) {
+            return std::nullopt;
+        }
+
+        image._mapping_handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!image._mapping_handle) {
+            return std::nullopt;
+        }
+        image._mapping = MapViewOfFile(image._mapping_handle, FILE_MAP_READ, 0, 0, 0);
+        if (!image._mapping) {
+            return std::nullopt;
+        }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+
+        struct stat st {};
+        if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < kPixelOffset) {
+            close(fd);
+            return std::nullopt;
+        }
+
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // the mapping keeps the file referenced
+        if (mapping == MAP_FAILED) {
+            return std::nullopt;
+        }
+        image._mapping = mapping;
+        image._mapping_size = static_cast<size_t>(st.st_size);
+#endif
+
+        EntryHeader header;
+        std::memcpy(&header, image._mapping, sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+            header.version != kVersion ||
+            header.resize_factor != normalize_factor(resize_factor) ||
+            header.source_mtime != mtime ||
+            header.source_size != size) {
+            LOG_TRACE("Stale image cache entry {}", path.string());
+            return std::nullopt;
+        }
+
+        image._width = header.width;
+        image._height = header.height;
+        image._channels = header.channels;
+        if (kPixelOffset + image.num_bytes() > image._mapping_size) {
+            LOG_WARN("Truncated image cache entry {}", path.string());
+            return std::nullopt;
+        }
+        image._pixels = static_cast<const unsigned char*>(image._mapping) + kPixelOffset;
+        return image;
+    }
+
+    bool DiskImageCache::store(const std::filesystem::path& source, int resize_factor,
+                               const unsigned char* data, int width, int height, int channels) const {
+        EntryHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.width = width;
+        header.height = height;
+        header.channels = channels;
+        header.resize_factor = normalize_factor(resize_factor);
+        if (!stat_source(source, header.source_mtime, header.source_size)) {
+            return false;
+        }
+
+        // Write to a private temporary and rename so readers never see a partial entry
+        static std::atomic<uint64_t> counter{0};
+        const auto path = entry_path(source, resize_factor);
+        const auto tmp_path = std::filesystem::path(path.string() + std::format(".{}.{}.tmp",
+                                                                                std::hash<std::thread::id>{}(std::this_thread::get_id()),
+                                                                                counter.fetch_add(1)));
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                LOG_WARN("Could not write image cache entry {}", tmp_path.string());
+                return false;
+            }
+            std::vector<char> head(kPixelOffset, 0);
+            std::memcpy(head.data(), &header, sizeof(header));
+            file.write(head.data(), static_cast<std::streamsize>(head.size()));
+            file.write(reinterpret_cast<const char*>(data),
+                       static_cast<std::streamsize>(static_cast<size_t>(width) * height * channels));
+            if (!file) {
+                file.close();
+                std::error_code ec;
+                std::filesystem::remove(tmp_path, ec);
+                LOG_WARN("Could not write image cache entry {}", tmp_path.string());
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<MappedImage> DiskImageCache::load(const std::filesystem::path& source, int resize_factor) const {
+        if (auto hit = find(source, resize_factor)) {
+            return hit;
+        }
+
+        auto [data, w, h, c] = load_image(source, resize_factor);
+        const bool stored = store(source, resize_factor, data, w, h, c);
+        free_image(data);
+        if (!stored) {
+            return std::nullopt;
+        }
+        return find(source, resize_factor);
+    }
+
+} // namespace gs
@@ -0,0 +1,304 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/image_cache.hpp"
+#include "core/camera.hpp"
+#include "core/device.hpp"
+#include "core/image_io.hpp"
+#include "core/image_resize.hpp"
+#include "core/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <tbb/parallel_for.h>
+#include <tuple>
+#include <utility>
+
+namespace gs {
+
+    namespace {
+        std::pair<int, int> level_size(int width, int height, int level) {
+            if (level == 0) {
+                return {width, height};
+            }
+            return image_io::downscaled_size(width, height, static_cast<float>(1 << level));
+        }
+
+        // Levels are stored back to back, finest first
+        size_t level_offset(int width, int height, int channels, int level) {
+            size_t offset = 0;
+            for (int l = 0; l < level; ++l) {
+                const auto [w, h] = level_size(width, height, l);
+                offset += static_cast<size_t>(w) * h * channels;
+            }
+            return offset;
+        }
+    } // namespace
+
+    // ---------------------------------------------------------------------
+    // Lease
+    // ---------------------------------------------------------------------
+
+    ImageCache::Lease::~Lease() {
+        release();
+    }
+
+    ImageCache::Lease::Lease(Lease&& other) noexcept
+        : _cache(std::exchange(other._cache, nullptr)),
+          _slot(other._slot),
+          _data(std::exchange(other._data, nullptr)),
+          _owned(std::exchange(other._owned, nullptr)),
+          _mapped(std::move(other._mapped)),
+          _width(other._width),
+          _height(other._height),
+          _channels(other._channels) {
+    }
+
+    ImageCache::Lease& ImageCache::Lease::operator=(Lease&& other) noexcept {
+        if (this != &other) {
+            release();
+            _cache = std::exchange(other._cache, nullptr);
+            _slot = other._slot;
+            _data = std::exchange(other._data, nullptr);
+            _owned = std::exchange(other._owned, nullptr);
+            _mapped = std::move(other._mapped);
+            _width = other._width;
+            _height = other._height;
+            _channels = other._channels;
+        }
+        return *this;
+    }
+
+    void ImageCache::Lease::release() {
+        if (_owned) {
+            free_image(_owned);
+            _owned = nullptr;
+        } else if (_cache) {
+            _cache->unref(_slot);
+        }
+        _mapped = MappedImage();
+        _cache = nullptr;
+        _data = nullptr;
+    }
+
+    // ---------------------------------------------------------------------
+    // ImageCache
+    // ---------------------------------------------------------------------
+
+    ImageCache::ImageCache(size_t slot_bytes, size_t num_images, size_t byte_budget, int levels)
+        : _slot_bytes(std::max<size_t>(slot_bytes, 1)),
+          _levels(std::max(levels, 1)) {
+
+        size_t num_slots = num_images;
+        if (byte_budget > 0) {
+            num_slots = std::min(num_images, byte_budget / _slot_bytes);
+        }
+
+        // Pinned memory lets the H2D copy in Camera::load_and_get_image run asynchronously
+        auto options = torch::TensorOptions().dtype(torch::kUInt8);
+        if (training_on_cuda() && torch::cuda::is_available()) {
+            options = options.pinned_memory(true);
+        }
+        _arena = torch::empty({static_cast<int64_t>(num_slots * _slot_bytes)}, options);
+
+        _slots.resize(num_slots);
+        for (size_t i = 0; i < num_slots; ++i) {
+            _slots[i].lru_it = _lru.insert(_lru.end(), i);
+        }
+    }
+
+    std::shared_ptr<ImageCache> ImageCache::create(const std::vector<std::shared_ptr<Camera>>& cameras,
+                                                   int resize_factor,
+                                                   size_t byte_budget,
+                                                   int levels) {
+        // Same output size as load_image, which never returns more than 3 channels
+        size_t slot_bytes = 0;
+        for (const auto& cam : cameras) {
+            const auto [w, h] = image_io::downscaled_size(cam->camera_width(), cam->camera_height(),
+                                                          static_cast<float>(resize_factor));
+            slot_bytes = std::max(slot_bytes, pyramid_bytes(w, h, 3, levels));
+        }
+        return std::make_shared<ImageCache>(slot_bytes, cameras.size(), byte_budget, levels);
+    }
+
+    size_t ImageCache::pyramid_bytes(int width, int height, int channels, int levels) {
+        return level_offset(width, height, channels, std::max(levels, 1));
+    }
+
+    ImageCache::Lease ImageCache::lease_of(size_t slot, int level) {
+        const auto& s = _slots[slot];
+        const auto [w, h] = level_size(s.width, s.height, level);
+
+        Lease lease;
+        lease._cache = this;
+        lease._slot = slot;
+        lease._data = slot_data(slot) + level_offset(s.width, s.height, s.channels, level);
+        lease._width = w;
+        lease._height = h;
+        lease._channels = s.channels;
+        return lease;
+    }
+
+    ImageCache::Lease ImageCache::make_lease(size_t slot, int level) {
+        auto& s = _slots[slot];
+        ++s.refs;
+        _lru.splice(_lru.begin(), _lru, s.lru_it);
+        return lease_of(slot, level);
+    }
+
+    void ImageCache::unref(size_t slot) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_slots[slot].refs;
+    }
+
+    ImageCache::Lease ImageCache::acquire(int uid, const std::filesystem::path& path, int resize_factor, int level) {
+        if (level < 0 || level >= _levels) {
+            throw std::out_of_range(std::format("ImageCache: level {} requested from a {}-level pyramid", level, _levels));
+        }
+        const uint64_t key = make_key(uid, resize_factor);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (auto it = _slot_of.find(key); it != _slot_of.end()) {
+                ++_stats.hits;
+                return make_lease(it->second, level);
+            }
+            ++_stats.misses;
+        }
+
+        // Decode outside the lock so workers can miss in parallel
+        std::optional<MappedImage> mapped;
+        if (_disk_cache) {
+            mapped = _disk_cache->load(path, resize_factor);
+        }
+        unsigned char* data = nullptr;
+        int w, h, c;
+        if (mapped) {
+            w = mapped->width();
+            h = mapped->height();
+            c = mapped->channels();
+        } else {
+            std::tie(data, w, h, c) = load_image(path, resize_factor);
+        }
+        const unsigned char* pixels = mapped ? mapped->data() : data;
+        const size_t num_bytes = pyramid_bytes(w, h, c, _levels);
+
+        size_t slot = _slots.size();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            // Another worker may have decoded the same image meanwhile
+            if (auto it = _slot_of.find(key); it != _slot_of.end()) {
+                if (data) {
+                    free_image(data);
+                }
+                return make_lease(it->second, level);
+            }
+
+            if (num_bytes <= _slot_bytes) {
+                for (auto it = _lru.rbegin(); it != _lru.rend(); ++it) {
+                    if (_slots[*it].refs == 0) {
+                        slot = *it;
+                        break;
+                    }
+                }
+            }
+
+            if (slot == _slots.size()) {
+                ++_stats.uncached;
+                Lease lease;
+                if (level > 0) {
+                    // Only the requested level is built for an image that is not cached
+                    lease._owned = image_io::downscale(pixels, w, h, c, static_cast<float>(1 << level),
+                                                       lease._width, lease._height);
+                    lease._data = lease._owned;
+                    lease._channels = c;
+                    if (data) {
+                        free_image(data);
+                    }
+                    return lease;
+                }
+                lease._data = pixels;
+                lease._owned = data;
+                if (mapped) {
+                    lease._mapped = std::move(*mapped);
+                }
+                lease._width = w;
+                lease._height = h;
+                lease._channels = c;
+                return lease;
+            }
+
+            auto& s = _slots[slot];
+            if (s.valid) {
+                if (auto it = _slot_of.find(s.key); it != _slot_of.end() && it->second == slot) {
+                    _slot_of.erase(it);
+                }
+                ++_stats.evictions;
+            }
+            // Reserve the slot while it is being filled
+            s.valid = false;
+            s.refs = 1;
+        }
+
+        std::memcpy(slot_data(slot), pixels, static_cast<size_t>(w) * h * c);
+        for (int l = 1; l < _levels; ++l) {
+            // Every level from the full image, so each one is an exact box filter of it
+            const auto [lw, lh] = level_size(w, h, l);
+            image_io::downscale(pixels, w, h, c, slot_data(slot) + level_offset(w, h, c, l), lw, lh);
+        }
+        if (data) {
+            free_image(data);
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto& s = _slots[slot];
+        s.key = key;
+        s.valid = true;
+        s.width = w;
+        s.height = h;
+        s.channels = c;
+        _slot_of[key] = slot;
+        _lru.splice(_lru.begin(), _lru, s.lru_it);
+
+        // The slot was reserved with one reference, which is the lease's
+        return lease_of(slot, level);
+    }
+
+    void ImageCache::preload(const std::vector<std::shared_ptr<Camera>>& cameras, int resize_factor) {
+        const size_t count = std::min(cameras.size(), capacity());
+        if (count == 0) {
+            return;
+        }
+
+        LOG_TIMER("ImageCache::preload");
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, count),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) {
+                                  acquire(cameras[i]->uid(), cameras[i]->image_path(), resize_factor);
+                              }
+                          });
+
+        if (count < cameras.size()) {
+            LOG_WARN("Image cache budget holds {} of {} images; the rest is decoded on demand with LRU eviction",
+                     count, cameras.size());
+        }
+        LOG_INFO("Preloaded {} images into RAM ({:.1f} MB arena)",
+                 size(), static_cast<double>(arena_bytes()) / (1024.0 * 1024.0));
+    }
+
+    size_t ImageCache::size() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _slot_of.size();
+    }
+
+    ImageCache::Stats ImageCache::stats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+} // namespace gs
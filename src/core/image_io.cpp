@@ -3,12 +3,13 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_RESIZE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 
 #include "core/image_io.hpp"
+#include "core/image_probe.hpp"
+#include "core/image_resize.hpp"
+#include "core/jpeg_decode.hpp"
 #include "external/stb_image.h"
-#include "external/stb_image_resize.h"
 #include "external/stb_image_write.h"
 
 #include <algorithm>
@@ -36,15 +37,19 @@ unsigned char* strip_image_alpha(unsigned char* img, int width, int height) {
 
 std::tuple<int, int, int>
 get_image_info(std::filesystem::path p) {
-    int w, h, c;
-    int result = stbi_info(p.string().c_str(), &w, &h, &c);
-    if (!result)
-        throw std::runtime_error("stbi_info failed: " + p.string() + " : " + stbi_failure_reason());
-    return {w, h, c};
+    auto info = image_io::probe_image(p);
+    if (!info)
+        throw std::runtime_error(info.error());
+    return {info->width, info->height, info->channels};
 }
 
 // Existing implementations...
 std::tuple<unsigned char*, int, int, int> load_image(std::filesystem::path p, int res_div) {
+    // JPEGs decode straight to the target resolution via the scaled IDCT when libjpeg is available
+    if (auto jpeg = image_io::decode_jpeg(p, res_div)) {
+        return *jpeg;
+    }
+
     int w, h, c;
     unsigned char* img = stbi_load(p.string().c_str(), &w, &h, &c, 0);
     if (!img)
@@ -55,17 +60,19 @@ std::tuple<unsigned char*, int, int, int> load_image(std::filesystem::path p, in
         c = 3;
     }
 
-    if (res_div == 2 || res_div == 4 || res_div == 8) {
-        int nw = w / res_div, nh = h / res_div;
-        auto* out = static_cast<unsigned char*>(malloc(nw * nh * c));
-        if (!stbir_resize_uint8(img, w, h, 0, out, nw, nh, 0, c))
-            throw std::runtime_error("Resize failed: " + p.string() + " : " + stbi_failure_reason());
+    if (res_div > 1) {
+        int nw, nh;
+        unsigned char* out;
+        try {
+            out = image_io::downscale(img, w, h, c, static_cast<float>(res_div), nw, nh);
+        } catch (const std::exception& e) {
+            stbi_image_free(img);
+            throw std::runtime_error("Resize failed: " + p.string() + " : " + e.what());
+        }
         stbi_image_free(img);
         img = out;
         w = nw;
         h = nh;
-    } else if (res_div > 1) {
-        LOG_ERROR("load_image: unimplement resize factor {}", res_div);
     }
 
     return {img, w, h, c};
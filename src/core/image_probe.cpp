@@ -0,0 +1,169 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/image_probe.hpp"
+#include "external/stb_image.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <tbb/parallel_for.h>
+
+namespace image_io {
+
+    namespace {
+        uint16_t read_be16(const uint8_t* p) {
+            return static_cast<uint16_t>((p[0] << 8) | p[1]);
+        }
+
+        uint32_t read_be32(const uint8_t* p) {
+            return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                   (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+        }
+
+        bool read_bytes(std::ifstream& file, uint8_t* dst, size_t n) {
+            return static_cast<bool>(file.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(n)));
+        }
+
+        // Walks the marker segments up to the first start-of-frame, skipping APPn/EXIF payloads with seeks
+        std::optional<ImageInfo> probe_jpeg(std::ifstream& file) {
+            file.seekg(2);
+            while (file) {
+                uint8_t byte = 0;
+                if (!read_bytes(file, &byte, 1) || byte != 0xFF) {
+                    return std::nullopt;
+                }
+                uint8_t marker = 0xFF;
+                while (marker == 0xFF) { // Fill bytes
+                    if (!read_bytes(file, &marker, 1)) {
+                        return std::nullopt;
+                    }
+                }
+                if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+                    continue; // Standalone markers carry no length
+                }
+                if (marker == 0xD9 || marker == 0xDA) {
+                    return std::nullopt; // Reached image data without a frame header
+                }
+
+                uint8_t len_bytes[2];
+                if (!read_bytes(file, len_bytes, 2)) {
+                    return std::nullopt;
+                }
+                const uint16_t length = read_be16(len_bytes);
+                if (length < 2) {
+                    return std::nullopt;
+                }
+
+                // SOF0..SOF15 except DHT (C4), JPG (C8) and DAC (CC)
+                const bool is_sof = marker >= 0xC0 && marker <= 0xCF &&
+                                    marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+                if (is_sof) {
+                    uint8_t sof[6];
+                    if (length < 8 || !read_bytes(file, sof, sizeof(sof))) {
+                        return std::nullopt;
+                    }
+                    const int height = read_be16(sof + 1);
+                    const int width = read_be16(sof + 3);
+                    const int components = sof[5];
+                    if (width == 0 || height == 0) {
+                        return std::nullopt; // Height defined by a later DNL segment
+                    }
+                    // stb_image decodes grayscale to 1 channel and everything else to RGB
+                    return ImageInfo{width, height, components >= 3 ? 3 : 1};
+                }
+                file.seekg(length - 2, std::ios::cur);
+            }
+            return std::nullopt;
+        }
+
+        // IHDR is always the first chunk; chunks up to IDAT are scanned only for tRNS
+        std::optional<ImageInfo> probe_png(std::ifstream& file) {
+            uint8_t ihdr[25];
+            file.seekg(8);
+            if (!read_bytes(file, ihdr, sizeof(ihdr)) || std::memcmp(ihdr + 4, "IHDR", 4) != 0) {
+                return std::nullopt;
+            }
+            const uint32_t width = read_be32(ihdr + 8);
+            const uint32_t height = read_be32(ihdr + 12);
+            const uint8_t color_type = ihdr[17];
+            if (width == 0 || height == 0 || width > (1u << 24) || height > (1u << 24)) {
+                return std::nullopt;
+            }
+
+            int channels = 0;
+            switch (color_type) {
+            case 0: channels = 1; break;
+            case 2: channels = 3; break;
+            case 3: channels = 3; break;
+            case 4: channels = 2; break;
+            case 6: channels = 4; break;
+            default: return std::nullopt;
+            }
+
+            if (color_type == 3) {
+                uint8_t chunk[8];
+                while (read_bytes(file, chunk, sizeof(chunk))) {
+                    if (std::memcmp(chunk + 4, "tRNS", 4) == 0) {
+                        channels = 4;
+                        break;
+                    }
+                    if (std::memcmp(chunk + 4, "IDAT", 4) == 0) {
+                        break;
+                    }
+                    file.seekg(static_cast<std::streamoff>(read_be32(chunk)) + 4, std::ios::cur); // data + CRC
+                }
+            }
+            return ImageInfo{static_cast<int>(width), static_cast<int>(height), channels};
+        }
+    } // namespace
+
+    std::expected<ImageInfo, std::string> probe_image(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return std::unexpected(std::format("Cannot open image: {}", path.string()));
+        }
+
+        std::array<uint8_t, 8> magic{};
+        file.read(reinterpret_cast<char*>(magic.data()), magic.size());
+        const auto n = file.gcount();
+        file.clear();
+
+        static constexpr uint8_t png_magic[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        std::optional<ImageInfo> info;
+        if (n >= 3 && magic[0] == 0xFF && magic[1] == 0xD8 && magic[2] == 0xFF) {
+            info = probe_jpeg(file);
+        } else if (n == 8 && std::memcmp(magic.data(), png_magic, 8) == 0) {
+            info = probe_png(file);
+        }
+        if (info) {
+            return *info;
+        }
+
+        // Other formats, and headers the fast path does not understand
+        int w, h, c;
+        if (!stbi_info(path.string().c_str(), &w, &h, &c)) {
+            return std::unexpected(std::format("Cannot read image header: {} : {}",
+                                               path.string(), stbi_failure_reason()));
+        }
+        return ImageInfo{w, h, c};
+    }
+
+    std::vector<std::expected<ImageInfo, std::string>>
+    probe_images(const std::vector<std::filesystem::path>& paths) {
+        std::vector<std::expected<ImageInfo, std::string>> results(paths.size(), std::unexpected(std::string()));
+        // Grain size 1: each probe is dominated by file open latency, not CPU
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, paths.size(), 1),
+                          [&](const tbb::blocked_range<size_t>& range) {
+                              for (size_t i = range.begin(); i < range.end(); ++i) {
+                                  results[i] = probe_image(paths[i]);
+                              }
+                          });
+        return results;
+    }
+
+} // namespace image_io
@@ -0,0 +1,216 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/image_resize.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <tuple>
+#include <tbb/parallel_for.h>
+#include <vector>
+
+// SIMD includes (with fallback)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace image_io {
+
+    namespace {
+        // Output rows per parallel task; keeps per-task scratch allocation negligible
+        constexpr int ROWS_PER_TASK = 8;
+        // uint16 row accumulators hold at most this many summed uint8 rows
+        constexpr int MAX_BLOCK_ROWS = 257;
+
+        // acc[i] += row[i]
+        void accumulate_row(uint16_t* acc, const uint8_t* row, size_t n) {
+            size_t i = 0;
+#if defined(__AVX2__)
+            for (; i + 32 <= n; i += 32) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+                const __m256i lo = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v));
+                const __m256i hi = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1));
+                auto* a = reinterpret_cast<__m256i*>(acc + i);
+                _mm256_storeu_si256(a, _mm256_add_epi16(_mm256_loadu_si256(a), lo));
+                _mm256_storeu_si256(a + 1, _mm256_add_epi16(_mm256_loadu_si256(a + 1), hi));
+            }
+#elif defined(__ARM_NEON)
+            for (; i + 16 <= n; i += 16) {
+                const uint8x16_t v = vld1q_u8(row + i);
+                vst1q_u16(acc + i, vaddw_u8(vld1q_u16(acc + i), vget_low_u8(v)));
+                vst1q_u16(acc + i + 8, vaddw_u8(vld1q_u16(acc + i + 8), vget_high_u8(v)));
+            }
+#endif
+            for (; i < n; ++i) {
+                acc[i] += row[i];
+            }
+        }
+
+        // Exact fx x fy block average: sum fy rows with SIMD, then fx columns per output pixel
+        void block_average(const uint8_t* src, int src_w, int channels,
+                           uint8_t* dst, int dst_w, int dst_h, int fx, int fy) {
+            const size_t row_bytes = static_cast<size_t>(src_w) * channels;
+            const uint32_t area = static_cast<uint32_t>(fx * fy);
+            const uint32_t half = area / 2;
+
+            tbb::parallel_for(tbb::blocked_range<int>(0, dst_h, ROWS_PER_TASK),
+                              [&](const tbb::blocked_range<int>& range) {
+                                  std::vector<uint16_t> acc(row_bytes);
+                                  for (int oy = range.begin(); oy < range.end(); ++oy) {
+                                      std::fill(acc.begin(), acc.end(), 0);
+                                      const uint8_t* rows = src + static_cast<size_t>(oy) * fy * row_bytes;
+                                      for (int k = 0; k < fy; ++k) {
+                                          accumulate_row(acc.data(), rows + k * row_bytes, row_bytes);
+                                      }
+
+                                      uint8_t* out = dst + static_cast<size_t>(oy) * dst_w * channels;
+                                      for (int ox = 0; ox < dst_w; ++ox) {
+                                          const uint16_t* block = acc.data() + static_cast<size_t>(ox) * fx * channels;
+                                          for (int ch = 0; ch < channels; ++ch) {
+                                              uint32_t sum = 0;
+                                              for (int k = 0; k < fx; ++k) {
+                                                  sum += block[k * channels + ch];
+                                              }
+                                              out[ox * channels + ch] = static_cast<uint8_t>((sum + half) / area);
+                                          }
+                                      }
+                                  }
+                              });
+        }
+
+        // Source footprint of one output sample along an axis
+        struct Taps {
+            std::vector<int> first;
+            std::vector<int> count;
+            std::vector<size_t> offset;
+            std::vector<float> weights;
+        };
+
+        Taps build_taps(int src_n, int dst_n) {
+            Taps taps;
+            taps.first.resize(dst_n);
+            taps.count.resize(dst_n);
+            taps.offset.resize(dst_n);
+
+            const double scale = static_cast<double>(src_n) / dst_n;
+            for (int o = 0; o < dst_n; ++o) {
+                const double start = o * scale;
+                const double end = std::min(start + scale, static_cast<double>(src_n));
+                const int i0 = static_cast<int>(std::floor(start));
+                const int i1 = std::min(src_n, static_cast<int>(std::ceil(end)));
+
+                taps.first[o] = i0;
+                taps.offset[o] = taps.weights.size();
+                for (int i = i0; i < i1; ++i) {
+                    const double overlap = std::min(end, i + 1.0) - std::max(start, static_cast<double>(i));
+                    taps.weights.push_back(static_cast<float>(std::max(overlap, 0.0) / scale));
+                }
+                taps.count[o] = i1 - i0;
+            }
+            return taps;
+        }
+
+        // General area filter for fractional factors (or sizes that do not divide evenly)
+        void area_resample(const uint8_t* src, int src_w, int src_h, int channels,
+                           uint8_t* dst, int dst_w, int dst_h) {
+            const Taps tx = build_taps(src_w, dst_w);
+            const Taps ty = build_taps(src_h, dst_h);
+            const size_t row_bytes = static_cast<size_t>(src_w) * channels;
+            const size_t out_row = static_cast<size_t>(dst_w) * channels;
+
+            tbb::parallel_for(tbb::blocked_range<int>(0, dst_h, ROWS_PER_TASK),
+                              [&](const tbb::blocked_range<int>& range) {
+                                  std::vector<float> hrow(out_row);
+                                  std::vector<float> acc(out_row);
+                                  for (int oy = range.begin(); oy < range.end(); ++oy) {
+                                      std::fill(acc.begin(), acc.end(), 0.0f);
+
+                                      for (int k = 0; k < ty.count[oy]; ++k) {
+                                          const uint8_t* srow = src + static_cast<size_t>(ty.first[oy] + k) * row_bytes;
+
+                                          // Horizontal pass
+                                          for (int ox = 0; ox < dst_w; ++ox) {
+                                              const float* wx = tx.weights.data() + tx.offset[ox];
+                                              const uint8_t* px = srow + static_cast<size_t>(tx.first[ox]) * channels;
+                                              for (int ch = 0; ch < channels; ++ch) {
+                                                  float s = 0.0f;
+                                                  for (int j = 0; j < tx.count[ox]; ++j) {
+                                                      s += wx[j] * px[j * channels + ch];
+                                                  }
+                                                  hrow[ox * channels + ch] = s;
+                                              }
+                                          }
+
+                                          // Vertical accumulation (vectorized by the compiler)
+                                          const float wy = ty.weights[ty.offset[oy] + k];
+                                          for (size_t i = 0; i < out_row; ++i) {
+                                              acc[i] += wy * hrow[i];
+                                          }
+                                      }
+
+                                      uint8_t* out = dst + static_cast<size_t>(oy) * out_row;
+                                      for (size_t i = 0; i < out_row; ++i) {
+                                          out[i] = static_cast<uint8_t>(std::clamp(acc[i] + 0.5f, 0.0f, 255.0f));
+                                      }
+                                  }
+                              });
+        }
+    } // namespace
+
+    std::pair<int, int> downscaled_size(int width, int height, float factor) {
+        if (factor <= 1.0f) {
+            return {width, height};
+        }
+        // Small epsilon so exact factors such as 3000 / 3.0f do not truncate to 999
+        const int w = static_cast<int>(std::floor(width / static_cast<double>(factor) + 1e-4));
+        const int h = static_cast<int>(std::floor(height / static_cast<double>(factor) + 1e-4));
+        return {std::max(w, 1), std::max(h, 1)};
+    }
+
+    void downscale(const unsigned char* src, int src_w, int src_h, int channels,
+                   unsigned char* dst, int dst_w, int dst_h) {
+        if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0 || channels <= 0) {
+            throw std::invalid_argument("downscale: invalid image");
+        }
+        if (dst_w > src_w || dst_h > src_h) {
+            throw std::invalid_argument(std::format("downscale: cannot upscale {}x{} to {}x{}",
+                                                    src_w, src_h, dst_w, dst_h));
+        }
+
+        if (dst_w == src_w && dst_h == src_h) {
+            std::memcpy(dst, src, static_cast<size_t>(src_w) * src_h * channels);
+            return;
+        }
+
+        if (src_w % dst_w == 0 && src_h % dst_h == 0 && src_h / dst_h <= MAX_BLOCK_ROWS) {
+            block_average(src, src_w, channels, dst, dst_w, dst_h, src_w / dst_w, src_h / dst_h);
+        } else {
+            area_resample(src, src_w, src_h, channels, dst, dst_w, dst_h);
+        }
+    }
+
+    unsigned char* downscale(const unsigned char* src, int src_w, int src_h, int channels,
+                             float factor, int& dst_w, int& dst_h) {
+        std::tie(dst_w, dst_h) = downscaled_size(src_w, src_h, factor);
+        auto* out = static_cast<unsigned char*>(malloc(static_cast<size_t>(dst_w) * dst_h * channels));
+        if (!out) {
+            throw std::runtime_error("downscale: allocation failed");
+        }
+        try {
+            downscale(src, src_w, src_h, channels, out, dst_w, dst_h);
+        } catch (...) {
+            free(out);
+            throw;
+        }
+        return out;
+    }
+
+} // namespace image_io
@@ -0,0 +1,210 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/jpeg_decode.hpp"
+#include "core/image_resize.hpp"
+#include "core/logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef HAS_LIBJPEG
+#include <csetjmp>
+#include <jpeglib.h>
+#endif
+
+namespace image_io {
+
+#ifdef HAS_LIBJPEG
+    namespace {
+        struct ErrorManager {
+            jpeg_error_mgr pub;
+            std::jmp_buf jump;
+            char message[JMSG_LENGTH_MAX];
+        };
+
+        void error_exit(j_common_ptr cinfo) {
+            auto* err = reinterpret_cast<ErrorManager*>(cinfo->err);
+            (*cinfo->err->format_message)(cinfo, err->message);
+            std::longjmp(err->jump, 1);
+        }
+
+        // Corrupt-data warnings would otherwise be printed to stderr
+        void silent_output(j_common_ptr) {}
+
+        struct Decoded {
+            unsigned char* pixels = nullptr;
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            int source_width = 0;
+            int source_height = 0;
+        };
+
+        // Largest IDCT scale that does not decode below the requested resolution
+        int pick_denom(int res_div) {
+            for (int denom : {8, 4, 2}) {
+                if (res_div >= denom) {
+                    return denom;
+                }
+            }
+            return 1;
+        }
+
+        // error_exit longjmps back into this frame, so it must only hold trivially destructible locals
+        bool decode_scaled(const unsigned char* data, size_t size, int denom, Decoded& out) {
+            jpeg_decompress_struct cinfo;
+            ErrorManager err;
+            cinfo.err = jpeg_std_error(&err.pub);
+            err.pub.error_exit = error_exit;
+            err.pub.output_message = silent_output;
+
+            if (setjmp(err.jump)) {
+                jpeg_destroy_decompress(&cinfo);
+                std::free(out.pixels);
+                out.pixels = nullptr;
+                LOG_DEBUG("libjpeg decode failed, falling back to stb: {}", err.message);
+                return false;
+            }
+
+            jpeg_create_decompress(&cinfo);
+            jpeg_mem_src(&cinfo, data, static_cast<unsigned long>(size));
+            jpeg_read_header(&cinfo, TRUE);
+
+            // Same channel layout stb_image produces; CMYK/YCCK are left to stb
+            if (cinfo.jpeg_color_space == JCS_GRAYSCALE) {
+                cinfo.out_color_space = JCS_GRAYSCALE;
+            } else if (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_RGB) {
+                cinfo.out_color_space = JCS_RGB;
+            } else {
+                jpeg_destroy_decompress(&cinfo);
+                return false;
+            }
+            cinfo.scale_num = 1;
+            cinfo.scale_denom = static_cast<unsigned int>(denom);
+            cinfo.dct_method = JDCT_ISLOW;
+
+            // Keep only output pixels backed by a full denom x denom source block, matching
+            // the truncation of an area downscale; the scaled IDCT rounds partial blocks up
+            const int width = static_cast<int>(cinfo.image_width) / denom;
+            const int height = static_cast<int>(cinfo.image_height) / denom;
+            if (width == 0 || height == 0) {
+                jpeg_destroy_decompress(&cinfo);
+                return false;
+            }
+
+            jpeg_start_decompress(&cinfo);
+            const int channels = cinfo.output_components;
+            const size_t out_row = static_cast<size_t>(width) * channels;
+            out.pixels = static_cast<unsigned char*>(std::malloc(out_row * height));
+            if (!out.pixels) {
+                jpeg_destroy_decompress(&cinfo);
+                return false;
+            }
+
+            JSAMPARRAY row = (*cinfo.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_IMAGE,
+                                                        cinfo.output_width * channels, 1);
+            while (cinfo.output_scanline < static_cast<JDIMENSION>(height)) {
+                const size_t y = cinfo.output_scanline;
+                jpeg_read_scanlines(&cinfo, row, 1);
+                std::memcpy(out.pixels + y * out_row, row[0], out_row);
+            }
+            if (cinfo.output_scanline < cinfo.output_height) {
+                jpeg_abort_decompress(&cinfo);
+            } else {
+                jpeg_finish_decompress(&cinfo);
+            }
+
+            out.width = width;
+            out.height = height;
+            out.channels = channels;
+            out.source_width = static_cast<int>(cinfo.image_width);
+            out.source_height = static_cast<int>(cinfo.image_height);
+            jpeg_destroy_decompress(&cinfo);
+            return true;
+        }
+    } // namespace
+#endif
+
+    bool has_fast_jpeg() {
+#ifdef HAS_LIBJPEG
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::optional<std::tuple<unsigned char*, int, int, int>>
+    decode_jpeg(const unsigned char* data, size_t size, int res_div) {
+#ifdef HAS_LIBJPEG
+        if (!data || size < 3 || data[0] != 0xFF || data[1] != 0xD8 || data[2] != 0xFF) {
+            return std::nullopt;
+        }
+
+        Decoded img;
+        if (!decode_scaled(data, size, pick_denom(res_div), img)) {
+            return std::nullopt;
+        }
+
+        // Factors the IDCT cannot cover (3 = 2 x 1.5, 6 = 4 x 1.5, ...) finish with the area filter
+        const auto [dst_w, dst_h] = downscaled_size(img.source_width, img.source_height,
+                                                    res_div > 1 ? static_cast<float>(res_div) : 1.0f);
+        if (dst_w == img.width && dst_h == img.height) {
+            return std::make_tuple(img.pixels, img.width, img.height, img.channels);
+        }
+
+        auto* out = static_cast<unsigned char*>(std::malloc(static_cast<size_t>(dst_w) * dst_h * img.channels));
+        if (!out) {
+            std::free(img.pixels);
+            throw std::runtime_error("decode_jpeg: allocation failed");
+        }
+        try {
+            downscale(img.pixels, img.width, img.height, img.channels, out, dst_w, dst_h);
+        } catch (...) {
+            std::free(out);
+            std::free(img.pixels);
+            throw;
+        }
+        std::free(img.pixels);
+        return std::make_tuple(out, dst_w, dst_h, img.channels);
+#else
+        (void)data;
+        (void)size;
+        (void)res_div;
+        return std::nullopt;
+#endif
+    }
+
+    std::optional<std::tuple<unsigned char*, int, int, int>>
+    decode_jpeg(const std::filesystem::path& path, int res_div) {
+        if (!has_fast_jpeg()) {
+            return std::nullopt;
+        }
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return std::nullopt;
+        }
+        const auto size = static_cast<size_t>(file.tellg());
+        unsigned char magic[3] = {};
+        file.seekg(0);
+        if (size < sizeof(magic) || !file.read(reinterpret_cast<char*>(magic), sizeof(magic)) ||
+            magic[0] != 0xFF || magic[1] != 0xD8 || magic[2] != 0xFF) {
+            return std::nullopt;
+        }
+
+        std::vector<unsigned char> bytes(size);
+        std::memcpy(bytes.data(), magic, sizeof(magic));
+        if (!file.read(reinterpret_cast<char*>(bytes.data() + sizeof(magic)),
+                       static_cast<std::streamsize>(size - sizeof(magic)))) {
+            return std::nullopt;
+        }
+        return decode_jpeg(bytes.data(), bytes.size(), res_div);
+    }
+
+} // namespace image_io
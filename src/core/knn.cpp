@@ -0,0 +1,111 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/knn.hpp"
+#include "external/nanoflann.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace gs {
+
+    namespace {
+        // Point cloud adaptor for nanoflann
+        struct PointCloudAdaptor {
+            const float* points;
+            size_t num_points;
+
+            inline size_t kdtree_get_point_count() const { return num_points; }
+
+            inline float kdtree_get_pt(const size_t idx, const size_t dim) const {
+                return points[idx * 3 + dim];
+            }
+
+            template <class BBOX>
+            bool kdtree_get_bbox(BBOX& /* bb */) const { return false; }
+        };
+
+        using KDTree = nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, PointCloudAdaptor>,
+                                                           PointCloudAdaptor, 3, uint32_t>;
+
+        // Queries per TBB task; small enough to balance, large enough to amortize the scratch buffers
+        constexpr size_t QUERY_GRAIN = 1024;
+    } // namespace
+
+    struct KnnIndex::Tree {
+        PointCloudAdaptor cloud;
+        KDTree index;
+
+        // The tree is built in the constructor; n_thread_build = 0 uses every hardware thread
+        Tree(const float* points, size_t num_points)
+            : cloud{points, num_points},
+              index(3, cloud, nanoflann::KDTreeSingleIndexAdaptorParams(10, nanoflann::KDTreeSingleIndexAdaptorFlags::None, 0)) {}
+    };
+
+    KnnIndex::KnnIndex(const float* points, size_t num_points)
+        : _num_points(num_points) {
+        if (num_points >= INVALID) {
+            throw std::length_error("KnnIndex supports at most 2^32 - 1 points");
+        }
+        if (num_points > 0) {
+            _tree = std::make_unique<Tree>(points, num_points);
+        }
+    }
+
+    KnnIndex::~KnnIndex() = default;
+
+    void KnnIndex::query(const float* queries, size_t num_queries, size_t k,
+                         uint32_t* indices, float* sq_dists) const {
+        const size_t found = std::min(k, _num_points);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_queries, QUERY_GRAIN), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t q = range.begin(); q < range.end(); ++q) {
+                uint32_t* row_indices = indices + q * k;
+                float* row_dists = sq_dists + q * k;
+                if (found > 0) {
+                    nanoflann::KNNResultSet<float, uint32_t> result(found);
+                    result.init(row_indices, row_dists);
+                    _tree->index.findNeighbors(result, queries + q * 3);
+                }
+                std::fill(row_indices + found, row_indices + k, INVALID);
+                std::fill(row_dists + found, row_dists + k, std::numeric_limits<float>::infinity());
+            }
+        });
+    }
+
+    std::vector<float> KnnIndex::mean_neighbor_distances(size_t k, float fallback) const {
+        std::vector<float> result(_num_points, fallback);
+        if (_num_points <= 1 || k == 0) {
+            return result;
+        }
+
+        // The point itself comes back at distance 0 and is skipped with any other duplicate
+        const float* points = _tree->cloud.points;
+        const size_t found = std::min(k + 1, _num_points);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, _num_points, QUERY_GRAIN), [&](const tbb::blocked_range<size_t>& range) {
+            std::vector<uint32_t> ret_indices(found);
+            std::vector<float> out_dists_sqr(found);
+            for (size_t i = range.begin(); i < range.end(); ++i) {
+                nanoflann::KNNResultSet<float, uint32_t> result_set(found);
+                result_set.init(ret_indices.data(), out_dists_sqr.data());
+                _tree->index.findNeighbors(result_set, points + i * 3);
+
+                float sum_dist = 0.0f;
+                size_t valid_neighbors = 0;
+                for (size_t j = 0; j < result_set.size() && valid_neighbors < k; ++j) {
+                    if (out_dists_sqr[j] > 1e-8f) {
+                        sum_dist += std::sqrt(out_dists_sqr[j]);
+                        valid_neighbors++;
+                    }
+                }
+                if (valid_neighbors > 0) {
+                    result[i] = sum_dist / static_cast<float>(valid_neighbors);
+                }
+            }
+        });
+        return result;
+    }
+
+} // namespace gs
@@ -121,7 +121,19 @@ namespace gs {
                     {"init_scaling", defaults.init_scaling, "Initial scaling value for new Gaussians"},
                     {"sh_degree", defaults.sh_degree, "Spherical harmonics degree"},
                     {"num_workers", defaults.num_workers, "Number of image loader threads"},
+                    {"prefetch_depth", defaults.prefetch_depth, "Number of decoded images kept ready ahead of training"},
+                    {"checkpoint_every", defaults.checkpoint_every, "Write a resumable training checkpoint every N iterations (0 = disabled)"},
+                    {"batch_views", defaults.batch_views, "Number of views accumulated into each optimizer step"},
+                    {"device", defaults.device, "Training device: cuda, cuda:N or cpu"},
+                    {"sparse_adam", defaults.sparse_adam, "Update only the Gaussians visible in the step's views"},
+                    {"shn_precision", defaults.shn_precision, "Storage type of the higher-degree SH coefficients: fp32, fp16, bf16"},
+                    {"moment_precision", defaults.moment_precision, "Storage type of the Adam moments: fp32, bf16"},
+                    {"view_sampling", defaults.view_sampling, "Training view order: uniform, loss"},
+                    {"view_sampling_temperature", defaults.view_sampling_temperature, "Exponent on the loss estimate for loss sampling"},
+                    {"view_sampling_floor", defaults.view_sampling_floor, "Probability mass loss sampling spreads uniformly over all views"},
                     {"max_cap", defaults.max_cap, "Maximum number of Gaussians for MCMC strategy"},
+                    {"preload_to_ram", defaults.preload_to_ram, "Decode all training images into RAM at startup"},
+                    {"preload_budget_mb", defaults.preload_budget_mb, "RAM budget for preloaded images in MB (0 = unlimited)"},
                     {"render_mode", defaults.render_mode, "Render mode: RGB, D, ED, RGB_D, RGB_ED"},
                     {"strategy", defaults.strategy, "Optimization strategy: mcmc, default"},
                     {"pose_optimization", defaults.pose_optimization, "Pose optimization type: none, direct, mlp"},
@@ -148,6 +160,9 @@ namespace gs {
                     {"random", defaults.random, "Use random initialization instead of SfM"},
                     {"init_num_pts", defaults.init_num_pts, "Number of random initialization points"},
                     {"init_extent", defaults.init_extent, "Extent of random initialization"},
+                    {"init_voxel_size", defaults.init_voxel_size, "Voxel edge length for averaging the SfM points (0 = off)"},
+                    {"init_max_points", defaults.init_max_points, "Voxel-downsample the SfM points to about this many (0 = off)"},
+                    {"init_outlier_std", defaults.init_outlier_std, "Standard deviations above the mean neighbour distance at which SfM points are dropped (0 = off)"},
                     {"enable_sparsity", defaults.enable_sparsity, "Enable sparsity optimization"},
                     {"sparsify_steps", defaults.sparsify_steps, "Number of steps for sparsification"},
                     {"init_rho", defaults.init_rho, "Initial ADMM penalty parameter"},
@@ -193,7 +208,7 @@ namespace gs {
                             break;
                         }
                     }
-                    if (key == "eval_steps" || key == "save_steps") {
+                    if (key == "eval_steps" || key == "save_steps" || key == "resolution_steps") {
                         found = true;
                     }
                     if (!found) {
@@ -275,11 +290,24 @@ namespace gs {
             opt_json["init_opacity"] = init_opacity;
             opt_json["init_scaling"] = init_scaling;
             opt_json["num_workers"] = num_workers;
+            opt_json["prefetch_depth"] = prefetch_depth;
+            opt_json["checkpoint_every"] = checkpoint_every;
+            opt_json["batch_views"] = batch_views;
+            opt_json["device"] = device;
+            opt_json["sparse_adam"] = sparse_adam;
+            opt_json["shn_precision"] = shn_precision;
+            opt_json["moment_precision"] = moment_precision;
+            opt_json["view_sampling"] = view_sampling;
+            opt_json["view_sampling_temperature"] = view_sampling_temperature;
+            opt_json["view_sampling_floor"] = view_sampling_floor;
             opt_json["max_cap"] = max_cap;
+            opt_json["preload_to_ram"] = preload_to_ram;
+            opt_json["preload_budget_mb"] = preload_budget_mb;
             opt_json["render_mode"] = render_mode;
             opt_json["pose_optimization"] = pose_optimization;
             opt_json["eval_steps"] = eval_steps;
             opt_json["save_steps"] = save_steps;
+            opt_json["resolution_steps"] = resolution_steps;
             opt_json["enable_eval"] = enable_eval;
             opt_json["enable_save_eval_images"] = enable_save_eval_images;
             opt_json["strategy"] = strategy;
@@ -304,6 +332,9 @@ namespace gs {
             opt_json["random"] = random;
             opt_json["init_num_pts"] = init_num_pts;
             opt_json["init_extent"] = init_extent;
+            opt_json["init_voxel_size"] = init_voxel_size;
+            opt_json["init_max_points"] = init_max_points;
+            opt_json["init_outlier_std"] = init_outlier_std;
             opt_json["save_sog"] = save_sog;
             opt_json["sog_iterations"] = sog_iterations;
             opt_json["enable_sparsity"] = enable_sparsity;
@@ -394,6 +425,13 @@ namespace gs {
                 }
             }
 
+            if (json.contains("resolution_steps")) {
+                params.resolution_steps.clear();
+                for (const auto& step : json["resolution_steps"]) {
+                    params.resolution_steps.push_back(step.get<size_t>());
+                }
+            }
+
             if (json.contains("enable_eval")) {
                 params.enable_eval = json["enable_eval"];
             }
@@ -463,6 +501,15 @@ namespace gs {
             if (json.contains("init_extent")) {
                 params.init_extent = json["init_extent"];
             }
+            if (json.contains("init_voxel_size")) {
+                params.init_voxel_size = json["init_voxel_size"];
+            }
+            if (json.contains("init_max_points")) {
+                params.init_max_points = json["init_max_points"];
+            }
+            if (json.contains("init_outlier_std")) {
+                params.init_outlier_std = json["init_outlier_std"];
+            }
             if (json.contains("save_sog")) {
                 params.save_sog = json["save_sog"];
             }
@@ -481,6 +528,42 @@ namespace gs {
             if (json.contains("prune_ratio")) {
                 params.prune_ratio = json["prune_ratio"];
             }
+            if (json.contains("prefetch_depth")) {
+                params.prefetch_depth = json["prefetch_depth"];
+            }
+            if (json.contains("checkpoint_every")) {
+                params.checkpoint_every = json["checkpoint_every"];
+            }
+            if (json.contains("batch_views")) {
+                params.batch_views = json["batch_views"];
+            }
+            if (json.contains("device")) {
+                params.device = json["device"];
+            }
+            if (json.contains("sparse_adam")) {
+                params.sparse_adam = json["sparse_adam"];
+            }
+            if (json.contains("shn_precision")) {
+                params.shn_precision = json["shn_precision"];
+            }
+            if (json.contains("moment_precision")) {
+                params.moment_precision = json["moment_precision"];
+            }
+            if (json.contains("view_sampling")) {
+                params.view_sampling = json["view_sampling"];
+            }
+            if (json.contains("view_sampling_temperature")) {
+                params.view_sampling_temperature = json["view_sampling_temperature"];
+            }
+            if (json.contains("view_sampling_floor")) {
+                params.view_sampling_floor = json["view_sampling_floor"];
+            }
+            if (json.contains("preload_to_ram")) {
+                params.preload_to_ram = json["preload_to_ram"];
+            }
+            if (json.contains("preload_budget_mb")) {
+                params.preload_budget_mb = json["preload_budget_mb"];
+            }
 
             return params;
         }
@@ -533,6 +616,8 @@ namespace gs {
                 json["dataset"]["images"] = params.dataset.images;
                 json["dataset"]["resize_factor"] = params.dataset.resize_factor;
                 json["dataset"]["test_every"] = params.dataset.test_every;
+                json["dataset"]["image_cache_dir"] = params.dataset.image_cache_dir.string();
+                json["dataset"]["validate_images"] = params.dataset.validate_images;
 
                 // Optimization configuration
                 nlohmann::json opt_json = params.optimization.to_json();
@@ -0,0 +1,295 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/point_cloud_filter.hpp"
+#include "core/knn.hpp"
+#include "core/logger.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gs {
+
+    namespace {
+        // 21 bits per axis pack a voxel coordinate into one 64-bit key
+        constexpr int KEY_BITS = 21;
+        constexpr int64_t KEY_CELLS = int64_t{1} << KEY_BITS;
+        // Hash partitions processed in parallel, each with its own map
+        constexpr size_t PARTITIONS = 256;
+        constexpr size_t GRAIN = size_t{1} << 16;
+        // Bisection steps of the voxel size search, and the accepted deviation from the target
+        constexpr int MAX_SEARCH_STEPS = 24;
+        constexpr double SEARCH_TOLERANCE = 0.05;
+
+        struct Bounds {
+            std::array<float, 3> min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+            std::array<float, 3> max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+        };
+
+        Bounds bounds_of(const float* points, size_t n) {
+            return tbb::parallel_reduce(
+                tbb::blocked_range<size_t>(0, n, GRAIN), Bounds{},
+                [&](const tbb::blocked_range<size_t>& range, Bounds b) {
+                    for (size_t i = range.begin(); i < range.end(); ++i) {
+                        for (int d = 0; d < 3; ++d) {
+                            b.min[d] = std::min(b.min[d], points[i * 3 + d]);
+                            b.max[d] = std::max(b.max[d], points[i * 3 + d]);
+                        }
+                    }
+                    return b;
+                },
+                [](Bounds a, const Bounds& b) {
+                    for (int d = 0; d < 3; ++d) {
+                        a.min[d] = std::min(a.min[d], b.min[d]);
+                        a.max[d] = std::max(a.max[d], b.max[d]);
+                    }
+                    return a;
+                });
+        }
+
+        // splitmix64 finalizer; spreads neighbouring voxels over the partitions
+        size_t partition_of(uint64_t key) {
+            key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ull;
+            key = (key ^ (key >> 27)) * 0x94D049BB133111EBull;
+            return static_cast<size_t>((key ^ (key >> 31)) % PARTITIONS);
+        }
+
+        // Smallest voxel size whose cell coordinates fit into KEY_BITS on every axis
+        float min_voxel_size(const Bounds& bounds) {
+            const float extent = std::max({bounds.max[0] - bounds.min[0], bounds.max[1] - bounds.min[1], bounds.max[2] - bounds.min[2]});
+            return std::max(extent / static_cast<float>(KEY_CELLS - 1), std::numeric_limits<float>::min());
+        }
+
+        // Requires voxel_size >= min_voxel_size(bounds); the clamp then only absorbs rounding
+        std::vector<uint64_t> voxel_keys(const float* points, size_t n, const Bounds& bounds, float voxel_size) {
+            const double inv_size = 1.0 / static_cast<double>(voxel_size);
+            std::vector<uint64_t> keys(n);
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, n, GRAIN), [&](const tbb::blocked_range<size_t>& range) {
+                for (size_t i = range.begin(); i < range.end(); ++i) {
+                    uint64_t key = 0;
+                    for (int d = 0; d < 3; ++d) {
+                        const double offset = static_cast<double>(points[i * 3 + d]) - bounds.min[d];
+                        const auto cell = static_cast<int64_t>(offset * inv_size);
+                        key = (key << KEY_BITS) | static_cast<uint64_t>(std::clamp<int64_t>(cell, 0, KEY_CELLS - 1));
+                    }
+                    keys[i] = key;
+                }
+            });
+            return keys;
+        }
+
+        // Point indices grouped by the partition of their voxel, in input order within a partition,
+        // so that every later pass is deterministic
+        struct Partitioned {
+            std::vector<uint32_t> indices;
+            std::array<size_t, PARTITIONS + 1> offsets{};
+        };
+
+        Partitioned partition(const std::vector<uint64_t>& keys) {
+            const size_t n = keys.size();
+            const size_t chunks = (n + GRAIN - 1) / GRAIN;
+            std::vector<std::array<size_t, PARTITIONS>> cursors(chunks);
+            tbb::parallel_for(size_t{0}, chunks, [&](size_t c) {
+                auto& count = cursors[c];
+                count.fill(0);
+                for (size_t i = c * GRAIN, end = std::min(n, (c + 1) * GRAIN); i < end; ++i) {
+                    ++count[partition_of(keys[i])];
+                }
+            });
+
+            // Partition-major prefix sums turn the counts into write cursors
+            Partitioned result;
+            size_t offset = 0;
+            for (size_t p = 0; p < PARTITIONS; ++p) {
+                result.offsets[p] = offset;
+                for (size_t c = 0; c < chunks; ++c) {
+                    const size_t count = cursors[c][p];
+                    cursors[c][p] = offset;
+                    offset += count;
+                }
+            }
+            result.offsets[PARTITIONS] = offset;
+
+            result.indices.resize(n);
+            tbb::parallel_for(size_t{0}, chunks, [&](size_t c) {
+                auto& cursor = cursors[c];
+                for (size_t i = c * GRAIN, end = std::min(n, (c + 1) * GRAIN); i < end; ++i) {
+                    result.indices[cursor[partition_of(keys[i])]++] = static_cast<uint32_t>(i);
+                }
+            });
+            return result;
+        }
+
+        size_t count_voxels(const float* points, size_t n, const Bounds& bounds, float voxel_size) {
+            const auto keys = voxel_keys(points, n, bounds, voxel_size);
+            const auto parts = partition(keys);
+            std::atomic<size_t> total{0};
+            tbb::parallel_for(size_t{0}, PARTITIONS, [&](size_t p) {
+                std::unordered_set<uint64_t> occupied;
+                occupied.reserve(parts.offsets[p + 1] - parts.offsets[p]);
+                for (size_t j = parts.offsets[p]; j < parts.offsets[p + 1]; ++j) {
+                    occupied.insert(keys[parts.indices[j]]);
+                }
+                total += occupied.size();
+            });
+            return total;
+        }
+
+        // Voxel size whose occupied cell count is closest to `target`, by bisection on a log scale
+        float search_voxel_size(const float* points, size_t n, const Bounds& bounds, int64_t target) {
+            const float extent = std::max({bounds.max[0] - bounds.min[0], bounds.max[1] - bounds.min[1], bounds.max[2] - bounds.min[2]});
+            const float smallest = min_voxel_size(bounds);
+            float lo = smallest;                          // Too many voxels
+            float hi = std::max(extent * 2.0f, smallest); // A single voxel
+            float best = hi;
+            double best_error = std::numeric_limits<double>::max();
+            for (int step = 0; step < MAX_SEARCH_STEPS; ++step) {
+                const float size = std::sqrt(lo * hi);
+                const auto count = static_cast<double>(count_voxels(points, n, bounds, size));
+                const double error = std::abs(count - static_cast<double>(target)) / static_cast<double>(target);
+                if (error < best_error) {
+                    best_error = error;
+                    best = size;
+                }
+                if (error <= SEARCH_TOLERANCE) {
+                    break;
+                }
+                (count > static_cast<double>(target) ? lo : hi) = size;
+            }
+            return best;
+        }
+
+        struct VoxelSums {
+            std::array<double, 3> position{};
+            std::array<double, 3> color{};
+            uint32_t count = 0;
+        };
+
+        void voxel_downsample(std::vector<float>& means, std::vector<float>& colors, const Bounds& bounds, float voxel_size) {
+            const size_t n = means.size() / 3;
+            const auto keys = voxel_keys(means.data(), n, bounds, voxel_size);
+            const auto parts = partition(keys);
+
+            std::array<std::vector<VoxelSums>, PARTITIONS> voxels;
+            tbb::parallel_for(size_t{0}, PARTITIONS, [&](size_t p) {
+                std::unordered_map<uint64_t, uint32_t> slot;
+                slot.reserve(parts.offsets[p + 1] - parts.offsets[p]);
+                auto& sums = voxels[p];
+                for (size_t j = parts.offsets[p]; j < parts.offsets[p + 1]; ++j) {
+                    const uint32_t i = parts.indices[j];
+                    const auto [it, inserted] = slot.try_emplace(keys[i], static_cast<uint32_t>(sums.size()));
+                    if (inserted) {
+                        sums.emplace_back();
+                    }
+                    auto& voxel = sums[it->second];
+                    for (int d = 0; d < 3; ++d) {
+                        voxel.position[d] += means[i * 3 + d];
+                        voxel.color[d] += colors[i * 3 + d];
+                    }
+                    ++voxel.count;
+                }
+            });
+
+            std::array<size_t, PARTITIONS + 1> offsets{};
+            for (size_t p = 0; p < PARTITIONS; ++p) {
+                offsets[p + 1] = offsets[p] + voxels[p].size();
+            }
+            std::vector<float> out_means(offsets[PARTITIONS] * 3);
+            std::vector<float> out_colors(offsets[PARTITIONS] * 3);
+            tbb::parallel_for(size_t{0}, PARTITIONS, [&](size_t p) {
+                for (size_t v = 0; v < voxels[p].size(); ++v) {
+                    const auto& voxel = voxels[p][v];
+                    const size_t o = (offsets[p] + v) * 3;
+                    for (int d = 0; d < 3; ++d) {
+                        out_means[o + d] = static_cast<float>(voxel.position[d] / voxel.count);
+                        out_colors[o + d] = static_cast<float>(voxel.color[d] / voxel.count);
+                    }
+                }
+            });
+            means = std::move(out_means);
+            colors = std::move(out_colors);
+        }
+
+        void remove_outliers(std::vector<float>& means, std::vector<float>& colors, int neighbors, float std_ratio) {
+            const size_t n = means.size() / 3;
+            if (n <= static_cast<size_t>(neighbors)) {
+                return;
+            }
+            const KnnIndex index(means.data(), n);
+            const auto distances = index.mean_neighbor_distances(static_cast<size_t>(neighbors), 0.0f);
+
+            double sum = 0.0, sum_sq = 0.0;
+            for (const float d : distances) {
+                sum += d;
+                sum_sq += static_cast<double>(d) * d;
+            }
+            const double mean = sum / static_cast<double>(n);
+            const double stddev = std::sqrt(std::max(sum_sq / static_cast<double>(n) - mean * mean, 0.0));
+            const auto threshold = static_cast<float>(mean + std_ratio * stddev);
+
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (distances[i] <= threshold) {
+                    std::copy_n(means.begin() + i * 3, 3, means.begin() + kept * 3);
+                    std::copy_n(colors.begin() + i * 3, 3, colors.begin() + kept * 3);
+                    ++kept;
+                }
+            }
+            means.resize(kept * 3);
+            colors.resize(kept * 3);
+        }
+    } // namespace
+
+    PointCloud filter_point_cloud(const PointCloud& cloud, const PointCloudFilterOptions& options) {
+        const int64_t n = cloud.size();
+        TORCH_CHECK(n == 0 || (cloud.means.dim() == 2 && cloud.means.size(1) == 3), "Point cloud means must have shape [N, 3]");
+        TORCH_CHECK(n < static_cast<int64_t>(std::numeric_limits<uint32_t>::max()), "Point cloud too large to filter");
+
+        const auto color_dtype = cloud.colors.defined() ? cloud.colors.scalar_type() : torch::kUInt8;
+        const auto means_cpu = cloud.means.defined() ? cloud.means.to(torch::kCPU, torch::kFloat32).contiguous()
+                                                     : torch::empty({0, 3}, torch::kFloat32);
+        const auto colors_cpu = cloud.colors.defined() ? cloud.colors.to(torch::kCPU, torch::kFloat32).contiguous()
+                                                       : torch::zeros({n, 3}, torch::kFloat32);
+        std::vector<float> means(means_cpu.data_ptr<float>(), means_cpu.data_ptr<float>() + n * 3);
+        std::vector<float> colors(colors_cpu.data_ptr<float>(), colors_cpu.data_ptr<float>() + n * 3);
+
+        if (n > 0 && (options.voxel_size > 0.0f || (options.target_count > 0 && options.target_count < n))) {
+            const auto bounds = bounds_of(means.data(), static_cast<size_t>(n));
+            float voxel_size = options.voxel_size > 0.0f
+                                   ? options.voxel_size
+                                   : search_voxel_size(means.data(), static_cast<size_t>(n), bounds, options.target_count);
+            // Finer cells would not fit the packed keys, and distant points would share the border voxel
+            if (const float smallest = min_voxel_size(bounds); voxel_size < smallest) {
+                LOG_WARN("Voxel size {:.6g} is too fine for a point cloud spanning {} cells per axis, using {:.6g}",
+                         voxel_size, KEY_CELLS, smallest);
+                voxel_size = smallest;
+            }
+            voxel_downsample(means, colors, bounds, voxel_size);
+            LOG_DEBUG("Voxel size {:.6f} averaged {} points into {}", voxel_size, n, means.size() / 3);
+        }
+
+        if (options.outlier_std > 0.0f && options.outlier_neighbors > 0) {
+            const size_t before = means.size() / 3;
+            remove_outliers(means, colors, options.outlier_neighbors, options.outlier_std);
+            LOG_DEBUG("Outlier removal dropped {} of {} points", before - means.size() / 3, before);
+        }
+
+        const auto kept = static_cast<int64_t>(means.size() / 3);
+        auto out_means = torch::from_blob(means.data(), {kept, 3}, torch::kFloat32).clone();
+        auto out_colors = torch::from_blob(colors.data(), {kept, 3}, torch::kFloat32).clone();
+        if (color_dtype == torch::kUInt8) {
+            out_colors = out_colors.round().clamp(0, 255);
+        }
+        return PointCloud(std::move(out_means), out_colors.to(color_dtype));
+    }
+
+} // namespace gs
@@ -357,7 +357,7 @@ namespace gs::core {
             auto rotations = splat_data.get_rotation().cpu().contiguous();
             auto opacities = splat_data.get_opacity().cpu().contiguous();
             auto sh0 = splat_data.sh0().cpu().contiguous();
-            auto shN = splat_data.shN().cpu().contiguous();
+            auto shN = splat_data.shN().cpu().to(torch::kFloat).contiguous();
 
             // Determine SH degree from shN shape
             int sh_degree = 0;
@@ -3,12 +3,13 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "core/splat_data.hpp"
+#include "core/device.hpp"
+#include "core/knn.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
 #include "core/point_cloud.hpp"
 #include "core/sogs.hpp"
 
-#include "external/nanoflann.hpp"
 #include "external/tinyply.hpp"
 #include <algorithm>
 #include <cmath>
@@ -38,31 +39,10 @@ namespace {
         return oss.str();
     }
 
-    // Point cloud adaptor for nanoflann
-    struct PointCloudAdaptor {
-        const float* points;
-        size_t num_points;
-
-        PointCloudAdaptor(const float* pts, size_t n) : points(pts),
-                                                        num_points(n) {}
-
-        inline size_t kdtree_get_point_count() const { return num_points; }
-
-        inline float kdtree_get_pt(const size_t idx, const size_t dim) const {
-            return points[idx * 3 + dim];
-        }
-
-        template <class BBOX>
-        bool kdtree_get_bbox(BBOX& /* bb */) const { return false; }
-    };
-
-    // Fixed: KDTree typedef on single line
-    using KDTree = nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<float, PointCloudAdaptor>, PointCloudAdaptor, 3>;
-
     // Compute mean distance to 3 nearest neighbors for each point
     torch::Tensor compute_mean_neighbor_distances(const torch::Tensor& points) {
         auto cpu_points = points.to(torch::kCPU).contiguous();
-        const int num_points = cpu_points.size(0);
+        const int64_t num_points = cpu_points.size(0);
 
         TORCH_CHECK(cpu_points.dim() == 2 && cpu_points.size(1) == 3,
                     "Input points must have shape [N, 3]");
@@ -73,41 +53,10 @@ namespace {
             return torch::full({num_points}, 0.01f, points.options());
         }
 
-        const float* data = cpu_points.data_ptr<float>();
-
-        PointCloudAdaptor cloud(data, num_points);
-        KDTree index(3, cloud, nanoflann::KDTreeSingleIndexAdaptorParams(10));
-        index.buildIndex();
-
-        auto result = torch::zeros({num_points}, torch::kFloat32);
-        float* result_data = result.data_ptr<float>();
-
-#pragma omp parallel for if (num_points > 1000)
-        for (int i = 0; i < num_points; i++) {
-            const float query_pt[3] = {data[i * 3 + 0], data[i * 3 + 1], data[i * 3 + 2]};
+        const gs::KnnIndex index(cpu_points.data_ptr<float>(), static_cast<size_t>(num_points));
+        auto distances = index.mean_neighbor_distances(3, 0.01f);
 
-            const size_t num_results = std::min(4, num_points);
-            std::vector<size_t> ret_indices(num_results);
-            std::vector<float> out_dists_sqr(num_results);
-
-            nanoflann::KNNResultSet<float> resultSet(num_results);
-            resultSet.init(&ret_indices[0], &out_dists_sqr[0]);
-            index.findNeighbors(resultSet, &query_pt[0], nanoflann::SearchParameters(10));
-
-            float sum_dist = 0.0f;
-            int valid_neighbors = 0;
-
-            for (size_t j = 0; j < num_results && valid_neighbors < 3; j++) {
-                if (out_dists_sqr[j] > 1e-8f) {
-                    sum_dist += std::sqrt(out_dists_sqr[j]);
-                    valid_neighbors++;
-                }
-            }
-
-            result_data[i] = (valid_neighbors > 0) ? (sum_dist / valid_neighbors) : 0.01f;
-        }
-
-        return result.to(points.device());
+        return torch::from_blob(distances.data(), {num_points}, torch::kFloat32).clone().to(points.device());
     }
 
     void write_ply_impl(const gs::PointCloud& pc,
@@ -220,7 +169,8 @@ namespace gs {
           _scaling(std::move(other._scaling)),
           _rotation(std::move(other._rotation)),
           _opacity(std::move(other._opacity)),
-          _densification_info(std::move(other._densification_info))
+          _densification_info(std::move(other._densification_info)),
+          _reserved(std::move(other._reserved))
     // Note: _save_mutex and _save_futures are default constructed
     {
         // Don't move the mutex or futures - each instance should have its own
@@ -245,6 +195,7 @@ namespace gs {
             _rotation = std::move(other._rotation);
             _opacity = std::move(other._opacity);
             _densification_info = std::move(other._densification_info);
+            _reserved = std::move(other._reserved);
 
             // Don't move the mutex or futures
         }
@@ -382,6 +333,48 @@ namespace gs {
         }
     }
 
+    void SplatData::reserve(int64_t capacity) {
+        torch::NoGradGuard no_grad;
+        const int64_t rows = size();
+        capacity = std::max(capacity, rows);
+
+        std::array params = {&_means, &_sh0, &_shN, &_scaling, &_rotation, &_opacity};
+        for (size_t i = 0; i < params.size(); ++i) {
+            auto& param = *params[i];
+            auto shape = param.sizes().vec();
+            shape[0] = capacity;
+            _reserved[i] = torch::empty(shape, param.options());
+            _reserved[i].narrow(0, 0, rows).copy_(param);
+            param = _reserved[i].narrow(0, 0, rows).detach().set_requires_grad(param.requires_grad());
+        }
+    }
+
+    void SplatData::resize(int64_t rows) {
+        if (!has_reserved_capacity()) {
+            throw std::runtime_error("SplatData::resize requires reserved capacity");
+        }
+        if (rows < 0 || rows > capacity()) {
+            throw std::runtime_error(std::format("SplatData::resize: {} rows exceed the reserved capacity of {}",
+                                                 rows, capacity()));
+        }
+
+        std::array params = {&_means, &_sh0, &_shN, &_scaling, &_rotation, &_opacity};
+        for (size_t i = 0; i < params.size(); ++i) {
+            auto& param = *params[i];
+            param = _reserved[i].narrow(0, 0, rows).detach().set_requires_grad(param.requires_grad());
+        }
+    }
+
+    bool SplatData::has_reserved_capacity() const {
+        const std::array params = {&_means, &_sh0, &_shN, &_scaling, &_rotation, &_opacity};
+        for (size_t i = 0; i < params.size(); ++i) {
+            if (!_reserved[i].defined() || !params[i]->defined() || !params[i]->is_alias_of(_reserved[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     // Get attribute names for PLY format
     std::vector<std::string> SplatData::get_attribute_names() const {
         std::vector<std::string> a{"x", "y", "z", "nx", "ny", "nz"};
@@ -465,6 +458,60 @@ namespace gs {
         write_sog_impl(*this, root, iteration, kmeans_iterations);
     }
 
+    SplatData SplatData::snapshot() const {
+        const auto copy = [](const torch::Tensor& t) { return t.detach().clone(); };
+        SplatData result(_max_sh_degree, copy(_means), copy(_sh0), copy(_shN),
+                         copy(_scaling), copy(_rotation), copy(_opacity), _scene_scale);
+        result._active_sh_degree = _active_sh_degree;
+        return result;
+    }
+
+    void SplatData::save_state(torch::serialize::OutputArchive& archive) const {
+        const auto snapshot = [](const torch::Tensor& t) { return t.detach().clone(); };
+        archive.write("active_sh_degree", static_cast<int64_t>(_active_sh_degree));
+        archive.write("max_sh_degree", static_cast<int64_t>(_max_sh_degree));
+        archive.write("scene_scale", static_cast<double>(_scene_scale));
+        archive.write("means", snapshot(_means));
+        archive.write("sh0", snapshot(_sh0));
+        archive.write("shN", snapshot(_shN));
+        archive.write("scaling", snapshot(_scaling));
+        archive.write("rotation", snapshot(_rotation));
+        archive.write("opacity", snapshot(_opacity));
+        if (_densification_info.numel() > 0) {
+            archive.write("densification_info", snapshot(_densification_info));
+        }
+    }
+
+    void SplatData::load_state(torch::serialize::InputArchive& archive) {
+        c10::IValue value;
+        archive.read("active_sh_degree", value);
+        _active_sh_degree = static_cast<int>(value.toInt());
+        archive.read("max_sh_degree", value);
+        _max_sh_degree = static_cast<int>(value.toInt());
+        archive.read("scene_scale", value);
+        _scene_scale = static_cast<float>(value.toDouble());
+
+        const auto read_param = [&archive](const char* key) {
+            torch::Tensor t;
+            archive.read(key, t);
+            return t.to(training_device()).contiguous().set_requires_grad(true);
+        };
+        _means = read_param("means");
+        _sh0 = read_param("sh0");
+        _shN = read_param("shN");
+        _scaling = read_param("scaling");
+        _rotation = read_param("rotation");
+        _opacity = read_param("opacity");
+        _reserved = {};
+
+        torch::Tensor densification_info;
+        if (archive.try_read("densification_info", densification_info)) {
+            _densification_info = densification_info.to(training_device());
+        } else {
+            _densification_info = torch::empty({0});
+        }
+    }
+
     PointCloud SplatData::to_point_cloud() const {
         PointCloud pc;
 
@@ -474,7 +521,7 @@ namespace gs {
 
         // Gaussian attributes
         pc.sh0 = _sh0.transpose(1, 2).flatten(1).cpu();
-        pc.shN = _shN.transpose(1, 2).flatten(1).cpu();
+        pc.shN = _shN.transpose(1, 2).flatten(1).cpu().to(torch::kFloat); // may be stored as fp16/bf16
         pc.opacity = _opacity.cpu();
         pc.scaling = _scaling.cpu();
 
@@ -500,10 +547,10 @@ namespace gs {
             if (params.optimization.random) {
                 const int num_points = params.optimization.init_num_pts;
                 const float extent = params.optimization.init_extent;
-                const auto f32_cuda = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+                const auto f32_device = torch::TensorOptions().dtype(torch::kFloat32).device(training_device());
 
-                positions = (torch::rand({num_points, 3}, f32_cuda) * 2.0f - 1.0f) * extent;
-                colors = torch::rand({num_points, 3}, f32_cuda);
+                positions = (torch::rand({num_points, 3}, f32_device) * 2.0f - 1.0f) * extent;
+                colors = torch::rand({num_points, 3}, f32_device);
             } else {
                 positions = pcd.means;
                 colors = pcd.colors / 255.0f; // Normalize directly
@@ -519,15 +566,15 @@ namespace gs {
             };
 
             const auto f32 = torch::TensorOptions().dtype(torch::kFloat32);
-            const auto f32_cuda = f32.device(torch::kCUDA);
+            const auto f32_device = f32.device(training_device());
 
             // 1. means
             torch::Tensor means;
             if (params.optimization.random) {
                 // Scale positions before setting requires_grad
-                means = (positions * scene_scale).to(torch::kCUDA).set_requires_grad(true);
+                means = (positions * scene_scale).to(training_device()).set_requires_grad(true);
             } else {
-                means = positions.to(torch::kCUDA).set_requires_grad(true);
+                means = positions.to(training_device()).set_requires_grad(true);
             }
 
             // 2. scaling (log(σ))
@@ -535,24 +582,24 @@ namespace gs {
             auto scaling = torch::log(torch::sqrt(nn_dist) * params.optimization.init_scaling)
                                .unsqueeze(-1)
                                .repeat({1, 3})
-                               .to(f32_cuda)
+                               .to(f32_device)
                                .set_requires_grad(true);
 
             // 3. rotation (quaternion, identity) - split into multiple lines to avoid compilation error
-            auto rotation = torch::zeros({means.size(0), 4}, f32_cuda);
+            auto rotation = torch::zeros({means.size(0), 4}, f32_device);
             rotation.index_put_({torch::indexing::Slice(), 0}, 1);
             rotation = rotation.set_requires_grad(true);
 
             // 4. opacity (inverse sigmoid of 0.5)
-            auto opacity = torch::logit(params.optimization.init_opacity * torch::ones({means.size(0), 1}, f32_cuda))
+            auto opacity = torch::logit(params.optimization.init_opacity * torch::ones({means.size(0), 1}, f32_device))
                                .set_requires_grad(true);
 
             // 5. shs (SH coefficients)
-            auto colors_float = colors.to(torch::kCUDA);
+            auto colors_float = colors.to(training_device());
             auto fused_color = rgb_to_sh(colors_float);
 
             const int64_t feature_shape = static_cast<int64_t>(std::pow(params.optimization.sh_degree + 1, 2));
-            auto shs = torch::zeros({fused_color.size(0), 3, feature_shape}, f32_cuda);
+            auto shs = torch::zeros({fused_color.size(0), 3, feature_shape}, f32_device);
 
             // Set DC coefficients
             shs.index_put_({torch::indexing::Slice(),
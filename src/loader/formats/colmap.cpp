@@ -3,7 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "colmap.hpp"
-#include "core/image_io.hpp"
+#include "core/image_probe.hpp"
 #include "core/logger.hpp"
 #include "core/point_cloud.hpp"
 #include "core/torch_shapes.hpp"
@@ -12,6 +12,7 @@
 #include <cstring>
 #include <exception>
 #include <filesystem>
+#include <format>
 #include <fstream>
 #include <memory>
 #include <stdexcept>
@@ -847,8 +848,14 @@ namespace gs::loader {
         if (!out.empty() && std::filesystem::exists(out[0]._image_path)) {
             LOG_DEBUG("Verifying actual image dimensions against COLMAP database");
 
-            // Load first image to check actual dimensions
-            auto [img_data, actual_w, actual_h, channels] = load_image(out[0]._image_path);
+            // Read the first image header to check actual dimensions
+            auto info = image_io::probe_image(out[0]._image_path);
+            if (!info) {
+                LOG_ERROR("{}", info.error());
+                throw std::runtime_error(info.error());
+            }
+            const int actual_w = info->width;
+            const int actual_h = info->height;
 
             int expected_w = out[0]._width;
             int expected_h = out[0]._height;
@@ -869,8 +876,6 @@ namespace gs::loader {
             } else {
                 LOG_DEBUG("Image dimensions match COLMAP database ({}x{})", actual_w, actual_h);
             }
-
-            free_image(img_data);
         }
 
         LOG_INFO("Training with {} images", out.size());
@@ -953,4 +958,42 @@ namespace gs::loader {
         return read_colmap_cameras(base, cams, images, images_folder);
     }
 
+    std::vector<std::string> validate_camera_images(const std::vector<CameraData>& cameras) {
+        LOG_TIMER_TRACE("Validate camera images");
+
+        std::vector<std::filesystem::path> paths;
+        paths.reserve(cameras.size());
+        for (const auto& cam : cameras) {
+            paths.push_back(cam._image_path);
+        }
+        const auto infos = image_io::probe_images(paths);
+
+        std::vector<std::string> errors;
+        std::vector<std::string> warnings;
+        for (size_t i = 0; i < cameras.size(); ++i) {
+            if (!infos[i]) {
+                errors.push_back(infos[i].error());
+                continue;
+            }
+            const auto& cam = cameras[i];
+            if (infos[i]->width != cam._width || infos[i]->height != cam._height) {
+                warnings.push_back(std::format("Image {} is {}x{} but its camera expects {}x{}",
+                                               cam._image_name, infos[i]->width, infos[i]->height,
+                                               cam._width, cam._height));
+                LOG_WARN("{}", warnings.back());
+            }
+        }
+
+        if (!errors.empty()) {
+            for (const auto& error : errors) {
+                LOG_ERROR("{}", error);
+            }
+            throw std::runtime_error(std::format("{} of {} images could not be read, first: {}",
+                                                 errors.size(), cameras.size(), errors.front()));
+        }
+
+        LOG_INFO("Validated {} image headers ({} size mismatches)", cameras.size(), warnings.size());
+        return warnings;
+    }
+
 } // namespace gs::loader
@@ -6,6 +6,7 @@
 #include "Common.h"
 #include "core/point_cloud.hpp"
 #include <filesystem>
+#include <string>
 #include <vector>
 
 namespace gs::loader {
@@ -66,4 +67,8 @@ namespace gs::loader {
     // Read COLMAP point cloud from a text file
     PointCloud read_colmap_point_cloud_text(const std::filesystem::path& filepath);
 
+    // Probe every image header in parallel. Throws if any image is missing or unreadable,
+    // returns one warning per image whose size differs from its camera.
+    std::vector<std::string> validate_camera_images(const std::vector<CameraData>& cameras);
+
 } // namespace gs::loader
\ No newline at end of file
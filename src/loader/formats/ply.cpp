@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "ply.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include <algorithm>
 #include <charconv>
@@ -608,14 +609,15 @@ namespace gs::loader {
                 rotation.select(1, 0).fill_(ply_constants::IDENTITY_QUATERNION_W);
             }
 
-            LOG_DEBUG("Transferring tensors to CUDA");
-            // Batch CUDA transfer for maximum speed
-            means = means.to(torch::kCUDA);
-            sh0 = sh0.to(torch::kCUDA);
-            shN = shN.to(torch::kCUDA);
-            scaling = scaling.to(torch::kCUDA);
-            rotation = rotation.to(torch::kCUDA);
-            opacity_tensor = opacity_tensor.to(torch::kCUDA);
+            LOG_DEBUG("Transferring tensors to the training device");
+            // Batch transfer for maximum speed
+            const auto device = training_device();
+            means = means.to(device);
+            sh0 = sh0.to(device);
+            shN = shN.to(device);
+            scaling = scaling.to(device);
+            rotation = rotation.to(device);
+            opacity_tensor = opacity_tensor.to(device);
 
             int sh_degree = static_cast<int>(std::sqrt(shN.size(1) + ply_constants::SH_DEGREE_OFFSET)) - ply_constants::SH_DEGREE_OFFSET;
 
@@ -7,6 +7,7 @@
 #endif
 
 #include "sogs.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include <archive.h>
 #include <archive_entry.h>
@@ -464,16 +465,17 @@ namespace gs::loader {
                 }
             }
 
-            // Move tensors to CUDA
-            means = means.to(torch::kCUDA);
-            scales = scales.to(torch::kCUDA);
-            rotations = rotations.to(torch::kCUDA);
-            sh0 = sh0.to(torch::kCUDA);
-            opacity = opacity.to(torch::kCUDA);
+            // Move tensors to the training device
+            const auto device = training_device();
+            means = means.to(device);
+            scales = scales.to(device);
+            rotations = rotations.to(device);
+            sh0 = sh0.to(device);
+            opacity = opacity.to(device);
             if (shN.defined()) {
-                shN = shN.to(torch::kCUDA);
+                shN = shN.to(device);
             } else {
-                shN = torch::zeros({num_splats, 0, 3}, torch::kFloat32).to(torch::kCUDA);
+                shN = torch::zeros({num_splats, 0, 3}, torch::kFloat32).to(device);
             }
 
             // Create SplatData
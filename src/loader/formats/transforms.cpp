@@ -3,7 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "transforms.hpp"
-#include "core/image_io.hpp"
+#include "core/image_probe.hpp"
 #include "core/logger.hpp"
 #include "formats/colmap.hpp"
 #include <filesystem>
@@ -102,9 +102,12 @@ namespace gs::loader {
             try {
                 LOG_DEBUG("Width/height not in transforms.json, reading from first image");
                 auto first_frame_img_path = GetTransformImagePath(dir_path, transforms["frames"][0]);
-                auto result = load_image(first_frame_img_path);
-                w = std::get<1>(result);
-                h = std::get<2>(result);
+                auto info = image_io::probe_image(first_frame_img_path);
+                if (!info) {
+                    throw std::runtime_error(info.error());
+                }
+                w = info->width;
+                h = info->height;
                 LOG_DEBUG("Got image dimensions: {}x{}", w, h);
             } catch (const std::exception& e) {
                 std::string error_msg = "Error while trying to read image dimensions: " + std::string(e.what());
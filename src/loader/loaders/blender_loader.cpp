@@ -113,6 +113,14 @@ namespace gs::loader {
             // Read transforms and create cameras
             auto [camera_infos, scene_center] = read_transforms_cameras_and_images(transforms_file);
 
+            std::vector<std::string> image_warnings;
+            if (options.validate_images) {
+                if (options.progress) {
+                    options.progress(30.0f, std::format("Validating {} images...", camera_infos.size()));
+                }
+                image_warnings = validate_camera_images(camera_infos);
+            }
+
             if (options.progress) {
                 options.progress(40.0f, std::format("Creating {} cameras...", camera_infos.size()));
             }
@@ -190,6 +198,8 @@ namespace gs::loader {
                       scene_center[1].item<float>(),
                       scene_center[2].item<float>());
 
+            result.warnings.insert(result.warnings.end(), image_warnings.begin(), image_warnings.end());
+
             return result;
 
         } catch (const std::exception& e) {
@@ -169,6 +169,14 @@ namespace gs::loader {
                 throw std::runtime_error("No valid COLMAP camera and image data found");
             }
 
+            std::vector<std::string> image_warnings;
+            if (options.validate_images) {
+                if (options.progress) {
+                    options.progress(30.0f, std::format("Validating {} images...", camera_infos.size()));
+                }
+                image_warnings = validate_camera_images(camera_infos);
+            }
+
             if (options.progress) {
                 options.progress(40.0f, std::format("Creating {} cameras...", camera_infos.size()));
             }
@@ -257,6 +265,8 @@ namespace gs::loader {
                       scene_center[1].item<float>(),
                       scene_center[2].item<float>());
 
+            result.warnings.insert(result.warnings.end(), image_warnings.begin(), image_warnings.end());
+
             return result;
 
         } catch (const std::exception& e) {
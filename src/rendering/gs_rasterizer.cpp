@@ -79,13 +79,14 @@ namespace gs::rendering {
             .center_y = cy,
             .near_plane = near_plane,
             .far_plane = far_plane};
+        // The viewer kernels read fp32 coefficients; shN trained with --shn-precision is widened per frame
         auto [image, alpha] = forward(
             gaussian_model.means(),
             gaussian_model.scaling_raw(),
             gaussian_model.rotation_raw(),
             gaussian_model.opacity_raw(),
             gaussian_model.sh0(),
-            gaussian_model.shN(),
+            gaussian_model.shN().to(torch::kFloat),
             settings);
 
         // Manually blend the background since the forward pass does not support it
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "rendering_pipeline.hpp"
+#include "core/device.hpp"
 #include "gs_rasterizer.hpp"
 #include "training/rasterization/rasterizer.hpp"
 
@@ -11,7 +12,7 @@
 namespace gs::rendering {
 
     RenderingPipeline::RenderingPipeline()
-        : background_(torch::zeros({3}, torch::kFloat32).to(torch::kCUDA)) {
+        : background_(torch::zeros({3}, torch::TensorOptions().dtype(torch::kFloat32).device(training_device()))) {
         point_cloud_renderer_ = std::make_unique<PointCloudRenderer>();
         LOG_DEBUG("RenderingPipeline initialized");
     }
@@ -233,9 +234,9 @@ namespace gs::rendering {
         // Flip vertically (OpenGL has origin at bottom-left)
         image_cpu = torch::flip(image_cpu, {0});
 
-        // Convert to CHW format and move to CUDA
+        // Convert to CHW format and move to the training device
         RenderResult result;
-        result.image = image_cpu.permute({2, 0, 1}).to(torch::kCUDA);
+        result.image = image_cpu.permute({2, 0, 1}).to(training_device());
         result.valid = true;
 
         LOG_TRACE("Point cloud rendering completed");
@@ -0,0 +1,226 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "checkpoint.hpp"
+#include "core/device.hpp"
+#include "core/logger.hpp"
+#include "optimizers/fused_adam.hpp"
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+#include <format>
+#include <optional>
+
+namespace gs::training {
+
+    namespace checkpoint {
+
+        torch::Tensor snapshot(const torch::Tensor& tensor) {
+            return tensor.detach().clone();
+        }
+
+        void write_optimizer(torch::serialize::OutputArchive& archive, const torch::optim::Optimizer& optimizer) {
+            const auto& groups = optimizer.param_groups();
+            archive.write("num_groups", static_cast<int64_t>(groups.size()));
+
+            for (size_t g = 0; g < groups.size(); ++g) {
+                torch::serialize::OutputArchive group_archive(archive.compilation_unit());
+                const auto& options = groups[g].options();
+                if (const auto* fused = dynamic_cast<const FusedAdam::Options*>(&options)) {
+                    group_archive.write("lr", fused->lr());
+                } else if (const auto* adam = dynamic_cast<const torch::optim::AdamOptions*>(&options)) {
+                    group_archive.write("lr", adam->lr());
+                }
+
+                const auto& params = groups[g].params();
+                for (size_t p = 0; p < params.size(); ++p) {
+                    const auto it = optimizer.state().find(params[p].unsafeGetTensorImpl());
+                    if (it == optimizer.state().end()) {
+                        continue; // Not stepped yet
+                    }
+                    const auto key = [p](const char* name) { return std::format("p{}_{}", p, name); };
+
+                    if (const auto* state = dynamic_cast<const FusedAdam::AdamParamState*>(it->second.get())) {
+                        group_archive.write(key("exp_avg"), snapshot(state->exp_avg));
+                        group_archive.write(key("exp_avg_sq"), snapshot(state->exp_avg_sq));
+                        group_archive.write(key("step"), state->step_count);
+                        if (state->max_exp_avg_sq.defined()) {
+                            group_archive.write(key("max_exp_avg_sq"), snapshot(state->max_exp_avg_sq));
+                        }
+                        if (state->last_step.defined()) {
+                            group_archive.write(key("last_step"), snapshot(state->last_step));
+                        }
+                    } else if (const auto* state = dynamic_cast<const torch::optim::AdamParamState*>(it->second.get())) {
+                        group_archive.write(key("exp_avg"), snapshot(state->exp_avg()));
+                        group_archive.write(key("exp_avg_sq"), snapshot(state->exp_avg_sq()));
+                        group_archive.write(key("step"), state->step());
+                        if (state->max_exp_avg_sq().defined()) {
+                            group_archive.write(key("max_exp_avg_sq"), snapshot(state->max_exp_avg_sq()));
+                        }
+                    } else {
+                        throw std::runtime_error("Checkpoint: unsupported optimizer state type");
+                    }
+                }
+                archive.write(std::format("group{}", g), group_archive);
+            }
+        }
+
+        void read_optimizer(torch::serialize::InputArchive& archive, torch::optim::Optimizer& optimizer) {
+            c10::IValue value;
+            archive.read("num_groups", value);
+            auto& groups = optimizer.param_groups();
+            if (value.toInt() != static_cast<int64_t>(groups.size())) {
+                throw std::runtime_error(std::format("Checkpoint: optimizer has {} parameter groups, checkpoint has {}",
+                                                     groups.size(), value.toInt()));
+            }
+            const bool fused = dynamic_cast<FusedAdam*>(&optimizer) != nullptr;
+
+            for (size_t g = 0; g < groups.size(); ++g) {
+                torch::serialize::InputArchive group_archive;
+                archive.read(std::format("group{}", g), group_archive);
+
+                if (group_archive.try_read("lr", value)) {
+                    if (auto* options = dynamic_cast<FusedAdam::Options*>(&groups[g].options())) {
+                        options->lr(value.toDouble());
+                    } else if (auto* options = dynamic_cast<torch::optim::AdamOptions*>(&groups[g].options())) {
+                        options->lr(value.toDouble());
+                    }
+                }
+
+                auto& params = groups[g].params();
+                for (size_t p = 0; p < params.size(); ++p) {
+                    const auto key = [p](const char* name) { return std::format("p{}_{}", p, name); };
+                    torch::Tensor exp_avg, exp_avg_sq, max_exp_avg_sq, last_step;
+                    if (!group_archive.try_read(key("exp_avg"), exp_avg)) {
+                        continue;
+                    }
+                    group_archive.read(key("exp_avg_sq"), exp_avg_sq);
+                    group_archive.read(key("step"), value);
+                    const int64_t step = value.toInt();
+                    const bool has_max = group_archive.try_read(key("max_exp_avg_sq"), max_exp_avg_sq);
+                    const bool has_last_step = group_archive.try_read(key("last_step"), last_step);
+
+                    const auto& param = params[p];
+                    if (exp_avg.sizes() != param.sizes()) {
+                        throw std::runtime_error(std::format("Checkpoint: optimizer state for group {} does not match its parameter", g));
+                    }
+                    const auto device = param.device();
+
+                    std::unique_ptr<torch::optim::OptimizerParamState> state;
+                    if (fused) {
+                        // Moments saved with another --moment-precision are converted
+                        const auto moment_dtype = static_cast<FusedAdam&>(optimizer).moment_dtype(groups[g]);
+                        auto fused_state = std::make_unique<FusedAdam::AdamParamState>();
+                        fused_state->exp_avg = exp_avg.to(device, moment_dtype);
+                        fused_state->exp_avg_sq = exp_avg_sq.to(device, moment_dtype);
+                        fused_state->step_count = step;
+                        if (has_max) {
+                            fused_state->max_exp_avg_sq = max_exp_avg_sq.to(device);
+                        }
+                        if (has_last_step) {
+                            fused_state->last_step = last_step.to(device);
+                        }
+                        state = std::move(fused_state);
+                    } else {
+                        auto adam_state = std::make_unique<torch::optim::AdamParamState>();
+                        adam_state->exp_avg(exp_avg.to(device));
+                        adam_state->exp_avg_sq(exp_avg_sq.to(device));
+                        adam_state->step(step);
+                        if (has_max) {
+                            adam_state->max_exp_avg_sq(max_exp_avg_sq.to(device));
+                        }
+                        state = std::move(adam_state);
+                    }
+                    optimizer.state()[param.unsafeGetTensorImpl()] = std::move(state);
+                }
+            }
+        }
+
+        std::string file_name(int iteration) {
+            return std::format("checkpoint_{:08d}{}", iteration, EXTENSION);
+        }
+
+        std::optional<std::filesystem::path> resolve(const std::filesystem::path& path) {
+            std::error_code ec;
+            if (std::filesystem::is_regular_file(path, ec)) {
+                return path;
+            }
+            for (const auto& dir : {path, path / "checkpoints"}) {
+                if (!std::filesystem::is_directory(dir, ec)) {
+                    continue;
+                }
+                // Zero-padded iteration numbers make the newest checkpoint the lexicographic maximum
+                std::optional<std::filesystem::path> newest;
+                for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+                    if (entry.is_regular_file() && entry.path().extension() == EXTENSION &&
+                        (!newest || entry.path().filename() > newest->filename())) {
+                        newest = entry.path();
+                    }
+                }
+                if (newest) {
+                    return newest;
+                }
+            }
+            return std::nullopt;
+        }
+
+    } // namespace checkpoint
+
+    CheckpointWriter::CheckpointWriter(std::filesystem::path directory)
+        : _directory(std::move(directory)) {
+    }
+
+    CheckpointWriter::~CheckpointWriter() {
+        wait();
+    }
+
+    void CheckpointWriter::write(int iteration, std::unique_ptr<torch::serialize::OutputArchive> archive) {
+        wait();
+
+        // The snapshot copies are queued on the compute stream; only the writer thread waits for them.
+        // On the CPU they have already completed and the event stays unrecorded.
+        const bool on_cuda = training_on_cuda();
+        auto ready = std::make_shared<at::cuda::CUDAEvent>();
+        if (on_cuda) {
+            ready->record(at::cuda::getCurrentCUDAStream());
+        }
+
+        std::shared_ptr<torch::serialize::OutputArchive> shared_archive = std::move(archive);
+        _pending = std::async(std::launch::async, [directory = _directory, iteration, on_cuda, ready, shared_archive]() {
+            ready->synchronize();
+            std::optional<at::cuda::CUDAStreamGuard> guard;
+            if (on_cuda) {
+                guard.emplace(at::cuda::getStreamFromPool(false, training_device().index()));
+            }
+
+            std::filesystem::create_directories(directory);
+            const auto path = directory / checkpoint::file_name(iteration);
+            auto tmp_path = path;
+            tmp_path += ".tmp";
+            shared_archive->save_to(tmp_path.string());
+            std::filesystem::rename(tmp_path, path);
+
+            // Keep only the newest checkpoint
+            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+                if (entry.path() != path && entry.path().extension() == checkpoint::EXTENSION) {
+                    std::error_code ec;
+                    std::filesystem::remove(entry.path(), ec);
+                }
+            }
+            LOG_INFO("Checkpoint for iteration {} written to {}", iteration, path.string());
+        });
+    }
+
+    void CheckpointWriter::wait() {
+        if (!_pending.valid()) {
+            return;
+        }
+        try {
+            _pending.get();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to write checkpoint: {}", e.what());
+        }
+    }
+
+} // namespace gs::training
@@ -0,0 +1,62 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <optional>
+#include <torch/torch.h>
+
+namespace gs::training {
+
+    // Full training state checkpoints: model, optimizer moments, learning rates,
+    // strategy and auxiliary module state, RNG state and sampler position.
+    // Stored as a torch archive; tensors are written as device snapshots so the
+    // live parameters can keep training while the file is written.
+    namespace checkpoint {
+        inline constexpr const char* EXTENSION = ".lfsckpt";
+        inline constexpr int64_t FORMAT_VERSION = 1;
+
+        // Detached copy queued on the current stream (no host synchronization)
+        torch::Tensor snapshot(const torch::Tensor& tensor);
+
+        // Per-parameter Adam / FusedAdam state and per-group learning rates
+        void write_optimizer(torch::serialize::OutputArchive& archive, const torch::optim::Optimizer& optimizer);
+        void read_optimizer(torch::serialize::InputArchive& archive, torch::optim::Optimizer& optimizer);
+
+        // File name for the checkpoint taken after `iteration`
+        std::string file_name(int iteration);
+
+        // A checkpoint file as is, or the newest checkpoint in a directory or its checkpoints/ subdirectory
+        std::optional<std::filesystem::path> resolve(const std::filesystem::path& path);
+    } // namespace checkpoint
+
+    // Serializes checkpoint archives on a background thread. Only the newest
+    // completed checkpoint is kept; files are written under a temporary name and
+    // renamed, so a crash mid-write never leaves a truncated checkpoint behind.
+    class CheckpointWriter {
+    public:
+        explicit CheckpointWriter(std::filesystem::path directory);
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        // Takes ownership of an archive filled with snapshots on the current stream.
+        // Waits for a previous write that is still in flight.
+        void write(int iteration, std::unique_ptr<torch::serialize::OutputArchive> archive);
+
+        // Blocks until the pending write (if any) is on disk
+        void wait();
+
+        const std::filesystem::path& directory() const { return _directory; }
+
+    private:
+        std::filesystem::path _directory;
+        std::future<void> _pending;
+    };
+
+} // namespace gs::training
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "bilateral_grid.hpp"
+#include "core/device.hpp"
 #include "kernels/bilateral_grid.cuh"
 
 namespace gs::training {
@@ -87,7 +88,7 @@ namespace gs::training {
         grid = grid.reshape({1, grid_L, grid_H, grid_W, 12});
         grid = grid.permute({0, 4, 1, 2, 3});
 
-        grids_ = grid.repeat({num_images, 1, 1, 1, 1}).to(torch::kCUDA);
+        grids_ = grid.repeat({num_images, 1, 1, 1, 1}).to(training_device());
         grids_.set_requires_grad(true);
     }
 
@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "sparsity_optimizer.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include <format>
 #include <print>
@@ -149,6 +150,34 @@ namespace gs::training {
         return static_cast<int>(config_.prune_ratio * opacities.flatten().size(0));
     }
 
+    void ADMMSparsityOptimizer::save_state(torch::serialize::OutputArchive& archive) const {
+        archive.write("initialized", initialized_);
+        if (initialized_) {
+            archive.write("u", u_.detach().clone());
+            archive.write("z", z_.detach().clone());
+        }
+    }
+
+    std::expected<void, std::string> ADMMSparsityOptimizer::load_state(torch::serialize::InputArchive& archive) {
+        try {
+            c10::IValue value;
+            archive.read("initialized", value);
+            initialized_ = value.toBool();
+            if (initialized_) {
+                archive.read("u", u_);
+                archive.read("z", z_);
+                u_ = u_.to(training_device());
+                z_ = z_.to(training_device());
+            } else {
+                u_ = torch::Tensor();
+                z_ = torch::Tensor();
+            }
+            return {};
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to load ADMM state: {}", e.what()));
+        }
+    }
+
     torch::Tensor ADMMSparsityOptimizer::prune_z(const torch::Tensor& z) const {
         if (z.numel() == 0) {
             return torch::zeros_like(z);
@@ -74,6 +74,17 @@ namespace gs::training {
          * @brief Check if the optimizer has been initialized
          */
         virtual bool is_initialized() const = 0;
+
+        /**
+         * @brief Write the optimizer state to a training checkpoint
+         */
+        virtual void save_state(torch::serialize::OutputArchive& archive) const = 0;
+
+        /**
+         * @brief Restore the optimizer state from a training checkpoint
+         * @return Error string if the checkpoint does not contain compatible state
+         */
+        virtual std::expected<void, std::string> load_state(torch::serialize::InputArchive& archive) = 0;
     };
 
     /**
@@ -120,6 +131,9 @@ namespace gs::training {
 
         bool is_initialized() const override { return initialized_; }
 
+        void save_state(torch::serialize::OutputArchive& archive) const override;
+        std::expected<void, std::string> load_state(torch::serialize::InputArchive& archive) override;
+
     private:
         /**
          * @brief Apply soft thresholding to enforce sparsity
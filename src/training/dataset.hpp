@@ -5,6 +5,8 @@
 #pragma once
 
 #include "core/camera.hpp"
+#include "core/disk_image_cache.hpp"
+#include "core/image_cache.hpp"
 #include "core/parameters.hpp"
 #include "loader/loader.hpp"
 #include <expected>
@@ -69,7 +71,14 @@ namespace gs::training {
             size_t camera_idx = _indices[index];
             auto& cam = _cameras[camera_idx];
 
-            torch::Tensor image = cam->load_and_get_image(_datasetConfig.resize_factor);
+            torch::Tensor image;
+            if (_image_cache) {
+                image = cam->load_and_get_image(*_image_cache, _datasetConfig.resize_factor);
+            } else if (_disk_cache) {
+                image = cam->load_and_get_image(*_disk_cache, _datasetConfig.resize_factor);
+            } else {
+                image = cam->load_and_get_image(_datasetConfig.resize_factor);
+            }
             return {{cam.get(), std::move(image)}, torch::empty({})};
         }
 
@@ -107,12 +116,33 @@ namespace gs::training {
             return std::nullopt;
         }
         void set_resize_factor(int resize_factor) { _datasetConfig.resize_factor = resize_factor; }
+        int get_resize_factor() const { return _datasetConfig.resize_factor; }
+
+        // Serve samples from a decoded-image cache (shared between dataset copies)
+        void set_image_cache(std::shared_ptr<ImageCache> cache) { _image_cache = std::move(cache); }
+        const std::shared_ptr<ImageCache>& get_image_cache() const { return _image_cache; }
+
+        // Map decoded images from a persistent on-disk cache instead of decoding them
+        void set_disk_cache(std::shared_ptr<DiskImageCache> cache) { _disk_cache = std::move(cache); }
+        const std::shared_ptr<DiskImageCache>& get_disk_cache() const { return _disk_cache; }
+
+        // Cameras that belong to this split, in index order
+        std::vector<std::shared_ptr<Camera>> get_split_cameras() const {
+            std::vector<std::shared_ptr<Camera>> cameras;
+            cameras.reserve(_indices.size());
+            for (size_t idx : _indices) {
+                cameras.push_back(_cameras[idx]);
+            }
+            return cameras;
+        }
 
     private:
         std::vector<std::shared_ptr<Camera>> _cameras;
         gs::param::DatasetConfig _datasetConfig;
         Split _split;
         std::vector<size_t> _indices;
+        std::shared_ptr<ImageCache> _image_cache;
+        std::shared_ptr<DiskImageCache> _disk_cache;
     };
 
     // Infinite random sampler for continuous data flow
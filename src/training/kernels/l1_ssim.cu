@@ -0,0 +1,299 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/l1_ssim.cuh"
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <cooperative_groups.h>
+#include <cooperative_groups/reduce.h>
+
+namespace cg = cooperative_groups;
+
+namespace {
+
+    // Same 11-tap Gaussian (sigma 1.5) as the fused SSIM kernels
+    __constant__ float cGaussL1SSIM[11] = {
+        0.001028380123898387f,
+        0.0075987582094967365f,
+        0.036000773310661316f,
+        0.10936068743467331f,
+        0.21300552785396576f,
+        0.26601171493530273f,
+        0.21300552785396576f,
+        0.10936068743467331f,
+        0.036000773310661316f,
+        0.0075987582094967365f,
+        0.001028380123898387f};
+
+    constexpr int BLOCK_X = 16;
+    constexpr int BLOCK_Y = 16;
+    constexpr int N_THREADS = BLOCK_X * BLOCK_Y;
+    constexpr int HALO = 5;
+    // SSIM statistics and partial derivatives are needed HALO pixels around the tile for the
+    // gradient blur, and computing those statistics needs another HALO of input
+    constexpr int MID = BLOCK_X + 2 * HALO;
+    constexpr int IN = BLOCK_X + 4 * HALO;
+
+    __device__ __forceinline__ bool in_ssim_window(const int y, const int x, const int H, const int W) {
+        // "valid" padding crops HALO pixels on each side when the image is large enough
+        if (H > 2 * HALO && W > 2 * HALO) {
+            return y >= HALO && y < H - HALO && x >= HALO && x < W - HALO;
+        }
+        return y >= 0 && y < H && x >= 0 && x < W;
+    }
+
+    // Ground truth pixel (y, x) of channel c in image b, in [0, 1]: float [N,C,H,W] as is,
+    // uint8 [N,H,W,C] as loaded from disk, normalized here instead of in a separate pass
+    __device__ __forceinline__ float load_gt(const float* gt, const int b, const int c, const int y, const int x,
+                                             const int H, const int W, const int CH) {
+        return gt[((static_cast<int64_t>(b) * CH + c) * H + y) * W + x];
+    }
+
+    __device__ __forceinline__ float load_gt(const uint8_t* gt, const int b, const int c, const int y, const int x,
+                                             const int H, const int W, const int CH) {
+        return static_cast<float>(gt[((static_cast<int64_t>(b) * H + y) * W + x) * CH + c]) * (1.f / 255.f);
+    }
+
+    // One block per 16x16 tile of one image, looping over channels. Writes the gradient of its
+    // tile and the tile's (sum |r - g|, sum SSIM over the valid window) to partial_sums.
+    template <typename GtT>
+    __global__ void fused_l1_ssim_cu(
+        const int H,
+        const int W,
+        const int CH,
+        const float C1,
+        const float C2,
+        const float l1_scale,
+        const float ssim_scale,
+        const float* __restrict__ rendered,
+        const GtT* __restrict__ gt,
+        float* __restrict__ grad,
+        float* __restrict__ partial_sums) {
+        auto block = cg::this_thread_block();
+        const int b = block.group_index().z;
+        const int tile_y = block.group_index().y * BLOCK_Y;
+        const int tile_x = block.group_index().x * BLOCK_X;
+        const int tid = block.thread_rank();
+
+        __shared__ float s_in[IN][IN][2];
+        // Horizontal blur of (x, x^2, y, y^2, xy) on every input row
+        __shared__ float s_hconv[IN][MID][5];
+        // SSIM partials (d/dmu1, d/dsigma1_sq, d/dsigma12), zero outside the valid window
+        __shared__ float s_partials[MID][MID][3];
+        __shared__ float s_hpartials[MID][BLOCK_X][3];
+        __shared__ float s_reduce[2][N_THREADS / 32];
+
+        float l1_sum = 0.f;
+        float ssim_sum = 0.f;
+
+        for (int c = 0; c < CH; ++c) {
+            const int64_t plane = (static_cast<int64_t>(b) * CH + c) * H * W;
+
+            // 1) Input tile with a 2 * HALO border, zero padded
+            for (int i = tid; i < IN * IN; i += N_THREADS) {
+                const int ly = i / IN;
+                const int lx = i % IN;
+                const int gy = tile_y + ly - 2 * HALO;
+                const int gx = tile_x + lx - 2 * HALO;
+                const bool inside = gy >= 0 && gy < H && gx >= 0 && gx < W;
+                s_in[ly][lx][0] = inside ? rendered[plane + gy * W + gx] : 0.f;
+                s_in[ly][lx][1] = inside ? load_gt(gt, b, c, gy, gx, H, W, CH) : 0.f;
+            }
+            block.sync();
+
+            // 2) Horizontal pass of the statistics
+            for (int i = tid; i < IN * MID; i += N_THREADS) {
+                const int ly = i / MID;
+                const int lx = i % MID + HALO;
+                float sums[5] = {0.f, 0.f, 0.f, 0.f, 0.f};
+#pragma unroll
+                for (int d = -HALO; d <= HALO; ++d) {
+                    const float w = cGaussL1SSIM[d + HALO];
+                    const float X = s_in[ly][lx + d][0];
+                    const float Y = s_in[ly][lx + d][1];
+                    sums[0] += X * w;
+                    sums[1] += X * X * w;
+                    sums[2] += Y * w;
+                    sums[3] += Y * Y * w;
+                    sums[4] += X * Y * w;
+                }
+#pragma unroll
+                for (int k = 0; k < 5; ++k) {
+                    s_hconv[ly][lx - HALO][k] = sums[k];
+                }
+            }
+            block.sync();
+
+            // 3) Vertical pass, SSIM and its partial derivatives on the tile plus HALO
+            for (int i = tid; i < MID * MID; i += N_THREADS) {
+                const int ly = i / MID;
+                const int lx = i % MID;
+                const int gy = tile_y + ly - HALO;
+                const int gx = tile_x + lx - HALO;
+                float stats[5] = {0.f, 0.f, 0.f, 0.f, 0.f};
+#pragma unroll
+                for (int d = -HALO; d <= HALO; ++d) {
+                    const float w = cGaussL1SSIM[d + HALO];
+#pragma unroll
+                    for (int k = 0; k < 5; ++k) {
+                        stats[k] += s_hconv[ly + HALO + d][lx][k] * w;
+                    }
+                }
+
+                float dm_dmu1 = 0.f, dm_dsigma1_sq = 0.f, dm_dsigma12 = 0.f;
+                if (in_ssim_window(gy, gx, H, W)) {
+                    const float mu1 = stats[0];
+                    const float mu2 = stats[2];
+                    const float mu1_sq = mu1 * mu1;
+                    const float mu2_sq = mu2 * mu2;
+                    const float sigma1_sq = stats[1] - mu1_sq;
+                    const float sigma2_sq = stats[3] - mu2_sq;
+                    const float sigma12 = stats[4] - mu1 * mu2;
+
+                    const float A = mu1_sq + mu2_sq + C1;
+                    const float B = sigma1_sq + sigma2_sq + C2;
+                    const float C_ = 2.f * mu1 * mu2 + C1;
+                    const float D_ = 2.f * sigma12 + C2;
+
+                    dm_dmu1 = (mu2 * 2.f * D_) / (A * B) - (mu2 * 2.f * C_) / (A * B) -
+                              (mu1 * 2.f * C_ * D_) / (A * A * B) + (mu1 * 2.f * C_ * D_) / (A * B * B);
+                    dm_dsigma1_sq = (-C_ * D_) / (A * B * B);
+                    dm_dsigma12 = (2.f * C_) / (A * B);
+
+                    // Every valid pixel belongs to exactly one tile core
+                    const bool in_core = ly >= HALO && ly < HALO + BLOCK_Y && lx >= HALO && lx < HALO + BLOCK_X;
+                    if (in_core) {
+                        ssim_sum += (C_ * D_) / (A * B);
+                    }
+                }
+                s_partials[ly][lx][0] = dm_dmu1;
+                s_partials[ly][lx][1] = dm_dsigma1_sq;
+                s_partials[ly][lx][2] = dm_dsigma12;
+            }
+            block.sync();
+
+            // 4) Horizontal pass of the partials
+            for (int i = tid; i < MID * BLOCK_X; i += N_THREADS) {
+                const int ly = i / BLOCK_X;
+                const int lx = i % BLOCK_X + HALO;
+                float sums[3] = {0.f, 0.f, 0.f};
+#pragma unroll
+                for (int d = -HALO; d <= HALO; ++d) {
+                    const float w = cGaussL1SSIM[d + HALO];
+#pragma unroll
+                    for (int k = 0; k < 3; ++k) {
+                        sums[k] += s_partials[ly][lx + d][k] * w;
+                    }
+                }
+#pragma unroll
+                for (int k = 0; k < 3; ++k) {
+                    s_hpartials[ly][lx - HALO][k] = sums[k];
+                }
+            }
+            block.sync();
+
+            // 5) Vertical pass of the partials and the combined gradient of the tile
+            {
+                const int ly = block.thread_index().y;
+                const int lx = block.thread_index().x;
+                const int gy = tile_y + ly;
+                const int gx = tile_x + lx;
+                if (gy < H && gx < W) {
+                    float sums[3] = {0.f, 0.f, 0.f};
+#pragma unroll
+                    for (int d = -HALO; d <= HALO; ++d) {
+                        const float w = cGaussL1SSIM[d + HALO];
+#pragma unroll
+                        for (int k = 0; k < 3; ++k) {
+                            sums[k] += s_hpartials[ly + HALO + d][lx][k] * w;
+                        }
+                    }
+                    const float X = s_in[ly + 2 * HALO][lx + 2 * HALO][0];
+                    const float Y = s_in[ly + 2 * HALO][lx + 2 * HALO][1];
+                    const float dssim = sums[0] + 2.f * X * sums[1] + Y * sums[2];
+                    const float diff = X - Y;
+                    const float sign = static_cast<float>((diff > 0.f) - (diff < 0.f));
+                    grad[plane + gy * W + gx] = l1_scale * sign - ssim_scale * dssim;
+                    l1_sum += fabsf(diff);
+                }
+            }
+            block.sync();
+        }
+
+        // Per-tile sums without atomics; the caller reduces them on the device with partial_sums.sum(0),
+        // which does not depend on the order the blocks finish in
+        auto warp = cg::tiled_partition<32>(block);
+        const float l1_warp = cg::reduce(warp, l1_sum, cg::plus<float>());
+        const float ssim_warp = cg::reduce(warp, ssim_sum, cg::plus<float>());
+        if (warp.thread_rank() == 0) {
+            s_reduce[0][warp.meta_group_rank()] = l1_warp;
+            s_reduce[1][warp.meta_group_rank()] = ssim_warp;
+        }
+        block.sync();
+        if (tid == 0) {
+            float l1_total = 0.f, ssim_total = 0.f;
+            for (int i = 0; i < N_THREADS / 32; ++i) {
+                l1_total += s_reduce[0][i];
+                ssim_total += s_reduce[1][i];
+            }
+            const int64_t block_id = (static_cast<int64_t>(b) * gridDim.y + block.group_index().y) * gridDim.x +
+                                     block.group_index().x;
+            partial_sums[2 * block_id] = l1_total;
+            partial_sums[2 * block_id + 1] = ssim_total;
+        }
+    }
+
+} // namespace
+
+std::tuple<torch::Tensor, torch::Tensor>
+fused_l1_ssim(
+    float C1,
+    float C2,
+    const torch::Tensor& rendered,
+    const torch::Tensor& gt,
+    float lambda_dssim) {
+    check_l1_ssim_inputs(rendered, gt);
+    const at::cuda::OptionalCUDAGuard device_guard(device_of(rendered));
+    const int B = rendered.size(0);
+    const int CH = rendered.size(1);
+    const int H = rendered.size(2);
+    const int W = rendered.size(3);
+
+    const double n_pixels = static_cast<double>(B) * CH * H * W;
+    const bool cropped = H > 2 * HALO && W > 2 * HALO;
+    const double n_valid = static_cast<double>(B) * CH * (cropped ? (H - 2 * HALO) * (W - 2 * HALO) : H * W);
+
+    dim3 grid((W + BLOCK_X - 1) / BLOCK_X,
+              (H + BLOCK_Y - 1) / BLOCK_Y,
+              B);
+    dim3 block(BLOCK_X, BLOCK_Y);
+
+    const auto rendered_c = rendered.contiguous();
+    const auto gt_c = gt.contiguous();
+    auto grad = torch::empty_like(rendered_c);
+    auto partial_sums = torch::empty({static_cast<int64_t>(grid.x) * grid.y * grid.z, 2}, rendered.options());
+
+    // On the current stream, which also runs the reduction below and the backward pass
+    const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+    const auto launch = [&]<typename GtT>(const GtT* gt_ptr) {
+        fused_l1_ssim_cu<<<grid, block, 0, stream>>>(
+            H, W, CH, C1, C2,
+            static_cast<float>((1.0 - lambda_dssim) / n_pixels),
+            static_cast<float>(lambda_dssim / n_valid),
+            rendered_c.data_ptr<float>(),
+            gt_ptr,
+            grad.data_ptr<float>(),
+            partial_sums.data_ptr<float>());
+    };
+    if (gt_c.scalar_type() == torch::kByte) {
+        launch(gt_c.data_ptr<uint8_t>());
+    } else {
+        launch(gt_c.data_ptr<float>());
+    }
+
+    // Stays on the device: no synchronization for the scalar
+    const auto sums = partial_sums.sum(0);
+    const auto loss = (1.0 - lambda_dssim) / n_pixels * sums[0] + lambda_dssim * (1.0 - sums[1] / n_valid);
+    return std::make_tuple(loss, grad);
+}
@@ -0,0 +1,270 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "kernels/l1_ssim.cuh"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <cstdint>
+#include <tbb/parallel_for.h>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+    constexpr int HALO = 5;
+    constexpr int WINDOW = 2 * HALO + 1;
+    // Rows per parallel task; each band recomputes 2 * HALO rows of statistics above and below
+    constexpr int BAND_ROWS = 32;
+
+    constexpr std::array<float, WINDOW> GAUSS = {
+        0.001028380123898387f,
+        0.0075987582094967365f,
+        0.036000773310661316f,
+        0.10936068743467331f,
+        0.21300552785396576f,
+        0.26601171493530273f,
+        0.21300552785396576f,
+        0.10936068743467331f,
+        0.036000773310661316f,
+        0.0075987582094967365f,
+        0.001028380123898387f};
+
+    // out[x] = sum_d GAUSS[d] * in[x + d] over a row padded with HALO zeros on each side. The
+    // tap loop is outermost so the loop over x is a contiguous multiply-add the compiler vectorizes.
+    void blur_row(const float* padded, float* out, int width) {
+        std::fill(out, out + width, 0.f);
+        for (int d = 0; d < WINDOW; ++d) {
+            const float w = GAUSS[d];
+            const float* in = padded + d;
+            for (int x = 0; x < width; ++x) {
+                out[x] += w * in[x];
+            }
+        }
+    }
+
+    // out[x] = sum_d GAUSS[d] * rows[d][x]
+    void blur_column(const std::array<const float*, WINDOW>& rows, float* out, int width) {
+        std::fill(out, out + width, 0.f);
+        for (int d = 0; d < WINDOW; ++d) {
+            const float w = GAUSS[d];
+            const float* in = rows[d];
+            for (int x = 0; x < width; ++x) {
+                out[x] += w * in[x];
+            }
+        }
+    }
+
+    // Row y of one ground truth channel in [0, 1]. A float plane is read in place; uint8 images are
+    // interleaved [H, W, C] with gt pointing at the channel, so the row is gathered and normalized.
+    template <typename GtT>
+    const float* gt_row(const GtT* gt, int y, int W, int step, float* scratch) {
+        if constexpr (std::is_same_v<GtT, float>) {
+            return gt + static_cast<int64_t>(y) * W;
+        } else {
+            const GtT* in = gt + static_cast<int64_t>(y) * W * step;
+            for (int x = 0; x < W; ++x) {
+                scratch[x] = static_cast<float>(in[static_cast<int64_t>(x) * step]) * (1.f / 255.f);
+            }
+            return scratch;
+        }
+    }
+
+    struct BandSums {
+        double l1 = 0.0;
+        double ssim = 0.0;
+    };
+
+    // Loss sums and gradient of the rows [y0, y1) of one H x W plane. Mirrors the tiles of the
+    // CUDA kernel with full-width bands: the statistics on [y0 - HALO, y1 + HALO) come from the
+    // input rows [y0 - 2 * HALO, y1 + 2 * HALO), and the gradient blurs the partials back.
+    template <typename GtT>
+    BandSums l1_ssim_band(const float* rendered, const GtT* gt, int gt_step, float* grad,
+                          int H, int W, int y0, int y1,
+                          float C1, float C2, float l1_scale, float ssim_scale) {
+        const int padded_w = W + 2 * HALO;
+        const int in_rows = (y1 - y0) + 4 * HALO;
+        const int mid_rows = (y1 - y0) + 2 * HALO;
+        const bool cropped = H > 2 * HALO && W > 2 * HALO;
+        const int valid_x0 = cropped ? HALO : 0;
+        const int valid_x1 = cropped ? W - HALO : W;
+        const int valid_y0 = cropped ? HALO : 0;
+        const int valid_y1 = cropped ? H - HALO : H;
+
+        // Horizontal blur of (x, x^2, y, y^2, xy) for every input row of the band
+        std::array<std::vector<float>, 5> hconv;
+        for (auto& h : hconv) {
+            h.assign(static_cast<size_t>(in_rows) * W, 0.f);
+        }
+        std::vector<float> gt_scratch(W);
+        std::array<std::vector<float>, 5> padded;
+        for (auto& p : padded) {
+            p.assign(padded_w, 0.f);
+        }
+        for (int r = 0; r < in_rows; ++r) {
+            const int y = y0 - 2 * HALO + r;
+            if (y < 0 || y >= H) {
+                continue; // zero rows stay zero after blurring
+            }
+            const float* X = rendered + static_cast<int64_t>(y) * W;
+            const float* Y = gt_row(gt, y, W, gt_step, gt_scratch.data());
+            for (int x = 0; x < W; ++x) {
+                padded[0][x + HALO] = X[x];
+                padded[1][x + HALO] = X[x] * X[x];
+                padded[2][x + HALO] = Y[x];
+                padded[3][x + HALO] = Y[x] * Y[x];
+                padded[4][x + HALO] = X[x] * Y[x];
+            }
+            for (int k = 0; k < 5; ++k) {
+                blur_row(padded[k].data(), hconv[k].data() + static_cast<size_t>(r) * W, W);
+            }
+        }
+
+        // Vertical blur, SSIM and its partials, zero outside the valid window; rows padded for the
+        // horizontal gradient blur
+        BandSums sums;
+        std::array<std::vector<float>, 3> partials;
+        for (auto& p : partials) {
+            p.assign(static_cast<size_t>(mid_rows) * padded_w, 0.f);
+        }
+        std::array<std::vector<float>, 5> stats;
+        for (auto& s : stats) {
+            s.resize(W);
+        }
+        for (int r = 0; r < mid_rows; ++r) {
+            const int y = y0 - HALO + r;
+            if (y < valid_y0 || y >= valid_y1) {
+                continue;
+            }
+            for (int k = 0; k < 5; ++k) {
+                std::array<const float*, WINDOW> rows;
+                for (int d = 0; d < WINDOW; ++d) {
+                    rows[d] = hconv[k].data() + static_cast<size_t>(r + d) * W;
+                }
+                blur_column(rows, stats[k].data(), W);
+            }
+            float* p_mu1 = partials[0].data() + static_cast<size_t>(r) * padded_w + HALO;
+            float* p_sigma1_sq = partials[1].data() + static_cast<size_t>(r) * padded_w + HALO;
+            float* p_sigma12 = partials[2].data() + static_cast<size_t>(r) * padded_w + HALO;
+            const bool core_row = y >= y0 && y < y1;
+            double row_ssim = 0.0;
+            for (int x = valid_x0; x < valid_x1; ++x) {
+                const float mu1 = stats[0][x];
+                const float mu2 = stats[2][x];
+                const float mu1_sq = mu1 * mu1;
+                const float mu2_sq = mu2 * mu2;
+                const float sigma1_sq = stats[1][x] - mu1_sq;
+                const float sigma2_sq = stats[3][x] - mu2_sq;
+                const float sigma12 = stats[4][x] - mu1 * mu2;
+
+                const float A = mu1_sq + mu2_sq + C1;
+                const float B = sigma1_sq + sigma2_sq + C2;
+                const float C_ = 2.f * mu1 * mu2 + C1;
+                const float D_ = 2.f * sigma12 + C2;
+
+                p_mu1[x] = (mu2 * 2.f * D_) / (A * B) - (mu2 * 2.f * C_) / (A * B) -
+                           (mu1 * 2.f * C_ * D_) / (A * A * B) + (mu1 * 2.f * C_ * D_) / (A * B * B);
+                p_sigma1_sq[x] = (-C_ * D_) / (A * B * B);
+                p_sigma12[x] = (2.f * C_) / (A * B);
+                row_ssim += (C_ * D_) / (A * B);
+            }
+            if (core_row) {
+                sums.ssim += row_ssim;
+            }
+        }
+
+        // Blur the partials back and combine with the L1 term on the band's own rows
+        std::array<std::vector<float>, 3> hpartials;
+        for (int k = 0; k < 3; ++k) {
+            hpartials[k].resize(static_cast<size_t>(mid_rows) * W);
+            for (int r = 0; r < mid_rows; ++r) {
+                blur_row(partials[k].data() + static_cast<size_t>(r) * padded_w,
+                         hpartials[k].data() + static_cast<size_t>(r) * W, W);
+            }
+        }
+        std::array<std::vector<float>, 3> blurred;
+        for (auto& b : blurred) {
+            b.resize(W);
+        }
+        for (int y = y0; y < y1; ++y) {
+            const int r = y - y0;
+            for (int k = 0; k < 3; ++k) {
+                std::array<const float*, WINDOW> rows;
+                for (int d = 0; d < WINDOW; ++d) {
+                    rows[d] = hpartials[k].data() + static_cast<size_t>(r + d) * W;
+                }
+                blur_column(rows, blurred[k].data(), W);
+            }
+            const float* X = rendered + static_cast<int64_t>(y) * W;
+            const float* Y = gt_row(gt, y, W, gt_step, gt_scratch.data());
+            float* G = grad + static_cast<int64_t>(y) * W;
+            float row_l1 = 0.f;
+            for (int x = 0; x < W; ++x) {
+                const float dssim = blurred[0][x] + 2.f * X[x] * blurred[1][x] + Y[x] * blurred[2][x];
+                const float diff = X[x] - Y[x];
+                const float sign = static_cast<float>((diff > 0.f) - (diff < 0.f));
+                G[x] = l1_scale * sign - ssim_scale * dssim;
+                row_l1 += std::abs(diff);
+            }
+            sums.l1 += row_l1;
+        }
+        return sums;
+    }
+
+} // namespace
+
+std::tuple<torch::Tensor, torch::Tensor>
+fused_l1_ssim_cpu(
+    float C1,
+    float C2,
+    const torch::Tensor& rendered,
+    const torch::Tensor& gt,
+    float lambda_dssim) {
+    check_l1_ssim_inputs(rendered, gt);
+    TORCH_CHECK(rendered.is_cpu() && gt.is_cpu(), "fused_l1_ssim_cpu expects CPU tensors");
+    const auto rendered_c = rendered.detach().contiguous();
+    const auto gt_c = gt.detach().contiguous();
+    const int64_t CH = rendered.size(1);
+    const int64_t planes = rendered.size(0) * CH;
+    const int H = static_cast<int>(rendered.size(2));
+    const int W = static_cast<int>(rendered.size(3));
+
+    const double n_pixels = static_cast<double>(planes) * H * W;
+    const bool cropped = H > 2 * HALO && W > 2 * HALO;
+    const double n_valid = static_cast<double>(planes) * (cropped ? (H - 2 * HALO) * (W - 2 * HALO) : H * W);
+    const float l1_scale = static_cast<float>((1.0 - lambda_dssim) / n_pixels);
+    const float ssim_scale = static_cast<float>(lambda_dssim / n_valid);
+
+    auto grad = torch::empty_like(rendered_c);
+    const int bands = (H + BAND_ROWS - 1) / BAND_ROWS;
+    // Sums per task, added in a fixed order so the loss is deterministic
+    std::vector<BandSums> task_sums(static_cast<size_t>(planes) * bands);
+    const float* r_ptr = rendered_c.data_ptr<float>();
+    float* grad_ptr = grad.data_ptr<float>();
+    const bool gt_u8 = gt_c.scalar_type() == torch::kByte;
+    tbb::parallel_for(int64_t{0}, static_cast<int64_t>(task_sums.size()), [&](int64_t task) {
+        const int64_t plane = task / bands;
+        const int y0 = static_cast<int>(task % bands) * BAND_ROWS;
+        const int y1 = std::min(y0 + BAND_ROWS, H);
+        const int64_t offset = plane * H * W;
+        if (gt_u8) {
+            // Channel c of image n starts at byte n * H * W * CH + c
+            const int64_t gt_offset = (plane / CH) * H * W * CH + plane % CH;
+            task_sums[task] = l1_ssim_band(r_ptr + offset, gt_c.data_ptr<uint8_t>() + gt_offset, static_cast<int>(CH),
+                                           grad_ptr + offset, H, W, y0, y1, C1, C2, l1_scale, ssim_scale);
+        } else {
+            task_sums[task] = l1_ssim_band(r_ptr + offset, gt_c.data_ptr<float>() + offset, 1,
+                                           grad_ptr + offset, H, W, y0, y1, C1, C2, l1_scale, ssim_scale);
+        }
+    });
+
+    BandSums total;
+    for (const auto& s : task_sums) {
+        total.l1 += s.l1;
+        total.ssim += s.ssim;
+    }
+    const double loss = (1.0 - lambda_dssim) * total.l1 / n_pixels + lambda_dssim * (1.0 - total.ssim / n_valid);
+    return std::make_tuple(torch::tensor(static_cast<float>(loss), rendered.options()), grad);
+}
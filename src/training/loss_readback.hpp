@@ -0,0 +1,92 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <algorithm>
+#include <optional>
+#include <torch/torch.h>
+#include <utility>
+#include <vector>
+
+namespace gs::training {
+
+    // Non-blocking device -> host readback of the scalar training loss.
+    // push() queues a copy into a pinned slot on the current stream; poll()
+    // returns the newest value whose copy has already landed, so reporting
+    // progress never stalls the host on the GPU. The host only waits when it
+    // runs more than `slots` iterations ahead of the device.
+    class LossReadback {
+    public:
+        struct Value {
+            int iteration = 0;
+            float loss = 0.0f;
+        };
+
+        explicit LossReadback(size_t slots = 8) {
+            _slots.resize(std::max<size_t>(slots, 1));
+        }
+
+        // Queue the copy of a 0-dim (or single element) CUDA loss; a CPU loss is read directly
+        void push(int iteration, const torch::Tensor& loss) {
+            if (loss.is_cpu()) {
+                _latest = Value{iteration, loss.item<float>()};
+                return;
+            }
+            if (_head - _tail == _slots.size()) {
+                _slots[_tail % _slots.size()].done.synchronize();
+                collect();
+            }
+            auto& slot = _slots[_head % _slots.size()];
+            if (!slot.host.defined()) {
+                slot.host = torch::empty({1}, torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(true));
+            }
+            slot.host.copy_(loss.detach().reshape({1}), /*non_blocking=*/true);
+            slot.done.record(at::cuda::getCurrentCUDAStream());
+            slot.iteration = iteration;
+            ++_head;
+        }
+
+        // Newest loss that reached the host since the last call, if any
+        std::optional<Value> poll() {
+            collect();
+            return std::exchange(_latest, std::nullopt);
+        }
+
+        // Waits for every queued copy and returns the newest value
+        std::optional<Value> flush() {
+            if (_tail < _head) {
+                _slots[(_head - 1) % _slots.size()].done.synchronize();
+            }
+            return poll();
+        }
+
+    private:
+        struct Slot {
+            torch::Tensor host; // pinned float32 [1]
+            at::cuda::CUDAEvent done;
+            int iteration = 0;
+        };
+
+        // Copies complete in stream order, so stop at the first one still in flight
+        void collect() {
+            while (_tail < _head) {
+                auto& slot = _slots[_tail % _slots.size()];
+                if (!slot.done.query()) {
+                    break;
+                }
+                _latest = Value{slot.iteration, slot.host.data_ptr<float>()[0]};
+                ++_tail;
+            }
+        }
+
+        std::vector<Slot> _slots;
+        size_t _head = 0; // Next slot to fill
+        size_t _tail = 0; // Oldest copy not yet collected
+        std::optional<Value> _latest;
+    };
+
+} // namespace gs::training
@@ -3,14 +3,21 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "metrics.hpp"
+#include "core/device.hpp"
 #include "core/image_io.hpp"
+#include "core/logger.hpp"
 #include "core/splat_data.hpp"
 #include "rasterization/fast_rasterizer.hpp"
 #include "rasterization/rasterizer.hpp"
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
 #include <chrono>
 #include <cmath>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <optional>
 
 namespace gs::training {
     // 1D Gaussian kernel
@@ -38,81 +45,78 @@ namespace gs::training {
 
     // PSNR Implementation
     float PSNR::compute(const torch::Tensor& pred, const torch::Tensor& target) const {
+        return per_image(pred, target).mean().item<float>();
+    }
+
+    torch::Tensor PSNR::per_image(const torch::Tensor& pred, const torch::Tensor& target) const {
         TORCH_CHECK(pred.sizes() == target.sizes(),
                     "Prediction and target must have the same shape");
 
-        // Make tensors contiguous before operations
-        const auto pred_cont = pred.contiguous();
-        const auto target_cont = target.contiguous();
-
-        // Compute MSE
-        const torch::Tensor squared_diff = (pred_cont - target_cont).pow(2);
-
         // Use reshape instead of view to handle non-contiguous tensors
-        torch::Tensor mse_val = squared_diff.reshape({pred.size(0), -1}).mean(1, true);
+        torch::Tensor mse_val = (pred - target).pow(2).reshape({pred.size(0), -1}).mean(1);
 
         // Avoid log(0)
         mse_val = torch::clamp_min(mse_val, 1e-10);
 
         // PSNR = 20 * log10(data_range / sqrt(MSE))
-        return (20.f * torch::log10(data_range_ / mse_val.sqrt())).mean().item<float>();
+        return 20.f * torch::log10(data_range_ / mse_val.sqrt());
     }
 
     // SSIM Implementation
     SSIM::SSIM(const int window_size, const int channel)
         : window_size_(window_size),
           channel_(channel) {
-        window_ = create_window(window_size, channel).to(torch::kFloat32);
+        window_ = gaussian(window_size, 1.5).to(torch::kFloat32);
     }
 
     float SSIM::compute(const torch::Tensor& pred, const torch::Tensor& target) {
+        return per_image(pred, target).mean().item<float>();
+    }
+
+    torch::Tensor SSIM::per_image(const torch::Tensor& pred, const torch::Tensor& target) {
         TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
         TORCH_CHECK(pred.sizes() == target.sizes(),
                     "Prediction and target must have the same shape");
+        TORCH_CHECK(pred.size(1) == channel_, "Expected ", channel_, " channels, got ", pred.size(1));
 
         // Ensure window is on the same device as input
         if (window_.device() != pred.device()) {
             window_ = window_.to(pred.device());
         }
 
-        const int pad = window_size_ / 2;
-
-        // Compute local means
-        const auto mu1 = torch::nn::functional::conv2d(pred, window_,
-                                                       torch::nn::functional::Conv2dFuncOptions()
-                                                           .padding(pad)
-                                                           .groups(channel_));
-        const auto mu2 = torch::nn::functional::conv2d(target, window_,
-                                                       torch::nn::functional::Conv2dFuncOptions()
-                                                           .padding(pad)
-                                                           .groups(channel_));
+        // Local means of x, y, x^2, y^2 and xy in one grouped pass per axis. The 2D window is the
+        // outer product of the 1D one, so with zero padding this equals the full 2D convolution.
+        const int64_t pad = window_size_ / 2;
+        const int64_t planes = 5 * channel_;
+        const auto stats = torch::cat({pred, target, pred * pred, target * target, pred * target}, 1);
+        auto blurred = torch::nn::functional::conv2d(stats,
+                                                     window_.view({1, 1, 1, window_size_}).expand({planes, 1, 1, window_size_}),
+                                                     torch::nn::functional::Conv2dFuncOptions()
+                                                         .padding({0, pad})
+                                                         .groups(planes));
+        blurred = torch::nn::functional::conv2d(blurred,
+                                                window_.view({1, 1, window_size_, 1}).expand({planes, 1, window_size_, 1}),
+                                                torch::nn::functional::Conv2dFuncOptions()
+                                                    .padding({pad, 0})
+                                                    .groups(planes));
+        const auto moments = blurred.chunk(5, 1);
+        const auto& mu1 = moments[0];
+        const auto& mu2 = moments[1];
 
         const auto mu1_sq = mu1.pow(2);
         const auto mu2_sq = mu2.pow(2);
         const auto mu1_mu2 = mu1 * mu2;
 
-        // Compute local variances and covariance
-        const auto sigma1_sq = torch::nn::functional::conv2d(pred * pred, window_,
-                                                             torch::nn::functional::Conv2dFuncOptions()
-                                                                 .padding(pad)
-                                                                 .groups(channel_)) -
-                               mu1_sq;
-        const auto sigma2_sq = torch::nn::functional::conv2d(target * target, window_,
-                                                             torch::nn::functional::Conv2dFuncOptions()
-                                                                 .padding(pad)
-                                                                 .groups(channel_)) -
-                               mu2_sq;
-        const auto sigma12 = torch::nn::functional::conv2d(pred * target, window_,
-                                                           torch::nn::functional::Conv2dFuncOptions()
-                                                               .padding(pad)
-                                                               .groups(channel_)) -
-                             mu1_mu2;
+        // Local variances and covariance
+        const auto sigma1_sq = moments[2] - mu1_sq;
+        const auto sigma2_sq = moments[3] - mu2_sq;
+        const auto sigma12 = moments[4] - mu1_mu2;
 
         // SSIM formula
         const auto ssim_map = ((2.f * mu1_mu2 + C1) * (2.f * sigma12 + C2)) /
                               ((mu1_sq + mu2_sq + C1) * (sigma1_sq + sigma2_sq + C2));
 
-        return ssim_map.mean().item<float>();
+        return ssim_map.reshape({pred.size(0), -1}).mean(1);
     }
 
     // LPIPS Implementation
@@ -146,7 +150,7 @@ namespace gs::training {
         try {
             model_ = torch::jit::load(model_path);
             model_.eval();
-            model_.to(torch::kCUDA);
+            model_.to(training_device());
             model_loaded_ = true;
             std::cout << "LPIPS model loaded from: " << model_path << std::endl;
         } catch (const c10::Error& e) {
@@ -156,6 +160,10 @@ namespace gs::training {
     }
 
     float LPIPS::compute(const torch::Tensor& pred, const torch::Tensor& target) {
+        return per_image(pred, target).mean().item<float>();
+    }
+
+    torch::Tensor LPIPS::per_image(const torch::Tensor& pred, const torch::Tensor& target) {
         TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
         TORCH_CHECK(pred.sizes() == target.sizes(),
                     "Prediction and target must have the same shape");
@@ -168,11 +176,11 @@ namespace gs::training {
         auto pred_normalized = 2.0f * pred - 1.0f;
         auto target_normalized = 2.0f * target - 1.0f;
 
-        // Ensure inputs are on CUDA and contiguous
-        pred_normalized = pred_normalized.to(torch::kCUDA).contiguous();
-        target_normalized = target_normalized.to(torch::kCUDA).contiguous();
+        // Ensure inputs are on the model's device and contiguous
+        pred_normalized = pred_normalized.to(training_device()).contiguous();
+        target_normalized = target_normalized.to(training_device()).contiguous();
 
-        // Forward pass through LPIPS model
+        // Forward pass through LPIPS model, the whole batch at once
         std::vector<torch::jit::IValue> inputs;
         inputs.push_back(pred_normalized);
         inputs.push_back(target_normalized);
@@ -180,14 +188,60 @@ namespace gs::training {
         const auto output = model_.forward(inputs).toTensor();
 
         // LPIPS returns a single value per batch item
-        return output.mean().item<float>();
+        return output.reshape({pred.size(0), -1}).mean(1).to(pred.device());
+    }
+
+    // MetricsEngine Implementation
+    MetricsEngine::MetricsEngine(std::shared_ptr<LPIPS> lpips, const int64_t max_batch)
+        : psnr_(1.0f),
+          ssim_(11, 3),
+          lpips_(std::move(lpips)),
+          max_batch_(std::max<int64_t>(max_batch, 1)) {
+    }
+
+    torch::Tensor MetricsEngine::evaluate(const torch::Tensor& pred, const torch::Tensor& target) {
+        TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
+        const torch::NoGradGuard no_grad;
+        const auto pred_f = pred.to(torch::kFloat32);
+        const auto target_f = target.to(pred_f.device(), torch::kFloat32);
+
+        const auto lpips = lpips_ ? lpips_->per_image(pred_f, target_f)
+                                  : torch::full({pred.size(0)}, std::numeric_limits<float>::quiet_NaN(), pred_f.options());
+        return torch::stack({psnr_.per_image(pred_f, target_f), ssim_.per_image(pred_f, target_f), lpips});
+    }
+
+    MetricsEngine::Scores MetricsEngine::score(const torch::Tensor& pred, const torch::Tensor& target) {
+        TORCH_CHECK(pred.dim() == 4, "Expected 4D tensor [B, C, H, W]");
+        TORCH_CHECK(pred.sizes() == target.sizes(),
+                    "Prediction and target must have the same shape");
+
+        const int64_t batch = pred.size(0);
+        std::vector<torch::Tensor> chunks;
+        for (int64_t i = 0; i < batch; i += max_batch_) {
+            const int64_t n = std::min(max_batch_, batch - i);
+            chunks.push_back(evaluate(pred.narrow(0, i, n), target.narrow(0, i, n)));
+        }
+        if (chunks.empty()) {
+            return {};
+        }
+
+        const auto host = torch::cat(chunks, 1).to(torch::kCPU).contiguous();
+        const float* values = host.data_ptr<float>();
+        Scores scores;
+        scores.psnr.assign(values, values + batch);
+        scores.ssim.assign(values + batch, values + 2 * batch);
+        if (lpips_) {
+            scores.lpips.assign(values + 2 * batch, values + 3 * batch);
+        }
+        return scores;
     }
 
     // MetricsReporter Implementation
     MetricsReporter::MetricsReporter(const std::filesystem::path& output_dir)
         : output_dir_(output_dir),
           csv_path_(output_dir_ / "metrics.csv"),
-          txt_path_(output_dir_ / "metrics_report.txt") {
+          txt_path_(output_dir_ / "metrics_report.txt"),
+          view_weights_path_(output_dir_ / "view_weights.csv") {
         // Create CSV header if file doesn't exist
         if (!std::filesystem::exists(csv_path_)) {
             std::ofstream csv_file(csv_path_);
@@ -209,6 +263,24 @@ namespace gs::training {
         }
     }
 
+    void MetricsReporter::add_view_weights(const int iteration,
+                                           const std::vector<std::string>& view_names,
+                                           const std::vector<LossWeightedSampler::ViewWeight>& weights) const {
+        const bool write_header = !std::filesystem::exists(view_weights_path_);
+        std::ofstream csv_file(view_weights_path_, std::ios::app);
+        if (!csv_file.is_open()) {
+            std::cerr << "Failed to open view weights file: " << view_weights_path_ << std::endl;
+            return;
+        }
+        if (write_header) {
+            csv_file << "iteration,image,loss_estimate,probability" << std::endl;
+        }
+        csv_file << std::fixed << std::setprecision(6);
+        for (size_t i = 0; i < weights.size() && i < view_names.size(); ++i) {
+            csv_file << iteration << "," << view_names[i] << "," << weights[i].loss << "," << weights[i].probability << "\n";
+        }
+    }
+
     void MetricsReporter::save_report() const {
         std::ofstream report_file(txt_path_);
         if (!report_file.is_open()) {
@@ -294,21 +366,21 @@ namespace gs::training {
             return;
         }
 
-        // Initialize metrics
-        _psnr_metric = std::make_unique<PSNR>(1.0f);
-        _ssim_metric = std::make_unique<SSIM>(11, 3);
-
         // Find LPIPS model
         std::filesystem::path lpips_path = params.dataset.output_path.parent_path() / "weights" / "lpips_vgg.pt";
         if (!std::filesystem::exists(lpips_path)) {
             lpips_path = "weights/lpips_vgg.pt";
         }
-        _lpips_metric = std::make_unique<LPIPS>(lpips_path.string());
+        _engine = std::make_unique<MetricsEngine>(std::make_shared<LPIPS>(lpips_path.string()));
 
         // Initialize reporter
         _reporter = std::make_unique<MetricsReporter>(params.dataset.output_path);
     }
 
+    MetricsEvaluator::~MetricsEvaluator() {
+        wait();
+    }
+
     bool MetricsEvaluator::should_evaluate(const int iteration) const {
         if (!_params.optimization.enable_eval)
             return false;
@@ -382,8 +454,22 @@ namespace gs::training {
         return colormap;
     }
 
-    auto MetricsEvaluator::make_dataloader(std::shared_ptr<CameraDataset> dataset, const int workers) const {
-        return create_dataloader_from_dataset(dataset, workers);
+    torch::Tensor MetricsEvaluator::val_image(CameraDataset& dataset, const size_t index) {
+        if (_cached_dataset != &dataset) {
+            _cached_dataset = &dataset;
+            _val_images.assign(dataset.size().value(), torch::Tensor());
+        }
+        auto& image = _val_images[index];
+        if (!image.defined()) {
+            auto loaded = dataset.get(index).data.image;
+            if (loaded.is_cuda()) {
+                image = torch::empty(loaded.sizes(), loaded.options().device(torch::kCPU).pinned_memory(true));
+                image.copy_(loaded);
+            } else {
+                image = std::move(loaded);
+            }
+        }
+        return image.to(training_device(), /*non_blocking=*/true);
     }
 
     EvalMetrics MetricsEvaluator::evaluate(const int iteration,
@@ -398,9 +484,8 @@ namespace gs::training {
         result.num_gaussians = static_cast<int>(splatData.size());
         result.iteration = iteration;
 
-        const auto val_dataloader = make_dataloader(val_dataset);
-
-        std::vector<float> psnr_values, ssim_values, lpips_values;
+        // Per-view [3, 1] score columns, read back together after the last view
+        std::vector<torch::Tensor> scores;
         const auto start_time = std::chrono::steady_clock::now();
 
         // Create directory for evaluation images
@@ -419,11 +504,15 @@ namespace gs::training {
 
         int image_idx = 0;
         const size_t val_dataset_size = val_dataset->size().value();
+        const auto val_cameras = val_dataset->get_split_cameras();
 
-        for (auto& batch : *val_dataloader) {
-            auto camera_with_image = batch[0].data;
-            Camera* cam = camera_with_image.camera; // rasterize needs non-const Camera&
-            torch::Tensor gt_image = std::move(camera_with_image.image).to(torch::kCUDA);
+        for (size_t i = 0; i < val_dataset_size; ++i) {
+            Camera* cam = val_cameras[i].get(); // rasterize needs non-const Camera&
+            // Metrics compare float [C, H, W] images in [0, 1], the dataset yields uint8 [H, W, C]
+            torch::Tensor gt_image = val_image(*val_dataset, i)
+                                         .permute({2, 0, 1})
+                                         .to(torch::kFloat32) /
+                                     255.0f;
 
             // TODO: const_cast is certainly not the correct solution here!
             auto& splatData_mutable = const_cast<SplatData&>(splatData);
@@ -441,13 +530,7 @@ namespace gs::training {
                 r_output.image = torch::clamp(r_output.image, 0.0, 1.0);
 
                 // Compute metrics
-                const float psnr = _psnr_metric->compute(r_output.image, gt_image);
-                const float ssim = _ssim_metric->compute(r_output.image, gt_image);
-                const float lpips = _lpips_metric->compute(r_output.image, gt_image);
-
-                psnr_values.push_back(psnr);
-                ssim_values.push_back(ssim);
-                lpips_values.push_back(lpips);
+                scores.push_back(_engine->evaluate(r_output.image, gt_image));
 
                 // Save side-by-side RGB images asynchronously
                 if (_params.optimization.enable_save_eval_images) {
@@ -505,20 +588,22 @@ namespace gs::training {
             }
         }
 
-        const auto end_time = std::chrono::steady_clock::now();
-        const auto elapsed = std::chrono::duration<float>(end_time - start_time).count();
-
-        // Compute averages only if we have RGB metrics
-        if (has_rgb() && !psnr_values.empty()) {
-            result.psnr = std::accumulate(psnr_values.begin(), psnr_values.end(), 0.0f) / psnr_values.size();
-            result.ssim = std::accumulate(ssim_values.begin(), ssim_values.end(), 0.0f) / ssim_values.size();
-            result.lpips = std::accumulate(lpips_values.begin(), lpips_values.end(), 0.0f) / lpips_values.size();
+        // Compute averages only if we have RGB metrics; the single readback also waits for the renders
+        if (has_rgb() && !scores.empty()) {
+            const auto means = torch::cat(scores, 1).mean(1).to(torch::kCPU);
+            const auto values = means.accessor<float, 1>();
+            result.psnr = values[0];
+            result.ssim = values[1];
+            result.lpips = values[2];
         } else {
             // Set default values for depth-only modes
             result.psnr = 0.0f;
             result.ssim = 0.0f;
             result.lpips = 0.0f;
         }
+
+        const auto end_time = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration<float>(end_time - start_time).count();
         result.elapsed_time = elapsed / val_dataset_size;
 
         // Add metrics to reporter
@@ -533,4 +618,51 @@ namespace gs::training {
 
         return result;
     }
+
+    void MetricsEvaluator::evaluate_async(const int iteration,
+                                          SplatData snapshot,
+                                          std::shared_ptr<CameraDataset> val_dataset,
+                                          torch::Tensor background) {
+        wait();
+
+        // The snapshot copies are queued on the training stream; only the worker waits for them.
+        // On the CPU they have already completed and the event stays unrecorded.
+        const bool on_cuda = training_on_cuda();
+        auto ready = std::make_shared<at::cuda::CUDAEvent>();
+        if (on_cuda) {
+            ready->record(at::cuda::getCurrentCUDAStream());
+        }
+
+        auto model = std::make_shared<SplatData>(std::move(snapshot));
+        _pending = std::async(std::launch::async, [this, iteration, on_cuda, ready, model,
+                                                   val_dataset = std::move(val_dataset),
+                                                   background = std::move(background)]() mutable {
+            ready->synchronize();
+            // Renders and metrics go to a side stream on the training device, which also becomes
+            // this thread's current device. The rasterizer launches on the current stream, so the
+            // evaluation overlaps training without sharing its stream.
+            std::optional<at::cuda::CUDAStreamGuard> guard;
+            if (on_cuda) {
+                guard.emplace(at::cuda::getStreamFromPool(false, training_device().index()));
+            }
+            torch::NoGradGuard no_grad;
+
+            const auto metrics = evaluate(iteration, *model, val_dataset, background);
+            if (on_cuda) {
+                guard->current_stream().synchronize();
+            }
+            LOG_INFO("[Evaluation at step {}] {}", iteration, metrics.to_string());
+        });
+    }
+
+    void MetricsEvaluator::wait() {
+        if (!_pending.valid()) {
+            return;
+        }
+        try {
+            _pending.get();
+        } catch (const std::exception& e) {
+            LOG_ERROR("Evaluation failed: {}", e.what());
+        }
+    }
 } // namespace gs::training
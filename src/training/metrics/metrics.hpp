@@ -5,10 +5,12 @@
 #pragma once
 
 #include "../dataset.hpp"
+#include "../view_sampler.hpp"
 #include "core/parameters.hpp"
 #include "core/splat_data.hpp"
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <memory>
 #include <sstream>
@@ -32,21 +34,27 @@ namespace gs::training {
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target) const;
 
+        // [B] PSNR of every image pair, on the input device
+        torch::Tensor per_image(const torch::Tensor& pred, const torch::Tensor& target) const;
+
     private:
         const float data_range_;
     };
 
-    // Structural Similarity Index
+    // Structural Similarity Index, blurring with the separable Gaussian window one axis at a time
     class SSIM {
     public:
         SSIM(const int window_size = 11, const int channel = 3);
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target);
 
+        // [B] mean SSIM of every image pair, on the input device
+        torch::Tensor per_image(const torch::Tensor& pred, const torch::Tensor& target);
+
     private:
         const int window_size_;
         const int channel_;
-        torch::Tensor window_;
+        torch::Tensor window_; // 1D Gaussian [window_size]
         static constexpr float C1 = 0.01f * 0.01f;
         static constexpr float C2 = 0.03f * 0.03f;
     };
@@ -57,6 +65,9 @@ namespace gs::training {
 
         float compute(const torch::Tensor& pred, const torch::Tensor& target);
 
+        // [B] LPIPS of every image pair in one forward pass, on the input device
+        torch::Tensor per_image(const torch::Tensor& pred, const torch::Tensor& target);
+
         bool is_loaded() const { return model_loaded_; }
 
     private:
@@ -66,6 +77,32 @@ namespace gs::training {
         void load_model(const std::string& model_path);
     };
 
+    // Scores batches of (pred, target) pairs, [B, C, H, W] in [0, 1] on one device. Every metric is
+    // reduced per image on that device and score() reads them back once per batch. The CPU path
+    // runs the same tensor ops, so offline scoring on the CPU matches the numbers from training.
+    class MetricsEngine {
+    public:
+        struct Scores {
+            std::vector<float> psnr;
+            std::vector<float> ssim;
+            std::vector<float> lpips; // Empty without an LPIPS model
+        };
+
+        explicit MetricsEngine(std::shared_ptr<LPIPS> lpips = nullptr, const int64_t max_batch = 16);
+
+        // [3, B] rows of PSNR, SSIM and LPIPS (NaN without a model) on the input device, no host sync
+        torch::Tensor evaluate(const torch::Tensor& pred, const torch::Tensor& target);
+
+        // evaluate() over chunks of at most max_batch images with a single readback
+        Scores score(const torch::Tensor& pred, const torch::Tensor& target);
+
+    private:
+        PSNR psnr_;
+        SSIM ssim_;
+        std::shared_ptr<LPIPS> lpips_;
+        const int64_t max_batch_;
+    };
+
     // Evaluation result structure
     struct EvalMetrics {
         float psnr;
@@ -112,17 +149,27 @@ namespace gs::training {
 
         void save_report() const;
 
+        // Appends the sampling weight of every training view to view_weights.csv
+        void add_view_weights(int iteration,
+                              const std::vector<std::string>& view_names,
+                              const std::vector<LossWeightedSampler::ViewWeight>& weights) const;
+
     private:
         const std::filesystem::path output_dir_;
         std::vector<EvalMetrics> all_metrics_;
         const std::filesystem::path csv_path_;
         const std::filesystem::path txt_path_;
+        const std::filesystem::path view_weights_path_;
     };
 
     // Main evaluator class that handles all metrics computation and visualization
     class MetricsEvaluator {
     public:
         explicit MetricsEvaluator(const param::TrainingParameters& params);
+        ~MetricsEvaluator();
+
+        MetricsEvaluator(const MetricsEvaluator&) = delete;
+        MetricsEvaluator& operator=(const MetricsEvaluator&) = delete;
 
         // Check if evaluation is enabled
         bool is_enabled() const { return _params.optimization.enable_eval; }
@@ -130,22 +177,35 @@ namespace gs::training {
         // Check if we should evaluate at this iteration
         bool should_evaluate(const int iteration) const;
 
-        // Main evaluation method
+        // Main evaluation method, blocks the calling thread
         EvalMetrics evaluate(const int iteration,
                              const SplatData& splatData,
                              std::shared_ptr<CameraDataset> val_dataset,
                              torch::Tensor& background);
 
-        // Save final report
+        // Evaluates `snapshot` (see SplatData::snapshot) on a worker thread and a side stream once the
+        // work queued so far on the current stream has finished; the result is logged and added to
+        // the report. Waits for a previous evaluation that is still in flight.
+        void evaluate_async(const int iteration,
+                            SplatData snapshot,
+                            std::shared_ptr<CameraDataset> val_dataset,
+                            torch::Tensor background);
+
+        // Blocks until the pending evaluation (if any) is reported
+        void wait();
+
+        // Save final report; call wait() first to include a pending evaluation
         void save_report() const {
             if (_reporter)
                 _reporter->save_report();
         }
 
-        // Print evaluation header
-        void print_evaluation_header(const int iteration) const {
-            std::cout << std::endl;
-            std::cout << "[Evaluation at step " << iteration << "]" << std::endl;
+        // Record the loss-weighted sampling distribution next to the metrics
+        void add_view_weights(const int iteration,
+                              const std::vector<std::string>& view_names,
+                              const std::vector<LossWeightedSampler::ViewWeight>& weights) const {
+            if (_reporter)
+                _reporter->add_view_weights(iteration, view_names, weights);
         }
 
     private:
@@ -153,11 +213,16 @@ namespace gs::training {
         const param::TrainingParameters _params;
 
         // Metrics
-        std::unique_ptr<PSNR> _psnr_metric;
-        std::unique_ptr<SSIM> _ssim_metric;
-        std::unique_ptr<LPIPS> _lpips_metric;
+        std::unique_ptr<MetricsEngine> _engine;
         std::unique_ptr<MetricsReporter> _reporter;
 
+        // Validation images as loaded (uint8 [H, W, C], pinned when training on CUDA), filled on the
+        // first evaluation of a dataset
+        const CameraDataset* _cached_dataset = nullptr;
+        std::vector<torch::Tensor> _val_images;
+
+        std::future<void> _pending;
+
         // Helper functions
         torch::Tensor apply_depth_colormap(const torch::Tensor& depth_normalized) const;
 
@@ -165,7 +230,7 @@ namespace gs::training {
 
         bool has_depth() const;
 
-        // Create dataloader from dataset
-        auto make_dataloader(std::shared_ptr<CameraDataset> dataset, const int workers = 1) const;
+        // Ground truth of validation view `index` on the training device
+        torch::Tensor val_image(CameraDataset& dataset, size_t index);
     };
 } // namespace gs::training
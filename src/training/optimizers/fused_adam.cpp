@@ -14,12 +14,27 @@
 #define SKIP_SH_STEPS false
 
 namespace gs::training {
+    namespace {
+        // Decays each row's moments by the steps it missed since it was last current
+        void apply_pending_decay(FusedAdam::AdamParamState& state, double beta1, double beta2) {
+            if (!state.last_step.defined()) {
+                return;
+            }
+            const auto elapsed = (state.step_count - state.last_step).to(torch::kFloat);
+            auto shape = std::vector<int64_t>(state.exp_avg.dim(), 1);
+            shape[0] = -1;
+            state.exp_avg.mul_(torch::pow(beta1, elapsed).view(shape));
+            state.exp_avg_sq.mul_(torch::pow(beta2, elapsed).view(shape));
+            state.last_step.reset();
+        }
+    } // namespace
+
     torch::Tensor FusedAdam::step(LossClosure closure) {
         TORCH_CHECK(false, "FusedAdam does not support closures.");
         return {};
     }
 
-    void FusedAdam::step(int iteration) {
+    void FusedAdam::step(int iteration, const torch::Tensor& rows) {
         torch::NoGradGuard no_grad;
 
         // Get global options
@@ -53,8 +68,10 @@ namespace gs::training {
                 if (state_ptr == state_.end()) {
                     auto new_state = std::make_unique<AdamParamState>();
                     new_state->step_count = 0;
-                    new_state->exp_avg = torch::zeros_like(param, torch::MemoryFormat::Preserve);
-                    new_state->exp_avg_sq = torch::zeros_like(param, torch::MemoryFormat::Preserve);
+                    // Moments have their own storage type, independent of the parameter's
+                    const auto moment_options = param.options().dtype(moment_dtype(group));
+                    new_state->exp_avg = torch::zeros_like(param, moment_options, torch::MemoryFormat::Preserve);
+                    new_state->exp_avg_sq = torch::zeros_like(param, moment_options, torch::MemoryFormat::Preserve);
 
                     state_[param.unsafeGetTensorImpl()] = std::move(new_state);
                     state_ptr = state_.find(param.unsafeGetTensorImpl());
@@ -62,6 +79,11 @@ namespace gs::training {
 
                 auto& state = static_cast<AdamParamState&>(*state_ptr->second);
 
+                // A dense step after sparse ones first settles the rows they skipped
+                if (!rows.defined()) {
+                    apply_pending_decay(state, beta1, beta2);
+                }
+
                 // Increment step
                 state.step_count++;
 
@@ -78,12 +100,39 @@ namespace gs::training {
                 auto bias_correction1_rcp = 1.0 / (1.0 - std::pow(beta1, state.step_count));
                 auto bias_correction2_sqrt_rcp = 1.0 / std::sqrt(1.0 - std::pow(beta2, state.step_count));
 
+                if (rows.defined()) {
+                    // Rows without a record were current before this step
+                    if (!state.last_step.defined()) {
+                        state.last_step = torch::full({param.size(0)}, state.step_count - 1,
+                                                      torch::TensorOptions().dtype(torch::kInt32).device(param.device()));
+                    }
+                    TORCH_CHECK(state.last_step.size(0) == param.size(0),
+                                "FusedAdam: parameter rows changed without catch_up()");
+
+                    fast_gs::optimizer::adam_step_sparse_wrapper(
+                        param,
+                        state.exp_avg,
+                        state.exp_avg_sq,
+                        param.grad(),
+                        rows,
+                        state.last_step,
+                        static_cast<int>(state.step_count),
+                        static_cast<float>(lr),
+                        static_cast<float>(beta1),
+                        static_cast<float>(beta2),
+                        static_cast<float>(eps),
+                        static_cast<float>(bias_correction1_rcp),
+                        static_cast<float>(bias_correction2_sqrt_rcp));
+                    continue;
+                }
+
                 // Call the fused CUDA kernel from fastgs
                 fast_gs::optimizer::adam_step_wrapper(
                     param,
                     state.exp_avg,
                     state.exp_avg_sq,
                     param.grad(),
+                    static_cast<int>(state.step_count),
                     static_cast<float>(lr),
                     static_cast<float>(beta1),
                     static_cast<float>(beta2),
@@ -94,6 +143,36 @@ namespace gs::training {
         }
     }
 
+    void FusedAdam::catch_up() {
+        torch::NoGradGuard no_grad;
+        for (const auto& group : param_groups()) {
+            const auto [beta1, beta2] = group_betas(group);
+            for (const auto& param : group.params()) {
+                if (auto it = state_.find(param.unsafeGetTensorImpl()); it != state_.end()) {
+                    apply_pending_decay(static_cast<AdamParamState&>(*it->second), beta1, beta2);
+                }
+            }
+        }
+    }
+
+    torch::ScalarType FusedAdam::moment_dtype(const torch::optim::OptimizerParamGroup& group) const {
+        if (group.has_options()) {
+            if (const auto* group_opts = dynamic_cast<const Options*>(&group.options())) {
+                return group_opts->moment_dtype();
+            }
+        }
+        return options().moment_dtype();
+    }
+
+    std::tuple<double, double> FusedAdam::group_betas(const torch::optim::OptimizerParamGroup& group) const {
+        if (group.has_options()) {
+            if (const auto* group_opts = dynamic_cast<const Options*>(&group.options())) {
+                return group_opts->betas();
+            }
+        }
+        return options().betas();
+    }
+
     // Based on https://github.com/pytorch/pytorch/blob/ee343ce60ceb449da09d229db25fa9d425d85a4b/torch/csrc/api/src/optim/optimizer.cpp#L122
     void FusedAdam::zero_grad(bool set_to_none, int iteration) {
         if constexpr (SKIP_SH_STEPS) {
@@ -40,22 +40,31 @@ namespace gs::training {
                 return *this;
             }
 
+            // Storage type of exp_avg and exp_avg_sq: kFloat or kBFloat16
+            Options& moment_dtype(torch::ScalarType moment_dtype) {
+                moment_dtype_ = moment_dtype;
+                return *this;
+            }
+
             double lr() const { return lr_; }
             const std::tuple<double, double>& betas() const { return betas_; }
             double eps() const { return eps_; }
             double weight_decay() const { return weight_decay_; }
+            torch::ScalarType moment_dtype() const { return moment_dtype_; }
 
         private:
             double lr_ = 1e-3;
             std::tuple<double, double> betas_ = std::make_tuple(0.9, 0.999);
             double eps_ = 1e-8;
             double weight_decay_ = 0;
+            torch::ScalarType moment_dtype_ = torch::kFloat;
         };
 
         struct AdamParamState : public torch::optim::OptimizerParamState {
             torch::Tensor exp_avg;
             torch::Tensor exp_avg_sq;
             torch::Tensor max_exp_avg_sq; // For amsgrad variant (not used currently)
+            torch::Tensor last_step;      // Sparse steps: [N] int32 step each row is current at, undefined when all are
             int64_t step_count = 0;
 
             void serialize(torch::serialize::OutputArchive& archive) const override {
@@ -65,6 +74,9 @@ namespace gs::training {
                 if (max_exp_avg_sq.defined()) {
                     archive.write("max_exp_avg_sq", max_exp_avg_sq);
                 }
+                if (last_step.defined()) {
+                    archive.write("last_step", last_step);
+                }
             }
         };
 
@@ -84,8 +96,22 @@ namespace gs::training {
 
         /**
          * @brief Perform optimization step
+         * @param rows Optional unique int64 indices of the Gaussians to update. When defined, only
+         *             these rows of every parameter take a step; the moments of the others decay
+         *             lazily and catch up the next time they are updated.
          */
-        void step(int iteration);
+        void step(int iteration, const torch::Tensor& rows = {});
+
+        /**
+         * @brief Apply the moment decay still owed by rows that sparse steps skipped
+         *
+         * Leaves every row current. Must be called before the rows of the parameters or their
+         * moments are reordered, removed or appended.
+         */
+        void catch_up();
+
+        // Storage type of the moments of a parameter group, falling back to the global options
+        torch::ScalarType moment_dtype(const torch::optim::OptimizerParamGroup& group) const;
 
         void zero_grad(bool set_to_none, int iteration);
 
@@ -93,5 +119,7 @@ namespace gs::training {
         const Options& options() const {
             return static_cast<const Options&>(defaults());
         }
+
+        std::tuple<double, double> group_betas(const torch::optim::OptimizerParamGroup& group) const;
     };
 } // namespace gs::training
@@ -47,6 +47,10 @@ namespace gs::training {
 
         void step();
 
+        // Number of step() calls so far; restoring it resumes the schedule from a checkpoint
+        int current_step() const { return current_step_; }
+        void set_current_step(int step) { current_step_ = step; }
+
     private:
         torch::optim::Optimizer& optimizer_;
         double gamma_;
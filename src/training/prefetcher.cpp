@@ -0,0 +1,289 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "prefetcher.hpp"
+#include "core/image_io.hpp"
+#include "core/image_resize.hpp"
+#include "core/logger.hpp"
+#include "strategies/strategy_utils.hpp"
+#include <ATen/CPUGeneratorImpl.h>
+#include <algorithm>
+#include <c10/cuda/CUDAGuard.h>
+#include <chrono>
+#include <cstring>
+
+namespace gs::training {
+
+    ImagePrefetcher::ImagePrefetcher(std::shared_ptr<CameraDataset> dataset, Options options)
+        : _dataset(std::move(dataset)),
+          _options(options),
+          _resize_factor(_dataset->get_resize_factor()),
+          _sample(options.first_sample) {
+
+        _cameras = _dataset->get_split_cameras();
+        if (_cameras.empty()) {
+            throw std::runtime_error("ImagePrefetcher: dataset is empty");
+        }
+        _options.ring_size = std::max<size_t>(_options.ring_size, 2);
+        _options.num_workers = std::max(_options.num_workers, 1);
+        _options.views_per_step = std::max(_options.views_per_step, 1);
+        if (_options.sampler && _options.sampler->size() != _cameras.size()) {
+            throw std::runtime_error("ImagePrefetcher: sampler does not match the dataset size");
+        }
+
+        // Size the buffers for the expected decoded image so steady state never reallocates
+        size_t slot_bytes = 0;
+        for (const auto& cam : _cameras) {
+            const auto [w, h] = image_io::downscaled_size(cam->camera_width(), cam->camera_height(),
+                                                          static_cast<float>(_resize_factor));
+            slot_bytes = std::max(slot_bytes, static_cast<size_t>(w) * h * 3);
+        }
+
+        // Page-locked buffers only pay off (and only exist) when uploading to a CUDA device
+        const auto pinned = torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(_device.is_cuda());
+        _slots.reserve(_options.ring_size);
+        for (size_t i = 0; i < _options.ring_size; ++i) {
+            auto slot = std::make_unique<Slot>();
+            slot->buffer = torch::empty({static_cast<int64_t>(slot_bytes)}, pinned);
+            _slots.push_back(std::move(slot));
+        }
+
+        _stats.min_depth = _options.ring_size;
+
+        _workers.reserve(_options.num_workers);
+        for (int i = 0; i < _options.num_workers; ++i) {
+            _workers.emplace_back(&ImagePrefetcher::worker_loop, this);
+        }
+
+        LOG_DEBUG("ImagePrefetcher started: {} workers, ring of {} x {:.1f} MB pinned buffers",
+                  _options.num_workers, _options.ring_size,
+                  static_cast<double>(slot_bytes) / (1024.0 * 1024.0));
+    }
+
+    ImagePrefetcher::~ImagePrefetcher() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv_free.notify_all();
+        _cv_ready.notify_all();
+        for (auto& worker : _workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        // Pinned buffers must outlive any copy still queued on the side stream
+        if (_copy_stream) {
+            _copy_stream->synchronize();
+        }
+    }
+
+    size_t ImagePrefetcher::next_camera_index() {
+        if (_options.sampler) {
+            return _options.sampler->draw(_sample++);
+        }
+
+        // A fresh permutation every epoch, drawn from a generator of its own so the
+        // order depends only on (seed, sample index) and can be resumed mid-epoch
+        const size_t n = _cameras.size();
+        const size_t epoch = _sample / n;
+        if (epoch != _permutation_epoch) {
+            auto generator = at::make_generator<at::CPUGeneratorImpl>(_options.seed + epoch);
+            auto perm = torch::randperm(static_cast<int64_t>(n), generator, torch::kInt64);
+            _permutation.assign(perm.data_ptr<int64_t>(), perm.data_ptr<int64_t>() + perm.numel());
+            _permutation_epoch = epoch;
+        }
+        return static_cast<size_t>(_permutation[_sample++ % n]);
+    }
+
+    void ImagePrefetcher::worker_loop() {
+        // Growing a pinned buffer allocates in the context of the current device
+        bind_training_device();
+        while (true) {
+            Slot* slot = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv_free.wait(lock, [this] {
+                    return _stop || _slots[_fill_seq % _slots.size()]->state == SlotState::Free;
+                });
+                if (_stop) {
+                    return;
+                }
+                slot = _slots[_fill_seq % _slots.size()].get();
+                ++_fill_seq;
+                slot->state = SlotState::Filling;
+                slot->level = resolution_level(_options.resolution_steps,
+                                               static_cast<size_t>(_options.first_iteration) +
+                                                   (_sample - _options.first_sample) / static_cast<size_t>(_options.views_per_step));
+                slot->view = next_camera_index();
+                slot->camera = _cameras[slot->view].get();
+                slot->error = nullptr;
+            }
+
+            try {
+                fill_slot(*slot);
+            } catch (...) {
+                slot->error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                slot->state = SlotState::Ready;
+            }
+            _cv_ready.notify_all();
+        }
+    }
+
+    void ImagePrefetcher::fill_slot(Slot& slot) {
+        const Camera& cam = *slot.camera;
+
+        // Copies the image into the slot, box-filtering it down by 2^level on the way
+        auto write = [&slot, pinned = _device.is_cuda()](const unsigned char* data, int w, int h, int c, int level) {
+            const auto [dst_w, dst_h] = level == 0 ? std::pair{w, h}
+                                                   : image_io::downscaled_size(w, h, static_cast<float>(1 << level));
+            const size_t num_bytes = static_cast<size_t>(dst_w) * dst_h * c;
+            if (static_cast<size_t>(slot.buffer.numel()) < num_bytes) {
+                slot.buffer = torch::empty({static_cast<int64_t>(num_bytes)},
+                                           torch::TensorOptions().dtype(torch::kUInt8).pinned_memory(pinned));
+            }
+            if (level == 0) {
+                std::memcpy(slot.buffer.data_ptr<uint8_t>(), data, num_bytes);
+            } else {
+                image_io::downscale(data, w, h, c, slot.buffer.data_ptr<uint8_t>(), dst_w, dst_h);
+            }
+            slot.width = dst_w;
+            slot.height = dst_h;
+            slot.channels = c;
+        };
+
+        if (const auto& cache = _dataset->get_image_cache()) {
+            // Levels the cache holds come from its pyramid, coarser ones are filtered here
+            const int cached_level = std::min(slot.level, cache->levels() - 1);
+            auto lease = cache->acquire(cam.uid(), cam.image_path(), _resize_factor, cached_level);
+            write(lease.data(), lease.width(), lease.height(), lease.channels(), slot.level - cached_level);
+            return;
+        }
+        if (const auto& disk_cache = _dataset->get_disk_cache()) {
+            if (auto mapped = disk_cache->load(cam.image_path(), _resize_factor)) {
+                write(mapped->data(), mapped->width(), mapped->height(), mapped->channels(), slot.level);
+                return;
+            }
+        }
+        auto [data, w, h, c] = load_image(cam.image_path(), _resize_factor);
+        try {
+            write(data, w, h, c, slot.level);
+        } catch (...) {
+            free_image(data);
+            throw;
+        }
+        free_image(data);
+    }
+
+    ImagePrefetcher::Sample ImagePrefetcher::next() {
+        // The buffer handed out last time is free once its upload has landed. Only next() touches an
+        // in-flight slot, so the wait happens outside the lock and the workers keep decoding.
+        if (_in_flight) {
+            Slot& prev = *_slots[*_in_flight];
+            prev.copy_done.synchronize();
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                prev.state = SlotState::Free;
+            }
+            _in_flight.reset();
+            _cv_free.notify_all();
+        }
+
+        Slot* slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            size_t depth = 0;
+            for (size_t i = 0; i < _slots.size(); ++i) {
+                if (_slots[(_consume_seq + i) % _slots.size()]->state != SlotState::Ready) {
+                    break;
+                }
+                ++depth;
+            }
+            _depth_sum += depth;
+            _stats.min_depth = std::min(_stats.min_depth, depth);
+
+            slot = _slots[_consume_seq % _slots.size()].get();
+            if (slot->state != SlotState::Ready) {
+                const auto start = std::chrono::steady_clock::now();
+                _cv_ready.wait(lock, [this, slot] { return _stop || slot->state == SlotState::Ready; });
+                const double waited = std::chrono::duration<double, std::milli>(
+                                          std::chrono::steady_clock::now() - start)
+                                          .count();
+                ++_stats.stalls;
+                _stats.stall_ms += waited;
+                _stats.max_stall_ms = std::max(_stats.max_stall_ms, waited);
+            }
+
+            if (slot->error) {
+                auto error = slot->error;
+                slot->error = nullptr;
+                slot->state = SlotState::Free;
+                ++_consume_seq;
+                _cv_free.notify_all();
+                std::rethrow_exception(error);
+            }
+
+            slot->state = SlotState::InFlight;
+            _in_flight = _consume_seq % _slots.size();
+            ++_consume_seq;
+            ++_stats.samples;
+            _stats.mean_depth = static_cast<double>(_depth_sum) / static_cast<double>(_stats.samples);
+        }
+
+        const int w = slot->width;
+        const int h = slot->height;
+        const int c = slot->channels;
+        slot->camera->set_image_size(w, h);
+
+        if (!_device.is_cuda()) {
+            // Copy out of the slot, so it can be recycled right away
+            auto image = slot->buffer.narrow(0, 0, static_cast<int64_t>(w) * h * c)
+                             .view({h, w, c})
+                             .clone();
+            return {slot->camera, std::move(image), slot->view};
+        }
+
+        if (!_copy_stream) {
+            _copy_stream = at::cuda::getStreamFromPool(false, _device.index());
+        }
+        auto compute_stream = at::cuda::getCurrentCUDAStream();
+        torch::Tensor image;
+        {
+            at::cuda::CUDAStreamGuard guard(*_copy_stream);
+            image = slot->buffer.narrow(0, 0, static_cast<int64_t>(w) * h * c)
+                        .view({h, w, c})
+                        .to(_device, /*non_blocking=*/true);
+            slot->copy_done.record(*_copy_stream);
+        }
+
+        // Order the training step after the upload without blocking the host
+        slot->copy_done.block(compute_stream);
+        image.record_stream(compute_stream);
+
+        return {slot->camera, std::move(image), slot->view};
+    }
+
+    size_t ImagePrefetcher::queue_depth() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t depth = 0;
+        for (size_t i = 0; i < _slots.size(); ++i) {
+            if (_slots[(_consume_seq + i) % _slots.size()]->state != SlotState::Ready) {
+                break;
+            }
+            ++depth;
+        }
+        return depth;
+    }
+
+    ImagePrefetcher::Stats ImagePrefetcher::stats() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _stats;
+    }
+
+} // namespace gs::training
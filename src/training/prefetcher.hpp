@@ -0,0 +1,126 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include "core/device.hpp"
+#include "dataset.hpp"
+#include "view_sampler.hpp"
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAStream.h>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::training {
+
+    // Infinite, shuffled (or loss-weighted) stream of training samples decoded ahead of time.
+    // A pool of workers follows the sampler order and decodes into a bounded
+    // ring of pinned host buffers that are recycled; next() uploads the head
+    // of the ring on a side stream without blocking the host. Samples before
+    // the last resolution step are served downscaled from the image pyramid.
+    class ImagePrefetcher {
+    public:
+        struct Options {
+            size_t ring_size = 8;    // Number of pinned buffers, i.e. maximal look-ahead
+            int num_workers = 4;     // Decode threads
+            uint64_t seed = 0;       // Sampler seed; epoch e is shuffled with seed + e
+            size_t first_sample = 0; // Position in the sample stream to start from (resume)
+            int first_iteration = 1; // Training step that first_sample belongs to (resume)
+            // Coarse-to-fine schedule (OptimizationParameters::resolution_steps): sample s belongs to
+            // step first_iteration + (s - first_sample) / views_per_step and is served at that step's
+            // pyramid level
+            std::vector<size_t> resolution_steps;
+            int views_per_step = 1;
+            // Draws the views instead of the shuffled epochs when set
+            std::shared_ptr<LossWeightedSampler> sampler;
+        };
+
+        struct Sample {
+            Camera* camera = nullptr;
+            torch::Tensor image; // [H, W, C] uint8 on the training device, normalized by the loss
+            size_t view = 0;     // Index of the camera in the dataset split
+        };
+
+        struct Stats {
+            size_t samples = 0;       // Samples handed out
+            size_t stalls = 0;        // Samples that were not decoded when requested
+            double stall_ms = 0.0;    // Total time next() waited for a decode
+            double max_stall_ms = 0.0;
+            double mean_depth = 0.0;  // Average number of decoded samples ready at next()
+            size_t min_depth = 0;     // Lowest number of decoded samples ready at next()
+        };
+
+        ImagePrefetcher(std::shared_ptr<CameraDataset> dataset, Options options);
+        ~ImagePrefetcher();
+
+        ImagePrefetcher(const ImagePrefetcher&) = delete;
+        ImagePrefetcher& operator=(const ImagePrefetcher&) = delete;
+
+        // Returns the next sample in sampler order, waiting for it if necessary
+        Sample next();
+
+        // Number of decoded samples currently waiting in the ring
+        size_t queue_depth() const;
+
+        Stats stats() const;
+
+    private:
+        enum class SlotState {
+            Free,
+            Filling,
+            Ready,
+            InFlight // Handed out, H2D copy may still be running
+        };
+
+        struct Slot {
+            SlotState state = SlotState::Free;
+            Camera* camera = nullptr;
+            size_t view = 0;
+            torch::Tensor buffer; // pinned uint8, grows if an image does not fit
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            int level = 0; // Pyramid level the sample is served at
+            std::exception_ptr error;
+            at::cuda::CUDAEvent copy_done;
+        };
+
+        void worker_loop();
+        void fill_slot(Slot& slot);
+        size_t next_camera_index();
+
+        std::shared_ptr<CameraDataset> _dataset;
+        std::vector<std::shared_ptr<Camera>> _cameras;
+        Options _options;
+        int _resize_factor;
+
+        std::vector<std::unique_ptr<Slot>> _slots;
+        size_t _fill_seq = 0;    // Next sequence number handed to a worker
+        size_t _consume_seq = 0; // Next sequence number returned by next()
+        std::vector<int64_t> _permutation;
+        size_t _permutation_epoch = std::numeric_limits<size_t>::max();
+        size_t _sample = 0; // Next position in the sample stream
+        std::optional<size_t> _in_flight;
+
+        std::vector<std::thread> _workers;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv_free;
+        std::condition_variable _cv_ready;
+        bool _stop = false;
+
+        torch::Device _device = training_device();
+        std::optional<at::cuda::CUDAStream> _copy_stream; // Created on the first upload to a CUDA device
+
+        Stats _stats;
+        size_t _depth_sum = 0;
+    };
+
+} // namespace gs::training
@@ -33,8 +33,9 @@ namespace gs::training {
         constexpr float far_plane = 1e10f;
 
         fast_gs::rasterization::FastGSSettings settings;
-        auto w2c = viewpoint_camera.world_view_transform();
-        settings.cam_position = viewpoint_camera.cam_position();
+        // The camera lives on the GPU; the rasterizer runs on the device of the model
+        auto w2c = viewpoint_camera.world_view_transform().to(means.device());
+        settings.cam_position = viewpoint_camera.cam_position().to(means.device());
         settings.active_sh_bases = active_sh_bases;
         settings.width = width;
         settings.height = height;
@@ -59,6 +60,7 @@ namespace gs::training {
         RenderOutput output;
         output.image = raster_outputs[0];
         output.alpha = raster_outputs[1];
+        output.visible_indices = raster_outputs[2];
 
         // output.image = image + (1.0f - alpha) * bg_color.unsqueeze(-1).unsqueeze(-1);
 
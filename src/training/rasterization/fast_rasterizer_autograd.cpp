@@ -50,8 +50,15 @@ namespace gs::training {
         int primitive_primitive_indices_selector = std::get<9>(outputs);
         int instance_primitive_indices_selector = std::get<10>(outputs);
 
+        auto visible_indices = fast_gs::rasterization::visible_primitive_indices(
+            per_primitive_buffers,
+            static_cast<int>(means.size(0)),
+            n_visible_primitives,
+            primitive_primitive_indices_selector);
+
         // Mark non-differentiable tensors
-        ctx->mark_non_differentiable({per_primitive_buffers,
+        ctx->mark_non_differentiable({visible_indices,
+                                      per_primitive_buffers,
                                       per_tile_buffers,
                                       per_instance_buffers,
                                       per_bucket_buffers,
@@ -87,7 +94,7 @@ namespace gs::training {
         ctx->saved_data["primitive_primitive_indices_selector"] = primitive_primitive_indices_selector;
         ctx->saved_data["instance_primitive_indices_selector"] = instance_primitive_indices_selector;
 
-        return {image, alpha};
+        return {image, alpha, visible_indices};
     }
 
     torch::autograd::tensor_list FastGSRasterize::backward(
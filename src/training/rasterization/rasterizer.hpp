@@ -11,13 +11,14 @@
 
 namespace gs::training {
     struct RenderOutput {
-        torch::Tensor image;      // [..., channels, H, W]
-        torch::Tensor alpha;      // [..., C, H, W, 1]
-        torch::Tensor depth;      // [..., C, H, W, 1] - accumulated or expected depth
-        torch::Tensor means2d;    // [..., C, N, 2]
-        torch::Tensor depths;     // [..., N] - per-gaussian depths
-        torch::Tensor radii;      // [..., N]
-        torch::Tensor visibility; // [..., N]
+        torch::Tensor image;           // [..., channels, H, W]
+        torch::Tensor alpha;           // [..., C, H, W, 1]
+        torch::Tensor depth;           // [..., C, H, W, 1] - accumulated or expected depth
+        torch::Tensor means2d;         // [..., C, N, 2]
+        torch::Tensor depths;          // [..., N] - per-gaussian depths
+        torch::Tensor radii;           // [..., N]
+        torch::Tensor visibility;      // [..., N]
+        torch::Tensor visible_indices; // [n_visible] int64 - Gaussians surviving culling (fastgs only)
         int width;
         int height;
     };
@@ -4,6 +4,8 @@
 
 #include "default_strategy.hpp"
 #include "Ops.h"
+#include "checkpoint.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
 #include "optimizers/fused_adam.hpp"
@@ -19,13 +21,41 @@ namespace gs::training {
     void DefaultStrategy::initialize(const gs::param::OptimizationParameters& optimParams) {
         _params = std::make_unique<const gs::param::OptimizationParameters>(optimParams);
 
-        initialize_gaussians(_splat_data);
+        initialize_gaussians(_splat_data, *_params);
 
         // Initialize optimizer
         _optimizer = create_optimizer(_splat_data, *_params);
 
         // Initialize exponential scheduler
         _scheduler = create_scheduler(*_params, _optimizer.get(), 0);
+
+        reserve_storage(_splat_data, *_optimizer, _moments, _splat_data.size());
+    }
+
+    void DefaultStrategy::save_state(torch::serialize::OutputArchive& archive) const {
+        torch::serialize::OutputArchive model_archive(archive.compilation_unit());
+        _splat_data.save_state(model_archive);
+        archive.write("model", model_archive);
+
+        torch::serialize::OutputArchive optimizer_archive(archive.compilation_unit());
+        checkpoint::write_optimizer(optimizer_archive, *_optimizer);
+        archive.write("optimizer", optimizer_archive);
+    }
+
+    void DefaultStrategy::load_state(torch::serialize::InputArchive& archive) {
+        torch::serialize::InputArchive model_archive;
+        archive.read("model", model_archive);
+        _splat_data.load_state(model_archive);
+
+        // The parameter tensors were replaced, so the optimizer is rebuilt around them.
+        // Restored learning rates already include the scheduler decay.
+        _optimizer = create_optimizer(_splat_data, *_params);
+        _scheduler = create_scheduler(*_params, _optimizer.get(), 0);
+
+        torch::serialize::InputArchive optimizer_archive;
+        archive.read("optimizer", optimizer_archive);
+        checkpoint::read_optimizer(optimizer_archive, *_optimizer);
+        reserve_storage(_splat_data, *_optimizer, _moments, _splat_data.size());
     }
 
     bool DefaultStrategy::is_refining(int iter) const {
@@ -37,215 +67,186 @@ namespace gs::training {
     void DefaultStrategy::remove_gaussians(const torch::Tensor& mask) {
         torch::NoGradGuard no_grad;
 
-        if (mask.sum().item<int>() == 0) {
+        const int64_t num_removed = mask.sum().item<int64_t>();
+        if (num_removed == 0) {
             LOG_DEBUG("No Gaussians to remove");
             return;
         }
 
-        LOG_DEBUG("Removing {} Gaussians", mask.sum().item<int>());
+        LOG_DEBUG("Removing {} Gaussians", num_removed);
         remove(mask);
     }
 
-    void DefaultStrategy::duplicate(const torch::Tensor& is_duplicated) {
-        torch::NoGradGuard no_grad;
+    void DefaultStrategy::compact(const torch::Tensor& src, int64_t first_fresh, const RowFixup& fixup) {
+        const int64_t n = _splat_data.size();
+        const int64_t rows = src.size(0);
 
-        const torch::Tensor sampled_idxs = is_duplicated.nonzero().squeeze(-1);
+        // Moments are gathered row by row, so the lazily decayed ones are settled first
+        static_cast<FusedAdam*>(_optimizer.get())->catch_up();
 
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            const torch::Tensor new_param = param.index_select(0, sampled_idxs);
-            return torch::cat({param, new_param}).set_requires_grad(param.requires_grad());
-        };
+        if (!_splat_data.has_reserved_capacity()) {
+            reserve_storage(_splat_data, *_optimizer, _moments, n);
+        }
+        if (rows > _splat_data.capacity()) {
+            const int64_t capacity = std::max(rows, 2 * _splat_data.capacity());
+            reserve_storage(_splat_data, *_optimizer, _moments, capacity);
+            LOG_DEBUG("Gaussian capacity grown to {}", capacity);
+        }
 
-        const auto optimizer_fn = [&sampled_idxs](torch::optim::OptimizerParamState& state,
-                                                  const torch::Tensor& full_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            auto new_shape = full_param.sizes().vec();
-            new_shape[0] = sampled_idxs.size(0);
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto zeros_to_add = torch::zeros(new_shape, fused_adam_state->exp_avg.options());
-                auto new_exp_avg = torch::cat({fused_adam_state->exp_avg, zeros_to_add}, 0);
-                auto new_exp_avg_sq = torch::cat({fused_adam_state->exp_avg_sq, zeros_to_add}, 0);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = torch::cat({fused_adam_state->max_exp_avg_sq, zeros_to_add}, 0);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
-            }
-            return nullptr;
+        // Everything is gathered before it is written back, because the destination rows overlap
+        // the source. When every input row is kept in order, the kept rows are already in place.
+        const bool keeps_all = first_fresh == n;
+        const torch::Tensor kept_src = src.narrow(0, 0, first_fresh);
+        const torch::Tensor fresh_src = src.narrow(0, first_fresh, rows - first_fresh);
+        const auto state_of = [this](size_t i) {
+            const auto& param = _optimizer->param_groups()[i].params()[0];
+            return static_cast<FusedAdam::AdamParamState*>(_optimizer->state().find(param.unsafeGetTensorImpl())->second.get());
         };
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
-    }
-
-    void DefaultStrategy::split(const torch::Tensor& is_split) {
-        torch::NoGradGuard no_grad;
-
-        const c10::Device device = is_split.device();
-        const torch::Tensor sampled_idxs = is_split.nonzero().squeeze(-1);
-        const torch::Tensor rest_idxs = is_split.logical_not().nonzero().squeeze(-1);
-
-        const torch::Tensor sampled_scales = _splat_data.get_scaling().index_select(0, sampled_idxs);
-        const torch::Tensor sampled_quats = _splat_data.get_rotation().index_select(0, sampled_idxs);
-        const torch::Tensor rotmats = gsplat::quats_to_rotmats(sampled_quats); // [N, 3, 3]
-
-        const auto num_split_gaussians = sampled_idxs.size(0);
-        constexpr auto split_size = 2;
-        const torch::Tensor samples = torch::einsum( // [split_size, N, 3]
-            "nij,nj,bnj->bni",
-            {rotmats,
-             sampled_scales,
-             torch::randn({split_size, num_split_gaussians, 3}, sampled_quats.options().device(device))});
-
-        const auto param_fn = [this, &sampled_idxs, &rest_idxs, &samples, &sampled_scales](
-                                  const int i, const torch::Tensor& param) {
-            std::vector<int64_t> repeats(param.dim(), 1);
-            repeats[0] = split_size;
-
-            const torch::Tensor sampled_param = param.index_select(0, sampled_idxs);
-            torch::Tensor split_param;
-            if (i == 0) {
-                // means
-                split_param = (sampled_param.unsqueeze(0) + samples).reshape({-1, 3}); // [split_size * N, 3]
-            } else if (i == 3) {
-                // scaling
-                split_param = torch::log(sampled_scales / 1.6).repeat({split_size, 1}); // [split_size * N, 3]
-            } else if (i == 5 && _params->revised_opacity) {
-                // opacity
-                const torch::Tensor new_opacities = 1.0 - torch::sqrt(1.0 - torch::sigmoid(sampled_param));
-                split_param = torch::logit(new_opacities).repeat(repeats); // [split_size * N]
-            } else {
-                split_param = sampled_param.repeat(repeats);
+        const auto params = raw_params(_splat_data);
+        std::array<torch::Tensor, 6> kept_params, fresh_params, kept_exp_avg, kept_exp_avg_sq;
+        for (size_t i = 0; i < params.size(); ++i) {
+            fresh_params[i] = params[i]->index_select(0, fresh_src);
+            if (!keeps_all) {
+                kept_params[i] = params[i]->index_select(0, kept_src);
+                kept_exp_avg[i] = state_of(i)->exp_avg.index_select(0, kept_src);
+                kept_exp_avg_sq[i] = state_of(i)->exp_avg_sq.index_select(0, kept_src);
             }
+        }
 
-            const torch::Tensor rest_param = param.index_select(0, rest_idxs);
-            return torch::cat({rest_param, split_param}, 0).set_requires_grad(param.requires_grad());
-        };
-
-        const auto optimizer_fn = [&sampled_idxs, &rest_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& full_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            auto zero_shape = full_param.sizes().vec();
-            zero_shape[0] = sampled_idxs.size(0) * split_size;
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto rest_exp_avg = fused_adam_state->exp_avg.index_select(0, rest_idxs);
-                auto rest_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, rest_idxs);
-
-                auto zeros_to_add = torch::zeros(zero_shape, fused_adam_state->exp_avg.options());
-                auto new_exp_avg = torch::cat({rest_exp_avg, zeros_to_add}, 0);
-                auto new_exp_avg_sq = torch::cat({rest_exp_avg_sq, zeros_to_add}, 0);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto rest_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, rest_idxs);
-                    auto new_max_exp_avg_sq = torch::cat({rest_max_exp_avg_sq, zeros_to_add}, 0);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
+        resize_storage(_splat_data, *_optimizer, _moments, rows, first_fresh);
+        for (size_t i = 0; i < params.size(); ++i) {
+            auto& param = *params[i];
+            if (!keeps_all) {
+                param.narrow(0, 0, first_fresh).copy_(kept_params[i]);
+                state_of(i)->exp_avg.narrow(0, 0, first_fresh).copy_(kept_exp_avg[i]);
+                state_of(i)->exp_avg_sq.narrow(0, 0, first_fresh).copy_(kept_exp_avg_sq[i]);
             }
-            return nullptr;
-        };
+            param.narrow(0, first_fresh, rows - first_fresh).copy_(fresh_params[i]);
+            if (fixup) {
+                fixup(static_cast<int>(i), param);
+            }
+        }
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+        if (4 * rows < _splat_data.capacity()) {
+            const int64_t capacity = 2 * rows;
+            reserve_storage(_splat_data, *_optimizer, _moments, capacity);
+            LOG_DEBUG("Gaussian capacity shrunk to {}", capacity);
+        }
     }
 
-    void DefaultStrategy::grow_gs(int iter) {
+    void DefaultStrategy::grow_and_prune(int iter) {
         torch::NoGradGuard no_grad;
 
+        const int64_t n = _splat_data.size();
+        if (n == 0) {
+            return;
+        }
         const torch::Tensor grads = _splat_data._densification_info[1] / torch::clamp_min(
                                                                              _splat_data._densification_info[0], 1.0f);
         const c10::Device device = grads.device();
+        const float scene_scale = _splat_data.get_scene_scale();
 
+        // Growth: small Gaussians with high gradients are duplicated, large ones split in two
         const torch::Tensor is_grad_high = grads > _params->grad_threshold;
-        const auto max_values = std::get<0>(torch::max(_splat_data.get_scaling(), -1));
-        const torch::Tensor is_small = max_values <= _params->grow_scale3d * _splat_data.get_scene_scale();
+        const torch::Tensor max_scale = std::get<0>(torch::max(_splat_data.get_scaling(), -1));
+        const torch::Tensor is_small = max_scale <= _params->grow_scale3d * scene_scale;
         const torch::Tensor is_duplicated = is_grad_high & is_small;
-        const auto num_duplicates = is_duplicated.sum().item<int64_t>();
-
-        const torch::Tensor is_large = ~is_small;
-        torch::Tensor is_split = is_grad_high & is_large;
-        const auto num_split = is_split.sum().item<int64_t>();
-
-        // First duplicate
-        if (num_duplicates > 0) {
-            duplicate(is_duplicated);
+        const torch::Tensor is_split = is_grad_high & ~is_small;
+
+        // Pruning is decided up front for every output row. A duplicate shares its
+        // original's values; split children share its rotation, have their scale
+        // divided by 1.6 and (optionally) the revised opacity.
+        const torch::Tensor opacity = _splat_data.get_opacity();
+        const torch::Tensor child_opacity = _params->revised_opacity ? 1.0f - torch::sqrt(1.0f - opacity) : opacity;
+        const auto& rotation_raw = _splat_data.rotation_raw();
+        const torch::Tensor is_degenerate = (rotation_raw * rotation_raw).sum(-1) < 1e-8f;
+
+        torch::Tensor prune_original = (opacity < _params->prune_opacity) | is_degenerate;
+        torch::Tensor prune_child = (child_opacity < _params->prune_opacity) | is_degenerate;
+        if (iter > _params->reset_every) {
+            const float max_size = _params->prune_scale3d * scene_scale;
+            prune_original |= max_scale > max_size;
+            prune_child |= max_scale / 1.6f > max_size;
         }
 
-        // New Gaussians added by duplication will not be split
-        is_split = torch::cat({is_split,
-                               torch::zeros(num_duplicates, c10::TensorOptions().dtype(torch::kBool).device(device))});
-        if (num_split > 0) {
-            split(is_split);
+        const torch::Tensor keep_original = ~is_split & ~prune_original;
+        const torch::Tensor keep_duplicate = is_duplicated & ~prune_original;
+        const torch::Tensor keep_children = is_split & ~prune_child;
+
+        // The refinement's only host synchronization
+        const auto totals = torch::stack({keep_original.sum(),
+                                          keep_duplicate.sum(),
+                                          keep_children.sum(),
+                                          is_duplicated.sum(),
+                                          is_split.sum()})
+                                .cpu();
+        const auto* total = totals.data_ptr<int64_t>();
+        const int64_t num_original = total[0];
+        const int64_t num_duplicate = total[1];
+        const int64_t num_children = total[2];
+        const int64_t n_new = num_original + num_duplicate + 2 * num_children;
+        LOG_DEBUG("Refine at {}: {} duplicated, {} split, {} -> {} Gaussians",
+                  iter, total[3], total[4], n, n_new);
+
+        if (total[3] == 0 && total[4] == 0 && n_new == n) {
+            return; // Nothing grown and nothing pruned
         }
-    }
-
-    void DefaultStrategy::remove(const torch::Tensor& is_prune) {
-        torch::NoGradGuard no_grad;
 
-        const torch::Tensor sampled_idxs = is_prune.logical_not().nonzero().squeeze(-1);
-
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            return param.index_select(0, sampled_idxs).set_requires_grad(param.requires_grad());
+        // Same layout as duplicating, splitting and pruning one after another:
+        // [kept originals | duplicates | first split children | second split children].
+        // Each segment scatters its source indices by a running count; rows outside
+        // the segment land in a spill slot past the end.
+        const int64_t children_begin = num_original + num_duplicate;
+        const torch::Tensor input_rows = torch::arange(n, torch::TensorOptions().dtype(torch::kInt64).device(device));
+        torch::Tensor src = torch::empty({n_new + 1}, input_rows.options());
+        const auto place = [&](const torch::Tensor& mask, int64_t offset) {
+            const torch::Tensor dst = torch::where(mask, mask.cumsum(0) - 1 + offset, n_new);
+            src.scatter_(0, dst, input_rows);
         };
+        place(keep_original, 0);
+        place(keep_duplicate, num_original);
+        place(keep_children, children_begin);
+        place(keep_children, children_begin + num_children);
+        src = src.narrow(0, 0, n_new);
+
+        // Child offsets along the rotated axes
+        torch::Tensor child_offsets;
+        if (num_children > 0) {
+            const torch::Tensor child_src = src.narrow(0, children_begin, 2 * num_children);
+            const torch::Tensor child_scales = _splat_data.get_scaling().index_select(0, child_src);
+            const torch::Tensor child_quats = _splat_data.get_rotation().index_select(0, child_src);
+            child_offsets = torch::einsum(
+                "nij,nj->ni",
+                {gsplat::quats_to_rotmats(child_quats),
+                 child_scales * torch::randn({2 * num_children, 3}, child_scales.options())});
+        }
 
-        const auto optimizer_fn = [&sampled_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = fused_adam_state->exp_avg.index_select(0, sampled_idxs);
-                auto new_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, sampled_idxs);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, sampled_idxs);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
+        const auto fixup = [&](const int i, torch::Tensor& param) {
+            if (num_children == 0) {
+                return;
+            }
+            torch::Tensor children = param.narrow(0, children_begin, 2 * num_children);
+            if (i == 0) {
+                // means
+                children.add_(child_offsets);
+            } else if (i == 3) {
+                // scaling
+                children.sub_(std::log(1.6f));
+            } else if (i == 5 && _params->revised_opacity) {
+                // opacity
+                children.copy_(torch::logit(1.0f - torch::sqrt(1.0f - torch::sigmoid(children))));
             }
-            return nullptr;
         };
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+        // Duplicates and split children start with zero moments
+        compact(src, num_original, fixup);
     }
 
-    void DefaultStrategy::prune_gs(int iter) {
+    void DefaultStrategy::remove(const torch::Tensor& is_prune) {
         torch::NoGradGuard no_grad;
-
-        // Check for low opacity
-        torch::Tensor is_prune = _splat_data.get_opacity() < _params->prune_opacity;
-
-        auto rotation_raw = _splat_data.rotation_raw();
-        is_prune |= (rotation_raw * rotation_raw).sum(-1) < 1e-8f;
-
-        // Check for too large Gaussians
-        if (iter > _params->reset_every) {
-            const auto max_values = std::get<0>(torch::max(_splat_data.get_scaling(), -1));
-            torch::Tensor is_too_big = max_values > _params->prune_scale3d * _splat_data.get_scene_scale();
-            is_prune |= is_too_big;
-        }
-
-        const auto num_prunes = is_prune.sum().item<int64_t>();
-        if (num_prunes > 0) {
-            remove(is_prune);
-        }
+        const torch::Tensor src = is_prune.logical_not().nonzero().squeeze(-1);
+        compact(src, src.size(0), nullptr);
     }
 
     void DefaultStrategy::reset_opacity() {
@@ -253,40 +254,21 @@ namespace gs::training {
 
         const auto threshold = 2.0f * _params->prune_opacity;
 
-        const auto param_fn = [&threshold](const int i, const torch::Tensor& param) {
-            if (i == 5) {
-                const torch::Tensor new_opacities = torch::clamp_max(
-                    param,
-                    torch::logit(torch::tensor(threshold)).item());
-                return new_opacities.set_requires_grad(param.requires_grad());
-            }
-            throw std::runtime_error("Invalid parameter index for reset_opacity: " + std::to_string(i));
-        };
-
-        const auto optimizer_fn = [](torch::optim::OptimizerParamState& state,
-                                     const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = torch::zeros_like(fused_adam_state->exp_avg);
-                auto new_exp_avg_sq = torch::zeros_like(fused_adam_state->exp_avg_sq);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = torch::zeros_like(fused_adam_state->max_exp_avg_sq);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
+        // In place, so the opacity keeps its reserved storage; its moments restart from zero
+        auto* fused_adam = static_cast<FusedAdam*>(_optimizer.get());
+        fused_adam->catch_up();
+        _splat_data.opacity_raw().clamp_max_(torch::logit(torch::tensor(threshold)).item());
+
+        const auto& opacity = _optimizer->param_groups()[5].params()[0];
+        const auto it = _optimizer->state().find(opacity.unsafeGetTensorImpl());
+        if (it != _optimizer->state().end()) {
+            auto* state = static_cast<FusedAdam::AdamParamState*>(it->second.get());
+            state->exp_avg.zero_();
+            state->exp_avg_sq.zero_();
+            if (state->max_exp_avg_sq.defined()) {
+                state->max_exp_avg_sq.zero_();
             }
-
-            return nullptr;
-        };
-
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data, {5});
+        }
     }
 
     void DefaultStrategy::post_backward(int iter, RenderOutput& render_output) {
@@ -306,8 +288,7 @@ namespace gs::training {
         }
 
         if (is_refining(iter)) {
-            grow_gs(iter);
-            prune_gs(iter);
+            grow_and_prune(iter);
 
             _splat_data._densification_info = torch::zeros({2, _splat_data.means().size(0)},
                                                            _splat_data.means().options())
@@ -320,15 +301,17 @@ namespace gs::training {
 
 #ifdef _WIN32
         // Windows doesn't support CUDACachingAllocator expandable_segments
-        if (iter % 10 == 0)
+        if (iter % 10 == 0 && gs::training_on_cuda())
             c10::cuda::CUDACachingAllocator::emptyCache();
 #endif
     }
 
-    void DefaultStrategy::step(int iter) {
+    void DefaultStrategy::step(int iter, const torch::Tensor& visible_rows) {
         if (iter < _params->iterations) {
             auto* fused_adam = dynamic_cast<FusedAdam*>(_optimizer.get());
-            fused_adam->step(iter);
+            // Parameters rebuilt by densification carry no gradient and are skipped, so the
+            // visible indices are never applied to reindexed rows
+            fused_adam->step(iter, visible_rows);
             fused_adam->zero_grad(true, iter);
             _scheduler->step();
         }
@@ -6,6 +6,9 @@
 
 #include "istrategy.hpp"
 #include "optimizers/scheduler.hpp"
+#include "strategy_utils.hpp"
+#include <array>
+#include <functional>
 #include <memory>
 #include <torch/torch.h>
 
@@ -33,7 +36,7 @@ namespace gs::training {
 
         void post_backward(int iter, RenderOutput& render_output) override;
 
-        void step(int iter) override;
+        void step(int iter, const torch::Tensor& visible_rows = {}) override;
 
         bool is_refining(int iter) const override;
 
@@ -42,18 +45,26 @@ namespace gs::training {
 
         void remove_gaussians(const torch::Tensor& mask) override;
 
+        void save_state(torch::serialize::OutputArchive& archive) const override;
+
+        void load_state(torch::serialize::InputArchive& archive) override;
+
     private:
-        // Helper functions
-        void duplicate(const torch::Tensor& is_duplicated);
+        // Modifies a freshly gathered parameter (index as in raw_params) in place
+        using RowFixup = std::function<void(int, torch::Tensor&)>;
 
-        void split(const torch::Tensor& is_split);
+        // Helper functions
+        // Rewrites all parameters and their Adam moments within the reserved rows: output row j
+        // copies input row src[j]; rows from first_fresh on start with zero moments. The rows
+        // before first_fresh must be increasing input rows. The capacity doubles when exceeded
+        // and halves once less than a quarter of it is in use.
+        void compact(const torch::Tensor& src, int64_t first_fresh, const RowFixup& fixup);
 
-        void grow_gs(int iter);
+        // Duplicate, split and prune in a single compaction with one host synchronization
+        void grow_and_prune(int iter);
 
         void remove(const torch::Tensor& is_prune);
 
-        void prune_gs(int iter);
-
         void reset_opacity();
 
         // Member variables
@@ -61,5 +72,8 @@ namespace gs::training {
         std::unique_ptr<ExponentialLR> _scheduler;
         gs::SplatData _splat_data;
         std::unique_ptr<const gs::param::OptimizationParameters> _params;
+
+        // Reserved optimizer moment buffers, one per parameter group
+        std::array<ReservedMoments, 6> _moments;
     };
 } // namespace gs::training
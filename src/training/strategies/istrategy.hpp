@@ -18,7 +18,9 @@ namespace gs::training {
 
         virtual void post_backward(int iter, RenderOutput& render_output) = 0;
 
-        virtual void step(int iter) = 0;
+        // visible_rows: optional unique int64 indices of the Gaussians seen by this step's views.
+        // When defined, the optimizer updates only those rows (sparse Adam).
+        virtual void step(int iter, const torch::Tensor& visible_rows = {}) = 0;
 
         virtual bool is_refining(int iter) const = 0;
 
@@ -29,5 +31,11 @@ namespace gs::training {
 
         // Remove Gaussians based on mask
         virtual void remove_gaussians(const torch::Tensor& mask) = 0;
+
+        // Checkpoint the model together with optimizer moments and learning rates.
+        // load_state is called after initialize() and replaces both.
+        virtual void save_state(torch::serialize::OutputArchive& archive) const = 0;
+
+        virtual void load_state(torch::serialize::InputArchive& archive) = 0;
     };
 } // namespace gs::training
@@ -4,18 +4,17 @@
 
 #include "mcmc.hpp"
 #include "Ops.h"
+#include "checkpoint.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include "core/parameters.hpp"
 #include "optimizers/fused_adam.hpp"
 #include "rasterization/rasterizer.hpp"
 #include "strategy_utils.hpp"
+#include <array>
 #include <iostream>
 #include <random>
 
-#ifdef _WIN32
-#include <c10/cuda/CUDACachingAllocator.h> //required for emptyCache
-#endif
-
 namespace gs::training {
     void MCMC::ExponentialLR::step() {
         if (param_group_index_ >= 0) {
@@ -204,6 +203,10 @@ namespace gs::training {
         if (n_new == 0)
             return 0;
 
+        if (!_splat_data.has_reserved_capacity()) {
+            reserve_storage();
+        }
+
         // Get opacities and handle both [N] and [N, 1] shapes
         auto opacities = _splat_data.get_opacity();
         if (opacities.dim() == 2 && opacities.size(1) == 1) {
@@ -218,7 +221,7 @@ namespace gs::training {
         auto sampled_scales = _splat_data.get_scaling().index_select(0, sampled_idxs);
 
         // Count occurrences
-        auto ratios = torch::zeros({opacities.size(0)}, torch::kFloat32).to(torch::kCUDA);
+        auto ratios = torch::zeros({opacities.size(0)}, opacities.options().dtype(torch::kFloat32));
         ratios.index_add_(0, sampled_idxs, torch::ones_like(sampled_idxs, torch::kFloat32));
         ratios = ratios.index_select(0, sampled_idxs) + 1;
 
@@ -241,7 +244,7 @@ namespace gs::training {
         // Clamp new opacities
         new_opacities = torch::clamp(new_opacities, _params->min_opacity, 1.0f - 1e-7f);
 
-        // Update existing Gaussians FIRST (before concatenation)
+        // Update the sampled Gaussians before they are copied
         if (_splat_data.opacity_raw().dim() == 2) {
             _splat_data.opacity_raw().index_put_({sampled_idxs, torch::indexing::Slice()},
                                                  torch::logit(new_opacities).unsqueeze(-1));
@@ -250,99 +253,13 @@ namespace gs::training {
         }
         _splat_data.scaling_raw().index_put_({sampled_idxs}, torch::log(new_scales));
 
-        // Prepare new Gaussians to concatenate
-        auto new_means = _splat_data.means().index_select(0, sampled_idxs);
-        auto new_sh0 = _splat_data.sh0().index_select(0, sampled_idxs);
-        auto new_shN = _splat_data.shN().index_select(0, sampled_idxs);
-        auto new_scaling = _splat_data.scaling_raw().index_select(0, sampled_idxs);
-        auto new_rotation = _splat_data.rotation_raw().index_select(0, sampled_idxs);
-        auto new_opacity = _splat_data.opacity_raw().index_select(0, sampled_idxs);
-
-        // Step 1: Concatenate all parameters
-        auto concat_means = torch::cat({_splat_data.means(), new_means}, 0).set_requires_grad(true);
-        auto concat_sh0 = torch::cat({_splat_data.sh0(), new_sh0}, 0).set_requires_grad(true);
-        auto concat_shN = torch::cat({_splat_data.shN(), new_shN}, 0).set_requires_grad(true);
-        auto concat_scaling = torch::cat({_splat_data.scaling_raw(), new_scaling}, 0).set_requires_grad(true);
-        auto concat_rotation = torch::cat({_splat_data.rotation_raw(), new_rotation}, 0).set_requires_grad(true);
-        auto concat_opacity = torch::cat({_splat_data.opacity_raw(), new_opacity}, 0).set_requires_grad(true);
-
-        // Step 2: SAFER optimizer state update
-        // Store the new parameters in a temporary array first
-        std::array new_params = {
-            &concat_means, &concat_sh0, &concat_shN,
-            &concat_scaling, &concat_rotation, &concat_opacity};
-
-        // Collect old parameter keys and states
-        std::vector<void*> old_param_keys;
-        std::vector<std::unique_ptr<torch::optim::OptimizerParamState>> saved_states;
-
-        for (int i = 0; i < 6; ++i) {
-            auto& old_param = _optimizer->param_groups()[i].params()[0];
-            void* old_param_key = old_param.unsafeGetTensorImpl();
-            old_param_keys.push_back(old_param_key);
-
-            // Check if state exists
-            auto state_it = _optimizer->state().find(old_param_key);
-            if (state_it == _optimizer->state().end()) {
-                saved_states.push_back(nullptr);
-            }
-
-            auto* fused_adam_state = static_cast<FusedAdam::AdamParamState*>(state_it->second.get());
-            // FusedAdam state
-            torch::IntArrayRef new_shape;
-            if (i == 0)
-                new_shape = new_means.sizes();
-            else if (i == 1)
-                new_shape = new_sh0.sizes();
-            else if (i == 2)
-                new_shape = new_shN.sizes();
-            else if (i == 3)
-                new_shape = new_scaling.sizes();
-            else if (i == 4)
-                new_shape = new_rotation.sizes();
-            else
-                new_shape = new_opacity.sizes();
-
-            auto zeros_to_add = torch::zeros(new_shape, fused_adam_state->exp_avg.options());
-            auto new_exp_avg = torch::cat({fused_adam_state->exp_avg, zeros_to_add}, 0);
-            auto new_exp_avg_sq = torch::cat({fused_adam_state->exp_avg_sq, zeros_to_add}, 0);
-
-            // Create new state
-            auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-            new_state->step_count = fused_adam_state->step_count;
-            new_state->exp_avg = new_exp_avg;
-            new_state->exp_avg_sq = new_exp_avg_sq;
-            if (fused_adam_state->max_exp_avg_sq.defined()) {
-                auto new_max_exp_avg_sq = torch::cat({fused_adam_state->max_exp_avg_sq, zeros_to_add}, 0);
-                new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-            }
-
-            saved_states.push_back(std::move(new_state));
+        // The new Gaussians go into the reserved rows right after the active ones, with zeroed moments
+        resize_storage(current_n + n_new, current_n);
+        for (auto* param : raw_params(_splat_data)) {
+            auto appended = param->narrow(0, current_n, n_new);
+            torch::index_select_out(appended, param->narrow(0, 0, current_n), 0, sampled_idxs);
         }
 
-        // Now remove all old states
-        for (auto key : old_param_keys) {
-            _optimizer->state().erase(key);
-        }
-
-        // Update parameters and add new states
-        for (int i = 0; i < 6; ++i) {
-            _optimizer->param_groups()[i].params()[0] = *new_params[i];
-
-            if (saved_states[i]) {
-                void* new_param_key = new_params[i]->unsafeGetTensorImpl();
-                _optimizer->state()[new_param_key] = std::move(saved_states[i]);
-            }
-        }
-
-        // Step 3: Finally update the model's parameters
-        _splat_data.means() = concat_means;
-        _splat_data.sh0() = concat_sh0;
-        _splat_data.shN() = concat_shN;
-        _splat_data.scaling_raw() = concat_scaling;
-        _splat_data.rotation_raw() = concat_rotation;
-        _splat_data.opacity_raw() = concat_opacity;
-
         return n_new;
     }
 
@@ -375,6 +292,9 @@ namespace gs::training {
 
         // Refine Gaussians
         if (is_refining(iter)) {
+            // Settle lazily decayed moments before rows are reset and appended
+            static_cast<FusedAdam*>(_optimizer.get())->catch_up();
+
             // Relocate dead Gaussians
             relocate_gs();
 
@@ -384,18 +304,12 @@ namespace gs::training {
 
         // Inject noise to positions
         inject_noise();
-
-#ifdef _WIN32
-        // Windows doesn't support CUDACachingAllocator expandable_segments
-        if (iter % 10 == 0)
-            c10::cuda::CUDACachingAllocator::emptyCache();
-#endif
     }
 
-    void MCMC::step(int iter) {
+    void MCMC::step(int iter, const torch::Tensor& visible_rows) {
         if (iter < _params->iterations) {
             auto* fused_adam = dynamic_cast<FusedAdam*>(_optimizer.get());
-            fused_adam->step(iter);
+            fused_adam->step(iter, visible_rows);
             fused_adam->zero_grad(true, iter);
             _scheduler->step();
         }
@@ -404,55 +318,53 @@ namespace gs::training {
     void MCMC::remove_gaussians(const torch::Tensor& mask) {
         torch::NoGradGuard no_grad;
 
-        if (mask.sum().item<int>() == 0) {
+        const int64_t num_removed = mask.sum().item<int64_t>();
+        if (num_removed == 0) {
             LOG_DEBUG("No Gaussians to remove");
             return;
         }
 
-        LOG_DEBUG("MCMC: Removing {} Gaussians", mask.sum().item<int>());
+        LOG_DEBUG("MCMC: Removing {} Gaussians", num_removed);
 
-        const torch::Tensor sampled_idxs = mask.logical_not().nonzero().squeeze(-1);
-
-        const auto param_fn = [&sampled_idxs](const int i, const torch::Tensor& param) {
-            return param.index_select(0, sampled_idxs).set_requires_grad(param.requires_grad());
+        if (!_splat_data.has_reserved_capacity()) {
+            reserve_storage();
+        }
+        static_cast<FusedAdam*>(_optimizer.get())->catch_up();
+
+        // Compact the survivors to the front of the reserved rows. They are gathered
+        // before being written back because the destination overlaps the source.
+        const torch::Tensor keep = mask.logical_not().nonzero().squeeze(-1);
+        const int64_t n_keep = keep.numel();
+        const auto compact = [&keep, n_keep](torch::Tensor& tensor) {
+            tensor.narrow(0, 0, n_keep).copy_(tensor.index_select(0, keep));
         };
 
-        const auto optimizer_fn = [&sampled_idxs](
-                                      torch::optim::OptimizerParamState& state,
-                                      const torch::Tensor& new_param)
-            -> std::unique_ptr<torch::optim::OptimizerParamState> {
-            if (auto* fused_adam_state = dynamic_cast<FusedAdam::AdamParamState*>(&state)) {
-                // FusedAdam state
-                auto new_exp_avg = fused_adam_state->exp_avg.index_select(0, sampled_idxs);
-                auto new_exp_avg_sq = fused_adam_state->exp_avg_sq.index_select(0, sampled_idxs);
-
-                // Create new state
-                auto new_state = std::make_unique<FusedAdam::AdamParamState>();
-                new_state->step_count = fused_adam_state->step_count;
-                new_state->exp_avg = new_exp_avg;
-                new_state->exp_avg_sq = new_exp_avg_sq;
-                if (fused_adam_state->max_exp_avg_sq.defined()) {
-                    auto new_max_exp_avg_sq = fused_adam_state->max_exp_avg_sq.index_select(0, sampled_idxs);
-                    new_state->max_exp_avg_sq = new_max_exp_avg_sq;
-                }
-                return new_state;
+        for (auto* param : raw_params(_splat_data)) {
+            compact(*param);
+        }
+        for (auto& group : _optimizer->param_groups()) {
+            auto it = _optimizer->state().find(group.params()[0].unsafeGetTensorImpl());
+            if (it == _optimizer->state().end()) {
+                continue;
             }
-            return nullptr;
-        };
+            auto* state = static_cast<FusedAdam::AdamParamState*>(it->second.get());
+            compact(state->exp_avg);
+            compact(state->exp_avg_sq);
+        }
 
-        update_param_with_optimizer(param_fn, optimizer_fn, _optimizer, _splat_data);
+        resize_storage(n_keep, n_keep);
     }
 
     void MCMC::initialize(const gs::param::OptimizationParameters& optimParams) {
         _params = std::make_unique<const gs::param::OptimizationParameters>(optimParams);
 
-        const auto dev = torch::kCUDA;
+        const auto dev = gs::training_device();
         _splat_data.means() = _splat_data.means().to(dev).set_requires_grad(true);
         _splat_data.scaling_raw() = _splat_data.scaling_raw().to(dev).set_requires_grad(true);
         _splat_data.rotation_raw() = _splat_data.rotation_raw().to(dev).set_requires_grad(true);
         _splat_data.opacity_raw() = _splat_data.opacity_raw().to(dev).set_requires_grad(true);
         _splat_data.sh0() = _splat_data.sh0().to(dev).set_requires_grad(true);
-        _splat_data.shN() = _splat_data.shN().to(dev).set_requires_grad(true);
+        _splat_data.shN() = _splat_data.shN().to(dev, sh_rest_dtype(optimParams)).set_requires_grad(true);
         _splat_data._densification_info = torch::empty({0});
 
         // Initialize binomial coefficients
@@ -471,14 +383,19 @@ namespace gs::training {
         }
         _binoms = _binoms.to(dev);
 
-        // Initialize optimizer
+        init_optimizer();
+        reserve_storage();
+    }
+
+    void MCMC::init_optimizer() {
         using Options = FusedAdam::Options;
         std::vector<torch::optim::OptimizerParamGroup> groups;
 
         // Create groups with proper unique_ptr<Options>
-        auto add_param_group = [&groups](const torch::Tensor& param, double lr) {
+        const auto moments = moment_dtype(*_params);
+        auto add_param_group = [&groups, moments](const torch::Tensor& param, double lr) {
             auto options = std::make_unique<Options>(lr);
-            options->eps(1e-15).betas(std::make_tuple(0.9, 0.999));
+            options->eps(1e-15).betas(std::make_tuple(0.9, 0.999)).moment_dtype(moments);
             groups.emplace_back(
                 std::vector<torch::Tensor>{param},
                 std::unique_ptr<torch::optim::OptimizerOptions>(std::move(options)));
@@ -492,12 +409,47 @@ namespace gs::training {
         add_param_group(_splat_data.opacity_raw(), _params->opacity_lr);
 
         auto global_options = std::make_unique<Options>(0.f);
-        global_options->eps(1e-15);
+        global_options->eps(1e-15).moment_dtype(moments);
         _optimizer = std::make_unique<FusedAdam>(std::move(groups), std::move(global_options));
         const double gamma = std::pow(0.01, 1.0 / _params->iterations);
         _scheduler = std::make_unique<ExponentialLR>(*_optimizer, gamma, 0);
     }
 
+    void MCMC::save_state(torch::serialize::OutputArchive& archive) const {
+        torch::serialize::OutputArchive model_archive(archive.compilation_unit());
+        _splat_data.save_state(model_archive);
+        archive.write("model", model_archive);
+
+        torch::serialize::OutputArchive optimizer_archive(archive.compilation_unit());
+        checkpoint::write_optimizer(optimizer_archive, *_optimizer);
+        archive.write("optimizer", optimizer_archive);
+    }
+
+    void MCMC::load_state(torch::serialize::InputArchive& archive) {
+        torch::serialize::InputArchive model_archive;
+        archive.read("model", model_archive);
+        _splat_data.load_state(model_archive);
+
+        // Rebuild the optimizer around the restored tensors, then overwrite its
+        // moments and (already decayed) learning rates
+        init_optimizer();
+
+        torch::serialize::InputArchive optimizer_archive;
+        archive.read("optimizer", optimizer_archive);
+        checkpoint::read_optimizer(optimizer_archive, *_optimizer);
+        reserve_storage();
+    }
+
+    void MCMC::reserve_storage() {
+        const int64_t capacity = std::max<int64_t>(_params->max_cap, _splat_data.size());
+        training::reserve_storage(_splat_data, *_optimizer, _moments, capacity);
+        LOG_DEBUG("MCMC: reserved storage for {} Gaussians", capacity);
+    }
+
+    void MCMC::resize_storage(int64_t rows, int64_t first_fresh) {
+        training::resize_storage(_splat_data, *_optimizer, _moments, rows, first_fresh);
+    }
+
     bool MCMC::is_refining(int iter) const {
         return (iter < _params->stop_refine &&
                 iter > _params->start_refine &&
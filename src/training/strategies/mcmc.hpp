@@ -5,6 +5,8 @@
 #pragma once
 
 #include "istrategy.hpp"
+#include "strategy_utils.hpp"
+#include <array>
 #include <memory>
 #include <torch/torch.h>
 
@@ -30,13 +32,17 @@ namespace gs::training {
 
         bool is_refining(int iter) const override;
 
-        void step(int iter) override;
+        void step(int iter, const torch::Tensor& visible_rows = {}) override;
 
         gs::SplatData& get_model() override { return _splat_data; }
         const gs::SplatData& get_model() const override { return _splat_data; }
 
         void remove_gaussians(const torch::Tensor& mask) override;
 
+        void save_state(torch::serialize::OutputArchive& archive) const override;
+
+        void load_state(torch::serialize::InputArchive& archive) override;
+
     private:
         // Simple ExponentialLR implementation since C++ API is different
         class ExponentialLR {
@@ -56,6 +62,16 @@ namespace gs::training {
         };
 
         // Helper functions
+        void init_optimizer();
+
+        // Moves the parameters into buffers of max_cap rows and backs the optimizer moments the
+        // same way, so refinement never reallocates
+        void reserve_storage();
+
+        // Narrows parameters and moments to the first `rows` reserved rows; moments of the
+        // rows from `first_fresh` on are zeroed
+        void resize_storage(int64_t rows, int64_t first_fresh);
+
         torch::Tensor multinomial_sample(const torch::Tensor& weights, int n, bool replacement = true);
 
         int relocate_gs();
@@ -81,6 +97,9 @@ namespace gs::training {
         // State variables
         torch::Tensor _binoms;
 
+        // Reserved optimizer moment buffers, one per parameter group
+        std::array<ReservedMoments, 6> _moments;
+
         // SelectiveAdam support
         torch::Tensor _last_visibility_mask;
     };
@@ -3,17 +3,63 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "strategy_utils.hpp"
+#include "core/device.hpp"
 #include "optimizers/fused_adam.hpp"
+#include <algorithm>
+#include <array>
 
 namespace gs::training {
-    void initialize_gaussians(gs::SplatData& splat_data) {
-        const auto dev = torch::kCUDA;
+    namespace {
+        // Removes the optimizer states from their parameter keys so the parameters can be replaced
+        std::array<std::unique_ptr<torch::optim::OptimizerParamState>, 6> take_states(torch::optim::Optimizer& optimizer) {
+            std::array<std::unique_ptr<torch::optim::OptimizerParamState>, 6> states;
+            for (size_t i = 0; i < states.size(); ++i) {
+                void* key = optimizer.param_groups()[i].params()[0].unsafeGetTensorImpl();
+                auto it = optimizer.state().find(key);
+                if (it != optimizer.state().end()) {
+                    states[i] = std::move(it->second);
+                    optimizer.state().erase(key);
+                }
+            }
+            return states;
+        }
+    } // namespace
+
+    torch::ScalarType sh_rest_dtype(const gs::param::OptimizationParameters& params) {
+        if (params.shn_precision == "fp32") {
+            return torch::kFloat;
+        }
+        if (params.shn_precision == "fp16") {
+            return torch::kHalf;
+        }
+        if (params.shn_precision == "bf16") {
+            return torch::kBFloat16;
+        }
+        throw std::runtime_error("Invalid shn_precision '" + params.shn_precision + "'. Valid values are: fp32, fp16, bf16");
+    }
+
+    torch::ScalarType moment_dtype(const gs::param::OptimizationParameters& params) {
+        if (params.moment_precision == "fp32") {
+            return torch::kFloat;
+        }
+        if (params.moment_precision == "bf16") {
+            return torch::kBFloat16;
+        }
+        throw std::runtime_error("Invalid moment_precision '" + params.moment_precision + "'. Valid values are: fp32, bf16");
+    }
+
+    int resolution_level(const std::vector<size_t>& resolution_steps, size_t iter) {
+        return static_cast<int>(std::ranges::count_if(resolution_steps, [iter](size_t step) { return iter < step; }));
+    }
+
+    void initialize_gaussians(gs::SplatData& splat_data, const gs::param::OptimizationParameters& params) {
+        const auto dev = gs::training_device();
         splat_data.means() = splat_data.means().to(dev).set_requires_grad(true);
         splat_data.scaling_raw() = splat_data.scaling_raw().to(dev).set_requires_grad(true);
         splat_data.rotation_raw() = splat_data.rotation_raw().to(dev).set_requires_grad(true);
         splat_data.opacity_raw() = splat_data.opacity_raw().to(dev).set_requires_grad(true);
         splat_data.sh0() = splat_data.sh0().to(dev).set_requires_grad(true);
-        splat_data.shN() = splat_data.shN().to(dev).set_requires_grad(true);
+        splat_data.shN() = splat_data.shN().to(dev, sh_rest_dtype(params)).set_requires_grad(true);
         splat_data._densification_info = torch::zeros({2, splat_data.means().size(0)}, splat_data.means().options()).set_requires_grad(false);
     }
 
@@ -24,9 +70,10 @@ namespace gs::training {
         std::vector<torch::optim::OptimizerParamGroup> groups;
 
         // Create groups with proper unique_ptr<Options>
-        auto add_param_group = [&groups](const torch::Tensor& param, double lr) {
+        const auto moments = moment_dtype(params);
+        auto add_param_group = [&groups, moments](const torch::Tensor& param, double lr) {
             auto options = std::make_unique<Options>(lr);
-            options->eps(1e-15).betas(std::make_tuple(0.9, 0.999));
+            options->eps(1e-15).betas(std::make_tuple(0.9, 0.999)).moment_dtype(moments);
             groups.emplace_back(
                 std::vector<torch::Tensor>{param},
                 std::unique_ptr<torch::optim::OptimizerOptions>(std::move(options)));
@@ -40,7 +87,7 @@ namespace gs::training {
         add_param_group(splat_data.opacity_raw(), params.opacity_lr);
 
         auto global_options = std::make_unique<Options>(0.f);
-        global_options->eps(1e-15);
+        global_options->eps(1e-15).moment_dtype(moments);
         return std::make_unique<FusedAdam>(std::move(groups), std::move(global_options));
     }
 
@@ -126,4 +173,72 @@ namespace gs::training {
             }
         }
     }
+
+    std::array<torch::Tensor*, 6> raw_params(gs::SplatData& splat_data) {
+        return {&splat_data.means(), &splat_data.sh0(), &splat_data.shN(),
+                &splat_data.scaling_raw(), &splat_data.rotation_raw(), &splat_data.opacity_raw()};
+    }
+
+    void reserve_storage(gs::SplatData& splat_data, torch::optim::Optimizer& optimizer,
+                         std::array<ReservedMoments, 6>& moments, int64_t capacity) {
+        torch::NoGradGuard no_grad;
+        auto states = take_states(optimizer);
+
+        capacity = std::max(capacity, splat_data.size());
+        splat_data.reserve(capacity);
+
+        const auto params = raw_params(splat_data);
+        const auto& fused_adam = static_cast<const FusedAdam&>(optimizer);
+        auto& groups = optimizer.param_groups();
+        for (size_t i = 0; i < params.size(); ++i) {
+            const auto& param = *params[i];
+            groups[i].params()[0] = param;
+
+            if (!states[i]) {
+                auto state = std::make_unique<FusedAdam::AdamParamState>();
+                state->step_count = 0;
+                states[i] = std::move(state);
+            }
+            auto* state = static_cast<FusedAdam::AdamParamState*>(states[i].get());
+
+            const int64_t rows = param.size(0);
+            auto shape = param.sizes().vec();
+            shape[0] = capacity;
+            const auto moment_options = param.options().dtype(fused_adam.moment_dtype(groups[i]));
+            for (auto [buffer, moment] : {std::pair{&moments[i].exp_avg, &state->exp_avg},
+                                          std::pair{&moments[i].exp_avg_sq, &state->exp_avg_sq}}) {
+                *buffer = torch::zeros(shape, moment_options);
+                if (moment->defined()) {
+                    buffer->narrow(0, 0, rows).copy_(*moment);
+                }
+                *moment = buffer->narrow(0, 0, rows);
+            }
+            optimizer.state()[param.unsafeGetTensorImpl()] = std::move(states[i]);
+        }
+    }
+
+    void resize_storage(gs::SplatData& splat_data, torch::optim::Optimizer& optimizer,
+                        std::array<ReservedMoments, 6>& moments, int64_t rows, int64_t first_fresh) {
+        auto states = take_states(optimizer);
+        splat_data.resize(rows);
+
+        const auto params = raw_params(splat_data);
+        auto& groups = optimizer.param_groups();
+        for (size_t i = 0; i < params.size(); ++i) {
+            const auto& param = *params[i];
+            groups[i].params()[0] = param;
+            if (!states[i]) {
+                continue;
+            }
+
+            auto* state = static_cast<FusedAdam::AdamParamState*>(states[i].get());
+            state->exp_avg = moments[i].exp_avg.narrow(0, 0, rows);
+            state->exp_avg_sq = moments[i].exp_avg_sq.narrow(0, 0, rows);
+            if (rows > first_fresh) {
+                state->exp_avg.narrow(0, first_fresh, rows - first_fresh).zero_();
+                state->exp_avg_sq.narrow(0, first_fresh, rows - first_fresh).zero_();
+            }
+            optimizer.state()[param.unsafeGetTensorImpl()] = std::move(states[i]);
+        }
+    }
 } // namespace gs::training
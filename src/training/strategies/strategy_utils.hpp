@@ -6,11 +6,22 @@
 
 #include "istrategy.hpp"
 #include "optimizers/scheduler.hpp"
+#include <array>
 #include <memory>
 #include <torch/torch.h>
 
 namespace gs::training {
-    void initialize_gaussians(gs::SplatData& splat_data);
+    // Storage type of shN for OptimizationParameters::shn_precision ("fp32", "fp16" or "bf16")
+    torch::ScalarType sh_rest_dtype(const gs::param::OptimizationParameters& params);
+
+    // Storage type of the Adam moments for OptimizationParameters::moment_precision ("fp32" or "bf16")
+    torch::ScalarType moment_dtype(const gs::param::OptimizationParameters& params);
+
+    // Image pyramid level trained at iteration iter for OptimizationParameters::resolution_steps:
+    // one level per step not yet reached, each halving the resolution; 0 is full resolution
+    int resolution_level(const std::vector<size_t>& resolution_steps, size_t iter);
+
+    void initialize_gaussians(gs::SplatData& splat_data, const gs::param::OptimizationParameters& params);
 
     std::unique_ptr<torch::optim::Optimizer> create_optimizer(
         gs::SplatData& splat_data,
@@ -21,6 +32,26 @@ namespace gs::training {
         torch::optim::Optimizer* optimizer,
         int param_group_index = -1);
 
+    // Raw parameters in optimizer parameter-group order
+    std::array<torch::Tensor*, 6> raw_params(gs::SplatData& splat_data);
+
+    // Buffers backing the Adam moments of one parameter group's reserved rows
+    struct ReservedMoments {
+        torch::Tensor exp_avg;
+        torch::Tensor exp_avg_sq;
+    };
+
+    // Moves the parameters into buffers of `capacity` rows and backs the FusedAdam moments the same
+    // way, so that growing up to the capacity and compacting are in-place writes. Groups not stepped
+    // yet get zero moments up front, so FusedAdam never allocates its own.
+    void reserve_storage(gs::SplatData& splat_data, torch::optim::Optimizer& optimizer,
+                         std::array<ReservedMoments, 6>& moments, int64_t capacity);
+
+    // Narrows parameters and moments to the first `rows` reserved rows; moments of the
+    // rows from `first_fresh` on are zeroed
+    void resize_storage(gs::SplatData& splat_data, torch::optim::Optimizer& optimizer,
+                        std::array<ReservedMoments, 6>& moments, int64_t rows, int64_t first_fresh);
+
     // Use explicit type alias to help MSVC
     using ParamUpdateFn = std::function<torch::Tensor(const int, const torch::Tensor)>;
     using OptimizerUpdateFn = std::function<std::unique_ptr<torch::optim::OptimizerParamState>(
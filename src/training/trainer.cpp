@@ -6,12 +6,15 @@
 #include "components/bilateral_grid.hpp"
 #include "components/poseopt.hpp"
 #include "components/sparsity_optimizer.hpp"
+#include "core/device.hpp"
 #include "core/image_io.hpp"
 #include "core/logger.hpp"
-#include "kernels/fused_ssim.cuh"
+#include "kernels/fused_l1_ssim.cuh"
 #include "rasterization/fast_rasterizer.hpp"
 #include "rasterization/rasterizer.hpp"
+#include <ATen/CPUGeneratorImpl.h>
 #include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAGeneratorImpl.h>
 #include <atomic>
 #include <chrono>
 #include <cuda_runtime.h>
@@ -28,7 +31,7 @@ namespace gs::training {
 
         // Wait for callback to finish if busy
         if (callback_busy_.load()) {
-            callback_stream_.synchronize();
+            wait_for_callback();
             callback_busy_.store(false);
         }
 
@@ -41,6 +44,9 @@ namespace gs::training {
         poseopt_optimizer_.reset();
         sparsity_optimizer_.reset();
         evaluator_.reset();
+        checkpoint_writer_.reset(); // Waits for a write in flight
+        start_iteration_ = 1;
+        sample_cursor_ = 0;
 
         // Clear datasets (will be recreated)
         train_dataset_.reset();
@@ -110,20 +116,17 @@ namespace gs::training {
             torch::Tensor rendered = render_output.image;
             torch::Tensor gt = gt_image;
 
-            // Ensure both tensors are 4D (batch, height, width, channels)
+            // Ensure both tensors are 4D: rendered [N,C,H,W], ground truth uint8 [N,H,W,C]
             rendered = rendered.dim() == 3 ? rendered.unsqueeze(0) : rendered;
             gt = gt.dim() == 3 ? gt.unsqueeze(0) : gt;
 
-            TORCH_CHECK(rendered.sizes() == gt.sizes(),
+            TORCH_CHECK(rendered.sizes() == gt.permute({0, 3, 1, 2}).sizes(),
                         "ERROR: size mismatch – rendered ", rendered.sizes(),
                         " vs. ground truth ", gt.sizes());
 
-            // Base loss: L1 + SSIM
-            auto l1_loss = torch::l1_loss(rendered, gt);
-            auto ssim_loss = 1.f - fused_ssim(rendered, gt, "valid", /*train=*/true);
-            torch::Tensor loss = (1.f - opt_params.lambda_dssim) * l1_loss +
-                                 opt_params.lambda_dssim * ssim_loss;
-            return loss;
+            // Base loss: (1 - lambda) * L1 + lambda * (1 - SSIM) in one pass over both images; the
+            // ground truth is normalized to [0, 1] while the kernel reads it
+            return fused_l1_ssim_loss(rendered, gt, opt_params.lambda_dssim);
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Error computing photometric loss: {}", e.what()));
         }
@@ -137,7 +140,7 @@ namespace gs::training {
                 auto scale_l1 = splatData.get_scaling().mean();
                 return opt_params.scale_reg * scale_l1;
             }
-            return torch::zeros({1}, torch::kFloat32).requires_grad_();
+            return torch::Tensor();
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Error computing scale regularization loss: {}", e.what()));
         }
@@ -151,7 +154,7 @@ namespace gs::training {
                 auto opacity_l1 = splatData.get_opacity().mean();
                 return opt_params.opacity_reg * opacity_l1;
             }
-            return torch::zeros({1}, torch::kFloat32).requires_grad_();
+            return torch::Tensor();
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Error computing opacity regularization loss: {}", e.what()));
         }
@@ -164,7 +167,7 @@ namespace gs::training {
             if (opt_params.use_bilateral_grid) {
                 return opt_params.tv_loss_weight * bilateral_grid->tv_loss();
             }
-            return torch::zeros({1}, torch::kFloat32).requires_grad_();
+            return torch::Tensor();
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Error computing bilateral grid TV loss: {}", e.what()));
         }
@@ -190,7 +193,7 @@ namespace gs::training {
                 }
                 return *loss_result;
             }
-            return torch::zeros({1}, torch::kFloat32).to(torch::kCUDA).requires_grad_();
+            return torch::Tensor();
         } catch (const std::exception& e) {
             return std::unexpected(std::format("Error computing sparsity loss: {}", e.what()));
         }
@@ -250,7 +253,7 @@ namespace gs::training {
                      std::unique_ptr<IStrategy> strategy)
         : base_dataset_(std::move(dataset)),
           strategy_(std::move(strategy)) {
-        if (!torch::cuda::is_available()) {
+        if (training_on_cuda() && !torch::cuda::is_available()) {
             throw std::runtime_error("CUDA is not available – aborting.");
         }
         LOG_DEBUG("Trainer constructed with {} cameras", base_dataset_->get_cameras().size());
@@ -310,6 +313,41 @@ namespace gs::training {
 
             train_dataset_size_ = train_dataset_->size().value();
 
+            // Persistent decoded-image cache shared by all runs on this dataset
+            std::shared_ptr<DiskImageCache> disk_cache;
+            if (!params.dataset.image_cache_dir.empty()) {
+                disk_cache = std::make_shared<DiskImageCache>(params.dataset.image_cache_dir);
+                LOG_INFO("Using decoded image cache at {}", params.dataset.image_cache_dir.string());
+            }
+            train_dataset_->set_disk_cache(disk_cache);
+            if (val_dataset_) {
+                val_dataset_->set_disk_cache(disk_cache);
+            }
+
+            // Decode training images once and serve them from RAM
+            if (params.optimization.preload_to_ram) {
+                const size_t budget_bytes = params.optimization.preload_budget_mb * 1024ull * 1024ull;
+                // One pyramid level per resolution step, built while preloading
+                auto image_cache = ImageCache::create(base_dataset_->get_cameras(),
+                                                      params.dataset.resize_factor,
+                                                      budget_bytes,
+                                                      static_cast<int>(params.optimization.resolution_steps.size()) + 1);
+                image_cache->set_disk_cache(disk_cache);
+                if (image_cache->capacity() == 0) {
+                    LOG_WARN("preload_budget_mb={} is too small for a single image, preloading disabled",
+                             params.optimization.preload_budget_mb);
+                    image_cache.reset();
+                } else {
+                    image_cache->preload(train_dataset_->get_split_cameras(), params.dataset.resize_factor);
+                }
+                train_dataset_->set_image_cache(image_cache);
+                if (val_dataset_) {
+                    val_dataset_->set_image_cache(image_cache);
+                }
+            } else {
+                train_dataset_->set_image_cache(nullptr);
+            }
+
             m_cam_id_to_cam.clear();
             // Setup camera cache
             for (const auto& cam : base_dataset_->get_cameras()) {
@@ -359,7 +397,7 @@ namespace gs::training {
             }
 
             background_ = torch::tensor({0.f, 0.f, 0.f},
-                                        torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA));
+                                        torch::TensorOptions().dtype(torch::kFloat32).device(training_device()));
 
             if (params.optimization.pose_optimization != "none") {
                 if (params.optimization.enable_eval) {
@@ -402,6 +440,27 @@ namespace gs::training {
             LOG_INFO("Render mode: {}", params.optimization.render_mode);
             LOG_INFO("Visualization: {}", params.optimization.headless ? "disabled" : "enabled");
             LOG_INFO("Strategy: {}", params.optimization.strategy);
+            if (const auto& steps = params.optimization.resolution_steps; !steps.empty()) {
+                LOG_INFO("Coarse-to-fine training: 1/{} resolution until step {}, full resolution from step {}",
+                         1 << steps.size(), steps.front(), steps.back());
+            }
+
+            checkpoint_writer_ = std::make_unique<CheckpointWriter>(params_.dataset.output_path / "checkpoints");
+            sampler_seed_ = at::detail::getDefaultCPUGenerator().current_seed();
+            start_iteration_ = 1;
+            sample_cursor_ = 0;
+
+            // Resume last, once every stateful component exists
+            if (params.resume_checkpoint) {
+                const auto checkpoint_path = checkpoint::resolve(*params.resume_checkpoint);
+                if (!checkpoint_path) {
+                    return std::unexpected(std::format("No training checkpoint found at {}",
+                                                       params.resume_checkpoint->string()));
+                }
+                if (auto result = load_checkpoint(*checkpoint_path); !result) {
+                    return std::unexpected(result.error());
+                }
+            }
 
             initialized_ = true;
             LOG_INFO("Trainer initialization complete");
@@ -411,14 +470,21 @@ namespace gs::training {
         }
     }
 
+    void Trainer::wait_for_callback() {
+        if (callback_stream_) {
+            callback_stream_->synchronize();
+        }
+    }
+
     Trainer::~Trainer() {
         // Ensure training is stopped
         stop_requested_ = true;
 
         // Wait for callback to finish if busy
         if (callback_busy_.load()) {
-            callback_stream_.synchronize();
+            wait_for_callback();
         }
+        checkpoint_writer_.reset();
         LOG_DEBUG("Trainer destroyed");
     }
 
@@ -451,6 +517,11 @@ namespace gs::training {
             auto checkpoint_path = params_.dataset.output_path / "checkpoints";
             save_ply(checkpoint_path, iter, /*join=*/true);
 
+            // The state on entry to `iter` is the state after iteration iter - 1
+            if (iter > 1) {
+                write_checkpoint(iter - 1);
+            }
+
             LOG_INFO("Checkpoint saved to {}", checkpoint_path.string());
 
             // Emit checkpoint saved event
@@ -465,6 +536,9 @@ namespace gs::training {
             LOG_INFO("Stopping training permanently at iteration {}...", iter);
             LOG_DEBUG("Saving final model...");
             save_ply(params_.dataset.output_path, iter, /*join=*/true);
+            if (iter > 1) {
+                write_checkpoint(iter - 1);
+            }
             is_running_ = false;
         }
     }
@@ -495,7 +569,7 @@ namespace gs::training {
     torch::Tensor sine_background_for_step(
         int step, int periodR = 37, int periodG = 41, int periodB = 43, bool grayscale_only = false, float jitter_amp = 0.03f) {
         const float eps = 1e-4f;
-        auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(torch::kCUDA);
+        auto opts = torch::TensorOptions().dtype(torch::kFloat32).device(training_device());
         const float two_pi = M_PI * 2.0f;
 
         // Phase 0..2PI
@@ -576,24 +650,26 @@ namespace gs::training {
 
     std::expected<Trainer::StepResult, std::string> Trainer::train_step(
         int iter,
-        Camera* cam,
-        torch::Tensor gt_image,
+        std::span<const ImagePrefetcher::Sample> views,
         RenderMode render_mode,
         std::stop_token stop_token) {
         try {
-            if (params_.optimization.gut) {
-                if (cam->camera_model_type() == gsplat::CameraModelType::ORTHO) {
-                    return std::unexpected("Training on cameras with ortho model is not supported yet.");
-                }
-            } else {
-                // Flag is workaround for non-RC datasets with distortion. By default it is off.
-                if (!params_.optimization.rc) {
-                    if (cam->radial_distortion().numel() != 0 ||
-                        cam->tangential_distortion().numel() != 0) {
-                        return std::unexpected("You must use --gut option to train on cameras with distortion.");
+            for (const auto& view : views) {
+                const Camera* cam = view.camera;
+                if (params_.optimization.gut) {
+                    if (cam->camera_model_type() == gsplat::CameraModelType::ORTHO) {
+                        return std::unexpected("Training on cameras with ortho model is not supported yet.");
                     }
-                    if (cam->camera_model_type() != gsplat::CameraModelType::PINHOLE) {
-                        return std::unexpected("You must use --gut option to train on cameras with non-pinhole model.");
+                } else {
+                    // Flag is workaround for non-RC datasets with distortion. By default it is off.
+                    if (!params_.optimization.rc) {
+                        if (cam->radial_distortion().numel() != 0 ||
+                            cam->tangential_distortion().numel() != 0) {
+                            return std::unexpected("You must use --gut option to train on cameras with distortion.");
+                        }
+                        if (cam->camera_model_type() != gsplat::CameraModelType::PINHOLE) {
+                            return std::unexpected("You must use --gut option to train on cameras with non-pinhole model.");
+                        }
                     }
                 }
             }
@@ -646,76 +722,94 @@ namespace gs::training {
                 }
             }
 
-            auto adjusted_cam_pos = poseopt_module_->forward(cam->world_view_transform(), torch::tensor({cam->uid()}));
-            auto adjusted_cam = Camera(*cam, adjusted_cam_pos);
-
             torch::Tensor& bg = background_for_step(iter);
 
+            // All views and terms go into one graph: a single backward and no host readback here.
+            // View losses are summed rather than averaged so the per-view screen-space gradients
+            // feeding the densification statistics match single-view steps. The regularizers are
+            // scaled by the view count to keep their weight; Adam is invariant to the overall scale.
+            const int64_t num_views = static_cast<int64_t>(views.size());
+            torch::Tensor loss;
             RenderOutput r_output;
-            // Use the render mode from parameters
-            if (!params_.optimization.gut) {
-                r_output = fast_rasterize(adjusted_cam, strategy_->get_model(), bg);
-            } else {
-                r_output = rasterize(adjusted_cam, strategy_->get_model(), bg, 1.0f, false, false, render_mode,
-                                     nullptr);
-            }
+            std::vector<torch::Tensor> visible_per_view;
+            for (const auto& view : views) {
+                Camera* cam = view.camera;
+                auto adjusted_cam_pos = poseopt_module_->forward(cam->world_view_transform(), torch::tensor({cam->uid()}));
+                auto adjusted_cam = Camera(*cam, adjusted_cam_pos);
+
+                // Use the render mode from parameters
+                if (!params_.optimization.gut) {
+                    r_output = fast_rasterize(adjusted_cam, strategy_->get_model(), bg);
+                } else {
+                    r_output = rasterize(adjusted_cam, strategy_->get_model(), bg, 1.0f, false, false, render_mode,
+                                         nullptr);
+                }
+                if (params_.optimization.sparse_adam && r_output.visible_indices.defined()) {
+                    visible_per_view.push_back(r_output.visible_indices);
+                }
 
-            // Apply bilateral grid if enabled
-            if (bilateral_grid_ && params_.optimization.use_bilateral_grid) {
-                r_output.image = bilateral_grid_->apply(r_output.image, cam->uid());
-            }
+                // Apply bilateral grid if enabled
+                if (bilateral_grid_ && params_.optimization.use_bilateral_grid) {
+                    r_output.image = bilateral_grid_->apply(r_output.image, cam->uid());
+                }
 
-            // Compute losses
-            auto loss_result = compute_photometric_loss(r_output,
-                                                        gt_image,
-                                                        strategy_->get_model(),
-                                                        params_.optimization);
-            if (!loss_result) {
-                return std::unexpected(loss_result.error());
+                // Compute losses
+                auto loss_result = compute_photometric_loss(r_output,
+                                                            view.image,
+                                                            strategy_->get_model(),
+                                                            params_.optimization);
+                if (!loss_result) {
+                    return std::unexpected(loss_result.error());
+                }
+                if (view_sampler_) {
+                    view_sampler_->record(view.view, *loss_result);
+                }
+                loss = loss.defined() ? loss + *loss_result : *loss_result;
             }
 
-            torch::Tensor loss = *loss_result;
-            loss.backward();
-            float loss_value = loss.item<float>();
+            const auto accumulate = [&loss, num_views](const std::expected<torch::Tensor, std::string>& term)
+                -> std::expected<void, std::string> {
+                if (!term) {
+                    return std::unexpected(term.error());
+                }
+                if (term->defined()) {
+                    loss = num_views > 1 ? loss + term->reshape({}) * num_views : loss + term->reshape({});
+                }
+                return {};
+            };
 
             // Scale regularization loss
-            auto scale_loss_result = compute_scale_reg_loss(strategy_->get_model(), params_.optimization);
-            if (!scale_loss_result) {
-                return std::unexpected(scale_loss_result.error());
+            if (auto result = accumulate(compute_scale_reg_loss(strategy_->get_model(), params_.optimization)); !result) {
+                return std::unexpected(result.error());
             }
-            loss = *scale_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
 
             // Opacity regularization loss
-            auto opacity_loss_result = compute_opacity_reg_loss(strategy_->get_model(), params_.optimization);
-            if (!opacity_loss_result) {
-                return std::unexpected(opacity_loss_result.error());
+            if (auto result = accumulate(compute_opacity_reg_loss(strategy_->get_model(), params_.optimization)); !result) {
+                return std::unexpected(result.error());
             }
-            loss = *opacity_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
 
             // Bilateral grid TV loss
-            auto tv_loss_result = compute_bilateral_grid_tv_loss(bilateral_grid_, params_.optimization);
-            if (!tv_loss_result) {
-                return std::unexpected(tv_loss_result.error());
+            if (auto result = accumulate(compute_bilateral_grid_tv_loss(bilateral_grid_, params_.optimization)); !result) {
+                return std::unexpected(result.error());
             }
-            loss = *tv_loss_result;
-            loss.backward();
-            loss_value += loss.item<float>();
 
-            // Add sparsity loss
-            auto sparsity_loss_result = compute_sparsity_loss(iter, strategy_->get_model());
-            if (!sparsity_loss_result) {
-                return std::unexpected(sparsity_loss_result.error());
+            // Sparsity loss
+            if (auto result = accumulate(compute_sparsity_loss(iter, strategy_->get_model())); !result) {
+                return std::unexpected(result.error());
             }
-            loss = *sparsity_loss_result;
+
             loss.backward();
-            loss_value += loss.item<float>();
 
-            // Store the loss value immediately
-            current_loss_ = loss_value;
+            if (view_sampler_) {
+                view_sampler_->update(iter);
+            }
+
+            // The loss reaches the host asynchronously; report the newest value that has landed
+            loss_readback_.push(iter, num_views > 1 ? loss.detach() / num_views : loss);
+            if (const auto value = loss_readback_.poll()) {
+                current_loss_ = value->loss;
+            }
+            const float loss_value = current_loss_.load();
 
             // Update progress synchronously if needed
             if (progress_) {
@@ -737,6 +831,19 @@ namespace gs::training {
             {
                 torch::NoGradGuard no_grad;
 
+                // Sparse Adam updates the union of the Gaussians the views saw
+                torch::Tensor visible_rows;
+                if (visible_per_view.size() == 1) {
+                    visible_rows = visible_per_view.front();
+                } else if (!visible_per_view.empty()) {
+                    auto seen = torch::zeros({strategy_->get_model().size()},
+                                             torch::TensorOptions().dtype(torch::kBool).device(visible_per_view.front().device()));
+                    for (const auto& indices : visible_per_view) {
+                        seen.index_fill_(0, indices, true);
+                    }
+                    visible_rows = seen.nonzero().squeeze(-1);
+                }
+
                 DeferredEvents deferred;
                 {
                     std::unique_lock<std::shared_mutex> lock(render_mutex_);
@@ -754,7 +861,7 @@ namespace gs::training {
                         strategy_->post_backward(iter, r_output);
                     }
 
-                    strategy_->step(iter);
+                    strategy_->step(iter, visible_rows);
 
                     if (params_.optimization.use_bilateral_grid) {
                         bilateral_grid_optimizer_->step();
@@ -786,12 +893,18 @@ namespace gs::training {
 
                 // Clean evaluation - let the evaluator handle everything
                 if (evaluator_->is_enabled() && evaluator_->should_evaluate(iter)) {
-                    evaluator_->print_evaluation_header(iter);
-                    auto metrics = evaluator_->evaluate(iter,
-                                                        strategy_->get_model(),
-                                                        val_dataset_,
-                                                        background_);
-                    LOG_INFO("{}", metrics.to_string());
+                    // Training continues on the live model while a worker scores the snapshot
+                    evaluator_->evaluate_async(iter,
+                                               strategy_->get_model().snapshot(),
+                                               val_dataset_,
+                                               background_.clone());
+                    if (view_sampler_) {
+                        std::vector<std::string> view_names;
+                        for (const auto& cam : train_dataset_->get_split_cameras()) {
+                            view_names.push_back(cam->image_name());
+                        }
+                        evaluator_->add_view_weights(iter, view_names, view_sampler_->weights());
+                    }
                 }
 
                 // Save model at specified steps
@@ -862,6 +975,9 @@ namespace gs::training {
             return std::unexpected("Trainer not initialized. Call initialize() before train()");
         }
 
+        // train() usually runs on a thread of its own
+        bind_training_device();
+
         is_running_ = false;
         training_complete_ = false;
         ready_to_start_ = false; // Reset the flag
@@ -887,9 +1003,12 @@ namespace gs::training {
         LOG_INFO("Starting training loop with {} workers", params_.optimization.num_workers);
 
         try {
-            int iter = 1;
+            int iter = start_iteration_;
             const int num_workers = params_.optimization.num_workers;
             const RenderMode render_mode = stringToRenderMode(params_.optimization.render_mode);
+            const int batch_views = std::max(params_.optimization.batch_views, 1);
+            std::vector<ImagePrefetcher::Sample> views;
+            views.reserve(batch_views);
 
             if (progress_) {
                 progress_->update(iter, current_loss_.load(),
@@ -897,9 +1016,27 @@ namespace gs::training {
                                   strategy_->is_refining(iter));
             }
 
-            // Use infinite dataloader to avoid epoch restarts
-            auto train_dataloader = create_infinite_dataloader_from_dataset(train_dataset_, num_workers);
-            auto loader = train_dataloader->begin();
+            // Loss-weighted view order, fed by the photometric losses of train_step
+            view_sampler_.reset();
+            if (params_.optimization.view_sampling == "loss") {
+                view_sampler_ = std::make_shared<LossWeightedSampler>(
+                    train_dataset_->get_split_cameras().size(),
+                    LossWeightedSampler::Options{.temperature = params_.optimization.view_sampling_temperature,
+                                                 .floor = params_.optimization.view_sampling_floor,
+                                                 .seed = sampler_seed_},
+                    training_device());
+            }
+
+            // Decode ahead of the training step into a ring of pinned buffers
+            ImagePrefetcher prefetcher(train_dataset_,
+                                       {.ring_size = static_cast<size_t>(std::max(params_.optimization.prefetch_depth, batch_views + 1)),
+                                        .num_workers = num_workers,
+                                        .seed = sampler_seed_,
+                                        .first_sample = sample_cursor_,
+                                        .first_iteration = start_iteration_,
+                                        .resolution_steps = params_.optimization.resolution_steps,
+                                        .views_per_step = batch_views,
+                                        .sampler = view_sampler_});
 
             LOG_DEBUG("Starting training iterations");
             // Single loop without epochs
@@ -910,15 +1047,15 @@ namespace gs::training {
 
                 // Wait for previous callback if still running
                 if (callback_busy_.load()) {
-                    callback_stream_.synchronize();
+                    wait_for_callback();
                 }
 
-                auto& batch = *loader;
-                auto camera_with_image = batch[0].data;
-                Camera* cam = camera_with_image.camera;
-                torch::Tensor gt_image = std::move(camera_with_image.image).to(torch::kCUDA, /*non_blocking=*/true);
+                views.clear();
+                for (int v = 0; v < batch_views; ++v) {
+                    views.push_back(prefetcher.next());
+                }
 
-                auto step_result = train_step(iter, cam, gt_image, render_mode, stop_token);
+                auto step_result = train_step(iter, views, render_mode, stop_token);
                 if (!step_result) {
                     return std::unexpected(step_result.error());
                 }
@@ -926,12 +1063,19 @@ namespace gs::training {
                 if (*step_result == StepResult::Stop) {
                     break;
                 }
+                sample_cursor_ += views.size();
 
                 // Launch callback for async progress update (except first iteration)
-                if (iter > 1 && callback_) {
+                if (iter > 1 && callback_ && !training_on_cuda()) {
+                    // Nothing is queued on the CPU, the step has already completed
+                    callback_();
+                } else if (iter > 1 && callback_) {
+                    if (!callback_stream_) {
+                        callback_stream_ = at::cuda::getStreamFromPool(false);
+                    }
                     callback_busy_ = true;
                     auto err = cudaLaunchHostFunc(
-                        callback_stream_.stream(),
+                        callback_stream_->stream(),
                         [](void* self) {
                             auto* trainer = static_cast<Trainer*>(self);
                             if (trainer->callback_) {
@@ -946,13 +1090,31 @@ namespace gs::training {
                     }
                 }
 
+                if (params_.optimization.checkpoint_every > 0 &&
+                    iter % params_.optimization.checkpoint_every == 0) {
+                    write_checkpoint(iter);
+                }
+
+                if (iter % 1000 == 0) {
+                    const auto stats = prefetcher.stats();
+                    LOG_DEBUG("Prefetch: queue depth {} (mean {:.1f}, min {}), {} stalls, {:.1f} ms stalled",
+                              prefetcher.queue_depth(), stats.mean_depth, stats.min_depth,
+                              stats.stalls, stats.stall_ms);
+                }
+
                 ++iter;
-                ++loader;
+            }
+
+            {
+                const auto stats = prefetcher.stats();
+                LOG_INFO("Data pipeline: {} samples, mean queue depth {:.1f} (min {}), {} stalls totalling {:.1f} ms (max {:.1f} ms)",
+                         stats.samples, stats.mean_depth, stats.min_depth,
+                         stats.stalls, stats.stall_ms, stats.max_stall_ms);
             }
 
             // Ensure callback is finished before final save
             if (callback_busy_.load()) {
-                callback_stream_.synchronize();
+                wait_for_callback();
             }
 
             // Final save if not already saved by stop request
@@ -966,9 +1128,18 @@ namespace gs::training {
                     .emit();
             }
 
+            if (checkpoint_writer_) {
+                checkpoint_writer_->wait();
+            }
+
+            if (const auto value = loss_readback_.flush()) {
+                current_loss_ = value->loss;
+            }
+
             if (progress_) {
                 progress_->complete();
             }
+            evaluator_->wait();
             evaluator_->save_report();
             if (progress_) {
                 progress_->print_final_summary(static_cast<int>(strategy_->get_model().size()));
@@ -985,6 +1156,181 @@ namespace gs::training {
         }
     }
 
+    void Trainer::write_checkpoint(int iter) {
+        if (!checkpoint_writer_) {
+            return;
+        }
+        try {
+            // Only tensor snapshots are queued here; the archive is serialized on the writer thread
+            auto archive = std::make_unique<torch::serialize::OutputArchive>();
+            const auto nested = [&archive]() { return torch::serialize::OutputArchive(archive->compilation_unit()); };
+
+            archive->write("format_version", checkpoint::FORMAT_VERSION);
+            archive->write("iteration", static_cast<int64_t>(iter));
+            archive->write("strategy", params_.optimization.strategy);
+            archive->write("sampler_seed", static_cast<int64_t>(sampler_seed_));
+            // The stream position rather than iteration * batch_views, so batch_views may change on resume
+            archive->write("sample_cursor", static_cast<int64_t>(sample_cursor_));
+
+            auto strategy_archive = nested();
+            strategy_->save_state(strategy_archive);
+            archive->write("strategy_state", strategy_archive);
+
+            if (bilateral_grid_) {
+                auto grid_archive = nested();
+                grid_archive.write("grids", checkpoint::snapshot(bilateral_grid_->parameters()));
+                grid_archive.write("scheduler_step", static_cast<int64_t>(bilateral_grid_scheduler_->current_step()));
+                auto optimizer_archive = nested();
+                checkpoint::write_optimizer(optimizer_archive, *bilateral_grid_optimizer_);
+                grid_archive.write("optimizer", optimizer_archive);
+                archive->write("bilateral_grid", grid_archive);
+            }
+
+            if (poseopt_optimizer_) {
+                auto poseopt_archive = nested();
+                const auto params = poseopt_module_->parameters();
+                for (size_t i = 0; i < params.size(); ++i) {
+                    poseopt_archive.write(std::format("param_{}", i), checkpoint::snapshot(params[i]));
+                }
+                auto optimizer_archive = nested();
+                checkpoint::write_optimizer(optimizer_archive, *poseopt_optimizer_);
+                poseopt_archive.write("optimizer", optimizer_archive);
+                archive->write("poseopt", poseopt_archive);
+            }
+
+            if (sparsity_optimizer_) {
+                auto sparsity_archive = nested();
+                sparsity_optimizer_->save_state(sparsity_archive);
+                archive->write("sparsity", sparsity_archive);
+            }
+
+            {
+                auto cpu_gen = at::detail::getDefaultCPUGenerator();
+                std::lock_guard<std::mutex> lock(cpu_gen.mutex());
+                archive->write("rng_cpu", cpu_gen.get_state());
+            }
+            if (training_on_cuda()) {
+                auto cuda_gen = at::cuda::detail::getDefaultCUDAGenerator();
+                std::lock_guard<std::mutex> lock(cuda_gen.mutex());
+                archive->write("rng_cuda", cuda_gen.get_state());
+            }
+
+            checkpoint_writer_->write(iter, std::move(archive));
+        } catch (const std::exception& e) {
+            LOG_ERROR("Failed to create checkpoint at iteration {}: {}", iter, e.what());
+        }
+    }
+
+    std::expected<void, std::string> Trainer::load_checkpoint(const std::filesystem::path& path) {
+        try {
+            torch::serialize::InputArchive archive;
+            archive.load_from(path.string(), training_device());
+
+            c10::IValue value;
+            archive.read("format_version", value);
+            if (value.toInt() != checkpoint::FORMAT_VERSION) {
+                return std::unexpected(std::format("Unsupported checkpoint version {} in {}", value.toInt(), path.string()));
+            }
+            archive.read("strategy", value);
+            if (value.toStringRef() != params_.optimization.strategy) {
+                return std::unexpected(std::format("Checkpoint was written by the '{}' strategy, but '{}' is selected",
+                                                   value.toStringRef(), params_.optimization.strategy));
+            }
+            archive.read("iteration", value);
+            const int iteration = static_cast<int>(value.toInt());
+            archive.read("sampler_seed", value);
+            sampler_seed_ = static_cast<uint64_t>(value.toInt());
+            if (archive.try_read("sample_cursor", value)) {
+                sample_cursor_ = static_cast<size_t>(value.toInt());
+            } else {
+                sample_cursor_ = static_cast<size_t>(iteration) * std::max(params_.optimization.batch_views, 1);
+                LOG_WARN("Checkpoint has no sample cursor; assuming it was written with batch_views = {}",
+                         std::max(params_.optimization.batch_views, 1));
+            }
+
+            torch::serialize::InputArchive strategy_archive;
+            archive.read("strategy_state", strategy_archive);
+            strategy_->load_state(strategy_archive);
+
+            const auto read_section = [&archive, &path](const char* key, torch::serialize::InputArchive& section)
+                -> std::expected<void, std::string> {
+                if (!archive.try_read(key, section)) {
+                    return std::unexpected(std::format("Checkpoint {} has no '{}' state; resume with the options it was written with",
+                                                       path.string(), key));
+                }
+                return {};
+            };
+
+            if (bilateral_grid_) {
+                torch::serialize::InputArchive grid_archive;
+                if (auto result = read_section("bilateral_grid", grid_archive); !result) {
+                    return result;
+                }
+                torch::Tensor grids;
+                grid_archive.read("grids", grids);
+                {
+                    torch::NoGradGuard no_grad;
+                    bilateral_grid_->parameters().copy_(grids);
+                }
+                grid_archive.read("scheduler_step", value);
+                bilateral_grid_scheduler_->set_current_step(static_cast<int>(value.toInt()));
+                torch::serialize::InputArchive optimizer_archive;
+                grid_archive.read("optimizer", optimizer_archive);
+                checkpoint::read_optimizer(optimizer_archive, *bilateral_grid_optimizer_);
+            }
+
+            if (poseopt_optimizer_) {
+                torch::serialize::InputArchive poseopt_archive;
+                if (auto result = read_section("poseopt", poseopt_archive); !result) {
+                    return result;
+                }
+                auto params = poseopt_module_->parameters();
+                torch::NoGradGuard no_grad;
+                for (size_t i = 0; i < params.size(); ++i) {
+                    torch::Tensor param;
+                    poseopt_archive.read(std::format("param_{}", i), param);
+                    params[i].copy_(param);
+                }
+                torch::serialize::InputArchive optimizer_archive;
+                poseopt_archive.read("optimizer", optimizer_archive);
+                checkpoint::read_optimizer(optimizer_archive, *poseopt_optimizer_);
+            }
+
+            if (sparsity_optimizer_) {
+                torch::serialize::InputArchive sparsity_archive;
+                if (auto result = read_section("sparsity", sparsity_archive); !result) {
+                    return result;
+                }
+                if (auto result = sparsity_optimizer_->load_state(sparsity_archive); !result) {
+                    return std::unexpected(result.error());
+                }
+            }
+
+            // Generator states are byte tensors and must be handed back on the CPU
+            torch::Tensor rng_state;
+            archive.read("rng_cpu", rng_state);
+            {
+                auto cpu_gen = at::detail::getDefaultCPUGenerator();
+                std::lock_guard<std::mutex> lock(cpu_gen.mutex());
+                cpu_gen.set_state(rng_state.cpu());
+            }
+            // Checkpoints written on the CPU carry no CUDA generator state
+            if (training_on_cuda() && archive.try_read("rng_cuda", rng_state)) {
+                auto cuda_gen = at::cuda::detail::getDefaultCUDAGenerator();
+                std::lock_guard<std::mutex> lock(cuda_gen.mutex());
+                cuda_gen.set_state(rng_state.cpu());
+            }
+
+            start_iteration_ = iteration + 1;
+            current_iteration_ = iteration;
+            LOG_INFO("Resumed from {} at iteration {} with {} Gaussians",
+                     path.string(), iteration, strategy_->get_model().size());
+            return {};
+        } catch (const std::exception& e) {
+            return std::unexpected(std::format("Failed to load checkpoint {}: {}", path.string(), e.what()));
+        }
+    }
+
     std::shared_ptr<const Camera> Trainer::getCamById(int camId) const {
         const auto it = m_cam_id_to_cam.find(camId);
         if (it == m_cam_id_to_cam.end()) {
@@ -4,14 +4,17 @@
 
 #pragma once
 
+#include "checkpoint.hpp"
 #include "components/bilateral_grid.hpp"
 #include "components/poseopt.hpp"
 #include "components/sparsity_optimizer.hpp"
 #include "core/events.hpp"
 #include "core/parameters.hpp"
 #include "dataset.hpp"
+#include "loss_readback.hpp"
 #include "metrics/metrics.hpp"
 #include "optimizers/scheduler.hpp"
+#include "prefetcher.hpp"
 #include "progress.hpp"
 #include "project/project.hpp"
 #include "rasterization/rasterizer.hpp"
@@ -21,7 +24,9 @@
 #include <expected>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <span>
 #include <stop_token>
 #include <torch/torch.h>
 
@@ -113,15 +118,15 @@ namespace gs::training {
         // Returns the background color to use at a given iteration
         torch::Tensor& background_for_step(int iter);
 
-        // Protected method for processing a single training step
+        // Protected method for processing a single training step; the gradients of all views are
+        // accumulated into one optimizer step
         std::expected<StepResult, std::string> train_step(
             int iter,
-            Camera* cam,
-            torch::Tensor gt_image,
+            std::span<const ImagePrefetcher::Sample> views,
             RenderMode render_mode,
             std::stop_token stop_token = {});
 
-        // Protected methods for computing loss
+        // Protected methods for computing loss; regularizers return an undefined tensor when disabled
         std::expected<torch::Tensor, std::string> compute_photometric_loss(
             const RenderOutput& render_output,
             const torch::Tensor& gt_image,
@@ -156,6 +161,9 @@ namespace gs::training {
         // Cleanup method for re-initialization
         void cleanup();
 
+        // Block until a callback launched on callback_stream_ has run
+        void wait_for_callback();
+
         std::expected<void, std::string> initialize_bilateral_grid();
 
         // Handle control requests
@@ -163,6 +171,12 @@ namespace gs::training {
 
         void save_ply(const std::filesystem::path& save_path, int iter_num, bool join_threads = true);
 
+        // Snapshot the full training state after `iter` and write it in the background
+        void write_checkpoint(int iter);
+
+        // Restore the state written by write_checkpoint; training continues at the following iteration
+        std::expected<void, std::string> load_checkpoint(const std::filesystem::path& path);
+
         // Member variables
         std::shared_ptr<CameraDataset> base_dataset_;
         std::shared_ptr<CameraDataset> train_dataset_;
@@ -186,6 +200,13 @@ namespace gs::training {
         // Sparsity optimizer
         std::unique_ptr<ISparsityOptimizer> sparsity_optimizer_;
 
+        // Training checkpoints
+        std::unique_ptr<CheckpointWriter> checkpoint_writer_;
+        int start_iteration_ = 1;   // > 1 when resuming from a checkpoint
+        uint64_t sampler_seed_ = 0; // Seed of the camera sampling order
+        size_t sample_cursor_ = 0;  // Views consumed by the completed iterations
+        std::shared_ptr<LossWeightedSampler> view_sampler_; // Set when views are drawn by their loss
+
         // Metrics evaluator - handles all evaluation logic
         std::unique_ptr<MetricsEvaluator> evaluator_;
 
@@ -207,12 +228,13 @@ namespace gs::training {
 
         // Current training state
         std::atomic<int> current_iteration_{0};
-        std::atomic<float> current_loss_{0.0f};
+        std::atomic<float> current_loss_{0.0f}; // Newest loss read back, may lag the iteration slightly
+        LossReadback loss_readback_;
 
         // Callback system for async operations
         std::function<void()> callback_;
         std::atomic<bool> callback_busy_{false};
-        at::cuda::CUDAStream callback_stream_ = at::cuda::getStreamFromPool(false);
+        std::optional<at::cuda::CUDAStream> callback_stream_; // Created on the first callback when training on CUDA
         at::cuda::CUDAEvent callback_launch_event_;
 
         // camera id to cam
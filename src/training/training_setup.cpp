@@ -3,8 +3,10 @@
  * SPDX-License-Identifier: GPL-3.0-or-later */
 
 #include "training_setup.hpp"
+#include "core/device.hpp"
 #include "core/logger.hpp"
 #include "core/point_cloud.hpp"
+#include "core/point_cloud_filter.hpp"
 #include "loader/loader.hpp"
 #include "strategies/default_strategy.hpp"
 #include "strategies/mcmc.hpp"
@@ -12,6 +14,33 @@
 
 namespace gs::training {
     std::expected<TrainingSetup, std::string> setupTraining(const param::TrainingParameters& params) {
+        // 0. Select the training device before anything allocates tensors
+        const auto device = gs::parse_training_device(params.optimization.device);
+        if (!device) {
+            return std::unexpected(device.error());
+        }
+        if (device->is_cpu()) {
+            // The viewer, the gsplat rasterizer, the bilateral grid and SOG export kernels are CUDA only
+            if (!params.optimization.headless) {
+                return std::unexpected("Training on the CPU requires --headless");
+            }
+            if (params.optimization.gut) {
+                return std::unexpected("GUT mode is not supported when training on the CPU");
+            }
+            if (params.optimization.use_bilateral_grid) {
+                return std::unexpected("The bilateral grid is not supported when training on the CPU");
+            }
+            if (params.optimization.save_sog) {
+                return std::unexpected("SOG export is not supported when training on the CPU");
+            }
+        }
+        gs::set_training_device(*device);
+        gs::bind_training_device();
+        LOG_INFO("Training on {}", device->str());
+        if (params.optimization.sparse_adam && params.optimization.gut) {
+            LOG_WARN("--sparse-adam needs the visible sets of the fastgs rasterizer; ignored in GUT mode");
+        }
+
         // 1. Create loader
         auto loader = loader::Loader::create();
 
@@ -20,6 +49,7 @@ namespace gs::training {
             .resize_factor = params.dataset.resize_factor,
             .images_folder = params.dataset.images,
             .validate_only = false,
+            .validate_images = params.dataset.validate_images,
             .progress = [](float percentage, const std::string& message) {
                 LOG_DEBUG("[{:5.1f}%] {}", percentage, message);
             }};
@@ -74,6 +104,15 @@ namespace gs::training {
                     if (data.point_cloud && data.point_cloud->size() > 0) {
                         point_cloud_to_use = *data.point_cloud;
                         LOG_INFO("Using point cloud with {} points", point_cloud_to_use.size());
+
+                        const auto& opt = params.optimization;
+                        if (!opt.random && (opt.init_voxel_size > 0.0f || opt.init_max_points > 0 || opt.init_outlier_std > 0.0f)) {
+                            point_cloud_to_use = filter_point_cloud(point_cloud_to_use,
+                                                                    {.voxel_size = opt.init_voxel_size,
+                                                                     .target_count = opt.init_max_points,
+                                                                     .outlier_std = opt.init_outlier_std});
+                            LOG_INFO("Preprocessed point cloud down to {} points", point_cloud_to_use.size());
+                        }
                     } else {
                         // Generate random point cloud if needed
                         LOG_INFO("No point cloud provided, using random initialization");
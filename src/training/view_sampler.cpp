@@ -0,0 +1,114 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "view_sampler.hpp"
+#include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gs::training {
+
+    namespace {
+        // splitmix64 finalizer, maps (seed, sample) to a uniform double in [0, 1)
+        double uniform(uint64_t seed, uint64_t sample) {
+            uint64_t z = seed + (sample + 1) * 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            z ^= z >> 31;
+            return static_cast<double>(z >> 11) * 0x1.0p-53;
+        }
+    } // namespace
+
+    LossWeightedSampler::LossWeightedSampler(size_t num_views, Options options, torch::Device device)
+        : _num_views(std::max<size_t>(num_views, 1)),
+          _options(options) {
+        _options.temperature = std::max(_options.temperature, 0.0f);
+        _options.floor = std::clamp(_options.floor, 0.0f, 1.0f);
+        _options.refresh_every = std::max(_options.refresh_every, 1);
+
+        const auto n = static_cast<int64_t>(_num_views);
+        _estimates = torch::full({n}, std::numeric_limits<float>::quiet_NaN(),
+                                 torch::TensorOptions().dtype(torch::kFloat32).device(device));
+        _host = torch::empty({n}, torch::TensorOptions().dtype(torch::kFloat32).pinned_memory(device.is_cuda()));
+
+        // Uniform until the first estimates arrive
+        std::vector<float> unseen(_num_views, std::numeric_limits<float>::quiet_NaN());
+        rebuild(unseen.data());
+    }
+
+    void LossWeightedSampler::record(size_t view, const torch::Tensor& loss) {
+        torch::NoGradGuard no_grad;
+        auto estimate = _estimates.narrow(0, static_cast<int64_t>(view), 1);
+        const auto value = loss.detach().reshape({1}).to(torch::kFloat32);
+        estimate.copy_(torch::where(torch::isnan(estimate), value, torch::lerp(estimate, value, _options.decay)));
+    }
+
+    void LossWeightedSampler::update(int iteration) {
+        if (!_estimates.is_cuda()) {
+            if (iteration % _options.refresh_every == 0) {
+                rebuild(_estimates.contiguous().data_ptr<float>());
+            }
+            return;
+        }
+
+        if (_copy_pending && _copied.query()) {
+            rebuild(_host.data_ptr<float>());
+            _copy_pending = false;
+        }
+        if (!_copy_pending && iteration % _options.refresh_every == 0) {
+            _host.copy_(_estimates, /*non_blocking=*/true);
+            _copied.record(at::cuda::getCurrentCUDAStream());
+            _copy_pending = true;
+        }
+    }
+
+    void LossWeightedSampler::rebuild(const float* estimates) {
+        float largest = 0.0f;
+        for (size_t i = 0; i < _num_views; ++i) {
+            if (std::isfinite(estimates[i])) {
+                largest = std::max(largest, estimates[i]);
+            }
+        }
+        // With no estimate at all every view counts the same
+        const float unseen = largest > 0.0f ? largest : 1.0f;
+
+        std::vector<ViewWeight> weights(_num_views);
+        double total = 0.0;
+        for (size_t i = 0; i < _num_views; ++i) {
+            weights[i].loss = estimates[i];
+            const float loss = std::isfinite(estimates[i]) ? std::max(estimates[i], 1e-8f) : unseen;
+            weights[i].probability = std::pow(loss, _options.temperature);
+            total += weights[i].probability;
+        }
+
+        const double uniform_share = static_cast<double>(_options.floor) / static_cast<double>(_num_views);
+        std::vector<double> cdf(_num_views);
+        double sum = 0.0;
+        for (size_t i = 0; i < _num_views; ++i) {
+            const double p = uniform_share + (1.0 - _options.floor) * weights[i].probability / total;
+            weights[i].probability = static_cast<float>(p);
+            sum += p;
+            cdf[i] = sum;
+        }
+        cdf.back() = 1.0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cdf = std::move(cdf);
+        _weights = std::move(weights);
+    }
+
+    size_t LossWeightedSampler::draw(size_t sample) const {
+        const double u = uniform(_options.seed, sample);
+        std::lock_guard<std::mutex> lock(_mutex);
+        const auto it = std::upper_bound(_cdf.begin(), _cdf.end(), u);
+        return std::min(static_cast<size_t>(it - _cdf.begin()), _num_views - 1);
+    }
+
+    std::vector<LossWeightedSampler::ViewWeight> LossWeightedSampler::weights() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _weights;
+    }
+
+} // namespace gs::training
@@ -0,0 +1,70 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#pragma once
+
+#include <ATen/cuda/CUDAEvent.h>
+#include <cstdint>
+#include <mutex>
+#include <torch/torch.h>
+#include <vector>
+
+namespace gs::training {
+
+    // Draws training views in proportion to how badly they are fit.
+    // Every view keeps a running estimate of its photometric loss on the
+    // training device; record() folds in a step's loss without a host sync.
+    // update() periodically copies the estimates to the host without blocking
+    // and rebuilds the distribution
+    //     p_i = floor / n + (1 - floor) * l_i^temperature / sum_j l_j^temperature,
+    // where views that were not trained yet count with the largest estimate.
+    class LossWeightedSampler {
+    public:
+        struct Options {
+            float temperature = 0.5f; // 0 = uniform, 1 = proportional to the loss estimate
+            float floor = 0.2f;       // Probability mass spread uniformly over all views
+            float decay = 0.1f;       // Weight of a new loss in the running estimate
+            int refresh_every = 100;  // Steps between refreshes of the distribution
+            uint64_t seed = 0;        // Draw s depends only on (seed, s) and the current distribution
+        };
+
+        struct ViewWeight {
+            float loss = 0.0f;        // Running loss estimate, NaN until the view was trained
+            float probability = 0.0f; // Current sampling probability
+        };
+
+        LossWeightedSampler(size_t num_views, Options options, torch::Device device);
+
+        // Folds the photometric loss of view `view` (0-dim tensor on the training device) into its estimate
+        void record(size_t view, const torch::Tensor& loss);
+
+        // Called once per step from the training thread
+        void update(int iteration);
+
+        // View index for sample `sample` of the stream; safe to call from any thread
+        size_t draw(size_t sample) const;
+
+        // Estimates and probabilities as of the last refresh
+        std::vector<ViewWeight> weights() const;
+
+        size_t size() const noexcept { return _num_views; }
+
+    private:
+        void rebuild(const float* estimates);
+
+        size_t _num_views;
+        Options _options;
+        torch::Tensor _estimates; // [n] float32 on the training device
+
+        // Pending host copy of the estimates
+        torch::Tensor _host; // [n] float32, pinned when training on CUDA
+        at::cuda::CUDAEvent _copied;
+        bool _copy_pending = false;
+
+        mutable std::mutex _mutex;
+        std::vector<double> _cdf; // Inclusive cumulative probabilities
+        std::vector<ViewWeight> _weights;
+    };
+
+} // namespace gs::training
@@ -94,8 +94,8 @@ namespace gs::gui::panels {
                 if (can_edit) {
                     ImGui::PushItemWidth(-1);
                     // Available options
-                    static const int resize_options[] = {1, 2, 4, 8};
-                    static const char* resize_labels[] = {"1", "2", "4", "8"};
+                    static const int resize_options[] = {1, 2, 3, 4, 6, 8};
+                    static const char* resize_labels[] = {"1", "2", "3", "4", "6", "8"};
                     static int current_index = 0; // default is 1
                     int array_size = IM_ARRAYSIZE(resize_labels);
                     // Set current_index to current value, if needed
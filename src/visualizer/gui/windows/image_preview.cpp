@@ -5,6 +5,7 @@
 #include "gui/windows/image_preview.hpp"
 #include "core/events.hpp"
 #include "core/image_io.hpp"
+#include "core/image_resize.hpp"
 #include "core/logger.hpp"
 #include <algorithm>
 #include <format>
@@ -16,6 +17,23 @@
 
 namespace gs::gui {
 
+    namespace {
+        // Shrink in memory so the image fits into a max_size texture, without decoding it again
+        void downscaleToFit(ImageData& image, int max_size) {
+            if (image.width() <= max_size && image.height() <= max_size) {
+                return;
+            }
+            const float factor = std::max(static_cast<float>(image.width()) / max_size,
+                                          static_cast<float>(image.height()) / max_size);
+            const int channels = image.channels();
+            int w, h;
+            unsigned char* scaled = image_io::downscale(image.data(), image.width(), image.height(), channels,
+                                                        factor, w, h);
+            LOG_TRACE("Downscaled {}x{} image by {:.2f} to {}x{}", image.width(), image.height(), factor, w, h);
+            image = ImageData(scaled, w, h, channels);
+        }
+    } // namespace
+
     ImagePreview::ImagePreview() = default;
 
     ImagePreview::~ImagePreview() {
@@ -136,25 +154,10 @@ namespace gs::gui {
 
         // Check if we need to downscale
         if (width > max_texture_size_ || height > max_texture_size_) {
-            // Calculate scale factor
-            int scale_factor = 1;
-            while (width / scale_factor > max_texture_size_ ||
-                   height / scale_factor > max_texture_size_) {
-                scale_factor *= 2;
-            }
+            LOG_DEBUG("Image too large ({}x{}), downscaling to fit {}x{}",
+                      width, height, max_texture_size_, max_texture_size_);
 
-            LOG_DEBUG("Image too large ({}x{}), downscaling by factor of {}",
-                      width, height, scale_factor);
-
-            // Reload at lower resolution
-            auto scaled_data = loadImageData(path);
-            if (!scaled_data) {
-                LOG_ERROR("Failed to reload image at lower resolution");
-                throw std::runtime_error("Failed to reload image at lower resolution");
-            }
-
-            // Move the scaled data
-            data = std::move(*scaled_data);
+            downscaleToFit(data, max_texture_size_);
             width = data.width();
             height = data.height();
             channels = data.channels();
@@ -296,19 +299,8 @@ namespace gs::gui {
                 try {
                     auto image_data = loadImageData(image_paths_[prev_idx]);
 
-                    // Check if downscaling is needed
-                    if (image_data->width() > max_size || image_data->height() > max_size) {
-                        int scale = 2;
-                        while (image_data->width() / scale > max_size ||
-                               image_data->height() / scale > max_size) {
-                            scale *= 2;
-                        }
-
-                        LOG_TRACE("Preloaded image needs downscaling by factor of {}", scale);
-                        // Reload at lower resolution
-                        auto [data, w, h, c] = ::load_image(image_paths_[prev_idx], scale);
-                        image_data = std::make_unique<ImageData>(data, w, h, c);
-                    }
+                    // Downscale in memory if the texture would be too large
+                    downscaleToFit(*image_data, max_size);
 
                     auto result = std::make_unique<LoadResult>();
                     auto preloaded = std::make_unique<PreloadedImage>();
@@ -337,19 +329,8 @@ namespace gs::gui {
                 try {
                     auto image_data = loadImageData(image_paths_[next_idx]);
 
-                    // Check if downscaling is needed
-                    if (image_data->width() > max_size || image_data->height() > max_size) {
-                        int scale = 2;
-                        while (image_data->width() / scale > max_size ||
-                               image_data->height() / scale > max_size) {
-                            scale *= 2;
-                        }
-
-                        LOG_TRACE("Preloaded image needs downscaling by factor of {}", scale);
-                        // Reload at lower resolution
-                        auto [data, w, h, c] = ::load_image(image_paths_[next_idx], scale);
-                        image_data = std::make_unique<ImageData>(data, w, h, c);
-                    }
+                    // Downscale in memory if the texture would be too large
+                    downscaleToFit(*image_data, max_size);
 
                     auto result = std::make_unique<LoadResult>();
                     auto preloaded = std::make_unique<PreloadedImage>();
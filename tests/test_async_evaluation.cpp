@@ -0,0 +1,133 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/camera.hpp"
+#include "core/device.hpp"
+#include "core/image_io.hpp"
+#include "core/parameters.hpp"
+#include "core/splat_data.hpp"
+#include "dataset.hpp"
+#include "metrics/metrics.hpp"
+#include "rasterization/fast_rasterizer.hpp"
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+using namespace gs;
+using gs::training::CameraDataset;
+using gs::training::MetricsEvaluator;
+
+// Evaluation on a worker thread (and a side stream on CUDA) must score a snapshot exactly like the
+// blocking evaluation of the same model, while the training thread keeps changing the live model.
+class AsyncEvaluationTest : public ::testing::Test {
+protected:
+    static constexpr int kWidth = 64;
+    static constexpr int kHeight = 48;
+    static constexpr int kViews = 3;
+
+    void SetUp() override {
+        previous_device = training_device();
+        set_training_device(torch::cuda::is_available() ? torch::Device(torch::kCUDA) : torch::Device(torch::kCPU));
+
+        dir = std::filesystem::temp_directory_path() / "lfs_async_evaluation_test";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir / "images");
+
+        torch::manual_seed(3);
+        std::vector<std::shared_ptr<Camera>> cameras;
+        for (int i = 0; i < kViews; ++i) {
+            const auto path = dir / "images" / ("view_" + std::to_string(i) + ".png");
+            save_image(path, torch::rand({3, kHeight, kWidth}));
+            cameras.push_back(std::make_shared<Camera>(
+                torch::eye(3), torch::tensor({0.1f * static_cast<float>(i), 0.0f, 4.0f}), 60.0f, 60.0f,
+                0.5f * kWidth, 0.5f * kHeight, torch::empty({0}), torch::empty({0}),
+                gsplat::CameraModelType::PINHOLE, path.filename().string(), path, kWidth, kHeight, i));
+        }
+        dataset = std::make_shared<CameraDataset>(std::move(cameras), param::DatasetConfig{}, CameraDataset::Split::ALL);
+
+        params.dataset.output_path = dir / "output";
+        std::filesystem::create_directories(params.dataset.output_path);
+        params.optimization.enable_eval = true;
+        params.optimization.enable_save_eval_images = false;
+        params.optimization.render_mode = "RGB";
+    }
+
+    void TearDown() override {
+        set_training_device(previous_device);
+        std::filesystem::remove_all(dir);
+    }
+
+    SplatData make_model(int n) const {
+        const auto device = training_device();
+        return SplatData(1,
+                         torch::randn({n, 3}).to(device),
+                         torch::rand({n, 1, 3}).to(device),
+                         torch::zeros({n, 3, 3}).to(device),
+                         torch::full({n, 3}, -3.0f).to(device),
+                         torch::tensor({1.0f, 0.0f, 0.0f, 0.0f}).repeat({n, 1}).to(device),
+                         torch::zeros({n, 1}).to(device),
+                         1.0f);
+    }
+
+    // Rows of metrics.csv without the header, split into columns
+    std::vector<std::vector<std::string>> read_metrics() const {
+        std::ifstream file(params.dataset.output_path / "metrics.csv");
+        std::vector<std::vector<std::string>> rows;
+        std::string line;
+        std::getline(file, line);
+        while (std::getline(file, line)) {
+            std::vector<std::string> columns;
+            std::stringstream ss(line);
+            for (std::string column; std::getline(ss, column, ',');) {
+                columns.push_back(column);
+            }
+            rows.push_back(std::move(columns));
+        }
+        return rows;
+    }
+
+    torch::Device previous_device = torch::kCPU;
+    std::filesystem::path dir;
+    std::shared_ptr<CameraDataset> dataset;
+    param::TrainingParameters params;
+};
+
+TEST_F(AsyncEvaluationTest, MatchesBlockingEvaluation) {
+    std::unique_ptr<MetricsEvaluator> evaluator;
+    try {
+        evaluator = std::make_unique<MetricsEvaluator>(params);
+    } catch (const std::exception& e) {
+        GTEST_SKIP() << "LPIPS weights not available: " << e.what();
+    }
+
+    auto model = make_model(4000);
+    auto background = torch::zeros({3}, training_device());
+    const auto blocking = evaluator->evaluate(1, model, dataset, background);
+
+    evaluator->evaluate_async(2, model.snapshot(), dataset, background.clone());
+    // Meanwhile the training thread renders and updates the live model on its own stream
+    for (int step = 0; step < 4; ++step) {
+        torch::NoGradGuard no_grad;
+        auto output = gs::training::fast_rasterize(*dataset->get_split_cameras()[0], model, background);
+        model.means().add_(output.image.mean() * 0.5f);
+        model.opacity_raw().sub_(1.0f);
+    }
+    evaluator->wait();
+
+    const auto rows = read_metrics();
+    ASSERT_EQ(rows.size(), 2u);
+    ASSERT_EQ(rows[0][0], "1");
+    ASSERT_EQ(rows[1][0], "2");
+    // PSNR, SSIM and LPIPS as written to the report; time per image differs
+    for (size_t column = 1; column <= 3; ++column) {
+        EXPECT_NEAR(std::stod(rows[1][column]), std::stod(rows[0][column]), 1e-5) << "column " << column;
+    }
+    EXPECT_EQ(rows[1][5], rows[0][5]);
+    EXPECT_GT(blocking.psnr, 0.0f);
+}
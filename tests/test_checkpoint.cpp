@@ -0,0 +1,210 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "checkpoint.hpp"
+#include "core/device.hpp"
+#include "core/parameters.hpp"
+#include "core/splat_data.hpp"
+#include "optimizers/fused_adam.hpp"
+#include "strategies/default_strategy.hpp"
+#include <array>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <torch/torch.h>
+#include <vector>
+
+using namespace gs;
+using gs::training::CheckpointWriter;
+using gs::training::DefaultStrategy;
+using gs::training::FusedAdam;
+
+// A resumed run must continue exactly like the run the checkpoint was taken from
+class CheckpointTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        previous_device = training_device();
+        set_training_device(torch::cuda::is_available() ? torch::Device(torch::kCUDA) : torch::Device(torch::kCPU));
+        dir = std::filesystem::temp_directory_path() / "lfs_checkpoint_test";
+        std::filesystem::remove_all(dir);
+    }
+
+    void TearDown() override {
+        set_training_device(previous_device);
+        std::filesystem::remove_all(dir);
+    }
+
+    // Archive written to memory and read back, as a checkpoint file would be
+    static void round_trip(torch::serialize::OutputArchive& out, torch::serialize::InputArchive& in) {
+        std::stringstream buffer;
+        out.save_to(buffer);
+        in.load_from(buffer, training_device());
+    }
+
+    // Two groups with their own learning rates over CPU parameters
+    static std::unique_ptr<FusedAdam> make_optimizer(const std::vector<torch::Tensor>& params) {
+        std::vector<torch::optim::OptimizerParamGroup> groups;
+        for (size_t i = 0; i < params.size(); ++i) {
+            auto options = std::make_unique<FusedAdam::Options>(1e-2 * static_cast<double>(i + 1));
+            options->eps(1e-15);
+            groups.emplace_back(std::vector<torch::Tensor>{params[i]},
+                                std::unique_ptr<torch::optim::OptimizerOptions>(std::move(options)));
+        }
+        return std::make_unique<FusedAdam>(std::move(groups), std::make_unique<FusedAdam::Options>(1e-3));
+    }
+
+    static std::array<torch::Tensor*, 6> params_of(SplatData& model) {
+        return {&model.means(), &model.sh0(), &model.shN(), &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()};
+    }
+
+    SplatData make_model(int n) const {
+        return SplatData(params.optimization.sh_degree,
+                         torch::randn({n, 3}),
+                         torch::randn({n, 1, 3}),
+                         torch::randn({n, 15, 3}),
+                         torch::randn({n, 3}) - 3.0f,
+                         torch::randn({n, 4}),
+                         torch::randn({n, 1}),
+                         1.0f);
+    }
+
+    torch::Device previous_device = torch::kCPU;
+    std::filesystem::path dir;
+    param::TrainingParameters params;
+};
+
+TEST_F(CheckpointTest, OptimizerStateRoundTrips) {
+    torch::manual_seed(1);
+    const std::vector<torch::Tensor> init = {torch::randn({32, 3}), torch::randn({32, 1})};
+    std::vector<torch::Tensor> live_params, resumed_params;
+    for (const auto& tensor : init) {
+        live_params.push_back(tensor.clone().requires_grad_(true));
+    }
+    auto live = make_optimizer(live_params);
+
+    // A dense step, a sparse one that leaves rows owing their decay, and a decayed learning rate
+    const auto step = [](FusedAdam& optimizer, std::vector<torch::Tensor>& tensors, int iteration, const torch::Tensor& rows) {
+        torch::manual_seed(100 + iteration);
+        for (auto& tensor : tensors) {
+            tensor.mutable_grad() = torch::randn_like(tensor);
+        }
+        optimizer.step(iteration, rows);
+    };
+    step(*live, live_params, 1, {});
+    step(*live, live_params, 2, torch::arange(0, 32, 3));
+    static_cast<FusedAdam::Options&>(live->param_groups()[1].options()).lr(7e-3);
+
+    torch::serialize::OutputArchive out;
+    training::checkpoint::write_optimizer(out, *live);
+    torch::serialize::InputArchive in;
+    round_trip(out, in);
+
+    for (const auto& tensor : live_params) {
+        resumed_params.push_back(tensor.detach().clone().requires_grad_(true));
+    }
+    auto resumed = make_optimizer(resumed_params);
+    training::checkpoint::read_optimizer(in, *resumed);
+    EXPECT_DOUBLE_EQ(static_cast<FusedAdam::Options&>(resumed->param_groups()[0].options()).lr(), 1e-2);
+    EXPECT_DOUBLE_EQ(static_cast<FusedAdam::Options&>(resumed->param_groups()[1].options()).lr(), 7e-3);
+
+    for (int iteration = 3; iteration <= 4; ++iteration) {
+        const auto rows = iteration == 3 ? torch::arange(1, 32, 2) : torch::Tensor();
+        step(*live, live_params, iteration, rows);
+        step(*resumed, resumed_params, iteration, rows);
+    }
+    for (size_t i = 0; i < live_params.size(); ++i) {
+        EXPECT_TRUE(torch::equal(resumed_params[i].detach(), live_params[i].detach())) << "group " << i;
+    }
+
+    // A checkpoint of a different optimizer layout is rejected
+    auto other = make_optimizer({init[0].clone().requires_grad_(true)});
+    torch::serialize::InputArchive again;
+    round_trip(out, again);
+    EXPECT_THROW(training::checkpoint::read_optimizer(again, *other), std::runtime_error);
+}
+
+TEST_F(CheckpointTest, StrategyResumesWhereItStopped) {
+    params.optimization.iterations = 100;
+    params.optimization.sh_degree = 3;
+    torch::manual_seed(2);
+    DefaultStrategy live(make_model(64));
+    live.initialize(params.optimization);
+
+    // Gradients seeded per iteration, so both runs see the same ones
+    const auto step = [](DefaultStrategy& strategy, int iteration) {
+        torch::manual_seed(1000 + iteration);
+        for (auto* param : params_of(strategy.get_model())) {
+            param->mutable_grad() = torch::randn_like(*param);
+        }
+        const auto rows = iteration % 2 == 0 ? torch::arange(0, 64, 4, torch::TensorOptions().device(training_device()).dtype(torch::kInt64))
+                                             : torch::Tensor();
+        strategy.step(iteration, rows);
+    };
+    for (int iteration = 1; iteration <= 4; ++iteration) {
+        step(live, iteration);
+    }
+
+    torch::serialize::OutputArchive out;
+    live.save_state(out);
+    torch::serialize::InputArchive in;
+    round_trip(out, in);
+
+    // Resumed into a strategy initialized from an unrelated model
+    DefaultStrategy resumed(make_model(16));
+    resumed.initialize(params.optimization);
+    resumed.load_state(in);
+    ASSERT_EQ(resumed.get_model().size(), live.get_model().size());
+
+    for (int iteration = 5; iteration <= 7; ++iteration) {
+        step(live, iteration);
+        step(resumed, iteration);
+    }
+    const auto live_params = params_of(live.get_model());
+    const auto resumed_params = params_of(resumed.get_model());
+    for (size_t i = 0; i < live_params.size(); ++i) {
+        EXPECT_TRUE(torch::equal(resumed_params[i]->detach(), live_params[i]->detach())) << "parameter " << i;
+    }
+}
+
+TEST_F(CheckpointTest, WriterKeepsOnlyTheNewestCheckpoint) {
+    const auto checkpoints = dir / "checkpoints";
+    {
+        CheckpointWriter writer(checkpoints);
+        for (const int iteration : {100, 200}) {
+            auto archive = std::make_unique<torch::serialize::OutputArchive>();
+            archive->write("iteration", static_cast<int64_t>(iteration));
+            archive->write("values", training::checkpoint::snapshot(torch::full({4}, static_cast<float>(iteration), training_device())));
+            writer.write(iteration, std::move(archive));
+        }
+        writer.wait();
+    }
+
+    const auto newest = checkpoints / training::checkpoint::file_name(200);
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(checkpoints)) {
+        files.push_back(entry.path().string());
+    }
+    ASSERT_EQ(files, std::vector<std::string>{newest.string()});
+
+    // The output directory, the checkpoints directory and the file itself all resolve to it
+    const auto resolved = [](const std::filesystem::path& path) {
+        const auto result = training::checkpoint::resolve(path);
+        return result ? result->string() : std::string();
+    };
+    EXPECT_EQ(resolved(dir), newest.string());
+    EXPECT_EQ(resolved(checkpoints), newest.string());
+    EXPECT_EQ(resolved(newest), newest.string());
+    EXPECT_EQ(resolved(dir / "missing"), "");
+
+    torch::serialize::InputArchive archive;
+    archive.load_from(newest.string(), training_device());
+    c10::IValue value;
+    archive.read("iteration", value);
+    EXPECT_EQ(value.toInt(), 200);
+    torch::Tensor values;
+    archive.read("values", values);
+    EXPECT_TRUE(torch::equal(values.cpu(), torch::full({4}, 200.0f)));
+}
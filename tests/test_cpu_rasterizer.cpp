@@ -0,0 +1,126 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "rasterization_api.h"
+#include <gtest/gtest.h>
+#include <torch/torch.h>
+
+using fast_gs::rasterization::backward_wrapper;
+using fast_gs::rasterization::forward_wrapper;
+
+class CpuRasterizerTest : public ::testing::Test {
+protected:
+    struct Scene {
+        torch::Tensor means, scales_raw, rotations_raw, opacities_raw, sh0, shN, w2c, cam_position;
+    };
+
+    static constexpr int width = 48;
+    static constexpr int height = 40;
+    static constexpr float fx = 50.0f, fy = 50.0f, cx = 24.0f, cy = 20.0f;
+    static constexpr int active_sh_bases = 9;
+
+    Scene make_scene(int n) {
+        torch::manual_seed(7);
+        Scene s;
+        s.means = torch::cat({torch::rand({n, 2}) * 2.0f - 1.0f, torch::rand({n, 1}) * 2.0f + 2.0f}, 1);
+        s.scales_raw = torch::log(torch::rand({n, 3}) * 0.15f + 0.05f);
+        s.rotations_raw = torch::randn({n, 4});
+        s.opacities_raw = torch::randn({n, 1});
+        s.sh0 = torch::randn({n, 1, 3}) * 0.5f;
+        s.shN = torch::randn({n, 15, 3}) * 0.1f;
+        s.w2c = torch::eye(4).unsqueeze(0);
+        s.cam_position = torch::zeros({3});
+        return s;
+    }
+
+    static Scene to(const Scene& s, torch::Device device) {
+        return {s.means.to(device), s.scales_raw.to(device), s.rotations_raw.to(device), s.opacities_raw.to(device),
+                s.sh0.to(device), s.shN.to(device), s.w2c.to(device), s.cam_position.to(device)};
+    }
+
+    static auto forward(const Scene& s) {
+        return forward_wrapper(s.means, s.scales_raw, s.rotations_raw, s.opacities_raw, s.sh0, s.shN,
+                               s.w2c, s.cam_position, active_sh_bases, width, height, fx, fy, cx, cy, 0.01f, 1e10f);
+    }
+
+    // Returns the gradients for grad_image = weights, grad_alpha = alpha_weights
+    static auto backward(const Scene& s, const torch::Tensor& weights, const torch::Tensor& alpha_weights) {
+        auto [image, alpha, primitive_buffers, tile_buffers, instance_buffers, bucket_buffers,
+              n_visible, n_instances, n_buckets, primitive_selector, instance_selector] = forward(s);
+        auto densification_info = torch::empty({0}, s.means.options());
+        return backward_wrapper(densification_info, weights, alpha_weights, image, alpha,
+                                s.means, s.scales_raw, s.rotations_raw, s.shN,
+                                primitive_buffers, tile_buffers, instance_buffers, bucket_buffers,
+                                s.w2c, s.cam_position, active_sh_bases, width, height, fx, fy, cx, cy, 0.01f, 1e10f,
+                                n_visible, n_instances, n_buckets, primitive_selector, instance_selector);
+    }
+};
+
+TEST_F(CpuRasterizerTest, MatchesCuda) {
+    if (!torch::cuda::is_available()) {
+        GTEST_SKIP() << "CUDA not available";
+    }
+
+    const Scene cpu = make_scene(300);
+    const Scene cuda = to(cpu, torch::kCUDA);
+
+    const auto cpu_out = forward(cpu);
+    const auto cuda_out = forward(cuda);
+    EXPECT_EQ(std::get<6>(cpu_out), std::get<6>(cuda_out)) << "visible primitives";
+    EXPECT_TRUE(torch::allclose(std::get<0>(cpu_out), std::get<0>(cuda_out).cpu(), 1e-3, 1e-3));
+    EXPECT_TRUE(torch::allclose(std::get<1>(cpu_out), std::get<1>(cuda_out).cpu(), 1e-3, 1e-3));
+
+    const auto weights = torch::rand({3, height, width});
+    const auto alpha_weights = torch::rand({1, height, width});
+    const auto cpu_grads = backward(cpu, weights, alpha_weights);
+    const auto cuda_grads = backward(cuda, weights.cuda(), alpha_weights.cuda());
+    const auto expect_close = [](const torch::Tensor& a, const torch::Tensor& b, const char* name) {
+        const float scale = b.abs().max().item<float>() + 1e-6f;
+        EXPECT_LT(((a - b.cpu()).abs().max() / scale).item<float>(), 1e-3f) << name;
+    };
+    expect_close(std::get<0>(cpu_grads), std::get<0>(cuda_grads), "means");
+    expect_close(std::get<1>(cpu_grads), std::get<1>(cuda_grads), "scales");
+    expect_close(std::get<2>(cpu_grads), std::get<2>(cuda_grads), "rotations");
+    expect_close(std::get<3>(cpu_grads), std::get<3>(cuda_grads), "opacities");
+    expect_close(std::get<4>(cpu_grads), std::get<4>(cuda_grads), "sh0");
+    expect_close(std::get<5>(cpu_grads), std::get<5>(cuda_grads), "shN");
+}
+
+TEST_F(CpuRasterizerTest, GradientsMatchFiniteDifferences) {
+    Scene s = make_scene(12);
+    const auto weights = torch::rand({3, height, width});
+    const auto alpha_weights = torch::rand({1, height, width});
+    const auto loss = [&]() {
+        const auto out = forward(s);
+        return ((std::get<0>(out) * weights).sum() + (std::get<1>(out) * alpha_weights).sum()).item<double>();
+    };
+
+    const auto grads = backward(s, weights, alpha_weights);
+    const std::tuple<const char*, torch::Tensor*, torch::Tensor> checked[] = {
+        {"means", &s.means, std::get<0>(grads)},
+        {"scales", &s.scales_raw, std::get<1>(grads)},
+        {"rotations", &s.rotations_raw, std::get<2>(grads)},
+        {"opacities", &s.opacities_raw, std::get<3>(grads)},
+        {"sh0", &s.sh0, std::get<4>(grads)},
+        {"shN", &s.shN, std::get<5>(grads)}};
+
+    // Pixels crossing the 1/255 alpha cutoff make single entries of the finite differences
+    // noisy, so the gradients are compared as whole vectors
+    constexpr float eps = 1e-3f;
+    for (const auto& [name, param, analytical] : checked) {
+        auto flat = param->view(-1);
+        auto numerical = torch::zeros_like(flat);
+        for (int64_t i = 0; i < flat.numel(); ++i) {
+            const float original = flat[i].item<float>();
+            flat[i] = original + eps;
+            const double plus = loss();
+            flat[i] = original - eps;
+            const double minus = loss();
+            flat[i] = original;
+            numerical[i] = static_cast<float>((plus - minus) / (2.0 * eps));
+        }
+        const auto similarity = torch::cosine_similarity(analytical.reshape(-1), numerical, 0).item<float>();
+        EXPECT_GT(similarity, 0.99f) << name;
+    }
+}
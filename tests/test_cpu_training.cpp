@@ -0,0 +1,452 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "Ops.h"
+#include "adam_api.h"
+#include "core/device.hpp"
+#include "core/point_cloud_filter.hpp"
+#include "kernels/fused_l1_ssim.cuh"
+#include "metrics/metrics.hpp"
+#include "optimizers/fused_adam.hpp"
+#include "view_sampler.hpp"
+#include <cmath>
+#include <format>
+#include <gtest/gtest.h>
+#include <torch/torch.h>
+#include <tuple>
+
+namespace {
+    torch::Tensor make_binoms(int n_max) {
+        auto binoms = torch::zeros({n_max, n_max}, torch::kFloat32);
+        auto acc = binoms.accessor<float, 2>();
+        for (int n = 0; n < n_max; ++n) {
+            for (int k = 0; k <= n; ++k) {
+                float binom = 1.0f;
+                for (int i = 0; i < k; ++i) {
+                    binom *= static_cast<float>(n - i) / static_cast<float>(i + 1);
+                }
+                acc[n][k] = binom;
+            }
+        }
+        return binoms;
+    }
+} // namespace
+
+TEST(CpuTrainingTest, ParseTrainingDevice) {
+    const auto cpu = gs::parse_training_device("cpu");
+    ASSERT_TRUE(cpu.has_value());
+    EXPECT_TRUE(cpu->is_cpu());
+    EXPECT_FALSE(gs::parse_training_device("tpu").has_value());
+    EXPECT_EQ(gs::parse_training_device("cuda").has_value(), torch::cuda::is_available());
+    if (torch::cuda::is_available()) {
+        // A bare "cuda" names the first GPU, so every thread can be bound to the same device
+        EXPECT_EQ(*gs::parse_training_device("cuda"), torch::Device(torch::kCUDA, 0));
+        EXPECT_FALSE(gs::parse_training_device(std::format("cuda:{}", torch::cuda::device_count())).has_value());
+    }
+}
+
+TEST(CpuTrainingTest, FusedAdamMatchesReference) {
+    torch::manual_seed(3);
+    auto param = torch::randn({1000});
+    auto exp_avg = torch::randn({1000}) * 0.1f;
+    auto exp_avg_sq = torch::rand({1000}) * 0.1f;
+    const auto grad = torch::randn({1000});
+    const float lr = 1e-2f, beta1 = 0.9f, beta2 = 0.999f, eps = 1e-15f;
+    const float bc1_rcp = 1.0f / (1.0f - std::pow(beta1, 3.0f));
+    const float bc2_sqrt_rcp = 1.0f / std::sqrt(1.0f - std::pow(beta2, 3.0f));
+
+    const auto m = beta1 * exp_avg + (1.0f - beta1) * grad;
+    const auto v = beta2 * exp_avg_sq + (1.0f - beta2) * grad * grad;
+    const auto expected = param - lr * bc1_rcp * m / (torch::sqrt(v) * bc2_sqrt_rcp + eps);
+
+    fast_gs::optimizer::adam_step_wrapper(param, exp_avg, exp_avg_sq, grad, 3, lr, beta1, beta2, eps, bc1_rcp, bc2_sqrt_rcp);
+    EXPECT_TRUE(torch::allclose(param, expected, 1e-5, 1e-6));
+    EXPECT_TRUE(torch::allclose(exp_avg, m));
+    EXPECT_TRUE(torch::allclose(exp_avg_sq, v));
+}
+
+TEST(CpuTrainingTest, FusedAdamMatchesReferenceAcrossChunks) {
+    // Spans several parallel chunks and ends in a scalar tail after the last full vector
+    constexpr int64_t n = (1 << 16) + 11;
+    torch::manual_seed(13);
+    auto param = torch::randn({n});
+    auto exp_avg = torch::randn({n}) * 0.1f;
+    auto exp_avg_sq = torch::rand({n}) * 0.1f;
+    const auto grad = torch::randn({n});
+    const float lr = 1e-2f, beta1 = 0.9f, beta2 = 0.999f, eps = 1e-15f;
+    const float bc1_rcp = 1.0f / (1.0f - std::pow(beta1, 7.0f));
+    const float bc2_sqrt_rcp = 1.0f / std::sqrt(1.0f - std::pow(beta2, 7.0f));
+
+    const auto m = beta1 * exp_avg + (1.0f - beta1) * grad;
+    const auto v = beta2 * exp_avg_sq + (1.0f - beta2) * grad * grad;
+    const auto expected = param - lr * bc1_rcp * m / (torch::sqrt(v) * bc2_sqrt_rcp + eps);
+
+    fast_gs::optimizer::adam_step_wrapper(param, exp_avg, exp_avg_sq, grad, 7, lr, beta1, beta2, eps, bc1_rcp, bc2_sqrt_rcp);
+    EXPECT_TRUE(torch::allclose(param, expected, 1e-5, 1e-6));
+    EXPECT_TRUE(torch::allclose(exp_avg, m));
+    EXPECT_TRUE(torch::allclose(exp_avg_sq, v));
+    // The last chunk and the scalar tail are updated like the rest
+    EXPECT_TRUE(torch::allclose(param.narrow(0, n - 16, 16), expected.narrow(0, n - 16, 16), 1e-5, 1e-6));
+}
+
+TEST(CpuTrainingTest, ReducedPrecisionAdamRoundsStochastically) {
+    // Each update is far below half a bf16 ulp at 1.0, so round-to-nearest would never move the params
+    constexpr int64_t n = 4096;
+    constexpr int steps = 50;
+    const float lr = 1e-4f, beta1 = 0.9f, beta2 = 0.999f, eps = 1e-15f;
+    torch::manual_seed(6);
+    auto param = torch::ones({n}, torch::kBFloat16);
+    auto exp_avg = torch::zeros({n});
+    auto exp_avg_sq = torch::zeros({n});
+    const auto grad = torch::ones({n}, torch::kBFloat16);
+    for (int step = 1; step <= steps; ++step) {
+        const float bc1_rcp = 1.0f / (1.0f - std::pow(beta1, static_cast<float>(step)));
+        const float bc2_sqrt_rcp = 1.0f / std::sqrt(1.0f - std::pow(beta2, static_cast<float>(step)));
+        fast_gs::optimizer::adam_step_wrapper(param, exp_avg, exp_avg_sq, grad, step, lr, beta1, beta2, eps, bc1_rcp, bc2_sqrt_rcp);
+    }
+    EXPECT_EQ(param.scalar_type(), torch::kBFloat16);
+    EXPECT_NEAR(param.to(torch::kFloat).mean().item<float>(), 1.0f - steps * lr, 2e-4f);
+}
+
+TEST(CpuTrainingTest, Bf16MomentsKeepDecaying) {
+    // 0.999 * v is within half a bf16 ulp of v, so round-to-nearest moments would never decay
+    constexpr int64_t n = 4096;
+    constexpr int steps = 200;
+    const float beta1 = 0.9f, beta2 = 0.999f;
+    torch::manual_seed(8);
+    auto param = torch::zeros({n});
+    auto exp_avg = torch::ones({n}, torch::kBFloat16);
+    auto exp_avg_sq = torch::ones({n}, torch::kBFloat16);
+    const auto grad = torch::zeros({n});
+    for (int step = 1; step <= steps; ++step) {
+        fast_gs::optimizer::adam_step_wrapper(param, exp_avg, exp_avg_sq, grad, step, 1e-3f, beta1, beta2, 1e-15f, 1.0f, 1.0f);
+    }
+    EXPECT_EQ(exp_avg_sq.scalar_type(), torch::kBFloat16);
+    EXPECT_NEAR(exp_avg_sq.to(torch::kFloat).mean().item<float>(), std::pow(beta2, static_cast<float>(steps)), 2e-3f);
+    EXPECT_NEAR(exp_avg.to(torch::kFloat).mean().item<float>(), std::pow(beta1, static_cast<float>(steps)), 1e-6f);
+}
+
+TEST(CpuTrainingTest, SparseAdamCatchesUpSkippedRows) {
+    // Rows skipped by sparse steps must end with the moments of dense steps on zero gradients
+    using gs::training::FusedAdam;
+    constexpr int64_t n = 40;
+    torch::manual_seed(4);
+    const auto init = torch::randn({n, 3});
+    const std::vector<torch::Tensor> grads = {torch::randn({n, 3}), torch::randn({n, 3}), torch::randn({n, 3})};
+    const std::vector<torch::Tensor> rows = {torch::arange(0, n, 2), torch::arange(0, 10), torch::arange(1, n, 4)};
+
+    const auto make = [&init](torch::Tensor& param) {
+        param = init.clone().requires_grad_(true);
+        auto options = std::make_unique<FusedAdam::Options>(1e-2);
+        options->eps(1e-15);
+        return FusedAdam(std::vector<torch::Tensor>{param}, std::move(options));
+    };
+    torch::Tensor sparse_param, dense_param;
+    auto sparse = make(sparse_param);
+    auto dense = make(dense_param);
+
+    auto touched = torch::zeros({n}, torch::kBool);
+    for (size_t s = 0; s < grads.size(); ++s) {
+        auto masked = torch::zeros_like(grads[s]);
+        masked.index_copy_(0, rows[s], grads[s].index_select(0, rows[s]));
+        sparse_param.mutable_grad() = grads[s].clone();
+        dense_param.mutable_grad() = masked;
+        sparse.step(static_cast<int>(s) + 1, rows[s]);
+        dense.step(static_cast<int>(s) + 1);
+        touched.index_fill_(0, rows[s], true);
+    }
+    sparse.catch_up();
+
+    const auto& sparse_state = static_cast<FusedAdam::AdamParamState&>(*sparse.state().find(sparse_param.unsafeGetTensorImpl())->second);
+    const auto& dense_state = static_cast<FusedAdam::AdamParamState&>(*dense.state().find(dense_param.unsafeGetTensorImpl())->second);
+    EXPECT_FALSE(sparse_state.last_step.defined());
+    EXPECT_TRUE(torch::allclose(sparse_state.exp_avg, dense_state.exp_avg, 1e-5, 1e-7));
+    EXPECT_TRUE(torch::allclose(sparse_state.exp_avg_sq, dense_state.exp_avg_sq, 1e-5, 1e-9));
+
+    // Rows never seen keep their values; the final step's rows match the dense update exactly
+    const auto untouched = touched.logical_not();
+    EXPECT_TRUE(torch::equal(sparse_param.detach().index({untouched}), init.index({untouched})));
+    const auto last = rows.back();
+    const auto last_only = last.index({(last >= 10).logical_and(last.remainder(2) == 1)});
+    EXPECT_TRUE(torch::allclose(sparse_param.detach().index_select(0, last_only),
+                                dense_param.detach().index_select(0, last_only), 1e-5, 1e-6));
+}
+
+TEST(CpuTrainingTest, ReducedPrecisionSparseAdamRoundsLikeTheKernel) {
+    // The rounding offsets hash (element, step) like the CUDA kernel: the same step gives the same
+    // result whatever the global generator state, and rows outside the update stay bit-identical
+    constexpr int64_t n = 64;
+    // A first step moves every updated element by about lr, more than a bf16 ulp below 2
+    const float lr = 2e-2f, beta1 = 0.9f, beta2 = 0.999f, eps = 1e-15f;
+    const float bc1_rcp = 1.0f / (1.0f - beta1), bc2_sqrt_rcp = 1.0f / std::sqrt(1.0f - beta2);
+    const auto init = torch::linspace(0.5f, 1.5f, n * 3).view({n, 3}).to(torch::kBFloat16);
+    const auto grad = torch::linspace(-1.0f, 1.0f, n * 3).view({n, 3}).to(torch::kBFloat16);
+    const auto rows = torch::arange(3, n, 5);
+
+    const auto run = [&](uint64_t seed) {
+        torch::manual_seed(seed);
+        auto param = init.clone();
+        auto exp_avg = torch::zeros({n, 3}, torch::kBFloat16);
+        auto exp_avg_sq = torch::zeros({n, 3}, torch::kBFloat16);
+        auto last_step = torch::zeros({n}, torch::kInt32);
+        fast_gs::optimizer::adam_step_sparse_wrapper(param, exp_avg, exp_avg_sq, grad, rows, last_step, 1, lr, beta1,
+                                                     beta2, eps, bc1_rcp, bc2_sqrt_rcp);
+        return std::tuple{param, exp_avg, torch::rand({1})};
+    };
+    const auto [param_a, exp_avg_a, draw_a] = run(1);
+    const auto [param_b, exp_avg_b, draw_b] = run(2);
+    EXPECT_TRUE(torch::equal(param_a, param_b));
+    EXPECT_TRUE(torch::equal(exp_avg_a, exp_avg_b));
+    // The step did not advance the global generator
+    torch::manual_seed(1);
+    EXPECT_TRUE(torch::equal(draw_a, torch::rand({1})));
+
+    auto untouched = torch::ones({n}, torch::kBool);
+    untouched.index_fill_(0, rows, false);
+    EXPECT_TRUE(torch::equal(param_a.index({untouched}), init.index({untouched})));
+    EXPECT_TRUE(torch::all(exp_avg_a.index({untouched}) == 0).item<bool>());
+    EXPECT_FALSE(torch::equal(param_a.index_select(0, rows), init.index_select(0, rows)));
+}
+
+TEST(CpuTrainingTest, FusedSsimOnCpu) {
+    torch::manual_seed(5);
+    const auto img = torch::rand({3, 32, 40});
+    EXPECT_NEAR(fused_ssim(img, img, "valid", true).item<float>(), 1.0f, 1e-5f);
+
+    auto pred = (img + 0.1f * torch::randn_like(img)).clamp(0, 1).requires_grad_(true);
+    const auto ssim = fused_ssim(pred, img, "valid", true);
+    EXPECT_LT(ssim.item<float>(), 1.0f);
+    ssim.backward();
+    ASSERT_TRUE(pred.grad().defined());
+    EXPECT_GT(pred.grad().abs().sum().item<float>(), 0.0f);
+
+    if (torch::cuda::is_available()) {
+        auto pred_cuda = pred.detach().cuda().requires_grad_(true);
+        const auto ssim_cuda = fused_ssim(pred_cuda, img.cuda(), "valid", true);
+        ssim_cuda.backward();
+        EXPECT_NEAR(ssim.item<float>(), ssim_cuda.item<float>(), 1e-4f);
+        EXPECT_TRUE(torch::allclose(pred.grad(), pred_cuda.grad().cpu(), 1e-3, 1e-6));
+    }
+}
+
+TEST(CpuTrainingTest, FusedL1SsimMatchesSeparateLosses) {
+    torch::manual_seed(10);
+    const float lambda = 0.2f;
+    const auto gt = torch::rand({1, 3, 45, 70});
+    auto pred = (gt + 0.1f * torch::randn_like(gt)).clamp(0, 1).requires_grad_(true);
+    const auto reference = (1.f - lambda) * torch::l1_loss(pred, gt) + lambda * (1.f - fused_ssim(pred, gt, "valid", true));
+    reference.backward();
+    const auto reference_grad = pred.grad().clone();
+    pred.mutable_grad().reset();
+
+    const auto loss = fused_l1_ssim_loss(pred, gt, lambda);
+    loss.backward();
+    EXPECT_NEAR(loss.item<float>(), reference.item<float>(), 1e-5f);
+    EXPECT_TRUE(torch::allclose(pred.grad(), reference_grad, 1e-3, 1e-7));
+
+    if (torch::cuda::is_available()) {
+        auto pred_cuda = pred.detach().cuda().requires_grad_(true);
+        const auto loss_cuda = fused_l1_ssim_loss(pred_cuda, gt.cuda(), lambda);
+        loss_cuda.backward();
+        EXPECT_NEAR(loss_cuda.item<float>(), loss.item<float>(), 1e-5f);
+        EXPECT_TRUE(torch::allclose(pred_cuda.grad().cpu(), pred.grad(), 1e-3, 1e-7));
+    }
+}
+
+TEST(CpuTrainingTest, FusedL1SsimNormalizesUint8GroundTruth) {
+    torch::manual_seed(11);
+    const float lambda = 0.2f;
+    // Ground truth as loaded from disk: uint8 [H, W, C]
+    const auto gt_u8 = torch::randint(0, 256, {45, 70, 3}, torch::kUInt8);
+    const auto gt = gt_u8.permute({2, 0, 1}).to(torch::kFloat32).unsqueeze(0) / 255.0f;
+    auto pred = (gt + 0.1f * torch::randn_like(gt)).clamp(0, 1).requires_grad_(true);
+    const auto reference = fused_l1_ssim_loss(pred, gt, lambda);
+    reference.backward();
+    const auto reference_grad = pred.grad().clone();
+    pred.mutable_grad().reset();
+
+    const auto loss = fused_l1_ssim_loss(pred, gt_u8, lambda);
+    loss.backward();
+    EXPECT_NEAR(loss.item<float>(), reference.item<float>(), 1e-6f);
+    EXPECT_TRUE(torch::allclose(pred.grad(), reference_grad, 1e-5, 1e-9));
+
+    if (torch::cuda::is_available()) {
+        auto pred_cuda = pred.detach().cuda().requires_grad_(true);
+        const auto loss_cuda = fused_l1_ssim_loss(pred_cuda, gt_u8.cuda(), lambda);
+        loss_cuda.backward();
+        EXPECT_NEAR(loss_cuda.item<float>(), loss.item<float>(), 1e-5f);
+        EXPECT_TRUE(torch::allclose(pred_cuda.grad().cpu(), pred.grad(), 1e-3, 1e-7));
+    }
+}
+
+TEST(CpuTrainingTest, LossWeightedSamplerFavorsHighLoss) {
+    using gs::training::LossWeightedSampler;
+    LossWeightedSampler sampler(4, {.temperature = 1.0f, .floor = 0.2f, .refresh_every = 1, .seed = 3}, torch::kCPU);
+
+    // Uniform before any loss was seen
+    for (const auto& w : sampler.weights()) {
+        EXPECT_NEAR(w.probability, 0.25f, 1e-6f);
+    }
+
+    sampler.record(0, torch::tensor(0.1f));
+    sampler.record(1, torch::tensor(0.1f));
+    sampler.record(2, torch::tensor(0.6f));
+    sampler.update(1);
+
+    // View 3 was never trained and counts with the largest estimate
+    const auto weights = sampler.weights();
+    EXPECT_NEAR(weights[0].probability, 0.05f + 0.8f * 0.1f / 1.4f, 1e-6f);
+    EXPECT_NEAR(weights[2].probability, 0.05f + 0.8f * 0.6f / 1.4f, 1e-6f);
+    EXPECT_FLOAT_EQ(weights[2].probability, weights[3].probability);
+    EXPECT_TRUE(std::isnan(weights[3].loss));
+
+    std::vector<int> counts(4, 0);
+    for (size_t s = 0; s < 20000; ++s) {
+        ++counts[sampler.draw(s)];
+    }
+    EXPECT_NEAR(counts[0] / 20000.0, weights[0].probability, 0.01);
+    EXPECT_NEAR(counts[2] / 20000.0, weights[2].probability, 0.01);
+    EXPECT_EQ(sampler.draw(123), sampler.draw(123));
+
+    // The estimate is a running average of the recorded losses
+    sampler.record(2, torch::tensor(0.0f));
+    sampler.update(2);
+    EXPECT_NEAR(sampler.weights()[2].loss, 0.54f, 1e-6f);
+}
+
+TEST(CpuTrainingTest, MetricsEngineMatchesPerImageReference) {
+    torch::manual_seed(11);
+    const auto pred = torch::rand({3, 3, 24, 20});
+    const auto target = (pred + 0.1f * torch::randn({3, 3, 24, 20})).clamp(0.0f, 1.0f);
+
+    gs::training::MetricsEngine engine(nullptr, /*max_batch=*/2);
+    const auto scores = engine.score(pred, target);
+    ASSERT_EQ(scores.psnr.size(), 3u);
+    EXPECT_TRUE(scores.lpips.empty());
+
+    // Separable SSIM equals the full 2D window convolution
+    const auto window = gs::training::create_window(11, 3);
+    const auto conv = [&](const torch::Tensor& x) {
+        return torch::nn::functional::conv2d(x, window, torch::nn::functional::Conv2dFuncOptions().padding(5).groups(3));
+    };
+    for (int64_t i = 0; i < 3; ++i) {
+        const auto x = pred.narrow(0, i, 1);
+        const auto y = target.narrow(0, i, 1);
+        const auto mu1 = conv(x), mu2 = conv(y);
+        const auto sigma1_sq = conv(x * x) - mu1 * mu1;
+        const auto sigma2_sq = conv(y * y) - mu2 * mu2;
+        const auto sigma12 = conv(x * y) - mu1 * mu2;
+        const float C1 = 0.01f * 0.01f, C2 = 0.03f * 0.03f;
+        const auto ssim = ((2.f * mu1 * mu2 + C1) * (2.f * sigma12 + C2)) /
+                          ((mu1 * mu1 + mu2 * mu2 + C1) * (sigma1_sq + sigma2_sq + C2));
+        EXPECT_NEAR(scores.ssim[i], ssim.mean().item<float>(), 1e-5f);
+
+        const float mse = (x - y).pow(2).mean().item<float>();
+        EXPECT_NEAR(scores.psnr[i], 10.0f * std::log10(1.0f / mse), 1e-3f);
+    }
+}
+
+TEST(CpuTrainingTest, PointCloudFilterAveragesVoxelsAndDropsOutliers) {
+    torch::manual_seed(5);
+    auto means = torch::randn({20000, 3});
+    auto colors = torch::full({20000, 3}, 100, torch::kUInt8);
+    // A few far-away points that would inflate the scene scale
+    means.narrow(0, 0, 4).fill_(500.0f);
+    means[0][0] = 800.0f;
+
+    const gs::PointCloud cloud(means, colors);
+    const auto downsampled = gs::filter_point_cloud(cloud, {.target_count = 2000});
+    EXPECT_NEAR(static_cast<double>(downsampled.size()), 2000.0, 200.0);
+    EXPECT_EQ(downsampled.colors.scalar_type(), torch::kUInt8);
+    EXPECT_TRUE(torch::all(downsampled.colors == 100).item<bool>());
+
+    // The far points keep voxels of their own instead of being averaged into the blob
+    const auto far = downsampled.means.select(1, 0) > 100.0f;
+    ASSERT_EQ(far.sum().item<int64_t>(), 2);
+    const auto far_means = downsampled.means.index({far});
+    const auto far_x = std::get<0>(far_means.select(1, 0).sort());
+    EXPECT_TRUE(torch::equal(far_x, torch::tensor({500.0f, 800.0f})));
+    EXPECT_TRUE(torch::all(far_means.narrow(1, 1, 2) == 500.0f).item<bool>());
+
+    const auto filtered = gs::filter_point_cloud(cloud, {.target_count = 2000, .outlier_std = 2.0f});
+    EXPECT_LT(filtered.means.abs().max().item<float>(), 100.0f);
+    EXPECT_GT(filtered.size(), downsampled.size() - 20);
+}
+
+TEST(CpuTrainingTest, PointCloudFilterAveragesExplicitVoxels) {
+    // Cells are counted from the minimum corner, which the first point pins to the origin
+    const auto means = torch::tensor({{0.0f, 0.0f, 0.0f},
+                                      {0.4f, 0.6f, 0.2f},   // cell (0, 0, 0)
+                                      {2.2f, 0.1f, 1.5f},
+                                      {2.6f, 0.5f, 1.1f},
+                                      {2.4f, 0.3f, 1.3f},   // cell (2, 0, 1)
+                                      {0.9f, 3.5f, 0.2f}}); // cell (0, 3, 0)
+    const auto colors = torch::tensor({10, 20, 30, 60, 90, 200}, torch::kUInt8).unsqueeze(1).repeat({1, 3});
+    const std::vector<std::vector<int64_t>> voxels = {{0, 1}, {2, 3, 4}, {5}};
+
+    // Output voxels are in no particular order: each expected mean must match exactly one row
+    const auto expect_voxels = [](const gs::PointCloud& result, const torch::Tensor& means, const torch::Tensor& colors,
+                                  const std::vector<std::vector<int64_t>>& groups) {
+        ASSERT_EQ(result.size(), static_cast<int64_t>(groups.size()));
+        for (const auto& group : groups) {
+            const auto rows = torch::tensor(group);
+            const auto mean = means.index_select(0, rows).to(torch::kDouble).mean(0).to(torch::kFloat);
+            const auto color = colors.index_select(0, rows).to(torch::kDouble).mean(0).round().to(torch::kUInt8);
+            const auto match = (result.means - mean).abs().amax(1) < 1e-6f;
+            ASSERT_EQ(match.sum().item<int64_t>(), 1) << "voxel of point " << group.front();
+            EXPECT_TRUE(torch::equal(result.colors.index({match}).squeeze(0), color));
+        }
+    };
+    expect_voxels(gs::filter_point_cloud(gs::PointCloud(means, colors), {.voxel_size = 1.0f}), means, colors, voxels);
+
+    // A point 10^7 voxels away cannot be addressed with 2^21 cells per axis. The voxel size is raised
+    // to about 4.8, so the near points share one voxel, while the two distant points 100 apart
+    // still get one each instead of being clamped into the border cell together.
+    const auto far_means = torch::cat({means, torch::tensor({{1.0e7f, 0.0f, 0.0f}, {1.0e7f - 100.0f, 0.0f, 0.0f}})});
+    const auto far_colors = torch::cat({colors, torch::full({2, 3}, 255, torch::kUInt8)});
+    expect_voxels(gs::filter_point_cloud(gs::PointCloud(far_means, far_colors), {.voxel_size = 1.0f}),
+                  far_means, far_colors, {{0, 1, 2, 3, 4, 5}, {6}, {7}});
+}
+
+TEST(CpuTrainingTest, QuatsToRotmatsOnCpu) {
+    torch::manual_seed(9);
+    const auto quats = torch::randn({64, 4});
+    const auto rotmats = gsplat::quats_to_rotmats(quats);
+    const auto identity = torch::eye(3).expand({64, 3, 3});
+    EXPECT_TRUE(torch::allclose(torch::bmm(rotmats, rotmats.transpose(1, 2)), identity, 1e-5, 1e-5));
+    EXPECT_TRUE(torch::allclose(torch::linalg_det(rotmats), torch::ones({64}), 1e-5, 1e-5));
+
+    if (torch::cuda::is_available()) {
+        EXPECT_TRUE(torch::allclose(rotmats, gsplat::quats_to_rotmats(quats.cuda()).cpu(), 1e-5, 1e-6));
+    }
+}
+
+TEST(CpuTrainingTest, McmcOpsMatchCuda) {
+    if (!torch::cuda::is_available()) {
+        GTEST_SKIP() << "CUDA not available";
+    }
+    torch::manual_seed(11);
+    const int N = 200;
+    const int n_max = 51;
+    const auto opacities = torch::rand({N}) * 0.8f + 0.1f;
+    const auto scales = torch::rand({N, 3}) * 0.5f + 0.1f;
+    const auto ratios = torch::randint(1, 10, {N}, torch::kInt32);
+    const auto binoms = make_binoms(n_max);
+
+    const auto [cpu_opacities, cpu_scales] = gsplat::relocation(opacities, scales, ratios, binoms, n_max);
+    const auto [cuda_opacities, cuda_scales] =
+        gsplat::relocation(opacities.cuda(), scales.cuda(), ratios.cuda(), binoms.cuda(), n_max);
+    EXPECT_TRUE(torch::allclose(cpu_opacities, cuda_opacities.cpu(), 1e-4, 1e-5));
+    EXPECT_TRUE(torch::allclose(cpu_scales, cuda_scales.cpu(), 1e-4, 1e-5));
+
+    const auto raw_opacities = torch::randn({N}) - 4.0f;
+    const auto raw_scales = torch::randn({N, 3}) - 3.0f;
+    const auto raw_quats = torch::randn({N, 4});
+    const auto noise = torch::randn({N, 3});
+    auto cpu_means = torch::randn({N, 3});
+    auto cuda_means = cpu_means.cuda();
+    gsplat::add_noise(raw_opacities, raw_scales, raw_quats, noise, cpu_means, 0.5f);
+    gsplat::add_noise(raw_opacities.cuda(), raw_scales.cuda(), raw_quats.cuda(), noise.cuda(), cuda_means, 0.5f);
+    EXPECT_TRUE(torch::allclose(cpu_means, cuda_means.cpu(), 1e-4, 1e-5));
+}
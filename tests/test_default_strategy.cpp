@@ -3,9 +3,14 @@
 #include "core/splat_data.hpp"
 #include "rasterization/rasterizer.hpp"
 #include "strategies/default_strategy.hpp"
+#include "strategies/strategy_utils.hpp"
+#include <cmath>
 #include <gtest/gtest.h>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <torch/torch.h>
+#include <vector>
 
 using namespace gs;
 
@@ -452,3 +457,159 @@ TEST_F(DefaultStrategyTest, ConsistentRenderingAfterOperationsTest) {
     // Images should be different due to optimization
     EXPECT_FALSE(torch::allclose(render1.image, render2.image));
 }
+
+TEST_F(DefaultStrategyTest, GrowAndPruneKeepsOptimizerStateAligned) {
+    // Rows 0 and 5 are small with high gradients (duplicated), 2 and 6 large with high gradients
+    // (split); 4, 5 and 6 are transparent, so only row 0 gains a duplicate and row 6 no children
+    constexpr int N = 8;
+    const float small = std::log(0.001f), large = std::log(0.5f);
+    const float opaque = 2.0f, transparent = std::log(0.001f / 0.999f);
+    auto scaling = torch::tensor({small, small, large, large, small, small, large, small}).unsqueeze(1).repeat({1, 3});
+    auto opacity = torch::tensor({opaque, opaque, opaque, opaque, transparent, transparent, transparent, opaque}).unsqueeze(1);
+    const auto is_grad_high = torch::tensor({true, false, true, false, false, true, true, false});
+    const int sh_rest = (params.optimization.sh_degree + 1) * (params.optimization.sh_degree + 1) - 1;
+    auto strategy = std::make_unique<DefaultStrategy>(SplatData(
+        params.optimization.sh_degree, torch::randn({N, 3}), torch::randn({N, 1, 3}), torch::randn({N, sh_rest, 3}),
+        scaling, torch::randn({N, 4}), opacity, 1.0f));
+    strategy->initialize(params.optimization);
+    auto& model = strategy->get_model();
+    const std::vector<torch::Tensor*> parameters = {&model.means(), &model.sh0(), &model.shN(),
+                                                    &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()};
+
+    // Non-zero, distinct moments on every row
+    for (auto* param : parameters) {
+        param->mutable_grad() = torch::randn_like(*param);
+    }
+    strategy->step(1);
+
+    // First moments of every optimizer group, as the strategy checkpoints them
+    const auto first_moments = [&strategy]() {
+        torch::serialize::OutputArchive out;
+        strategy->save_state(out);
+        std::stringstream buffer;
+        out.save_to(buffer);
+        torch::serialize::InputArchive in, optimizer;
+        in.load_from(buffer);
+        in.read("optimizer", optimizer);
+        c10::IValue num_groups;
+        optimizer.read("num_groups", num_groups);
+        std::vector<torch::Tensor> moments;
+        for (int64_t g = 0; g < num_groups.toInt(); ++g) {
+            torch::serialize::InputArchive group;
+            optimizer.read("group" + std::to_string(g), group);
+            torch::Tensor exp_avg;
+            group.read("p0_exp_avg", exp_avg);
+            moments.push_back(exp_avg);
+        }
+        return moments;
+    };
+    const auto moments_before = first_moments();
+    ASSERT_TRUE(model.has_reserved_capacity());
+    const void* means_storage = model.means().data_ptr();
+    const auto means_before = model.means().detach().clone();
+    const auto scaling_before = model.scaling_raw().detach().clone();
+
+    // One observation per Gaussian with the accumulated gradient norm 1 or 0
+    model._densification_info = torch::stack({torch::ones({N}), is_grad_high.to(torch::kFloat)}).to(device);
+    gs::RenderOutput render_output{};
+    strategy->post_backward(600, render_output);
+
+    // [kept originals 0, 1, 3, 7 | duplicate of 0 | two children of 2]
+    constexpr int64_t expected_rows = 7;
+    const auto kept = torch::tensor({0, 1, 3, 7}, torch::kInt64).to(device);
+    ASSERT_EQ(model.size(), expected_rows);
+    for (auto* param : parameters) {
+        EXPECT_EQ(param->size(0), expected_rows);
+    }
+    // Rewritten within the storage reserved at initialization
+    EXPECT_TRUE(model.has_reserved_capacity());
+    EXPECT_EQ(model.capacity(), N);
+    EXPECT_EQ(model.means().data_ptr(), means_storage);
+    EXPECT_TRUE(torch::equal(model.means().narrow(0, 0, 4), means_before.index_select(0, kept)));
+    EXPECT_TRUE(torch::equal(model.means()[4], means_before[0]));
+    EXPECT_TRUE(torch::allclose(model.scaling_raw().narrow(0, 5, 2),
+                                (scaling_before[2] - std::log(1.6f)).expand({2, 3})));
+
+    // Carried rows keep their moments, the new ones start from zero
+    const auto moments_after = first_moments();
+    ASSERT_EQ(moments_after.size(), moments_before.size());
+    for (size_t g = 0; g < moments_after.size(); ++g) {
+        const auto& after = moments_after[g];
+        ASSERT_EQ(after.size(0), expected_rows) << "group " << g;
+        EXPECT_TRUE(torch::equal(after.narrow(0, 0, 4), moments_before[g].index_select(0, kept))) << "group " << g;
+        EXPECT_TRUE(after.narrow(0, 4, 3).eq(0).all().item<bool>()) << "group " << g;
+    }
+
+    // And the optimizer steps the rebuilt parameters
+    for (auto* param : parameters) {
+        param->mutable_grad() = torch::randn_like(*param);
+    }
+    const auto means_refined = model.means().detach().clone();
+    strategy->step(601);
+    EXPECT_FALSE(torch::equal(model.means().detach(), means_refined));
+}
+
+TEST_F(DefaultStrategyTest, ReservedStorageDoublesAndShrinks) {
+    // Small, opaque Gaussians with high gradients are all duplicated at every refinement
+    constexpr int N = 8;
+    const int sh_rest = (params.optimization.sh_degree + 1) * (params.optimization.sh_degree + 1) - 1;
+    auto strategy = std::make_unique<DefaultStrategy>(SplatData(
+        params.optimization.sh_degree, torch::randn({N, 3}), torch::randn({N, 1, 3}), torch::randn({N, sh_rest, 3}),
+        torch::full({N, 3}, std::log(0.001f)), torch::randn({N, 4}), torch::full({N, 1}, 2.0f), 1.0f));
+    strategy->initialize(params.optimization);
+    auto& model = strategy->get_model();
+
+    const auto duplicate_all = [&](int iter) {
+        const int64_t n = model.size();
+        model._densification_info = torch::ones({2, n}, device);
+        gs::RenderOutput render_output{};
+        strategy->post_backward(iter, render_output);
+    };
+
+    duplicate_all(600);
+    EXPECT_EQ(model.size(), 2 * N);
+    EXPECT_EQ(model.capacity(), 2 * N);
+    duplicate_all(700);
+    EXPECT_EQ(model.size(), 4 * N);
+    EXPECT_EQ(model.capacity(), 4 * N);
+
+    // Pruning compacts within the same storage
+    const void* means_storage = model.means().data_ptr();
+    auto mask = torch::zeros({model.size()}, torch::TensorOptions().dtype(torch::kBool).device(device));
+    mask.narrow(0, 0, 10).fill_(true);
+    strategy->remove_gaussians(mask);
+    EXPECT_EQ(model.size(), 4 * N - 10);
+    EXPECT_EQ(model.capacity(), 4 * N);
+    EXPECT_EQ(model.means().data_ptr(), means_storage);
+
+    // Below a quarter of the capacity the storage is halved and still backs every parameter
+    mask = torch::ones({model.size()}, torch::TensorOptions().dtype(torch::kBool).device(device));
+    mask.narrow(0, 0, 3).fill_(false);
+    strategy->remove_gaussians(mask);
+    EXPECT_EQ(model.size(), 3);
+    EXPECT_EQ(model.capacity(), 6);
+    EXPECT_TRUE(model.has_reserved_capacity());
+    EXPECT_TRUE(model.means().requires_grad());
+
+    // The optimizer still steps the compacted parameters
+    for (auto* param : {&model.means(), &model.sh0(), &model.shN(), &model.scaling_raw(), &model.rotation_raw(), &model.opacity_raw()}) {
+        param->mutable_grad() = torch::randn_like(*param);
+    }
+    const auto means_before = model.means().detach().clone();
+    strategy->step(701);
+    EXPECT_FALSE(torch::equal(model.means().detach(), means_before));
+}
+
+TEST(ResolutionScheduleTest, LevelCountsTheStepsNotYetReached) {
+    using gs::training::resolution_level;
+    EXPECT_EQ(resolution_level({}, 1), 0);
+    EXPECT_EQ(resolution_level({}, 100000), 0);
+
+    const std::vector<size_t> steps = {2000, 5000};
+    EXPECT_EQ(resolution_level(steps, 1), 2);
+    EXPECT_EQ(resolution_level(steps, 1999), 2);
+    EXPECT_EQ(resolution_level(steps, 2000), 1);
+    EXPECT_EQ(resolution_level(steps, 4999), 1);
+    EXPECT_EQ(resolution_level(steps, 5000), 0);
+    EXPECT_EQ(resolution_level(steps, 30000), 0);
+}
@@ -0,0 +1,263 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/disk_image_cache.hpp"
+#include "core/image_cache.hpp"
+#include "core/image_io.hpp"
+#include "core/image_probe.hpp"
+#include "core/image_resize.hpp"
+#include "core/jpeg_decode.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <gtest/gtest.h>
+#include <torch/torch.h>
+
+using namespace gs;
+
+class ImageCacheTest : public ::testing::Test {
+protected:
+    static constexpr int kWidth = 32;
+    static constexpr int kHeight = 24;
+    static constexpr size_t kImageBytes = kWidth * kHeight * 3;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "lfs_image_cache_test";
+        std::filesystem::create_directories(dir);
+        for (int i = 0; i < 3; ++i) {
+            torch::manual_seed(i);
+            auto path = dir / ("img_" + std::to_string(i) + ".png");
+            save_image(path, torch::rand({3, kHeight, kWidth}));
+            paths.push_back(path);
+        }
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+    std::vector<std::filesystem::path> paths;
+};
+
+TEST_F(ImageCacheTest, ServesDecodedPixels) {
+    ImageCache cache(kImageBytes, paths.size(), 0);
+    ASSERT_EQ(cache.capacity(), paths.size());
+
+    auto [ref, w, h, c] = load_image(paths[1]);
+    {
+        auto lease = cache.acquire(1, paths[1], -1);
+        ASSERT_TRUE(lease.cached());
+        ASSERT_EQ(lease.width(), w);
+        ASSERT_EQ(lease.height(), h);
+        ASSERT_EQ(lease.channels(), c);
+        EXPECT_EQ(std::memcmp(lease.data(), ref, static_cast<size_t>(w) * h * c), 0);
+    }
+    free_image(ref);
+
+    auto again = cache.acquire(1, paths[1], -1);
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST_F(ImageCacheTest, EvictsLeastRecentlyUsed) {
+    ImageCache cache(kImageBytes, paths.size(), 2 * kImageBytes);
+    ASSERT_EQ(cache.capacity(), 2u);
+
+    cache.acquire(0, paths[0], -1);
+    cache.acquire(1, paths[1], -1);
+    cache.acquire(0, paths[0], -1); // touch 0 so 1 becomes the LRU entry
+    cache.acquire(2, paths[2], -1); // evicts 1
+
+    EXPECT_EQ(cache.stats().evictions, 1u);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.acquire(0, paths[0], -1);
+    EXPECT_EQ(cache.stats().hits, 2u);
+    cache.acquire(1, paths[1], -1);
+    EXPECT_EQ(cache.stats().misses, 4u);
+}
+
+TEST_F(ImageCacheTest, LeasedSlotIsNotEvicted) {
+    ImageCache cache(kImageBytes, paths.size(), kImageBytes);
+    ASSERT_EQ(cache.capacity(), 1u);
+
+    auto held = cache.acquire(0, paths[0], -1);
+    auto other = cache.acquire(1, paths[1], -1);
+
+    EXPECT_TRUE(held.cached());
+    EXPECT_FALSE(other.cached());
+    EXPECT_EQ(cache.stats().uncached, 1u);
+    EXPECT_EQ(cache.stats().evictions, 0u);
+}
+
+TEST_F(ImageCacheTest, ServesPyramidLevels) {
+    constexpr int kLevels = 3;
+    ImageCache cache(ImageCache::pyramid_bytes(kWidth, kHeight, 3, kLevels), paths.size(), 0, kLevels);
+
+    auto [ref, w, h, c] = load_image(paths[0]);
+    for (int level = 0; level < kLevels; ++level) {
+        int ref_w = w, ref_h = h;
+        unsigned char* expected = level == 0 ? ref : image_io::downscale(ref, w, h, c, static_cast<float>(1 << level), ref_w, ref_h);
+        auto lease = cache.acquire(0, paths[0], -1, level);
+        ASSERT_TRUE(lease.cached());
+        ASSERT_EQ(lease.width(), ref_w);
+        ASSERT_EQ(lease.height(), ref_h);
+        EXPECT_EQ(std::memcmp(lease.data(), expected, static_cast<size_t>(ref_w) * ref_h * c), 0);
+        if (level > 0) {
+            free_image(expected);
+        }
+    }
+    free_image(ref);
+
+    // The pyramid is built with the image, later levels are hits
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(cache.stats().hits, static_cast<size_t>(kLevels - 1));
+    EXPECT_THROW(cache.acquire(0, paths[0], -1, kLevels), std::out_of_range);
+}
+
+TEST_F(ImageCacheTest, DiskCacheRoundTrip) {
+    DiskImageCache disk(dir / "cache");
+    EXPECT_FALSE(disk.find(paths[0], 1).has_value());
+
+    auto mapped = disk.load(paths[0], 1);
+    ASSERT_TRUE(mapped.has_value());
+
+    auto [ref, w, h, c] = load_image(paths[0]);
+    ASSERT_EQ(mapped->width(), w);
+    ASSERT_EQ(mapped->height(), h);
+    ASSERT_EQ(mapped->channels(), c);
+    EXPECT_EQ(std::memcmp(mapped->data(), ref, mapped->num_bytes()), 0);
+    free_image(ref);
+
+    // resize factors <= 1 share one entry, other factors do not
+    EXPECT_TRUE(disk.find(paths[0], -1).has_value());
+    EXPECT_FALSE(disk.find(paths[0], 2).has_value());
+}
+
+TEST_F(ImageCacheTest, DiskCacheDetectsStaleEntries) {
+    DiskImageCache disk(dir / "cache");
+    ASSERT_TRUE(disk.load(paths[1], 1).has_value());
+
+    auto mtime = std::filesystem::last_write_time(paths[1]);
+    std::filesystem::last_write_time(paths[1], mtime + std::chrono::seconds(5));
+    EXPECT_FALSE(disk.find(paths[1], 1).has_value());
+}
+
+TEST_F(ImageCacheTest, ArenaFillsFromDiskCache) {
+    auto disk = std::make_shared<DiskImageCache>(dir / "cache");
+    ImageCache cache(kImageBytes, paths.size(), 0);
+    cache.set_disk_cache(disk);
+
+    auto lease = cache.acquire(2, paths[2], 1);
+    ASSERT_TRUE(lease.cached());
+    EXPECT_TRUE(disk->find(paths[2], 1).has_value());
+}
+
+TEST_F(ImageCacheTest, ProbeMatchesDecodedSize) {
+    const auto jpg = dir / "odd.jpg";
+    save_image(jpg, torch::rand({3, 17, 45}));
+    auto probe_paths = paths;
+    probe_paths.push_back(jpg);
+    probe_paths.push_back(dir / "missing.png");
+
+    const auto infos = image_io::probe_images(probe_paths);
+    ASSERT_EQ(infos.size(), probe_paths.size());
+    for (size_t i = 0; i + 1 < probe_paths.size(); ++i) {
+        ASSERT_TRUE(infos[i].has_value()) << infos[i].error();
+        auto [data, w, h, c] = load_image(probe_paths[i]);
+        free_image(data);
+        EXPECT_EQ(infos[i]->width, w);
+        EXPECT_EQ(infos[i]->height, h);
+    }
+    EXPECT_FALSE(infos.back().has_value());
+}
+
+TEST(ImageResizeTest, IntegerFactorIsExactBlockAverage) {
+    constexpr int w = 96, h = 60, c = 3, f = 3;
+    std::mt19937 rng(42);
+    std::vector<unsigned char> src(w * h * c);
+    for (auto& v : src) {
+        v = static_cast<unsigned char>(rng() % 256);
+    }
+
+    int dw, dh;
+    unsigned char* dst = image_io::downscale(src.data(), w, h, c, static_cast<float>(f), dw, dh);
+    ASSERT_EQ(dw, w / f);
+    ASSERT_EQ(dh, h / f);
+
+    for (int y = 0; y < dh; ++y) {
+        for (int x = 0; x < dw; ++x) {
+            for (int ch = 0; ch < c; ++ch) {
+                int sum = 0;
+                for (int j = 0; j < f; ++j) {
+                    for (int i = 0; i < f; ++i) {
+                        sum += src[((y * f + j) * w + x * f + i) * c + ch];
+                    }
+                }
+                ASSERT_EQ(dst[(y * dw + x) * c + ch], (sum + f * f / 2) / (f * f));
+            }
+        }
+    }
+    free_image(dst);
+}
+
+TEST(ImageResizeTest, FractionalFactorPreservesMeanAndConstants) {
+    constexpr int w = 101, h = 67, c = 1;
+    std::vector<unsigned char> flat(w * h * c, 77);
+
+    int dw, dh;
+    unsigned char* dst = image_io::downscale(flat.data(), w, h, c, 2.5f, dw, dh);
+    EXPECT_EQ(dw, 40);
+    EXPECT_EQ(dh, 26);
+    for (int i = 0; i < dw * dh * c; ++i) {
+        ASSERT_EQ(dst[i], 77);
+    }
+    free_image(dst);
+
+    // A horizontal ramp keeps its mean under area filtering
+    std::vector<unsigned char> ramp(w * h);
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            ramp[y * w + x] = static_cast<unsigned char>(x * 2);
+        }
+    }
+    std::vector<unsigned char> out(50 * 33);
+    image_io::downscale(ramp.data(), w, h, 1, out.data(), 50, 33);
+    double src_mean = 0.0, dst_mean = 0.0;
+    for (auto v : ramp) {
+        src_mean += v;
+    }
+    for (auto v : out) {
+        dst_mean += v;
+    }
+    EXPECT_NEAR(src_mean / ramp.size(), dst_mean / out.size(), 0.5);
+}
+
+TEST_F(ImageCacheTest, ScaledJpegDecodeMatchesAreaDownscale) {
+    const auto jpg = dir / "scaled.jpg";
+    auto ramp = torch::linspace(0.0f, 1.0f, 101).view({1, 1, 101}).expand({3, 75, 101});
+    save_image(jpg, ramp.contiguous());
+
+    auto [full, fw, fh, fc] = load_image(jpg);
+    for (int factor : {2, 3, 4, 8}) {
+        auto [data, w, h, c] = load_image(jpg, factor);
+        const auto [ew, eh] = image_io::downscaled_size(fw, fh, static_cast<float>(factor));
+        ASSERT_EQ(w, ew) << "factor " << factor;
+        ASSERT_EQ(h, eh) << "factor " << factor;
+        ASSERT_EQ(c, fc);
+
+        std::vector<unsigned char> ref(static_cast<size_t>(w) * h * c);
+        image_io::downscale(full, fw, fh, fc, ref.data(), w, h);
+        double diff = 0.0;
+        for (size_t i = 0; i < ref.size(); ++i) {
+            diff += std::abs(static_cast<int>(ref[i]) - static_cast<int>(data[i]));
+        }
+        EXPECT_LT(diff / ref.size(), image_io::has_fast_jpeg() ? 3.0 : 0.5) << "factor " << factor;
+        free_image(data);
+    }
+    free_image(full);
+}
@@ -0,0 +1,163 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/knn.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using gs::KnnIndex;
+
+// KnnIndex against an exhaustive search over the same points
+class KnnIndexTest : public ::testing::Test {
+protected:
+    static std::vector<float> random_points(size_t n, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coord(-5.0f, 5.0f);
+        std::vector<float> points(n * 3);
+        for (auto& c : points) {
+            c = coord(rng);
+        }
+        return points;
+    }
+
+    static float sq_distance(const float* a, const float* b) {
+        const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    // Squared distances from `query` to every point, ascending
+    static std::vector<float> sorted_sq_distances(const std::vector<float>& points, const float* query) {
+        std::vector<float> dists(points.size() / 3);
+        for (size_t i = 0; i < dists.size(); ++i) {
+            dists[i] = sq_distance(points.data() + i * 3, query);
+        }
+        std::sort(dists.begin(), dists.end());
+        return dists;
+    }
+
+    static float brute_force_mean_distance(const std::vector<float>& points, size_t i, size_t k, float fallback) {
+        const auto dists = sorted_sq_distances(points, points.data() + i * 3);
+        float sum = 0.0f;
+        size_t valid = 0;
+        for (size_t j = 0; j < dists.size() && valid < k; ++j) {
+            if (dists[j] > 1e-8f) {
+                sum += std::sqrt(dists[j]);
+                ++valid;
+            }
+        }
+        return valid > 0 ? sum / static_cast<float>(valid) : fallback;
+    }
+
+    // Every row of query() holds the k smallest distances in order, with matching indices
+    static void expect_matches_brute_force(const std::vector<float>& points, const std::vector<float>& queries, size_t k) {
+        const KnnIndex index(points.data(), points.size() / 3);
+        const size_t num_queries = queries.size() / 3;
+        std::vector<uint32_t> indices(num_queries * k);
+        std::vector<float> sq_dists(num_queries * k);
+        index.query(queries.data(), num_queries, k, indices.data(), sq_dists.data());
+
+        const size_t found = std::min(k, index.size());
+        for (size_t q = 0; q < num_queries; ++q) {
+            const float* query = queries.data() + q * 3;
+            const auto expected = sorted_sq_distances(points, query);
+            for (size_t j = 0; j < found; ++j) {
+                const uint32_t idx = indices[q * k + j];
+                ASSERT_LT(idx, index.size()) << "query " << q << " neighbour " << j;
+                EXPECT_NEAR(sq_dists[q * k + j], expected[j], 1e-5f) << "query " << q << " neighbour " << j;
+                EXPECT_NEAR(sq_distance(points.data() + idx * 3, query), sq_dists[q * k + j], 1e-5f);
+            }
+            // Distinct neighbours within a row
+            std::vector<uint32_t> row(indices.begin() + q * k, indices.begin() + q * k + found);
+            std::sort(row.begin(), row.end());
+            EXPECT_EQ(std::adjacent_find(row.begin(), row.end()), row.end()) << "query " << q;
+            for (size_t j = found; j < k; ++j) {
+                EXPECT_EQ(indices[q * k + j], KnnIndex::INVALID);
+                EXPECT_EQ(sq_dists[q * k + j], std::numeric_limits<float>::infinity());
+            }
+        }
+    }
+};
+
+TEST_F(KnnIndexTest, QueryMatchesBruteForce) {
+    const auto points = random_points(3000, 1);
+    const auto queries = random_points(500, 2);
+    for (const size_t k : {1u, 4u, 16u}) {
+        SCOPED_TRACE(k);
+        expect_matches_brute_force(points, queries, k);
+    }
+}
+
+TEST_F(KnnIndexTest, PadsRowsPastTheIndexSize) {
+    const auto points = random_points(5, 3);
+    const auto queries = random_points(40, 4);
+    for (const size_t k : {5u, 6u, 9u}) {
+        SCOPED_TRACE(k);
+        expect_matches_brute_force(points, queries, k);
+    }
+
+    // An empty index pads every slot
+    const KnnIndex empty(nullptr, 0);
+    std::vector<uint32_t> indices(2 * 3, 0);
+    std::vector<float> sq_dists(2 * 3, 0.0f);
+    empty.query(queries.data(), 2, 3, indices.data(), sq_dists.data());
+    EXPECT_TRUE(std::all_of(indices.begin(), indices.end(), [](uint32_t i) { return i == KnnIndex::INVALID; }));
+    EXPECT_TRUE(std::all_of(sq_dists.begin(), sq_dists.end(), [](float d) { return std::isinf(d); }));
+}
+
+TEST_F(KnnIndexTest, QueryReturnsDuplicatesAsDistinctNeighbours) {
+    // Every position appears three times
+    auto points = random_points(200, 5);
+    const std::vector<float> unique = points;
+    for (int copy = 0; copy < 2; ++copy) {
+        points.insert(points.end(), unique.begin(), unique.end());
+    }
+    expect_matches_brute_force(points, unique, 5);
+}
+
+TEST_F(KnnIndexTest, MeanNeighborDistancesMatchBruteForce) {
+    const auto points = random_points(2000, 6);
+    const KnnIndex index(points.data(), points.size() / 3);
+    for (const size_t k : {1u, 3u, 8u}) {
+        const auto means = index.mean_neighbor_distances(k, -1.0f);
+        ASSERT_EQ(means.size(), index.size());
+        for (size_t i = 0; i < means.size(); ++i) {
+            EXPECT_NEAR(means[i], brute_force_mean_distance(points, i, k, -1.0f), 1e-4f) << "k " << k << " point " << i;
+        }
+    }
+}
+
+TEST_F(KnnIndexTest, MeanNeighborDistancesSkipDuplicates) {
+    // Points 0-2 coincide, 3 and 4 are apart from them: a coincident point is not a neighbour
+    const std::vector<float> points = {
+        0.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 0.0f,
+        1.0f, 0.0f, 0.0f,
+        0.0f, 3.0f, 0.0f};
+    const KnnIndex index(points.data(), 5);
+
+    // Only the k + 1 nearest are searched, so a point with k or more copies of itself falls back
+    const auto nearest = index.mean_neighbor_distances(1, -1.0f);
+    EXPECT_EQ(nearest, (std::vector<float>{-1.0f, -1.0f, -1.0f, 1.0f, 3.0f}));
+    EXPECT_FLOAT_EQ(index.mean_neighbor_distances(2, -1.0f)[0], -1.0f);
+    // With k = 3 the window reaches point 3; its neighbours are points 4 and 0-2, never itself
+    const auto wider = index.mean_neighbor_distances(3, -1.0f);
+    EXPECT_FLOAT_EQ(wider[0], 1.0f);
+    EXPECT_FLOAT_EQ(wider[3], 1.0f);
+    EXPECT_FLOAT_EQ(wider[4], 3.0f);
+
+    // A cloud of one position only has no neighbours at all
+    const std::vector<float> same(4 * 3, 2.0f);
+    const KnnIndex coincident(same.data(), 4);
+    for (const float d : coincident.mean_neighbor_distances(3, 0.25f)) {
+        EXPECT_EQ(d, 0.25f);
+    }
+    const KnnIndex single(points.data(), 1);
+    EXPECT_EQ(single.mean_neighbor_distances(3, 0.5f), std::vector<float>{0.5f});
+}
@@ -377,3 +377,44 @@ TEST_F(MCMCTest, MultipleRefinementCyclesTest) {
     // Verify some growth happened
     EXPECT_GT(sizes.back(), sizes.front()) << "Some Gaussians should have been added";
 }
+
+TEST_F(MCMCTest, ReservedCapacityGrowsInPlaceTest) {
+    // Growth up to max_cap must reuse the storage reserved at initialization
+    auto splat_data = createTestSplatData(50);
+    auto mcmc = std::make_unique<MCMC>(std::move(splat_data));
+
+    params.optimization.max_cap = 200;
+    params.optimization.start_refine = 100;
+    params.optimization.stop_refine = 1000;
+    params.optimization.refine_every = 100;
+    mcmc->initialize(params.optimization);
+
+    auto& model = mcmc->get_model();
+    ASSERT_TRUE(model.has_reserved_capacity());
+    EXPECT_EQ(model.capacity(), params.optimization.max_cap);
+    const void* means_storage = model.means().data_ptr();
+    const void* shN_storage = model.shN().data_ptr();
+
+    for (int iter = 100; iter <= 300; iter += 100) {
+        auto render_output = performRendering(*mcmc);
+        auto loss = render_output.image.mean();
+        loss.backward();
+
+        mcmc->post_backward(iter, render_output);
+        mcmc->step(iter);
+    }
+
+    EXPECT_GT(model.size(), 50) << "Some Gaussians should have been added";
+    EXPECT_TRUE(model.has_reserved_capacity());
+    EXPECT_EQ(model.means().data_ptr(), means_storage);
+    EXPECT_EQ(model.shN().data_ptr(), shN_storage);
+    EXPECT_TRUE(model.means().requires_grad());
+
+    // Pruning compacts within the same storage
+    auto mask = torch::zeros({model.size()}, torch::TensorOptions().dtype(torch::kBool).device(device));
+    mask.index_put_({torch::indexing::Slice(0, 10)}, true);
+    const int64_t before = model.size();
+    mcmc->remove_gaussians(mask);
+    EXPECT_EQ(model.size(), before - 10);
+    EXPECT_EQ(model.means().data_ptr(), means_storage);
+}
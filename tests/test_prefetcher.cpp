@@ -0,0 +1,158 @@
+/* SPDX-FileCopyrightText: 2025 LichtFeld Studio Authors
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later */
+
+#include "core/camera.hpp"
+#include "core/device.hpp"
+#include "core/image_io.hpp"
+#include "core/parameters.hpp"
+#include "dataset.hpp"
+#include "prefetcher.hpp"
+#include <ATen/CPUGeneratorImpl.h>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <torch/torch.h>
+#include <vector>
+
+using namespace gs;
+using gs::training::CameraDataset;
+using gs::training::ImagePrefetcher;
+
+// Prefetcher on the CPU over a handful of flat images: image i has every pixel set to 40 * i,
+// so a sample's pixels identify the view it was decoded from.
+class PrefetcherTest : public ::testing::Test {
+protected:
+    static constexpr int kWidth = 16;
+    static constexpr int kHeight = 12;
+    static constexpr int kViews = 5;
+
+    void SetUp() override {
+        previous_device = training_device();
+        set_training_device(torch::kCPU);
+
+        dir = std::filesystem::temp_directory_path() / "lfs_prefetcher_test";
+        std::filesystem::create_directories(dir);
+        std::vector<std::shared_ptr<Camera>> cameras;
+        for (int i = 0; i < kViews; ++i) {
+            const auto path = dir / ("view_" + std::to_string(i) + ".png");
+            save_image(path, torch::full({3, kHeight, kWidth}, static_cast<float>(40 * i) / 255.0f));
+            cameras.push_back(std::make_shared<Camera>(
+                torch::eye(3), torch::zeros({3}), 20.0f, 20.0f, 0.5f * kWidth, 0.5f * kHeight,
+                torch::empty({0}), torch::empty({0}), gsplat::CameraModelType::PINHOLE,
+                path.filename().string(), path, kWidth, kHeight, i));
+        }
+        param::DatasetConfig config;
+        dataset = std::make_shared<CameraDataset>(std::move(cameras), config, CameraDataset::Split::ALL);
+    }
+
+    void TearDown() override {
+        set_training_device(previous_device);
+        std::filesystem::remove_all(dir);
+    }
+
+    // Shuffled-epoch order the prefetcher promises for `count` samples from the start of the stream
+    static std::vector<size_t> expected_order(uint64_t seed, size_t count) {
+        std::vector<size_t> order;
+        for (size_t epoch = 0; order.size() < count; ++epoch) {
+            auto generator = at::make_generator<at::CPUGeneratorImpl>(seed + epoch);
+            const auto perm = torch::randperm(kViews, generator, torch::kInt64);
+            for (int64_t i = 0; i < kViews && order.size() < count; ++i) {
+                order.push_back(static_cast<size_t>(perm[i].item<int64_t>()));
+            }
+        }
+        return order;
+    }
+
+    torch::Device previous_device = torch::kCPU;
+    std::filesystem::path dir;
+    std::shared_ptr<CameraDataset> dataset;
+};
+
+TEST_F(PrefetcherTest, FollowsSamplerOrder) {
+    ImagePrefetcher prefetcher(dataset, {.ring_size = 3, .num_workers = 3, .seed = 7});
+    const auto order = expected_order(7, 3 * kViews);
+    for (const size_t view : order) {
+        const auto sample = prefetcher.next();
+        ASSERT_EQ(sample.view, view);
+        EXPECT_EQ(sample.camera->uid(), static_cast<int>(view));
+        ASSERT_EQ(sample.image.sizes(), (std::vector<int64_t>{kHeight, kWidth, 3}));
+        EXPECT_TRUE(torch::all(sample.image == static_cast<uint8_t>(40 * view)).item<bool>());
+    }
+    EXPECT_EQ(prefetcher.stats().samples, order.size());
+}
+
+TEST_F(PrefetcherTest, ResumesMidStream) {
+    const auto order = expected_order(3, 12);
+    ImagePrefetcher prefetcher(dataset, {.ring_size = 4, .num_workers = 2, .seed = 3, .first_sample = 7});
+    for (size_t s = 7; s < order.size(); ++s) {
+        EXPECT_EQ(prefetcher.next().view, order[s]);
+    }
+}
+
+TEST_F(PrefetcherTest, RethrowsDecodeErrorsInOrder) {
+    const auto order = expected_order(1, kViews);
+    std::filesystem::remove(dataset->get_split_cameras()[order[1]]->image_path());
+
+    ImagePrefetcher prefetcher(dataset, {.ring_size = 2, .num_workers = 2, .seed = 1});
+    EXPECT_EQ(prefetcher.next().view, order[0]);
+    EXPECT_ANY_THROW(prefetcher.next());
+    EXPECT_EQ(prefetcher.next().view, order[2]);
+}
+
+TEST_F(PrefetcherTest, ShutsDownWithFullRing) {
+    // Workers block on a full ring; destruction must wake and join them
+    for (int handed_out = 0; handed_out < 3; ++handed_out) {
+        ImagePrefetcher prefetcher(dataset, {.ring_size = 2, .num_workers = 4, .seed = 5});
+        for (int i = 0; i < handed_out; ++i) {
+            prefetcher.next();
+        }
+        // The sample handed out last stays in flight until the next call
+        const size_t ready = handed_out == 0 ? 2 : 1;
+        while (prefetcher.queue_depth() < ready) {
+            std::this_thread::yield();
+        }
+    }
+    SUCCEED();
+}
+
+TEST_F(PrefetcherTest, BatchedStepsFollowTheResolutionSchedule) {
+    // Two views per step at half resolution until step 3: samples 0-3 are steps 1 and 2
+    const auto order = expected_order(9, 8);
+    {
+        ImagePrefetcher prefetcher(dataset, {.ring_size = 3, .num_workers = 2, .seed = 9,
+                                             .resolution_steps = {3}, .views_per_step = 2});
+        for (size_t s = 0; s < order.size(); ++s) {
+            const auto sample = prefetcher.next();
+            EXPECT_EQ(sample.view, order[s]);
+            const int64_t scale = s < 4 ? 2 : 1;
+            EXPECT_EQ(sample.image.size(0), kHeight / scale) << "sample " << s;
+            EXPECT_EQ(sample.image.size(1), kWidth / scale) << "sample " << s;
+        }
+    }
+
+    // Resumed after step 1 with three views per step: the stream continues at sample 2 and
+    // only step 2 (samples 2-4) is still served at half resolution
+    ImagePrefetcher prefetcher(dataset, {.ring_size = 4, .num_workers = 2, .seed = 9, .first_sample = 2,
+                                         .first_iteration = 2, .resolution_steps = {3}, .views_per_step = 3});
+    for (size_t s = 2; s < order.size(); ++s) {
+        const auto sample = prefetcher.next();
+        EXPECT_EQ(sample.view, order[s]);
+        EXPECT_EQ(sample.image.size(1), s < 5 ? kWidth / 2 : kWidth) << "sample " << s;
+    }
+}
+
+TEST_F(PrefetcherTest, ServesEachStepAtItsPyramidLevel) {
+    // Quarter resolution for step 1, half for steps 2 and 3, full from step 4
+    ImagePrefetcher prefetcher(dataset, {.ring_size = 3, .num_workers = 3, .seed = 2, .resolution_steps = {2, 4}});
+    const std::vector<int64_t> widths = {kWidth / 4, kWidth / 2, kWidth / 2, kWidth, kWidth, kWidth};
+    const std::vector<int64_t> heights = {kHeight / 4, kHeight / 2, kHeight / 2, kHeight, kHeight, kHeight};
+    for (size_t s = 0; s < widths.size(); ++s) {
+        const auto sample = prefetcher.next();
+        EXPECT_EQ(sample.image.size(0), heights[s]) << "sample " << s;
+        EXPECT_EQ(sample.image.size(1), widths[s]) << "sample " << s;
+        // Box-filtering a flat image keeps its value
+        EXPECT_TRUE(torch::all(sample.image == static_cast<uint8_t>(40 * sample.view)).item<bool>());
+    }
+}